@@ -0,0 +1,134 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/AsyncDiskWriter.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+namespace carla {
+
+  AsyncDiskWriter::AsyncDiskWriter(
+      const size_t worker_threads,
+      const size_t max_queue_size,
+      const OverflowPolicy overflow_policy)
+    : _max_queue_size(std::max<size_t>(max_queue_size, 1u)),
+      _overflow_policy(overflow_policy) {
+    _workers.CreateThreads(std::max<size_t>(worker_threads, 1u), [this]() { Run(); });
+  }
+
+  AsyncDiskWriter::~AsyncDiskWriter() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _job_available.notify_all();
+    _job_done.notify_all();
+    _workers.JoinAll();
+  }
+
+  bool AsyncDiskWriter::Write(Buffer data, std::string path, WriteFunction write) {
+    DEBUG_ASSERT(write != nullptr);
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      if (_queue.size() >= _max_queue_size) {
+        switch (_overflow_policy) {
+          case OverflowPolicy::Block:
+            _job_done.wait(lock, [this]() {
+              return _stop || (_queue.size() < _max_queue_size);
+            });
+            break;
+          case OverflowPolicy::DropNewest:
+            ++_stats.dropped;
+            return false;
+          case OverflowPolicy::DropOldest:
+            ++_stats.dropped;
+            _queue.pop_front();
+            _job_done.notify_all();
+            break;
+        }
+      }
+      if (_stop) {
+        ++_stats.dropped;
+        return false;
+      }
+      _queue.push_back(Job{_next_sequence++, std::move(data), std::move(path), std::move(write)});
+    }
+    _job_available.notify_one();
+    return true;
+  }
+
+  void AsyncDiskWriter::Flush() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    const uint64_t target = _next_sequence;
+    _job_done.wait(lock, [this, target]() {
+      return _stop || (GetOldestPendingSequence() >= target);
+    });
+  }
+
+  AsyncDiskWriter::Stats AsyncDiskWriter::GetStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Stats stats = _stats;
+    stats.pending = _queue.size() + _in_progress.size();
+    if (_write_time > 0.0) {
+      stats.throughput = 1e-6 * static_cast<double>(stats.bytes_written) / _write_time;
+    }
+    return stats;
+  }
+
+  void AsyncDiskWriter::Run() {
+    using clock = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+      // Pending jobs are written before stopping.
+      _job_available.wait(lock, [this]() { return _stop || !_queue.empty(); });
+      if (_queue.empty()) {
+        return;
+      }
+      Job job = std::move(_queue.front());
+      _queue.pop_front();
+      _in_progress.emplace_back(job.sequence);
+      // Room in the queue for blocked producers.
+      _job_done.notify_all();
+      lock.unlock();
+
+      const auto start = clock::now();
+      bool succeeded = true;
+      try {
+        job.write(job.data, job.path);
+      } catch (const std::exception &e) {
+        log_error("failed to write", job.path, ':', e.what());
+        succeeded = false;
+      }
+      const std::chrono::duration<double> elapsed = clock::now() - start;
+
+      lock.lock();
+      _in_progress.erase(std::find(_in_progress.begin(), _in_progress.end(), job.sequence));
+      _write_time += elapsed.count();
+      if (succeeded) {
+        ++_stats.written;
+        _stats.bytes_written += job.data.size();
+      } else {
+        ++_stats.failed;
+      }
+      _job_done.notify_all();
+    }
+  }
+
+  uint64_t AsyncDiskWriter::GetOldestPendingSequence() const {
+    // Jobs leave the queue in order, so the front is the oldest queued.
+    uint64_t oldest = _queue.empty() ? _next_sequence : _queue.front().sequence;
+    for (auto sequence : _in_progress) {
+      oldest = std::min(oldest, sequence);
+    }
+    return oldest;
+  }
+
+} // namespace carla
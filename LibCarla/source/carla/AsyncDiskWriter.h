@@ -0,0 +1,120 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/NonCopyable.h"
+#include "carla/ThreadGroup.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace carla {
+
+  /// Writes files in background threads. Each write is a Buffer owned by the
+  /// writer, the destination path, and the function that encodes the buffer
+  /// into the file (i.e. the format and color conversion). Producers, e.g. a
+  /// sensor callback, only pay for queuing the buffer.
+  ///
+  /// The queue is bounded, when full new writes block or are dropped
+  /// according to the OverflowPolicy.
+  class AsyncDiskWriter : private NonCopyable {
+  public:
+
+    using WriteFunction = std::function<void(const Buffer &data, const std::string &path)>;
+
+    enum class OverflowPolicy : uint8_t {
+      /// Wait until there is room in the queue (back-pressure).
+      Block,
+      /// Discard the write being queued.
+      DropNewest,
+      /// Discard the oldest write in the queue.
+      DropOldest
+    };
+
+    struct Stats {
+      /// Writes queued or in progress.
+      size_t pending = 0u;
+      uint64_t written = 0u;
+      uint64_t dropped = 0u;
+      /// Writes that threw an exception, the error is logged.
+      uint64_t failed = 0u;
+      uint64_t bytes_written = 0u;
+      /// Bytes written per second of write time, in MB/s.
+      double throughput = 0.0;
+    };
+
+    /// @a max_queue_size writes can be waiting (not counting the ones in
+    /// progress) before applying @a overflow_policy.
+    explicit AsyncDiskWriter(
+        size_t worker_threads = 1u,
+        size_t max_queue_size = 64u,
+        OverflowPolicy overflow_policy = OverflowPolicy::Block);
+
+    /// Finishes all the pending writes and joins the worker threads.
+    ~AsyncDiskWriter();
+
+    /// Queue a write of @a data to @a path. Return false if it was dropped.
+    bool Write(Buffer data, std::string path, WriteFunction write);
+
+    /// Block until every write queued before this call has finished (or has
+    /// been dropped). Writes queued meanwhile are not waited for.
+    void Flush();
+
+    Stats GetStats() const;
+
+  private:
+
+    struct Job {
+      uint64_t sequence;
+      Buffer data;
+      std::string path;
+      WriteFunction write;
+    };
+
+    void Run();
+
+    /// Sequence of the oldest job queued or in progress.
+    ///
+    /// @pre _mutex is locked.
+    uint64_t GetOldestPendingSequence() const;
+
+    const size_t _max_queue_size;
+
+    const OverflowPolicy _overflow_policy;
+
+    mutable std::mutex _mutex;
+
+    /// Notified when a job is queued, or on stop.
+    std::condition_variable _job_available;
+
+    /// Notified when a job leaves the queue or finishes.
+    std::condition_variable _job_done;
+
+    std::deque<Job> _queue;
+
+    /// Sequences of the jobs being written.
+    std::vector<uint64_t> _in_progress;
+
+    uint64_t _next_sequence = 0u;
+
+    bool _stop = false;
+
+    Stats _stats;
+
+    /// Accumulated write time, in seconds.
+    double _write_time = 0.0;
+
+    ThreadGroup _workers;
+  };
+
+} // namespace carla
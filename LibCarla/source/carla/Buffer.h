@@ -53,6 +53,33 @@ namespace carla {
 
     using const_iterator = const value_type *;
 
+    /// Deletes the memory allocated by the buffer. If the buffer wraps
+    /// external memory, releases instead the owner of that memory.
+    class Deleter {
+    public:
+
+      Deleter() = default;
+
+      explicit Deleter(std::shared_ptr<const void> owner) noexcept
+        : _owner(std::move(owner)) {}
+
+      void operator()(value_type *data) noexcept {
+        if (_owner != nullptr) {
+          // External memory, not ours to delete. Memory allocated later by
+          // reset() uses a default Deleter and is deleted below.
+          _owner.reset();
+        } else {
+          delete[] data;
+        }
+      }
+
+    private:
+
+      std::shared_ptr<const void> _owner;
+    };
+
+    using pointer_type = std::unique_ptr<value_type[], Deleter>;
+
     /// @}
     // =========================================================================
     /// @name Construction and destruction
@@ -68,7 +95,7 @@ namespace carla {
     explicit Buffer(size_type size)
       : _size(size),
         _capacity(size),
-        _data(std::make_unique<value_type[]>(size)) {}
+        _data(Allocate(size)) {}
 
     /// @copydoc Buffer(size_type)
     explicit Buffer(uint64_t size)
@@ -98,6 +125,15 @@ namespace carla {
           return static_cast<size_type>(size);
         } ()) {}
 
+    /// Wrap @a size bytes of external memory pointed by @a data, no copy is
+    /// made. @a owner must keep the memory valid, a reference to it is held
+    /// until the buffer releases the memory (i.e. is destroyed, cleared, or
+    /// needs more capacity).
+    explicit Buffer(value_type *data, size_type size, std::shared_ptr<const void> owner)
+      : _size(size),
+        _capacity(size),
+        _data(data, Deleter(std::move(owner))) {}
+
     Buffer(const Buffer &) = delete;
 
     Buffer(Buffer &&rhs) noexcept
@@ -249,7 +285,7 @@ namespace carla {
     void reset(size_type size) {
       if (_capacity < size) {
         log_debug("allocating buffer of", size, "bytes");
-        _data = std::make_unique<value_type[]>(size);
+        _data = Allocate(size);
         _capacity = size;
       }
       _size = size;
@@ -265,7 +301,7 @@ namespace carla {
 
     /// Release the contents of this buffer and set its size and capacity to
     /// zero.
-    std::unique_ptr<value_type[]> pop() noexcept {
+    pointer_type pop() noexcept {
       _size = 0u;
       _capacity = 0u;
       return std::move(_data);
@@ -343,6 +379,10 @@ namespace carla {
 
   private:
 
+    static pointer_type Allocate(size_type size) {
+      return pointer_type(new value_type[size]());
+    }
+
     void ReuseThisBuffer();
 
     friend class BufferPool;
@@ -353,7 +393,7 @@ namespace carla {
 
     size_type _capacity = 0u;
 
-    std::unique_ptr<value_type[]> _data = nullptr;
+    pointer_type _data = nullptr;
   };
 
 } // namespace carla
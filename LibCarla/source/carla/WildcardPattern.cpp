@@ -0,0 +1,130 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/WildcardPattern.h"
+
+#include "carla/StringUtil.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace carla {
+
+  /// Maximum number of patterns kept in the cache, it is flushed when full.
+  static constexpr size_t MAX_CACHED_PATTERNS = 256u;
+
+  WildcardPattern::WildcardPattern(std::string pattern)
+    : _pattern(std::move(pattern)) {
+#ifdef _WIN32
+    // PathMatchSpec has its own rules (e.g. case-insensitive), keep them.
+    _kind = Kind::Fallback;
+#else
+    if (_pattern.find_first_of("[\\") != std::string::npos) {
+      // Bracket expressions and escapes are left to fnmatch.
+      _kind = Kind::Fallback;
+      return;
+    }
+    const auto first_wildcard = _pattern.find_first_of("*?");
+    if (first_wildcard == std::string::npos) {
+      _kind = Kind::Literal;
+      _text = _pattern;
+      return;
+    }
+    if (_pattern.find('?') != std::string::npos) {
+      _kind = Kind::Generic;
+      return;
+    }
+    const auto last_star = _pattern.rfind('*');
+    const auto size = _pattern.size();
+    if (first_wildcard == last_star) {
+      // A single star.
+      if (last_star == size - 1u) {
+        _kind = (size == 1u ? Kind::Any : Kind::Prefix);
+        _text = _pattern.substr(0u, size - 1u);
+        return;
+      }
+      if (last_star == 0u) {
+        _kind = Kind::Suffix;
+        _text = _pattern.substr(1u);
+        return;
+      }
+    } else if ((first_wildcard == 0u) && (last_star == size - 1u) &&
+               (_pattern.find('*', 1u) == last_star)) {
+      _kind = Kind::Contains;
+      _text = _pattern.substr(1u, size - 2u);
+      return;
+    }
+    _kind = Kind::Generic;
+#endif // _WIN32
+  }
+
+  SharedPtr<const WildcardPattern> WildcardPattern::Get(const std::string &pattern) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, SharedPtr<const WildcardPattern>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(pattern);
+    if (it != cache.end()) {
+      return it->second;
+    }
+    if (cache.size() >= MAX_CACHED_PATTERNS) {
+      cache.clear();
+    }
+    auto compiled = MakeShared<const WildcardPattern>(pattern);
+    cache.emplace(pattern, compiled);
+    return compiled;
+  }
+
+  /// Iterative matching of '*' and '?' wildcards, backtracking only to the
+  /// last star seen.
+  static bool MatchGeneric(const std::string &str, const std::string &pattern) {
+    const size_t length = str.size();
+    const size_t pattern_length = pattern.size();
+    size_t s = 0u;
+    size_t p = 0u;
+    size_t star = pattern_length; // none.
+    size_t star_match = 0u;
+    while (s < length) {
+      if ((p < pattern_length) && ((pattern[p] == '?') || (pattern[p] == str[s]))) {
+        ++s;
+        ++p;
+      } else if ((p < pattern_length) && (pattern[p] == '*')) {
+        star = p++;
+        star_match = s;
+      } else if (star != pattern_length) {
+        p = star + 1u;
+        s = ++star_match;
+      } else {
+        return false;
+      }
+    }
+    while ((p < pattern_length) && (pattern[p] == '*')) {
+      ++p;
+    }
+    return p == pattern_length;
+  }
+
+  bool WildcardPattern::Match(const std::string &str) const {
+    switch (_kind) {
+      case Kind::Literal:
+        return str == _text;
+      case Kind::Prefix:
+        return str.compare(0u, _text.size(), _text) == 0;
+      case Kind::Suffix:
+        return (str.size() >= _text.size()) &&
+            (str.compare(str.size() - _text.size(), _text.size(), _text) == 0);
+      case Kind::Contains:
+        return str.find(_text) != std::string::npos;
+      case Kind::Any:
+        return true;
+      case Kind::Generic:
+        return MatchGeneric(str, _pattern);
+      case Kind::Fallback:
+      default:
+        return StringUtil::Match(str, _pattern);
+    }
+  }
+
+} // namespace carla
@@ -0,0 +1,62 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+
+#include <string>
+
+namespace carla {
+
+  /// A Unix shell-style wildcard pattern compiled for repeated matching.
+  ///
+  /// Matches the same strings as StringUtil::Match, but the pattern is parsed
+  /// only once and the most common shapes ("abc", "abc*", "*abc", "*abc*",
+  /// "*") are matched with a single string comparison.
+  class WildcardPattern {
+  public:
+
+    explicit WildcardPattern(std::string pattern);
+
+    /// Return a compiled @a pattern from a process-wide cache, compiling it
+    /// if not found.
+    static SharedPtr<const WildcardPattern> Get(const std::string &pattern);
+
+    const std::string &GetPattern() const {
+      return _pattern;
+    }
+
+    /// Whether the pattern has no wildcards, i.e. it only matches the string
+    /// equal to the pattern.
+    bool IsLiteral() const {
+      return _kind == Kind::Literal;
+    }
+
+    bool Match(const std::string &str) const;
+
+  private:
+
+    enum class Kind {
+      Literal,
+      Prefix,
+      Suffix,
+      Contains,
+      Any,
+      Generic,
+      Fallback
+    };
+
+    std::string _pattern;
+
+    /// Literal part of the pattern, without the wildcards, for the simple
+    /// kinds.
+    std::string _text;
+
+    Kind _kind;
+  };
+
+} // namespace carla
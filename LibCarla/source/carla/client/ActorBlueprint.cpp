@@ -8,6 +8,7 @@
 
 #include "carla/Exception.h"
 #include "carla/StringUtil.h"
+#include "carla/WildcardPattern.h"
 
 #include <algorithm>
 
@@ -31,10 +32,11 @@ namespace client {
   }
 
   bool ActorBlueprint::MatchTags(const std::string &wildcard_pattern) const {
+    const auto pattern = WildcardPattern::Get(wildcard_pattern);
     return
-        StringUtil::Match(_id, wildcard_pattern) ||
+        pattern->Match(_id) ||
         std::any_of(_tags.begin(), _tags.end(), [&](const auto &tag) {
-          return StringUtil::Match(tag, wildcard_pattern);
+          return pattern->Match(tag);
         });
   }
 
@@ -6,9 +6,10 @@
 
 #include "carla/client/ActorList.h"
 
-#include "carla/StringUtil.h"
+#include "carla/WildcardPattern.h"
 #include "carla/client/detail/ActorFactory.h"
 
+#include <algorithm>
 #include <iterator>
 
 namespace carla {
@@ -20,6 +21,14 @@ namespace client {
     : _episode(std::move(episode)),
       _actors(std::make_move_iterator(actors.begin()), std::make_move_iterator(actors.end())) {}
 
+  ActorList::ActorList(
+      detail::EpisodeProxy episode,
+      std::shared_ptr<const detail::EpisodeState> state,
+      const std::vector<detail::CachedActorList::ActorPtr> &actors)
+    : _episode(std::move(episode)),
+      _state(std::move(state)),
+      _actors(actors.begin(), actors.end()) {}
+
   SharedPtr<Actor> ActorList::Find(const ActorId actor_id) const {
     for (auto &actor : _actors) {
       if (actor_id == actor.GetId()) {
@@ -30,14 +39,46 @@ namespace client {
   }
 
   SharedPtr<ActorList> ActorList::Filter(const std::string &wildcard_pattern) const {
-    SharedPtr<ActorList> filtered (new ActorList(_episode, {}));
-    for (auto &&actor : _actors) {
-      if (StringUtil::Match(actor.GetTypeId(), wildcard_pattern)) {
-        filtered->_actors.push_back(actor);
+    const auto pattern = WildcardPattern::Get(wildcard_pattern);
+    const auto &index = GetTypeIndex();
+    std::vector<size_t> matches;
+    if (pattern->IsLiteral()) {
+      auto it = index.find(wildcard_pattern);
+      if (it != index.end()) {
+        matches = it->second;
+      }
+    } else {
+      size_t matched_types = 0u;
+      for (auto &pair : index) {
+        if (pattern->Match(pair.first)) {
+          matches.insert(matches.end(), pair.second.begin(), pair.second.end());
+          ++matched_types;
+        }
       }
+      if (matched_types > 1u) {
+        // Keep the original order of the actors.
+        std::sort(matches.begin(), matches.end());
+      }
+    }
+    SharedPtr<ActorList> filtered (new ActorList(_episode, {}));
+    filtered->_state = _state;
+    filtered->_actors.reserve(matches.size());
+    for (auto i : matches) {
+      filtered->_actors.push_back(_actors[i]);
     }
     return filtered;
   }
 
+  const ActorList::TypeIndex &ActorList::GetTypeIndex() const {
+    std::call_once(_type_index_flag, [this]() {
+      auto index = std::make_unique<TypeIndex>();
+      for (size_t i = 0u; i < _actors.size(); ++i) {
+        (*index)[_actors[i].GetTypeId()].emplace_back(i);
+      }
+      _type_index = std::move(index);
+    });
+    return *_type_index;
+  }
+
 } // namespace client
 } // namespace carla
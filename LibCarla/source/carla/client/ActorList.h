@@ -7,14 +7,21 @@
 #pragma once
 
 #include "carla/client/detail/ActorVariant.h"
+#include "carla/client/detail/CachedActorList.h"
+#include "carla/client/detail/EpisodeState.h"
 
 #include <boost/iterator/transform_iterator.hpp>
 
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace carla {
 namespace client {
 
+  /// List of actors, the Actor instances are only created when accessed.
   class ActorList : public EnableSharedFromThis<ActorList> {
   private:
 
@@ -31,6 +38,8 @@ namespace client {
     SharedPtr<Actor> Find(ActorId actor_id) const;
 
     /// Filters a list of Actor with type id matching @a wildcard_pattern.
+    ///
+    /// The pattern is only tested once per distinct type id in the list.
     SharedPtr<ActorList> Filter(const std::string &wildcard_pattern) const;
 
     SharedPtr<Actor> operator[](size_t pos) const {
@@ -63,9 +72,30 @@ namespace client {
 
     ActorList(detail::EpisodeProxy episode, std::vector<rpc::Actor> actors);
 
+    /// List of the actors present in @a state, sharing the descriptions
+    /// cached by the episode.
+    ActorList(
+        detail::EpisodeProxy episode,
+        std::shared_ptr<const detail::EpisodeState> state,
+        const std::vector<detail::CachedActorList::ActorPtr> &actors);
+
+    /// Positions in _actors of the actors of each type id.
+    using TypeIndex = std::unordered_map<std::string, std::vector<size_t>>;
+
+    /// Return the type index, building it the first time is requested.
+    const TypeIndex &GetTypeIndex() const;
+
     detail::EpisodeProxy _episode;
 
+    /// State the list was taken from, if any. Pinned so the list keeps
+    /// referring to the same frame.
+    std::shared_ptr<const detail::EpisodeState> _state;
+
     std::vector<detail::ActorVariant> _actors;
+
+    mutable std::once_flag _type_index_flag;
+
+    mutable std::unique_ptr<TypeIndex> _type_index;
   };
 
 } // namespace client
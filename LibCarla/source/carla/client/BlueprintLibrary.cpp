@@ -7,6 +7,7 @@
 #include "carla/client/BlueprintLibrary.h"
 
 #include "carla/Exception.h"
+#include "carla/WildcardPattern.h"
 
 #include <algorithm>
 #include <iterator>
@@ -20,17 +21,52 @@ namespace client {
     for (auto &definition : blueprints) {
       _blueprints.emplace(definition.id, definition);
     }
+    BuildTagIndex();
+  }
+
+  BlueprintLibrary::BlueprintLibrary(map_type blueprints)
+    : _blueprints(std::move(blueprints)) {
+    BuildTagIndex();
+  }
+
+  void BlueprintLibrary::BuildTagIndex() {
+    for (auto &pair : _blueprints) {
+      for (auto &tag : pair.second.GetTags()) {
+        _tag_index[tag].emplace_back(pair.first);
+      }
+    }
   }
 
   SharedPtr<BlueprintLibrary> BlueprintLibrary::Filter(
       const std::string &wildcard_pattern) const {
+    const auto pattern = WildcardPattern::Get(wildcard_pattern);
     map_type result;
-    for (auto &pair : _blueprints) {
-      if (pair.second.MatchTags(wildcard_pattern)) {
-        result.emplace(pair);
+    auto add = [&](const key_type &id) {
+      if (result.find(id) == result.end()) {
+        result.emplace(id, _blueprints.at(id));
+      }
+    };
+    if (pattern->IsLiteral()) {
+      if (_blueprints.find(wildcard_pattern) != _blueprints.end()) {
+        add(wildcard_pattern);
+      }
+      auto it = _tag_index.find(wildcard_pattern);
+      if (it != _tag_index.end()) {
+        std::for_each(it->second.begin(), it->second.end(), add);
+      }
+    } else {
+      for (auto &pair : _blueprints) {
+        if (pattern->Match(pair.first)) {
+          result.emplace(pair);
+        }
+      }
+      for (auto &pair : _tag_index) {
+        if (pattern->Match(pair.first)) {
+          std::for_each(pair.second.begin(), pair.second.end(), add);
+        }
       }
     }
-    return SharedPtr<BlueprintLibrary>{new BlueprintLibrary(result)};
+    return SharedPtr<BlueprintLibrary>{new BlueprintLibrary(std::move(result))};
   }
 
   BlueprintLibrary::const_pointer BlueprintLibrary::Find(const std::string &key) const {
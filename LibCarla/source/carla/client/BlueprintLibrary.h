@@ -42,6 +42,8 @@ namespace client {
 
     /// Filters a list of ActorBlueprint with id or tags matching
     /// @a wildcard_pattern.
+    ///
+    /// The pattern is only tested once per distinct tag in the library.
     SharedPtr<BlueprintLibrary> Filter(const std::string &wildcard_pattern) const;
 
     const_pointer Find(const std::string &key) const;
@@ -77,10 +79,14 @@ namespace client {
 
   private:
 
-    BlueprintLibrary(map_type blueprints)
-      : _blueprints(std::move(blueprints)) {}
+    BlueprintLibrary(map_type blueprints);
+
+    void BuildTagIndex();
 
     map_type _blueprints;
+
+    /// Ids of the blueprints with each tag.
+    std::unordered_map<std::string, std::vector<key_type>> _tag_index;
   };
 
 } // namespace client
@@ -0,0 +1,64 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace carla {
+namespace client {
+
+  /// Where a registered callback is executed.
+  enum class CallbackExecutor : uint8_t {
+    /// Run in the streaming thread that received the data. A slow callback
+    /// delays every other callback and the delivery of the following frames.
+    Inline,
+    /// Run in a thread owned exclusively by this callback.
+    DedicatedThread,
+    /// Run in a thread pool shared by all the callbacks of the episode.
+    SharedPool
+  };
+
+  /// What to do with an incoming event when the queue of a callback is full.
+  enum class CallbackOverflowPolicy : uint8_t {
+    /// Discard the incoming event.
+    DropNewest,
+    /// Discard the oldest pending event. With a queue size of one the callback
+    /// only ever receives the latest event.
+    DropOldest
+  };
+
+  struct CallbackPolicy {
+    CallbackExecutor executor = CallbackExecutor::Inline;
+
+    /// Maximum number of pending events, ignored by inline callbacks.
+    size_t queue_size = 1u;
+
+    CallbackOverflowPolicy overflow = CallbackOverflowPolicy::DropOldest;
+  };
+
+  /// Execution statistics of a registered callback. Latency is the time spent
+  /// inside the callback, lag is the time an event waited in the queue before
+  /// the callback started. All times in milliseconds.
+  struct CallbackStats {
+    uint64_t calls = 0u;
+
+    uint64_t dropped = 0u;
+
+    size_t pending = 0u;
+
+    float average_latency = 0.0f;
+
+    float max_latency = 0.0f;
+
+    float average_lag = 0.0f;
+
+    float max_lag = 0.0f;
+  };
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,64 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/LaneRouter.h"
+
+#include "carla/Exception.h"
+#include "carla/client/Map.h"
+#include "carla/client/Waypoint.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace carla {
+namespace client {
+
+  static const road::Map &GetRoadMap(const SharedPtr<const Map> &map) {
+    if (map == nullptr) {
+      throw_exception(std::invalid_argument("LaneRouter: null map"));
+    }
+    return map->GetMap();
+  }
+
+  LaneRouter::LaneRouter(SharedPtr<const Map> map, const double lane_change_cost)
+    : _map(std::move(map)),
+      _graph(GetRoadMap(_map), lane_change_cost) {}
+
+  LaneRouter::~LaneRouter() = default;
+
+  void LaneRouter::BuildContractionHierarchy(const size_t witness_search_limit) {
+    // Built aside and published at once, FindRoute may be running.
+    _hierarchy = std::make_shared<const road::ContractionHierarchy>(_graph, witness_search_limit);
+  }
+
+  std::vector<SharedPtr<Waypoint>> LaneRouter::FindRoute(
+      const Waypoint &origin,
+      const Waypoint &destination) const {
+    if ((origin._parent != _map) || (destination._parent != _map)) {
+      // Lanes of another map may have the same ids, the route would be wrong.
+      throw_exception(std::invalid_argument("LaneRouter: waypoint from a different map"));
+    }
+    std::vector<SharedPtr<Waypoint>> result;
+    const auto origin_node = _graph.GetNode(origin._waypoint);
+    const auto destination_node = _graph.GetNode(destination._waypoint);
+    if (!origin_node.has_value() || !destination_node.has_value()) {
+      return result;
+    }
+    const auto hierarchy = _hierarchy.load();
+    const auto route = (hierarchy != nullptr) ?
+        hierarchy->FindRoute(*origin_node, *destination_node) :
+        _graph.FindRoute(*origin_node, *destination_node);
+    if (route.has_value()) {
+      result.reserve(route->nodes.size());
+      for (const auto node : route->nodes) {
+        result.emplace_back(SharedPtr<Waypoint>(new Waypoint{_map, _graph.GetWaypoint(node)}));
+      }
+    }
+    return result;
+  }
+
+} // namespace client
+} // namespace carla
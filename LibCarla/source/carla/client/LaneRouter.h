@@ -0,0 +1,75 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/AtomicSharedPtr.h"
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/road/ContractionHierarchy.h"
+#include "carla/road/LaneGraph.h"
+
+#include <vector>
+
+namespace carla {
+namespace client {
+
+  class Map;
+  class Waypoint;
+
+  /// Find routes between the lanes of a Map, see road::LaneGraph.
+  ///
+  /// Routes are found with A* unless BuildContractionHierarchy is called,
+  /// which preprocesses the graph for faster queries on large maps. Every
+  /// method can be called concurrently.
+  class LaneRouter : private NonCopyable {
+  public:
+
+    explicit LaneRouter(
+        SharedPtr<const Map> map,
+        double lane_change_cost = road::LaneGraph::DEFAULT_LANE_CHANGE_COST);
+
+    ~LaneRouter();
+
+    const SharedPtr<const Map> &GetMap() const {
+      return _map;
+    }
+
+    const road::LaneGraph &GetGraph() const {
+      return _graph;
+    }
+
+    /// Build a road::ContractionHierarchy of the graph, used by the calls to
+    /// FindRoute that start after it returns. Calls already in progress keep
+    /// using the previous one.
+    void BuildContractionHierarchy(
+        size_t witness_search_limit = road::ContractionHierarchy::DEFAULT_WITNESS_SEARCH_LIMIT);
+
+    bool HasContractionHierarchy() const {
+      return _hierarchy.load() != nullptr;
+    }
+
+    /// Return a waypoint at the entrance of each lane of the cheapest route
+    /// from the lane of @a origin to the lane of @a destination, both
+    /// included. Return an empty list if there is no route.
+    ///
+    /// @throw std::invalid_argument if a waypoint is not from the map of this
+    /// router.
+    std::vector<SharedPtr<Waypoint>> FindRoute(
+        const Waypoint &origin,
+        const Waypoint &destination) const;
+
+  private:
+
+    const SharedPtr<const Map> _map;
+
+    const road::LaneGraph _graph;
+
+    AtomicSharedPtr<const road::ContractionHierarchy> _hierarchy;
+  };
+
+} // namespace client
+} // namespace carla
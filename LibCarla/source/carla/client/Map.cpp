@@ -6,11 +6,18 @@
 
 #include "carla/client/Map.h"
 
+#include "carla/MsgPack.h"
+#include "carla/client/MapCache.h"
 #include "carla/client/Waypoint.h"
+#include "carla/client/detail/WaypointProjector.h"
 #include "carla/opendrive/OpenDriveParser.h"
+#include "carla/road/CompiledMap.h"
 #include "carla/road/Map.h"
 #include "carla/road/RoadTypes.h"
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
 #include <sstream>
 
 namespace carla {
@@ -27,6 +34,7 @@ namespace client {
 
   Map::Map(rpc::MapInfo description)
     : _description(std::move(description)),
+      _hash(_description.GetHash()),
       _map(MakeMap(_description.open_drive_file)) {}
 
   Map::Map(std::string name, std::string xodr_content)
@@ -35,8 +43,48 @@ namespace client {
           std::move(xodr_content),
           std::vector<geom::Transform>{}}) {}
 
+  Map::Map(rpc::MapInfo description, road::Map map)
+    : _description(std::move(description)),
+      _hash(_description.GetHash()),
+      _map(std::move(map)) {}
+
   Map::~Map() = default;
 
+  SharedPtr<Map> Map::LoadCompiled(const std::string &path) {
+    namespace bip = boost::interprocess;
+    // The region only needs to outlive the CompiledMap, the map built from
+    // it copies everything it uses.
+    bip::mapped_region region;
+    try {
+      bip::file_mapping file(path.c_str(), bip::read_only);
+      region = bip::mapped_region(file, bip::read_only);
+    } catch (const bip::interprocess_exception &e) {
+      throw_exception(std::runtime_error("Map: failed to map " + path + ": " + e.what()));
+    }
+    const road::CompiledMap compiled(
+        static_cast<const unsigned char *>(region.get_address()),
+        region.get_size());
+    // The metadata holds the description of the map.
+    const auto metadata = compiled.GetMetadata();
+    auto description = MsgPack::UnPack<rpc::MapInfo>(
+        reinterpret_cast<const unsigned char *>(metadata.data()),
+        metadata.size());
+    const auto hash = description.GetHash();
+    auto map = MapCache::Find(hash);
+    if (map == nullptr) {
+      map = MapCache::Add(hash, MakeShared<Map>(std::move(description), compiled.Load()));
+    }
+    return map;
+  }
+
+  void Map::SaveCompiled(const std::string &path) const {
+    const auto metadata = MsgPack::Pack(_description);
+    road::CompiledMap::Write(
+        _map,
+        path,
+        std::string(reinterpret_cast<const char *>(metadata.data()), metadata.size()));
+  }
+
   SharedPtr<Waypoint> Map::GetWaypoint(
       const geom::Location &location,
       bool project_to_road,
@@ -52,7 +100,24 @@ namespace client {
         nullptr;
   }
 
-  Map::TopologyList Map::GetTopology() const {
+  SharedPtr<Waypoint> Map::GetWaypoint(
+      const geom::Location &location,
+      const Waypoint &hint,
+      bool project_to_road,
+      uint32_t lane_type) const {
+    boost::optional<road::element::Waypoint> waypoint;
+    if (project_to_road) {
+      waypoint = _map.GetClosestWaypointOnRoad(location, hint._waypoint, lane_type);
+    } else {
+      waypoint = _map.GetWaypoint(location, hint._waypoint, lane_type);
+    }
+    return waypoint.has_value() ?
+        SharedPtr<Waypoint>(new Waypoint{shared_from_this(), *waypoint}) :
+        nullptr;
+  }
+
+  Map::TopologyList Map::MakeTopology(
+      const std::vector<std::pair<road::element::Waypoint, road::element::Waypoint>> &topology) const {
     namespace re = carla::road::element;
     std::unordered_map<re::Waypoint, SharedPtr<Waypoint>> waypoints;
 
@@ -67,7 +132,6 @@ namespace client {
     };
 
     TopologyList result;
-    auto topology = _map.GenerateTopology();
     result.reserve(topology.size());
     for (const auto &pair : topology) {
       result.emplace_back(
@@ -77,9 +141,17 @@ namespace client {
     return result;
   }
 
-  std::vector<SharedPtr<Waypoint>> Map::GenerateWaypoints(double distance) const {
+  Map::TopologyList Map::GetTopology() const {
+    return MakeTopology(_map.GenerateTopology());
+  }
+
+  Map::TopologyList Map::GetTopology(detail::WaypointProjector &projector) const {
+    return MakeTopology(projector.GenerateTopology(_map));
+  }
+
+  std::vector<SharedPtr<Waypoint>> Map::MakeWaypoints(
+      const std::vector<road::element::Waypoint> &waypoints) const {
     std::vector<SharedPtr<Waypoint>> result;
-    const auto waypoints = _map.GenerateWaypoints(distance);
     result.reserve(waypoints.size());
     for (const auto &waypoint : waypoints) {
       result.emplace_back(SharedPtr<Waypoint>(new Waypoint{shared_from_this(), waypoint}));
@@ -87,6 +159,16 @@ namespace client {
     return result;
   }
 
+  std::vector<SharedPtr<Waypoint>> Map::GenerateWaypoints(double distance) const {
+    return MakeWaypoints(_map.GenerateWaypoints(distance));
+  }
+
+  std::vector<SharedPtr<Waypoint>> Map::GenerateWaypoints(
+      double distance,
+      detail::WaypointProjector &projector) const {
+    return MakeWaypoints(projector.GenerateWaypoints(_map, distance));
+  }
+
   std::vector<road::element::LaneMarking> Map::CalculateCrossedLanes(
       const geom::Location &origin,
       const geom::Location &destination) const {
@@ -20,6 +20,7 @@ namespace geom { class GeoLocation; }
 namespace client {
 
   class Waypoint;
+  namespace detail { class WaypointProjector; }
 
   class Map
     : public EnableSharedFromThis<Map>,
@@ -30,6 +31,17 @@ namespace client {
 
     explicit Map(std::string name, std::string xodr_content);
 
+    /// Use an already built @a map, e.g. one loaded from a compiled map.
+    Map(rpc::MapInfo description, road::Map map);
+
+    /// Load a map written with SaveCompiled, without parsing its OpenDRIVE.
+    /// The map is added to the MapCache, so the client reuses it while the
+    /// simulator runs the same map.
+    ///
+    /// @throw std::runtime_error if the file cannot be mapped or is not a
+    /// valid compiled map.
+    static SharedPtr<Map> LoadCompiled(const std::string &path);
+
     ~Map();
 
     const std::string &GetName() const {
@@ -44,6 +56,11 @@ namespace client {
       return _description.open_drive_file;
     }
 
+    /// Hash of the description of the map, see rpc::MapInfo::Hash.
+    uint64_t GetHash() const {
+      return _hash;
+    }
+
     const std::vector<geom::Transform> &GetRecommendedSpawnPoints() const {
       return _description.recommended_spawn_points;
     }
@@ -53,22 +70,52 @@ namespace client {
         bool project_to_road = true,
         uint32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving)) const;
 
+    /// Same as above, but first searches the lanes around @a hint, e.g. the
+    /// previous waypoint of a moving actor. See
+    /// road::Map::GetClosestWaypointOnRoad.
+    SharedPtr<Waypoint> GetWaypoint(
+        const geom::Location &location,
+        const Waypoint &hint,
+        bool project_to_road = true,
+        uint32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving)) const;
+
     using TopologyList = std::vector<std::pair<SharedPtr<Waypoint>, SharedPtr<Waypoint>>>;
 
     TopologyList GetTopology() const;
 
+    /// Same as above, but the roads are split among the threads of @a
+    /// projector. The result is the same.
+    TopologyList GetTopology(detail::WaypointProjector &projector) const;
+
     std::vector<SharedPtr<Waypoint>> GenerateWaypoints(double distance) const;
 
+    /// Same as above, but the roads are split among the threads of @a
+    /// projector. The result is the same.
+    std::vector<SharedPtr<Waypoint>> GenerateWaypoints(
+        double distance,
+        detail::WaypointProjector &projector) const;
+
     std::vector<road::element::LaneMarking> CalculateCrossedLanes(
         const geom::Location &origin,
         const geom::Location &destination) const;
 
     const geom::GeoLocation &GetGeoReference() const;
 
+    /// Write this map to @a path in the format of road::CompiledMap.
+    void SaveCompiled(const std::string &path) const;
+
   private:
 
+    TopologyList MakeTopology(
+        const std::vector<std::pair<road::element::Waypoint, road::element::Waypoint>> &topology) const;
+
+    std::vector<SharedPtr<Waypoint>> MakeWaypoints(
+        const std::vector<road::element::Waypoint> &waypoints) const;
+
     const rpc::MapInfo _description;
 
+    const uint64_t _hash;
+
     const road::Map _map;
   };
 
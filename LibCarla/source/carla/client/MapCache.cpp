@@ -0,0 +1,82 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/MapCache.h"
+
+#include "carla/Debug.h"
+#include "carla/client/Map.h"
+
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+namespace carla {
+namespace client {
+
+  namespace {
+
+    struct Cache {
+      std::mutex mutex;
+      std::unordered_map<uint64_t, WeakPtr<Map>> maps;
+      uint64_t hits = 0u;
+      uint64_t misses = 0u;
+    };
+
+  } // namespace
+
+  static Cache &GetCache() {
+    static Cache cache;
+    return cache;
+  }
+
+  SharedPtr<Map> MapCache::Find(const uint64_t hash) {
+    auto &cache = GetCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.maps.find(hash);
+    if (it == cache.maps.end()) {
+      return nullptr;
+    }
+    auto map = it->second.lock();
+    if (map == nullptr) {
+      cache.maps.erase(it);
+      return nullptr;
+    }
+    ++cache.hits;
+    return map;
+  }
+
+  SharedPtr<Map> MapCache::Add(const uint64_t hash, SharedPtr<Map> map) {
+    DEBUG_ASSERT(map != nullptr);
+    auto &cache = GetCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    ++cache.misses;
+    // Drop the entries of the maps already destroyed.
+    for (auto it = cache.maps.begin(); it != cache.maps.end();) {
+      it = it->second.expired() ? cache.maps.erase(it) : std::next(it);
+    }
+    auto &entry = cache.maps[hash];
+    auto existing = entry.lock();
+    if (existing != nullptr) {
+      return existing;
+    }
+    entry = map;
+    return map;
+  }
+
+  MapCache::Stats MapCache::GetStats() {
+    auto &cache = GetCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    Stats stats;
+    stats.hits = cache.hits;
+    stats.misses = cache.misses;
+    for (auto &pair : cache.maps) {
+      stats.size += pair.second.expired() ? 0u : 1u;
+    }
+    return stats;
+  }
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,47 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+
+#include <cstdint>
+
+namespace carla {
+namespace client {
+
+  class Map;
+
+  /// Process-wide cache of the maps parsed from the simulator, keyed by
+  /// rpc::MapInfo::Hash. The cache only keeps weak references, a map is
+  /// destroyed as usual once nobody uses it.
+  class MapCache {
+  public:
+
+    struct Stats {
+      /// Number of maps returned from the cache.
+      uint64_t hits = 0u;
+
+      /// Number of maps that had to be parsed.
+      uint64_t misses = 0u;
+
+      /// Number of maps alive in the cache.
+      size_t size = 0u;
+    };
+
+    /// Return the map with @a hash if it is still alive, nullptr otherwise.
+    /// Counts a hit if found.
+    static SharedPtr<Map> Find(uint64_t hash);
+
+    /// Add a newly parsed @a map, counts a miss. If another thread added a
+    /// map with the same @a hash in the meantime, return that one instead.
+    static SharedPtr<Map> Add(uint64_t hash, SharedPtr<Map> map);
+
+    static Stats GetStats();
+  };
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,76 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/sensor/SensorData.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace carla {
+namespace client {
+
+  /// The data received from the sensors of a SensorGroup for a single frame,
+  /// in the same order as the sensors of the group. The data of the sensors
+  /// that did not deliver on time is null.
+  ///
+  /// The bundle shares the data objects, and these share the buffers they
+  /// were received in; nothing is copied.
+  class SensorBundle
+    : public EnableSharedFromThis<SensorBundle>,
+      private NonCopyable {
+  public:
+
+    using value_type = SharedPtr<sensor::SensorData>;
+
+    SensorBundle(size_t frame, std::vector<value_type> data)
+      : _frame(frame),
+        _data(std::move(data)) {}
+
+    /// Frame count when the data was generated.
+    size_t GetFrame() const {
+      return _frame;
+    }
+
+    /// Whether every sensor of the group delivered its data.
+    bool IsComplete() const {
+      return std::all_of(_data.begin(), _data.end(), [](const auto &data) {
+        return data != nullptr;
+      });
+    }
+
+    const value_type &operator[](size_t pos) const {
+      return _data[pos];
+    }
+
+    const value_type &at(size_t pos) const {
+      return _data.at(pos);
+    }
+
+    auto begin() const {
+      return _data.begin();
+    }
+
+    auto end() const {
+      return _data.end();
+    }
+
+    size_t size() const {
+      return _data.size();
+    }
+
+  private:
+
+    const size_t _frame;
+
+    const std::vector<value_type> _data;
+  };
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,88 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/SensorGroup.h"
+
+#include "carla/Exception.h"
+#include "carla/Logging.h"
+#include "carla/client/Sensor.h"
+#include "carla/client/detail/FrameSynchronizer.h"
+
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+namespace carla {
+namespace client {
+
+  SensorGroup::SensorGroup(
+      std::vector<SharedPtr<Sensor>> sensors,
+      time_duration timeout,
+      size_t ring_size)
+    : _sensors(std::move(sensors)),
+      _timeout(timeout),
+      _ring_size(ring_size) {
+    if (_sensors.empty() || (_sensors.size() > detail::FrameSynchronizer::MAX_MEMBERS)) {
+      throw_exception(std::invalid_argument(
+          "SensorGroup: the number of sensors must be between 1 and " +
+          std::to_string(detail::FrameSynchronizer::MAX_MEMBERS)));
+    }
+    for (auto &sensor : _sensors) {
+      if (sensor == nullptr) {
+        throw_exception(std::invalid_argument("SensorGroup: null sensor"));
+      }
+    }
+  }
+
+  SensorGroup::~SensorGroup() {
+    if (IsListening()) {
+      try {
+        Stop();
+      } catch (const std::exception &e) {
+        log_error("exception trying to stop sensor group:", e.what());
+      }
+    }
+  }
+
+  void SensorGroup::Listen(CallbackFunctionType callback) {
+    if (IsListening()) {
+      Stop();
+    }
+    _synchronizer = std::make_shared<detail::FrameSynchronizer>(
+        _sensors.size(),
+        _timeout,
+        _ring_size,
+        std::move(callback));
+    _is_listening = true;
+    for (auto i = 0u; i < _sensors.size(); ++i) {
+      // Each callback keeps the synchronizer alive, data may still be in
+      // flight after Stop.
+      _sensors[i]->Listen([synchronizer=_synchronizer, i](auto data) {
+        synchronizer->Push(i, std::move(data));
+      });
+    }
+  }
+
+  void SensorGroup::Stop() {
+    if (!_is_listening) {
+      log_warning("attempting to stop a sensor group that wasn't listening");
+      return;
+    }
+    for (auto &sensor : _sensors) {
+      if (sensor->IsListening()) {
+        sensor->Stop();
+      }
+    }
+    _is_listening = false;
+    _synchronizer->Flush();
+  }
+
+  size_t SensorGroup::GetDroppedCount() const {
+    return _synchronizer != nullptr ? _synchronizer->GetDroppedCount() : 0u;
+  }
+
+} // namespace client
+} // namespace carla
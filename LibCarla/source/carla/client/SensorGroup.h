@@ -0,0 +1,83 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+#include "carla/client/SensorBundle.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace carla {
+namespace client {
+
+  class Sensor;
+  namespace detail { class FrameSynchronizer; }
+
+  /// Listens to several sensors and delivers their data grouped by frame, one
+  /// SensorBundle per frame, so the data of every sensor for a given frame is
+  /// received at once.
+  class SensorGroup
+    : public EnableSharedFromThis<SensorGroup>,
+      private NonCopyable {
+  public:
+
+    using CallbackFunctionType = std::function<void(SharedPtr<SensorBundle>)>;
+
+    /// @param timeout time to wait for the missing data of a frame since
+    ///   the first data of that frame arrived, after that an incomplete
+    ///   bundle is delivered. Zero waits until the frame is pushed out by
+    ///   newer frames.
+    /// @param ring_size number of frames that can be pending at once.
+    explicit SensorGroup(
+        std::vector<SharedPtr<Sensor>> sensors,
+        time_duration timeout = time_duration::seconds(1u),
+        size_t ring_size = 8u);
+
+    ~SensorGroup();
+
+    const std::vector<SharedPtr<Sensor>> &GetSensors() const {
+      return _sensors;
+    }
+
+    /// Register a @a callback to be executed each time the data of a frame
+    /// is ready. This calls Sensor::Listen on every sensor of the group.
+    ///
+    /// The callback is executed in the thread that received the last data of
+    /// the frame.
+    void Listen(CallbackFunctionType callback);
+
+    /// Stop listening to every sensor, the frames still pending are
+    /// delivered incomplete.
+    void Stop();
+
+    bool IsListening() const {
+      return _is_listening;
+    }
+
+    /// Number of sensor measurements discarded because they arrived after
+    /// their frame was delivered.
+    size_t GetDroppedCount() const;
+
+  private:
+
+    const std::vector<SharedPtr<Sensor>> _sensors;
+
+    const time_duration _timeout;
+
+    const size_t _ring_size;
+
+    std::shared_ptr<detail::FrameSynchronizer> _synchronizer;
+
+    bool _is_listening = false;
+  };
+
+} // namespace client
+} // namespace carla
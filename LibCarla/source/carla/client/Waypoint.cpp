@@ -36,8 +36,8 @@ namespace client {
     return _parent->GetMap().GetLaneType(_waypoint);
   }
 
-  std::vector<SharedPtr<Waypoint>> Waypoint::GetNext(double distance) const {
-    auto waypoints = _parent->GetMap().GetNext(_waypoint, distance);
+  std::vector<SharedPtr<Waypoint>> Waypoint::MakeWaypoints(
+      std::vector<road::element::Waypoint> &&waypoints) const {
     std::vector<SharedPtr<Waypoint>> result;
     result.reserve(waypoints.size());
     for (auto &waypoint : waypoints) {
@@ -46,6 +46,18 @@ namespace client {
     return result;
   }
 
+  std::vector<SharedPtr<Waypoint>> Waypoint::GetNext(double distance) const {
+    return MakeWaypoints(_parent->GetMap().GetNext(_waypoint, distance));
+  }
+
+  std::vector<SharedPtr<Waypoint>> Waypoint::GetPrevious(double distance) const {
+    return MakeWaypoints(_parent->GetMap().GetPrevious(_waypoint, distance));
+  }
+
+  std::vector<SharedPtr<Waypoint>> Waypoint::GetNextUntilLaneEnd(double distance) const {
+    return MakeWaypoints(_parent->GetMap().GetNextUntilLaneEnd(_waypoint, distance));
+  }
+
   SharedPtr<Waypoint> Waypoint::GetRight() const {
     auto right_lane_waypoint =
         _parent->GetMap().GetRight(_waypoint);
@@ -67,6 +67,13 @@ namespace client {
 
     std::vector<SharedPtr<Waypoint>> GetNext(double distance) const;
 
+    /// Waypoints at @a distance from which a vehicle could drive to this one.
+    std::vector<SharedPtr<Waypoint>> GetPrevious(double distance) const;
+
+    /// Waypoints every @a distance to the end of the lane, the last one at
+    /// the end of the lane.
+    std::vector<SharedPtr<Waypoint>> GetNextUntilLaneEnd(double distance) const;
+
     SharedPtr<Waypoint> GetRight() const;
 
     SharedPtr<Waypoint> GetLeft() const;
@@ -81,8 +88,13 @@ namespace client {
 
     friend class Map;
 
+    friend class LaneRouter;
+
     Waypoint(SharedPtr<const Map> parent, road::element::Waypoint waypoint);
 
+    std::vector<SharedPtr<Waypoint>> MakeWaypoints(
+        std::vector<road::element::Waypoint> &&waypoints) const;
+
     SharedPtr<const Map> _parent;
 
     road::element::Waypoint _waypoint;
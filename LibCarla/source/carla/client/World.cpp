@@ -53,6 +53,22 @@ namespace client {
     return _episode.Lock()->GetWorldSnapshot();
   }
 
+  void World::SetSnapshotHistorySize(size_t size) {
+    _episode.Lock()->SetSnapshotHistorySize(size);
+  }
+
+  size_t World::GetSnapshotHistorySize() const {
+    return _episode.Lock()->GetSnapshotHistorySize();
+  }
+
+  boost::optional<WorldSnapshot> World::GetSnapshotByFrame(size_t frame) const {
+    return _episode.Lock()->GetWorldSnapshotByFrame(frame);
+  }
+
+  boost::optional<ActorSnapshot> World::GetActorSnapshotAt(ActorId id, double elapsed_seconds) const {
+    return _episode.Lock()->GetActorSnapshotAt(id, elapsed_seconds);
+  }
+
   SharedPtr<Actor> World::GetActor(ActorId id) const {
     auto simulator = _episode.Lock();
     auto description = simulator->GetActorById(id);
@@ -62,9 +78,10 @@ namespace client {
   }
 
   SharedPtr<ActorList> World::GetActors() const {
-    return SharedPtr<ActorList>{new ActorList{
-                                  _episode,
-                                  _episode.Lock()->GetAllTheActorsInTheEpisode()}};
+    auto simulator = _episode.Lock();
+    auto state = simulator->GetEpisodeState();
+    auto actors = simulator->GetAllTheActorsInTheEpisode(*state);
+    return SharedPtr<ActorList>{new ActorList{_episode, std::move(state), actors}};
   }
 
   SharedPtr<ActorList> World::GetActors(const std::vector<ActorId> &actor_ids) const {
@@ -97,14 +114,20 @@ namespace client {
     return _episode.Lock()->WaitForTick(timeout);
   }
 
-  size_t World::OnTick(std::function<void(WorldSnapshot)> callback) {
-    return _episode.Lock()->RegisterOnTickEvent(std::move(callback));
+  size_t World::OnTick(
+      std::function<void(WorldSnapshot)> callback,
+      CallbackPolicy policy) {
+    return _episode.Lock()->RegisterOnTickEvent(std::move(callback), policy);
   }
 
   void World::RemoveOnTick(size_t callback_id) {
     _episode.Lock()->RemoveOnTickEvent(callback_id);
   }
 
+  boost::optional<CallbackStats> World::GetOnTickStats(size_t callback_id) const {
+    return _episode.Lock()->GetOnTickEventStats(callback_id);
+  }
+
   uint64_t World::Tick() {
     return _episode.Lock()->Tick();
   }
@@ -8,6 +8,7 @@
 
 #include "carla/Memory.h"
 #include "carla/Time.h"
+#include "carla/client/CallbackPolicy.h"
 #include "carla/client/DebugHelper.h"
 #include "carla/client/Timestamp.h"
 #include "carla/client/WorldSnapshot.h"
@@ -74,6 +75,20 @@ namespace client {
     /// Return a snapshot of the world at this moment.
     WorldSnapshot GetSnapshot() const;
 
+    /// Set the number of past snapshots kept by the client, zero (default)
+    /// disables the history. Memory grows linearly with @a size.
+    void SetSnapshotHistorySize(size_t size);
+
+    size_t GetSnapshotHistorySize() const;
+
+    /// Return the snapshot of @a frame if it is still in the history.
+    boost::optional<WorldSnapshot> GetSnapshotByFrame(size_t frame) const;
+
+    /// Return the snapshot of actor @a id at simulation time
+    /// @a elapsed_seconds, interpolated between the two enclosing snapshots of
+    /// the history.
+    boost::optional<ActorSnapshot> GetActorSnapshotAt(ActorId id, double elapsed_seconds) const;
+
     /// Find actor by id, return nullptr if not found.
     SharedPtr<Actor> GetActor(ActorId id) const;
 
@@ -104,13 +119,21 @@ namespace client {
     WorldSnapshot WaitForTick(time_duration timeout) const;
 
     /// Register a @a callback to be called every time a world tick is received.
+    /// By default the callback runs in the streaming thread, use @a policy to
+    /// run it in a dedicated thread or in a shared thread pool instead.
     ///
     /// @return ID of the callback, use it to remove the callback.
-    size_t OnTick(std::function<void(WorldSnapshot)> callback);
+    size_t OnTick(
+        std::function<void(WorldSnapshot)> callback,
+        CallbackPolicy policy = CallbackPolicy{});
 
     /// Remove a callback registered with OnTick.
     void RemoveOnTick(size_t callback_id);
 
+    /// Return the execution statistics of a callback registered with OnTick,
+    /// or an empty optional if no callback has such id.
+    boost::optional<CallbackStats> GetOnTickStats(size_t callback_id) const;
+
     /// Signal the simulator to continue to next tick (only has effect on
     /// synchronous mode).
     ///
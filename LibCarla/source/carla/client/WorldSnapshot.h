@@ -9,9 +9,13 @@
 #include "carla/client/Timestamp.h"
 #include "carla/client/ActorSnapshot.h"
 #include "carla/client/detail/EpisodeState.h"
+#include "carla/geom/BoundingBox.h"
+#include "carla/geom/Location.h"
 
 #include <boost/optional.hpp>
 
+#include <vector>
+
 namespace carla {
 namespace client {
 
@@ -45,6 +49,27 @@ namespace client {
       return _state->GetActorSnapshotIfPresent(actor_id);
     }
 
+    /// Return the ActorSnapshots of the actors located within @a radius meters
+    /// of @a center.
+    ///
+    /// The first spatial query on a snapshot builds a spatial index, shared by
+    /// all the copies of this snapshot.
+    std::vector<ActorSnapshot> FindActorsInRadius(const geom::Location &center, float radius) const {
+      return _state->GetActorSnapshots(_state->GetSpatialIndex().FindInRadius(center, radius));
+    }
+
+    /// Return the ActorSnapshots of the actors located inside the axis-aligned
+    /// @a box.
+    std::vector<ActorSnapshot> FindActorsInBox(const geom::BoundingBox &box) const {
+      return _state->GetActorSnapshots(_state->GetSpatialIndex().FindInBox(box));
+    }
+
+    /// Return the ActorSnapshots of the @a k actors closest to @a point,
+    /// sorted by distance.
+    std::vector<ActorSnapshot> FindKNearestActors(const geom::Location &point, size_t k) const {
+      return _state->GetActorSnapshots(_state->GetSpatialIndex().FindKNearest(point, k));
+    }
+
     /// Return number of ActorSnapshots present in this WorldSnapshot.
     size_t size() const {
       return _state->size();
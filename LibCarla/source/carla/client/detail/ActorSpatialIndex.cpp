@@ -0,0 +1,239 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/detail/ActorSpatialIndex.h"
+
+#include "carla/geom/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  using geom::Math;
+
+  /// Average number of actors per cell the grid is sized for.
+  static constexpr size_t ACTORS_PER_CELL = 2u;
+
+  /// Cells smaller than this are not worth the bookkeeping.
+  static constexpr float MIN_CELL_SIZE = 0.5f;
+
+  /// Index of the cell at @a offset from the origin of a grid of @a cells
+  /// cells, clamped to [0, @a cells - 1]. The quotient is clamped before the
+  /// conversion as it may not fit in an int; NaN goes to the first cell.
+  static int ToCell(float offset, float cell_size, int cells) {
+    const float cell = std::floor(offset / cell_size);
+    if (!(cell > 0.0f)) {
+      return 0;
+    }
+    return cell < static_cast<float>(cells - 1) ? static_cast<int>(cell) : cells - 1;
+  }
+
+  static bool IsNaN(const geom::Location &location) {
+    return std::isnan(location.x) || std::isnan(location.y);
+  }
+
+  ActorSpatialIndex::ActorSpatialIndex(std::vector<Item> items) {
+    if (items.empty()) {
+      _cell_offsets = {0u, 0u};
+      return;
+    }
+
+    float max_x = std::numeric_limits<float>::lowest();
+    float max_y = std::numeric_limits<float>::lowest();
+    _min_x = std::numeric_limits<float>::max();
+    _min_y = std::numeric_limits<float>::max();
+    for (auto &item : items) {
+      _min_x = std::min(_min_x, item.location.x);
+      _min_y = std::min(_min_y, item.location.y);
+      max_x = std::max(max_x, item.location.x);
+      max_y = std::max(max_y, item.location.y);
+    }
+    const float width = max_x - _min_x;
+    const float height = max_y - _min_y;
+    const auto target_cells = static_cast<float>(std::max<size_t>(1u, items.size() / ACTORS_PER_CELL));
+    // The second term keeps the number of cells bounded when all the actors
+    // are aligned along one axis.
+    _cell_size = std::max({
+        std::sqrt(width * height / target_cells),
+        std::max(width, height) / target_cells,
+        MIN_CELL_SIZE});
+    // At most target_cells + 1 per axis, unless the extent is not finite.
+    const auto max_cells = static_cast<int>(target_cells) + 1;
+    _columns = ToCell(width, _cell_size, max_cells) + 1;
+    _rows = ToCell(height, _cell_size, max_cells) + 1;
+
+    // Counting sort of the items by cell.
+    const auto number_of_cells = static_cast<size_t>(_columns) * static_cast<size_t>(_rows);
+    std::vector<size_t> cell_of_item;
+    cell_of_item.reserve(items.size());
+    _cell_offsets.assign(number_of_cells + 1u, 0u);
+    for (auto &item : items) {
+      const auto cell = CellIndex(CellX(item.location.x), CellY(item.location.y));
+      cell_of_item.emplace_back(cell);
+      ++_cell_offsets[cell + 1u];
+    }
+    for (size_t i = 1u; i < _cell_offsets.size(); ++i) {
+      _cell_offsets[i] += _cell_offsets[i - 1u];
+    }
+    std::vector<size_t> next(_cell_offsets.begin(), _cell_offsets.end() - 1);
+    _items.resize(items.size());
+    for (size_t i = 0u; i < items.size(); ++i) {
+      _items[next[cell_of_item[i]]++] = items[i];
+    }
+  }
+
+  int ActorSpatialIndex::CellX(float x) const {
+    return ToCell(x - _min_x, _cell_size, _columns);
+  }
+
+  int ActorSpatialIndex::CellY(float y) const {
+    return ToCell(y - _min_y, _cell_size, _rows);
+  }
+
+  ActorSpatialIndex::CellRange ActorSpatialIndex::GetCellRange(
+      float min_x,
+      float min_y,
+      float max_x,
+      float max_y) const {
+    return {CellX(min_x), CellY(min_y), CellX(max_x), CellY(max_y)};
+  }
+
+  std::vector<ActorId> ActorSpatialIndex::FindInRadius(
+      const geom::Location &center,
+      const float radius) const {
+    std::vector<ActorId> result;
+    // Also empty if the radius is NaN.
+    if (_items.empty() || !(radius >= 0.0f) || IsNaN(center)) {
+      return result;
+    }
+    const float radius_squared = radius * radius;
+    // If it overflows every actor is in range, even around an infinite center.
+    const auto range = std::isinf(radius_squared) ?
+        CellRange{0, 0, _columns - 1, _rows - 1} :
+        GetCellRange(
+            center.x - radius,
+            center.y - radius,
+            center.x + radius,
+            center.y + radius);
+    ForEachItemIn(range, [&](const Item &item) {
+      if (Math::DistanceSquared(item.location, center) <= radius_squared) {
+        result.emplace_back(item.id);
+      }
+    });
+    return result;
+  }
+
+  std::vector<ActorId> ActorSpatialIndex::FindInBox(const geom::BoundingBox &box) const {
+    std::vector<ActorId> result;
+    if (_items.empty()) {
+      return result;
+    }
+    const geom::Location min = box.location - geom::Location(box.extent);
+    const geom::Location max = box.location + geom::Location(box.extent);
+    if (IsNaN(min) || IsNaN(max)) {
+      return result;
+    }
+    const auto range = GetCellRange(min.x, min.y, max.x, max.y);
+    ForEachItemIn(range, [&](const Item &item) {
+      const auto &l = item.location;
+      if ((l.x >= min.x) && (l.x <= max.x) &&
+          (l.y >= min.y) && (l.y <= max.y) &&
+          (l.z >= min.z) && (l.z <= max.z)) {
+        result.emplace_back(item.id);
+      }
+    });
+    return result;
+  }
+
+  std::vector<ActorId> ActorSpatialIndex::FindKNearest(
+      const geom::Location &point,
+      const size_t k) const {
+    using Candidate = std::pair<float, size_t>; // distance squared, index.
+    std::priority_queue<Candidate> heap; // max-heap, top is the k-th nearest.
+    const size_t count = IsNaN(point) ? 0u : std::min(k, _items.size());
+
+    auto visit_cell = [&](int x, int y) {
+      if ((x < 0) || (x >= _columns) || (y < 0) || (y >= _rows)) {
+        return;
+      }
+      const auto cell = CellIndex(x, y);
+      for (auto i = _cell_offsets[cell]; i < _cell_offsets[cell + 1u]; ++i) {
+        const float distance = Math::DistanceSquared(_items[i].location, point);
+        if (heap.size() < count) {
+          heap.emplace(distance, i);
+        } else if (distance < heap.top().first) {
+          heap.pop();
+          heap.emplace(distance, i);
+        }
+      }
+    };
+
+    if (count > 0u) {
+      const int cx = CellX(point.x);
+      const int cy = CellY(point.y);
+      constexpr float infinity = std::numeric_limits<float>::max();
+      for (int r = 0; ; ++r) {
+        // Visit the cells at Chebyshev distance r of (cx, cy).
+        if (r == 0) {
+          visit_cell(cx, cy);
+        } else {
+          for (int x = cx - r; x <= cx + r; ++x) {
+            visit_cell(x, cy - r);
+            visit_cell(x, cy + r);
+          }
+          for (int y = cy - r + 1; y < cy + r; ++y) {
+            visit_cell(cx - r, y);
+            visit_cell(cx + r, y);
+          }
+        }
+        // Lower bound of the distance to any cell not visited yet, only
+        // considering the sides of the grid with cells left.
+        const bool left = (cx - r > 0);
+        const bool right = (cx + r < _columns - 1);
+        const bool bottom = (cy - r > 0);
+        const bool top = (cy + r < _rows - 1);
+        if (!left && !right && !bottom && !top) {
+          break;
+        }
+        if (heap.size() == count) {
+          float bound = infinity;
+          if (left) {
+            bound = std::min(bound, point.x - (_min_x + static_cast<float>(cx - r) * _cell_size));
+          }
+          if (right) {
+            bound = std::min(bound, (_min_x + static_cast<float>(cx + r + 1) * _cell_size) - point.x);
+          }
+          if (bottom) {
+            bound = std::min(bound, point.y - (_min_y + static_cast<float>(cy - r) * _cell_size));
+          }
+          if (top) {
+            bound = std::min(bound, (_min_y + static_cast<float>(cy + r + 1) * _cell_size) - point.y);
+          }
+          bound = std::max(bound, 0.0f);
+          if (bound * bound > heap.top().first) {
+            break;
+          }
+        }
+      }
+    }
+
+    std::vector<ActorId> result(heap.size());
+    for (auto it = result.rbegin(); it != result.rend(); ++it) {
+      *it = _items[heap.top().second].id;
+      heap.pop();
+    }
+    return result;
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
@@ -0,0 +1,94 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/geom/BoundingBox.h"
+#include "carla/geom/Location.h"
+#include "carla/rpc/ActorId.h"
+
+#include <vector>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Immutable uniform grid over the XY plane of the actor locations of a
+  /// frame. Cells hold a contiguous range of actors, so queries only visit
+  /// the actors in the cells overlapping the query region.
+  class ActorSpatialIndex : private NonCopyable {
+  public:
+
+    struct Item {
+      ActorId id;
+      geom::Location location;
+    };
+
+    explicit ActorSpatialIndex(std::vector<Item> items);
+
+    size_t size() const {
+      return _items.size();
+    }
+
+    /// Return the actors whose location is within @a radius meters of
+    /// @a center.
+    std::vector<ActorId> FindInRadius(const geom::Location &center, float radius) const;
+
+    /// Return the actors whose location is inside the axis-aligned @a box.
+    std::vector<ActorId> FindInBox(const geom::BoundingBox &box) const;
+
+    /// Return the @a k actors closest to @a point, sorted by distance.
+    std::vector<ActorId> FindKNearest(const geom::Location &point, size_t k) const;
+
+  private:
+
+    struct CellRange {
+      int min_x, min_y, max_x, max_y;
+    };
+
+    int CellX(float x) const;
+
+    int CellY(float y) const;
+
+    size_t CellIndex(int x, int y) const {
+      return static_cast<size_t>(y) * static_cast<size_t>(_columns) + static_cast<size_t>(x);
+    }
+
+    CellRange GetCellRange(float min_x, float min_y, float max_x, float max_y) const;
+
+    template <typename FunctorT>
+    void ForEachItemIn(const CellRange &range, FunctorT &&functor) const {
+      for (int y = range.min_y; y <= range.max_y; ++y) {
+        const auto row = CellIndex(range.min_x, y);
+        const auto begin = _cell_offsets[row];
+        const auto end = _cell_offsets[row + static_cast<size_t>(range.max_x - range.min_x) + 1u];
+        for (auto i = begin; i < end; ++i) {
+          functor(_items[i]);
+        }
+      }
+    }
+
+    float _min_x = 0.0f;
+
+    float _min_y = 0.0f;
+
+    float _cell_size = 1.0f;
+
+    int _columns = 1;
+
+    int _rows = 1;
+
+    /// Items sorted by cell.
+    std::vector<Item> _items;
+
+    /// Offset in _items of the first item of each cell, plus a sentinel.
+    std::vector<size_t> _cell_offsets;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
@@ -14,9 +14,15 @@ namespace client {
 namespace detail {
 
   void ActorVariant::MakeActor(EpisodeProxy episode) const {
+    rpc::Actor description;
+    if (_value.which() == 0u) {
+      description = boost::get<rpc::Actor>(std::move(_value));
+    } else {
+      description = *boost::get<std::shared_ptr<const rpc::Actor>>(_value);
+    }
     _value = detail::ActorFactory::MakeActor(
         episode,
-        boost::get<rpc::Actor>(std::move(_value)),
+        std::move(description),
         GarbageCollectionPolicy::Disabled);
   }
 
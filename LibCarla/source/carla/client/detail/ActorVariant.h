@@ -14,6 +14,8 @@
 
 #include <boost/variant.hpp>
 
+#include <memory>
+
 namespace carla {
 namespace client {
 namespace detail {
@@ -25,9 +27,20 @@ namespace detail {
     ActorVariant(rpc::Actor actor)
       : _value(actor) {}
 
+    /// Holds a shared, immutable, actor description; it is only copied when
+    /// the actor is instantiated.
+    ActorVariant(std::shared_ptr<const rpc::Actor> actor)
+      : _value(std::move(actor)) {
+      DEBUG_ASSERT(boost::get<std::shared_ptr<const rpc::Actor>>(_value) != nullptr);
+    }
+
     ActorVariant(SharedPtr<client::Actor> actor)
       : _value(actor) {}
 
+    /// Null actor, disambiguates between the pointer alternatives.
+    ActorVariant(std::nullptr_t)
+      : _value(SharedPtr<client::Actor>{}) {}
+
     ActorVariant &operator=(rpc::Actor actor) {
       _value = actor;
       return *this;
@@ -39,7 +52,7 @@ namespace detail {
     }
 
     SharedPtr<client::Actor> Get(EpisodeProxy episode) const {
-      if (_value.which() == 0u) {
+      if (_value.which() != 1u) {
         MakeActor(episode);
       }
       DEBUG_ASSERT(_value.which() == 1u);
@@ -79,11 +92,17 @@ namespace detail {
       const rpc::Actor &operator()(const SharedPtr<const client::Actor> &actor) const {
         return actor->Serialize();
       }
+      const rpc::Actor &operator()(const std::shared_ptr<const rpc::Actor> &actor) const {
+        return *actor;
+      }
     };
 
     void MakeActor(EpisodeProxy episode) const;
 
-    mutable boost::variant<rpc::Actor, SharedPtr<client::Actor>> _value;
+    mutable boost::variant<
+        rpc::Actor,
+        SharedPtr<client::Actor>,
+        std::shared_ptr<const rpc::Actor>> _value;
   };
 
 } // namespace detail
@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <memory>
 #include <mutex>
 
 namespace carla {
@@ -26,10 +27,15 @@ namespace detail {
   /// Keeps a list of actor descriptions to avoid requesting each time the
   /// descriptions to the server.
   ///
+  /// Descriptions are immutable once inserted, so they can be shared without
+  /// copying them.
+  ///
   /// @todo Dead actors are never removed from the list.
   class CachedActorList : private MovableNonCopyable {
   public:
 
+    using ActorPtr = std::shared_ptr<const rpc::Actor>;
+
     /// Inserts an actor into the list.
     void Insert(rpc::Actor actor);
 
@@ -50,13 +56,18 @@ namespace detail {
     template <typename RangeT>
     std::vector<rpc::Actor> GetActorsById(const RangeT &range) const;
 
+    /// Retrieve the actors matching the ids in @a range, sharing the cached
+    /// descriptions instead of copying them.
+    template <typename RangeT>
+    std::vector<ActorPtr> GetSharedActorsById(const RangeT &range) const;
+
     void Clear();
 
   private:
 
     mutable std::mutex _mutex;
 
-    std::unordered_map<ActorId, rpc::Actor> _actors;
+    std::unordered_map<ActorId, ActorPtr> _actors;
   };
 
   // ===========================================================================
@@ -66,14 +77,14 @@ namespace detail {
   inline void CachedActorList::Insert(rpc::Actor actor) {
     std::lock_guard<std::mutex> lock(_mutex);
     auto id = actor.id;
-    _actors.emplace(id, std::move(actor));
+    _actors.emplace(id, std::make_shared<const rpc::Actor>(std::move(actor)));
   }
 
   template <typename RangeT>
   inline void CachedActorList::InsertRange(RangeT range) {
     auto make_a_pair = [](rpc::Actor actor) {
       auto id = actor.id;
-      return std::make_pair(id, std::move(actor));
+      return std::make_pair(id, std::make_shared<const rpc::Actor>(std::move(actor)));
     };
     auto make_iterator = [&make_a_pair](auto it) {
       return boost::make_transform_iterator(std::make_move_iterator(it), make_a_pair);
@@ -97,7 +108,7 @@ namespace detail {
     std::lock_guard<std::mutex> lock(_mutex);
     auto it = _actors.find(id);
     if (it != _actors.end()) {
-      return it->second;
+      return *it->second;
     }
     return boost::none;
   }
@@ -107,6 +118,20 @@ namespace detail {
     std::vector<rpc::Actor> result;
     result.reserve(range.size());
     std::lock_guard<std::mutex> lock(_mutex);
+    for (auto &&id : range) {
+      auto it = _actors.find(id);
+      if (it != _actors.end()) {
+        result.emplace_back(*it->second);
+      }
+    }
+    return result;
+  }
+
+  template <typename RangeT>
+  inline std::vector<CachedActorList::ActorPtr> CachedActorList::GetSharedActorsById(const RangeT &range) const {
+    std::vector<ActorPtr> result;
+    result.reserve(range.size());
+    std::lock_guard<std::mutex> lock(_mutex);
     for (auto &&id : range) {
       auto it = _actors.find(id);
       if (it != _actors.end()) {
@@ -0,0 +1,285 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+#include "carla/client/CallbackPolicy.h"
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Wraps a callback and delivers the events to it according to a
+  /// CallbackPolicy: inline, in a dedicated thread, or in a shared ThreadPool.
+  /// Non-inline callbacks receive the events in order through a bounded queue.
+  ///
+  /// The threads belong to the owner: a dedicated thread has to run the
+  /// function returned by MakeRunLoop.
+  template <typename... InputsT>
+  class CallbackDispatcher : private NonCopyable {
+  public:
+
+    using CallbackType = std::function<void(InputsT...)>;
+
+    /// @a pool is only used by callbacks with CallbackExecutor::SharedPool,
+    /// events are dropped if the pool has been destroyed.
+    CallbackDispatcher(
+        CallbackType callback,
+        CallbackPolicy policy,
+        std::weak_ptr<ThreadPool> pool = {})
+      : _state(std::make_shared<State>(std::move(callback), policy)),
+        _pool(std::move(pool)) {}
+
+    /// Pending events are discarded, an event already being delivered in
+    /// another thread completes after the dispatcher is gone.
+    ~CallbackDispatcher() {
+      Stop();
+    }
+
+    /// Consumer loop of a callback with CallbackExecutor::DedicatedThread, it
+    /// returns once the dispatcher is stopped.
+    std::function<void()> MakeRunLoop() const {
+      auto state = _state;
+      return [state]() { state->RunLoop(); };
+    }
+
+    /// Discard the pending events and ignore any further one. An event already
+    /// being delivered in another thread completes.
+    void Stop() {
+      _state->Stop();
+    }
+
+    void Dispatch(InputsT... args) {
+      switch (_state->policy.executor) {
+        case CallbackExecutor::Inline:
+          _state->Invoke(MakeEvent(std::move(args)...), false);
+          break;
+        case CallbackExecutor::DedicatedThread:
+          _state->Push(MakeEvent(std::move(args)...));
+          break;
+        case CallbackExecutor::SharedPool:
+          DispatchToPool(MakeEvent(std::move(args)...));
+          break;
+      }
+    }
+
+    CallbackStats GetStats() const {
+      return _state->GetStats();
+    }
+
+  private:
+
+    using clock = std::chrono::steady_clock;
+
+    struct Event {
+      std::tuple<InputsT...> args;
+      clock::time_point enqueued;
+    };
+
+    static Event MakeEvent(InputsT... args) {
+      return Event{std::tuple<InputsT...>{std::move(args)...}, clock::now()};
+    }
+
+    /// State shared with the worker threads, it may outlive the dispatcher.
+    struct State {
+
+      State(CallbackType cb, CallbackPolicy p)
+        : callback(std::move(cb)),
+          policy(p) {
+        policy.queue_size = std::max<size_t>(policy.queue_size, 1u);
+      }
+
+      /// Push an event to the queue applying the overflow policy. Return
+      /// whether a pool task needs to be scheduled to consume it.
+      bool Push(Event &&event) {
+        bool schedule = false;
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (stop) {
+            return false;
+          }
+          if (queue.size() >= policy.queue_size) {
+            ++dropped;
+            if (policy.overflow == CallbackOverflowPolicy::DropNewest) {
+              return false;
+            }
+            queue.pop_front();
+          }
+          queue.emplace_back(std::move(event));
+          schedule = !scheduled;
+          scheduled = true;
+        }
+        condition.notify_one();
+        return schedule;
+      }
+
+      void CountDropped() {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++dropped;
+      }
+
+      void Stop() {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stop = true;
+          queue.clear();
+        }
+        condition.notify_all();
+      }
+
+      /// Consumer loop of the dedicated thread.
+      void RunLoop() {
+        for (;;) {
+          boost::optional<Event> event;
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stop || !queue.empty(); });
+            if (stop) {
+              return;
+            }
+            event = Pop();
+          }
+          Invoke(std::move(*event), true);
+        }
+      }
+
+      /// Consume pending events in a pool thread until the queue is empty.
+      void Drain() {
+        for (;;) {
+          boost::optional<Event> event;
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stop || queue.empty()) {
+              scheduled = false;
+              return;
+            }
+            event = Pop();
+          }
+          Invoke(std::move(*event), true);
+        }
+      }
+
+      /// @pre mutex is locked and the queue is not empty.
+      Event Pop() {
+        DEBUG_ASSERT(!queue.empty());
+        Event event = std::move(queue.front());
+        queue.pop_front();
+        return event;
+      }
+
+      void Invoke(Event &&event, bool catch_exceptions) {
+        const auto start = clock::now();
+        if (catch_exceptions) {
+          try {
+            Call(event.args, std::index_sequence_for<InputsT...>());
+          } catch (const std::exception &e) {
+            log_error("exception thrown in callback:", e.what());
+          }
+        } else {
+          Call(event.args, std::index_sequence_for<InputsT...>());
+        }
+        const auto end = clock::now();
+        std::lock_guard<std::mutex> lock(mutex);
+        Annotate(start - event.enqueued, end - start);
+      }
+
+      template <size_t... Is>
+      void Call(std::tuple<InputsT...> &args, std::index_sequence<Is...>) {
+        callback(std::get<Is>(std::move(args))...);
+      }
+
+      /// @pre mutex is locked.
+      void Annotate(clock::duration lag, clock::duration latency) {
+        using us = std::chrono::microseconds;
+        const auto lag_us = static_cast<uint64_t>(std::chrono::duration_cast<us>(lag).count());
+        const auto latency_us = static_cast<uint64_t>(std::chrono::duration_cast<us>(latency).count());
+        ++calls;
+        total_lag += lag_us;
+        total_latency += latency_us;
+        max_lag = std::max(max_lag, lag_us);
+        max_latency = std::max(max_latency, latency_us);
+      }
+
+      CallbackStats GetStats() const {
+        constexpr float to_ms = 1e-3f;
+        std::lock_guard<std::mutex> lock(mutex);
+        CallbackStats stats;
+        stats.calls = calls;
+        stats.dropped = dropped;
+        stats.pending = queue.size();
+        if (calls > 0u) {
+          stats.average_latency = to_ms * static_cast<float>(total_latency) / static_cast<float>(calls);
+          stats.average_lag = to_ms * static_cast<float>(total_lag) / static_cast<float>(calls);
+        }
+        stats.max_latency = to_ms * static_cast<float>(max_latency);
+        stats.max_lag = to_ms * static_cast<float>(max_lag);
+        return stats;
+      }
+
+      const CallbackType callback;
+
+      CallbackPolicy policy;
+
+      mutable std::mutex mutex;
+
+      std::condition_variable condition;
+
+      std::deque<Event> queue;
+
+      bool stop = false;
+
+      bool scheduled = false;
+
+      uint64_t calls = 0u;
+
+      uint64_t dropped = 0u;
+
+      uint64_t total_latency = 0u;
+
+      uint64_t total_lag = 0u;
+
+      uint64_t max_latency = 0u;
+
+      uint64_t max_lag = 0u;
+    };
+
+    void DispatchToPool(Event &&event) {
+      auto pool = _pool.lock();
+      if (pool == nullptr) {
+        _state->CountDropped();
+        return;
+      }
+      if (_state->Push(std::move(event))) {
+        auto state = _state;
+        pool->Post([state]() { state->Drain(); });
+      }
+    }
+
+    const std::shared_ptr<State> _state;
+
+    const std::weak_ptr<ThreadPool> _pool;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
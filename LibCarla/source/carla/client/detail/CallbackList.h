@@ -8,34 +8,83 @@
 
 #include "carla/AtomicList.h"
 #include "carla/NonCopyable.h"
+#include "carla/PythonUtil.h"
+#include "carla/ThreadPool.h"
+#include "carla/client/CallbackPolicy.h"
+#include "carla/client/detail/CallbackDispatcher.h"
 
+#include <boost/optional.hpp>
+
+#include <algorithm>
 #include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace carla {
 namespace client {
 namespace detail {
 
+  /// List of callbacks, each one executed according to the CallbackPolicy it
+  /// was registered with. Callbacks registered with
+  /// CallbackExecutor::SharedPool share a thread pool owned by this list.
+  ///
+  /// The list owns every thread it launches, they are joined by Stop, at the
+  /// latest when the list is destroyed.
   template <typename... InputsT>
   class CallbackList : private NonCopyable {
   public:
 
     using CallbackType = std::function<void(InputsT...)>;
 
+    CallbackList() = default;
+
+    ~CallbackList() {
+      Stop();
+    }
+
     void Call(InputsT... args) const {
       auto list = _list.Load();
       for (auto &item : *list) {
-        item.callback(args...);
+        item.dispatcher->Dispatch(args...);
       }
     }
 
-    size_t Push(CallbackType &&callback) {
+    /// The callback is ignored if the list has been stopped.
+    size_t Push(CallbackType &&callback, CallbackPolicy policy = CallbackPolicy{}) {
       auto id = ++_counter;
       DEBUG_ASSERT(id != 0u);
-      _list.Push(Item{id, std::move(callback)});
+      std::lock_guard<std::mutex> lock(_executors_mutex);
+      if (_stopped) {
+        return id;
+      }
+      JoinFinishedThreads();
+      std::weak_ptr<ThreadPool> pool;
+      if (policy.executor == CallbackExecutor::SharedPool) {
+        pool = GetOrCreatePool();
+      }
+      auto dispatcher = std::make_shared<DispatcherType>(std::move(callback), policy, pool);
+      if (policy.executor == CallbackExecutor::DedicatedThread) {
+        LaunchThread(dispatcher->MakeRunLoop(), true);
+      }
+      _list.Push(Item{id, std::move(dispatcher)});
       return id;
     }
 
+    boost::optional<CallbackStats> GetStats(size_t id) const {
+      auto list = _list.Load();
+      for (auto &item : *list) {
+        if (item.id == id) {
+          return item.dispatcher->GetStats();
+        }
+      }
+      return boost::none;
+    }
+
+    /// Does not wait for a call in progress in another thread, it may
+    /// complete after returning.
     void Remove(size_t id) {
       _list.DeleteByValue(id);
     }
@@ -44,11 +93,105 @@ namespace detail {
       _list.Clear();
     }
 
+    /// Remove every callback, discarding their pending events, and join the
+    /// threads of the list. Calls in progress complete first, so the GIL is
+    /// released meanwhile if this thread holds it.
+    void Stop() {
+      std::vector<Thread> threads;
+      std::shared_ptr<ThreadPool> pool;
+      {
+        std::lock_guard<std::mutex> lock(_executors_mutex);
+        _stopped = true;
+        // Close the queues first so the threads have nothing left to drain.
+        auto list = _list.Load();
+        for (auto &item : *list) {
+          item.dispatcher->Stop();
+        }
+        _list.Clear();
+        threads = std::move(_threads);
+        _threads.clear();
+        pool = std::move(_pool);
+      }
+      if (pool != nullptr) {
+        pool->Stop();
+      }
+      std::unique_ptr<PythonUtil::ReleaseGIL> unlock;
+      if (!threads.empty() && PythonUtil::ThisThreadHasTheGIL()) {
+        unlock = std::make_unique<PythonUtil::ReleaseGIL>();
+      }
+      for (auto &thread : threads) {
+        if (thread.thread.get_id() == std::this_thread::get_id()) {
+          // Stopped from one of its own callbacks, e.g. dropping the last
+          // reference to the episode. This thread cannot join itself; it
+          // owns everything it still uses and exits when the callback
+          // returns.
+          thread.thread.detach();
+        } else {
+          thread.thread.join();
+        }
+      }
+    }
+
   private:
 
+    using DispatcherType = CallbackDispatcher<InputsT...>;
+
+    struct Thread {
+      std::thread thread;
+
+      /// Set when a dedicated thread is about to exit, null for the threads
+      /// of the pool.
+      std::shared_ptr<std::atomic_bool> finished;
+    };
+
+    /// @pre _executors_mutex is locked.
+    void LaunchThread(std::function<void()> run, bool dedicated) {
+      Thread thread;
+      if (dedicated) {
+        thread.finished = std::make_shared<std::atomic_bool>(false);
+      }
+      auto finished = thread.finished;
+      thread.thread = std::thread([run, finished]() {
+        run();
+        if (finished != nullptr) {
+          *finished = true;
+        }
+      });
+      _threads.emplace_back(std::move(thread));
+    }
+
+    /// Join the dedicated threads of the callbacks already removed.
+    ///
+    /// @pre _executors_mutex is locked.
+    void JoinFinishedThreads() {
+      for (auto it = _threads.begin(); it != _threads.end();) {
+        if ((it->finished != nullptr) && *it->finished) {
+          it->thread.join();
+          it = _threads.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    /// @pre _executors_mutex is locked.
+    std::shared_ptr<ThreadPool> GetOrCreatePool() {
+      if (_pool == nullptr) {
+        _pool = std::make_shared<ThreadPool>();
+        // The workers keep the pool alive, they may outlive this list if it
+        // is stopped from one of them.
+        auto pool = _pool;
+        const auto worker_threads = std::max(1u, std::thread::hardware_concurrency());
+        for (auto i = 0u; i < worker_threads; ++i) {
+          LaunchThread([pool]() { pool->Run(); }, false);
+        }
+      }
+      return _pool;
+    }
+
     struct Item {
       size_t id;
-      CallbackType callback;
+      std::shared_ptr<DispatcherType> dispatcher;
 
       friend bool operator==(const Item &lhs, const Item &rhs) {
         return lhs.id == rhs.id;
@@ -66,6 +209,14 @@ namespace detail {
     std::atomic_size_t _counter{0u};
 
     AtomicList<Item> _list;
+
+    std::mutex _executors_mutex;
+
+    bool _stopped = false;
+
+    std::vector<Thread> _threads;
+
+    std::shared_ptr<ThreadPool> _pool;
   };
 
 } // namespace detail
@@ -136,6 +136,10 @@ namespace detail {
     return _pimpl->CallAndWait<rpc::MapInfo>("get_map_info");
   }
 
+  uint64_t Client::GetMapHash() {
+    return _pimpl->CallAndWait<uint64_t>("get_map_hash");
+  }
+
   std::vector<uint8_t> Client::GetNavigationMesh() const {
     return _pimpl->CallAndWait<std::vector<uint8_t>>("get_navigation_mesh");
   }
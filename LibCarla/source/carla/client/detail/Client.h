@@ -77,6 +77,9 @@ namespace detail {
 
     rpc::MapInfo GetMapInfo();
 
+    /// Hash of the current map, see rpc::MapInfo::Hash.
+    uint64_t GetMapHash();
+
     std::vector<uint8_t> GetNavigationMesh() const;
 
     std::vector<std::string> GetAvailableMaps();
@@ -23,11 +23,16 @@ namespace detail {
   }
 
   template <typename RangeT>
-  static auto GetActorsById_Impl(Client &client, CachedActorList &actors, const RangeT &actor_ids) {
+  static void FetchMissingActors(Client &client, CachedActorList &actors, const RangeT &actor_ids) {
     auto missing_ids = actors.GetMissingIds(actor_ids);
     if (!missing_ids.empty()) {
       actors.InsertRange(client.GetActorsById(missing_ids));
     }
+  }
+
+  template <typename RangeT>
+  static auto GetActorsById_Impl(Client &client, CachedActorList &actors, const RangeT &actor_ids) {
+    FetchMissingActors(client, actors, actor_ids);
     return actors.GetActorsById(actor_ids);
   }
 
@@ -45,6 +50,8 @@ namespace detail {
     } catch (const std::exception &e) {
       log_error("exception trying to disconnect from episode:", e.what());
     }
+    // No more ticks arrive, wait for the callbacks still running.
+    _on_tick_callbacks.Stop();
   }
 
   void Episode::Listen() {
@@ -67,6 +74,8 @@ namespace detail {
           self->OnEpisodeStarted();
         }
 
+        self->_history.Push(next);
+
         // Notify waiting threads and do the callbacks.
         self->_snapshot.SetValue(next);
 
@@ -110,12 +119,15 @@ namespace detail {
     return GetActorsById_Impl(_client, _actors, actor_ids);
   }
 
-  std::vector<rpc::Actor> Episode::GetActors() {
-    return GetActorsById_Impl(_client, _actors, GetState()->GetActorIds());
+  std::vector<CachedActorList::ActorPtr> Episode::GetActors(const EpisodeState &state) {
+    const auto actor_ids = state.GetActorIds();
+    FetchMissingActors(_client, _actors, actor_ids);
+    return _actors.GetSharedActorsById(actor_ids);
   }
 
   void Episode::OnEpisodeStarted() {
     _actors.Clear();
+    _history.Clear();
     _on_tick_callbacks.Clear();
     _navigation.reset();
   }
@@ -9,11 +9,13 @@
 #include "carla/AtomicSharedPtr.h"
 #include "carla/NonCopyable.h"
 #include "carla/RecurrentSharedFuture.h"
+#include "carla/client/CallbackPolicy.h"
 #include "carla/client/Timestamp.h"
 #include "carla/client/WorldSnapshot.h"
 #include "carla/client/detail/CachedActorList.h"
 #include "carla/client/detail/CallbackList.h"
 #include "carla/client/detail/EpisodeState.h"
+#include "carla/client/detail/EpisodeStateHistory.h"
 #include "carla/rpc/EpisodeInfo.h"
 
 #include <vector>
@@ -49,6 +51,28 @@ namespace detail {
       return _state.load();
     }
 
+    /// Set the number of past states kept in the history, zero disables it.
+    void SetStateHistorySize(size_t size) {
+      _history.SetCapacity(size);
+    }
+
+    size_t GetStateHistorySize() const {
+      return _history.GetCapacity();
+    }
+
+    /// Return the state at @a frame if present in the history.
+    std::shared_ptr<const EpisodeState> GetStateByFrame(size_t frame) const {
+      return _history.FindByFrame(frame);
+    }
+
+    /// Return the snapshot of an actor at @a elapsed_seconds, interpolated
+    /// between the enclosing states of the history.
+    boost::optional<ActorSnapshot> GetActorSnapshotAt(
+        ActorId id,
+        double elapsed_seconds) const {
+      return _history.GetActorSnapshotAt(id, elapsed_seconds);
+    }
+
     std::shared_ptr<WalkerNavigation> CreateNavigationIfMissing();
 
     std::shared_ptr<WalkerNavigation> GetNavigation() const {
@@ -65,20 +89,28 @@ namespace detail {
 
     std::vector<rpc::Actor> GetActorsById(const std::vector<ActorId> &actor_ids);
 
-    std::vector<rpc::Actor> GetActors();
+    /// Return the descriptions of the actors present in @a state, shared with
+    /// the cache.
+    std::vector<CachedActorList::ActorPtr> GetActors(const EpisodeState &state);
 
     boost::optional<WorldSnapshot> WaitForState(time_duration timeout) {
       return _snapshot.WaitFor(timeout);
     }
 
-    size_t RegisterOnTickEvent(std::function<void(WorldSnapshot)> callback) {
-      return _on_tick_callbacks.Push(std::move(callback));
+    size_t RegisterOnTickEvent(
+        std::function<void(WorldSnapshot)> callback,
+        CallbackPolicy policy = CallbackPolicy{}) {
+      return _on_tick_callbacks.Push(std::move(callback), policy);
     }
 
     void RemoveOnTickEvent(size_t id) {
       _on_tick_callbacks.Remove(id);
     }
 
+    boost::optional<CallbackStats> GetOnTickEventStats(size_t id) const {
+      return _on_tick_callbacks.GetStats(id);
+    }
+
   private:
 
     Episode(Client &client, const rpc::EpisodeInfo &info);
@@ -89,6 +121,8 @@ namespace detail {
 
     AtomicSharedPtr<const EpisodeState> _state;
 
+    EpisodeStateHistory _history;
+
     AtomicSharedPtr<WalkerNavigation> _navigation;
 
     CachedActorList _actors;
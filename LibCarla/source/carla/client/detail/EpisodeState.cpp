@@ -33,6 +33,19 @@ namespace detail {
     }
   }
 
+  const ActorSpatialIndex &EpisodeState::GetSpatialIndex() const {
+    std::call_once(_spatial_index_flag, [this]() {
+      std::vector<ActorSpatialIndex::Item> items;
+      items.reserve(_actors.size());
+      for (auto &pair : _actors) {
+        items.push_back({pair.first, pair.second.transform.location});
+      }
+      _spatial_index = std::make_unique<const ActorSpatialIndex>(std::move(items));
+    });
+    DEBUG_ASSERT(_spatial_index != nullptr);
+    return *_spatial_index;
+  }
+
 } // namespace detail
 } // namespace client
 } // namespace carla
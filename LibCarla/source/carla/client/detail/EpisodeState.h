@@ -11,12 +11,15 @@
 #include "carla/NonCopyable.h"
 #include "carla/client/ActorSnapshot.h"
 #include "carla/client/Timestamp.h"
+#include "carla/client/detail/ActorSpatialIndex.h"
 #include "carla/sensor/data/RawEpisodeState.h"
 
 #include <boost/optional.hpp>
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace client {
@@ -32,6 +35,20 @@ namespace detail {
 
     explicit EpisodeState(const sensor::data::RawEpisodeState &state);
 
+#ifdef LIBCARLA_WITH_GTEST
+    /// Build a state directly from the snapshots of its actors.
+    EpisodeState(
+        uint64_t episode_id,
+        const Timestamp &timestamp,
+        const std::vector<ActorSnapshot> &actors)
+      : _episode_id(episode_id),
+        _timestamp(timestamp) {
+      for (const auto &actor : actors) {
+        _actors.emplace(actor.id, actor);
+      }
+    }
+#endif // LIBCARLA_WITH_GTEST
+
     auto GetEpisodeId() const {
       return _episode_id;
     }
@@ -60,6 +77,22 @@ namespace detail {
       return state;
     }
 
+    /// Return the snapshots of @a ids, ids not present are skipped.
+    std::vector<ActorSnapshot> GetActorSnapshots(const std::vector<ActorId> &ids) const {
+      std::vector<ActorSnapshot> result;
+      result.reserve(ids.size());
+      for (auto id : ids) {
+        auto it = _actors.find(id);
+        if (it != _actors.end()) {
+          result.emplace_back(it->second);
+        }
+      }
+      return result;
+    }
+
+    /// Spatial index over the actor locations, built on first use.
+    const ActorSpatialIndex &GetSpatialIndex() const;
+
     auto GetActorIds() const {
       return MakeListView(
           iterator::make_map_keys_const_iterator(_actors.begin()),
@@ -93,6 +126,10 @@ namespace detail {
     const Timestamp _timestamp;
 
     std::unordered_map<ActorId, ActorSnapshot> _actors;
+
+    mutable std::once_flag _spatial_index_flag;
+
+    mutable std::unique_ptr<const ActorSpatialIndex> _spatial_index;
   };
 
 } // namespace detail
@@ -0,0 +1,168 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/detail/EpisodeStateHistory.h"
+
+#include "carla/Debug.h"
+#include "carla/geom/Math.h"
+
+#include <algorithm>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  static double GetElapsedSeconds(const EpisodeState &state) {
+    return state.GetTimestamp().elapsed_seconds;
+  }
+
+  EpisodeStateHistory::EpisodeStateHistory(size_t capacity)
+    : _buffer(capacity) {}
+
+  void EpisodeStateHistory::SetCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const size_t kept = std::min(capacity, _size);
+    std::vector<StatePtr> buffer(capacity);
+    for (size_t i = 0u; i < kept; ++i) {
+      buffer[i] = At(_size - kept + i);
+    }
+    _buffer = std::move(buffer);
+    _head = 0u;
+    _size = kept;
+  }
+
+  size_t EpisodeStateHistory::GetCapacity() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _buffer.size();
+  }
+
+  size_t EpisodeStateHistory::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+  }
+
+  void EpisodeStateHistory::Push(StatePtr state) {
+    DEBUG_ASSERT(state != nullptr);
+    std::lock_guard<std::mutex> lock(_mutex);
+    const size_t capacity = _buffer.size();
+    if (capacity == 0u) {
+      return;
+    }
+    const auto frame = state->GetFrame();
+    if ((_size == 0u) || (At(_size - 1u)->GetFrame() < frame)) {
+      // Common case, append at the end overwriting the oldest if full.
+      if (_size < capacity) {
+        _buffer[(_head + _size) % capacity] = std::move(state);
+        ++_size;
+      } else {
+        _buffer[_head] = std::move(state);
+        _head = (_head + 1u) % capacity;
+      }
+      return;
+    }
+    // Out of order arrival (rare), rebuild the buffer with the state in place.
+    std::vector<StatePtr> states;
+    states.reserve(_size + 1u);
+    for (size_t i = 0u; i < _size; ++i) {
+      states.emplace_back(At(i));
+    }
+    auto it = std::lower_bound(states.begin(), states.end(), frame,
+        [](const StatePtr &item, size_t value) { return item->GetFrame() < value; });
+    if ((it != states.end()) && ((*it)->GetFrame() == frame)) {
+      return;
+    }
+    states.insert(it, std::move(state));
+    const size_t first = states.size() > capacity ? states.size() - capacity : 0u;
+    auto last = std::move(states.begin() + static_cast<std::ptrdiff_t>(first), states.end(), _buffer.begin());
+    std::fill(last, _buffer.end(), nullptr);
+    _head = 0u;
+    _size = states.size() - first;
+  }
+
+  void EpisodeStateHistory::Clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto &item : _buffer) {
+      item.reset();
+    }
+    _head = 0u;
+    _size = 0u;
+  }
+
+  EpisodeStateHistory::StatePtr EpisodeStateHistory::FindByFrame(size_t frame) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const size_t index = PartitionPoint([frame](const EpisodeState &item) {
+      return item.GetFrame() < frame;
+    });
+    if ((index < _size) && (At(index)->GetFrame() == frame)) {
+      return At(index);
+    }
+    return nullptr;
+  }
+
+  std::pair<EpisodeStateHistory::StatePtr, EpisodeStateHistory::StatePtr>
+  EpisodeStateHistory::FindByElapsedSeconds(double elapsed_seconds) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const size_t index = PartitionPoint([elapsed_seconds](const EpisodeState &item) {
+      return GetElapsedSeconds(item) < elapsed_seconds;
+    });
+    if (index >= _size) {
+      return {nullptr, nullptr};
+    }
+    const auto &upper = At(index);
+    if (GetElapsedSeconds(*upper) == elapsed_seconds) {
+      return {upper, upper};
+    }
+    if (index == 0u) {
+      return {nullptr, nullptr};
+    }
+    return {At(index - 1u), upper};
+  }
+
+  boost::optional<ActorSnapshot> EpisodeStateHistory::GetActorSnapshotAt(
+      const ActorId id,
+      const double elapsed_seconds) const {
+    const auto states = FindByElapsedSeconds(elapsed_seconds);
+    if (states.first == nullptr) {
+      return boost::none;
+    }
+    auto lower = states.first->GetActorSnapshotIfPresent(id);
+    if (!lower.has_value() || (states.first == states.second)) {
+      return lower;
+    }
+    auto upper = states.second->GetActorSnapshotIfPresent(id);
+    if (!upper.has_value()) {
+      return boost::none;
+    }
+    const double t0 = GetElapsedSeconds(*states.first);
+    const double t1 = GetElapsedSeconds(*states.second);
+    const auto alpha = static_cast<float>((elapsed_seconds - t0) / (t1 - t0));
+    return Interpolate(*lower, *upper, alpha);
+  }
+
+  ActorSnapshot EpisodeStateHistory::Interpolate(
+      const ActorSnapshot &a,
+      const ActorSnapshot &b,
+      const float alpha) {
+    using geom::Math;
+    using geom::Vector3D;
+    ActorSnapshot result = (alpha < 0.5f ? a : b);
+    result.transform.location = Math::Lerp<Vector3D>(
+        a.transform.location,
+        b.transform.location,
+        alpha);
+    result.transform.rotation = Math::Slerp(
+        a.transform.rotation,
+        b.transform.rotation,
+        alpha);
+    result.velocity = Math::Lerp(a.velocity, b.velocity, alpha);
+    result.angular_velocity = Math::Lerp(a.angular_velocity, b.angular_velocity, alpha);
+    result.acceleration = Math::Lerp(a.acceleration, b.acceleration, alpha);
+    return result;
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
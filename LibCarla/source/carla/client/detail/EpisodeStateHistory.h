@@ -0,0 +1,110 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/client/ActorSnapshot.h"
+#include "carla/client/detail/EpisodeState.h"
+
+#include <boost/optional.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Ring buffer holding the last N episode states received, sorted by frame.
+  /// Memory is bounded by the capacity, which is zero (disabled) by default.
+  ///
+  /// Lookups by frame or by simulation time are binary searches, O(log N).
+  class EpisodeStateHistory : private NonCopyable {
+  public:
+
+    using StatePtr = std::shared_ptr<const EpisodeState>;
+
+    explicit EpisodeStateHistory(size_t capacity = 0u);
+
+    /// Change the maximum number of states kept, the most recent states are
+    /// preserved.
+    void SetCapacity(size_t capacity);
+
+    size_t GetCapacity() const;
+
+    size_t size() const;
+
+    /// Add a new state. States are expected in increasing frame order, a
+    /// state with a frame already present is ignored.
+    void Push(StatePtr state);
+
+    void Clear();
+
+    /// Return the state at @a frame, or nullptr if not in the history.
+    StatePtr FindByFrame(size_t frame) const;
+
+    /// Return the two states enclosing @a elapsed_seconds (simulated seconds
+    /// since the beginning of the episode). Both are the same state on an
+    /// exact match, and both are nullptr if the time is out of the history.
+    std::pair<StatePtr, StatePtr> FindByElapsedSeconds(double elapsed_seconds) const;
+
+    /// Return the snapshot of actor @a id at @a elapsed_seconds, interpolated
+    /// between the two enclosing states: location and velocities linearly,
+    /// rotation spherically. Return an empty optional if the time is out of
+    /// the history or the actor is missing in any of the enclosing states.
+    boost::optional<ActorSnapshot> GetActorSnapshotAt(
+        ActorId id,
+        double elapsed_seconds) const;
+
+    /// Interpolate two snapshots of the same actor, @a alpha in [0, 1].
+    static ActorSnapshot Interpolate(
+        const ActorSnapshot &a,
+        const ActorSnapshot &b,
+        float alpha);
+
+  private:
+
+    /// @pre _mutex is locked.
+    const StatePtr &At(size_t index) const {
+      return _buffer[(_head + index) % _buffer.size()];
+    }
+
+    /// Index of the first state for which @a predicate is false, the states
+    /// must be partitioned by @a predicate.
+    ///
+    /// @pre _mutex is locked.
+    template <typename PredicateT>
+    size_t PartitionPoint(PredicateT &&predicate) const {
+      size_t first = 0u;
+      size_t count = _size;
+      while (count > 0u) {
+        const size_t step = count / 2u;
+        const size_t middle = first + step;
+        if (predicate(*At(middle))) {
+          first = middle + 1u;
+          count -= step + 1u;
+        } else {
+          count = step;
+        }
+      }
+      return first;
+    }
+
+    mutable std::mutex _mutex;
+
+    std::vector<StatePtr> _buffer;
+
+    /// Index in _buffer of the oldest state.
+    size_t _head = 0u;
+
+    size_t _size = 0u;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
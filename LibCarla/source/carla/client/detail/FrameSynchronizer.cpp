@@ -0,0 +1,195 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/detail/FrameSynchronizer.h"
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  // ===========================================================================
+  // -- Slot state -------------------------------------------------------------
+  // ===========================================================================
+
+  // Layout of the state word of a slot:
+  //
+  //   bits  0-15  members that delivered their data.
+  //   bits 16-31  members that claimed their entry to write their data.
+  //   bit     32  the bundle was emitted, no more data is accepted.
+  //   bit     33  a thread is moving the bundle out of the slot.
+  //   bits 34-63  frame, modulo 2^30.
+
+  static constexpr uint64_t MEMBERS_MASK = (uint64_t(1u) << FrameSynchronizer::MAX_MEMBERS) - 1u;
+  static constexpr uint64_t CLAIMED_SHIFT = 16u;
+  static constexpr uint64_t DONE = uint64_t(1u) << 32u;
+  static constexpr uint64_t EMITTING = uint64_t(1u) << 33u;
+  static constexpr uint64_t FRAME_SHIFT = 34u;
+  static constexpr uint64_t FRAME_MASK = (uint64_t(1u) << (64u - FRAME_SHIFT)) - 1u;
+
+  static uint64_t Arrived(uint64_t state) {
+    return state & MEMBERS_MASK;
+  }
+
+  static uint64_t Claimed(uint64_t state) {
+    return (state >> CLAIMED_SHIFT) & MEMBERS_MASK;
+  }
+
+  static uint64_t MakeState(size_t frame) {
+    return (static_cast<uint64_t>(frame) & FRAME_MASK) << FRAME_SHIFT;
+  }
+
+  /// Signed difference between @a frame and the frame of @a state, taking
+  /// into account that the latter wraps around.
+  static int64_t FrameDifference(size_t frame, uint64_t state) {
+    const uint64_t diff = (static_cast<uint64_t>(frame) - (state >> FRAME_SHIFT)) & FRAME_MASK;
+    const auto result = static_cast<int64_t>(diff);
+    return diff <= (FRAME_MASK >> 1u) ? result : result - static_cast<int64_t>(FRAME_MASK + 1u);
+  }
+
+  static int64_t Now() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    // Zero is reserved for "no data yet".
+    return std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+  }
+
+  struct FrameSynchronizer::Slot {
+    std::atomic<uint64_t> state{0u};
+    /// Time when the first data of the bundle arrived.
+    std::atomic<int64_t> first_arrival{0};
+    std::vector<SharedPtr<sensor::SensorData>> data;
+  };
+
+  // ===========================================================================
+  // -- FrameSynchronizer ------------------------------------------------------
+  // ===========================================================================
+
+  FrameSynchronizer::FrameSynchronizer(
+      size_t number_of_members,
+      time_duration timeout,
+      size_t ring_size,
+      CallbackFunctionType callback)
+    : _number_of_members(number_of_members),
+      _timeout_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout.to_chrono()).count()),
+      _ring_size(ring_size),
+      _callback(std::move(callback)) {
+    if ((number_of_members == 0u) || (number_of_members > MAX_MEMBERS)) {
+      throw_exception(std::invalid_argument(
+          "FrameSynchronizer: the number of members must be between 1 and " + std::to_string(MAX_MEMBERS)));
+    }
+    if (ring_size == 0u) {
+      throw_exception(std::invalid_argument("FrameSynchronizer: the ring size must be greater than zero"));
+    }
+    _slots = std::make_unique<Slot[]>(ring_size);
+    for (auto i = 0u; i < ring_size; ++i) {
+      _slots[i].data.resize(number_of_members);
+    }
+  }
+
+  FrameSynchronizer::~FrameSynchronizer() = default;
+
+  void FrameSynchronizer::Push(size_t index, SharedPtr<sensor::SensorData> data) {
+    DEBUG_ASSERT(index < _number_of_members);
+    DEBUG_ASSERT(data != nullptr);
+    const size_t frame = data->GetFrame();
+    const uint64_t bit = uint64_t(1u) << index;
+    auto &slot = _slots[frame % _ring_size];
+    for (;;) {
+      uint64_t state = slot.state.load(std::memory_order_acquire);
+      const auto diff = FrameDifference(frame, state);
+      if (diff < 0) {
+        // The slot was already taken by a newer frame.
+        ++_dropped;
+        break;
+      }
+      if (diff > 0) {
+        // The slot holds an older frame, wait until its data is written and
+        // moved out, then take it.
+        if (((state & EMITTING) != 0u) || (Claimed(state) != Arrived(state))) {
+          std::this_thread::yield();
+        } else if (((state & DONE) == 0u) && (Arrived(state) != 0u)) {
+          TryEmit(slot, state);
+        } else {
+          slot.state.compare_exchange_weak(state, MakeState(frame), std::memory_order_acq_rel);
+        }
+        continue;
+      }
+      if (((state & DONE) != 0u) || ((Claimed(state) & bit) != 0u)) {
+        // Already emitted, or a duplicate.
+        ++_dropped;
+        break;
+      }
+      if (!slot.state.compare_exchange_weak(state, state | (bit << CLAIMED_SHIFT), std::memory_order_acq_rel)) {
+        continue;
+      }
+      int64_t none = 0;
+      slot.first_arrival.compare_exchange_strong(none, Now(), std::memory_order_relaxed);
+      slot.data[index] = std::move(data);
+      state = slot.state.fetch_or(bit, std::memory_order_acq_rel) | bit;
+      if (Arrived(state) == (MEMBERS_MASK >> (MAX_MEMBERS - _number_of_members))) {
+        // We delivered the last data, nobody else can be emitting it.
+        const bool emitted = TryEmit(slot, state);
+        DEBUG_ASSERT(emitted);
+        (void) emitted;
+      }
+      break;
+    }
+    EmitPending(true);
+  }
+
+  void FrameSynchronizer::Flush() {
+    EmitPending(false);
+  }
+
+  void FrameSynchronizer::EmitPending(const bool only_expired) {
+    if (only_expired && (_timeout_ns == 0)) {
+      return;
+    }
+    const auto now = Now();
+    for (auto i = 0u; i < _ring_size; ++i) {
+      auto &slot = _slots[i];
+      const auto state = slot.state.load(std::memory_order_acquire);
+      if (((state & (DONE | EMITTING)) != 0u) ||
+          (Arrived(state) == 0u) ||
+          (Claimed(state) != Arrived(state))) {
+        continue;
+      }
+      if (only_expired && ((now - slot.first_arrival.load(std::memory_order_relaxed)) < _timeout_ns)) {
+        continue;
+      }
+      TryEmit(slot, state);
+    }
+  }
+
+  bool FrameSynchronizer::TryEmit(Slot &slot, uint64_t state) {
+    if (!slot.state.compare_exchange_strong(state, state | DONE | EMITTING, std::memory_order_acq_rel)) {
+      return false;
+    }
+    std::vector<SharedPtr<sensor::SensorData>> data(_number_of_members);
+    size_t frame = 0u;
+    for (auto i = 0u; i < _number_of_members; ++i) {
+      data[i] = std::move(slot.data[i]);
+      if (data[i] != nullptr) {
+        frame = data[i]->GetFrame();
+      }
+    }
+    slot.first_arrival.store(0, std::memory_order_relaxed);
+    slot.state.fetch_and(~EMITTING, std::memory_order_release);
+    _callback(MakeShared<SensorBundle>(frame, std::move(data)));
+    return true;
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
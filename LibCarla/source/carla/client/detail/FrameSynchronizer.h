@@ -0,0 +1,97 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+#include "carla/client/SensorBundle.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Groups by frame the data received from several sensors, the members,
+  /// and calls the callback with one SensorBundle per frame.
+  ///
+  /// Frames are assigned to a ring of slots by frame modulo the ring size.
+  /// The state of each slot (its frame and which members claimed and
+  /// delivered their data) is kept in a single atomic word, so the data can
+  /// be pushed concurrently from the threads of each sensor stream without
+  /// locks; a thread only spins when it needs a slot from which another
+  /// thread is moving out an older bundle.
+  ///
+  /// A bundle is emitted as soon as every member delivered its data. An
+  /// incomplete bundle is emitted when
+  ///   - its first data arrived longer than the timeout ago, checked each
+  ///     time new data is pushed;
+  ///   - its slot is needed for a newer frame;
+  ///   - Flush() is called.
+  /// Data for a frame already emitted, or for a frame older than the one in
+  /// its slot, is dropped.
+  class FrameSynchronizer : private NonCopyable {
+  public:
+
+    using CallbackFunctionType = std::function<void(SharedPtr<SensorBundle>)>;
+
+    static constexpr size_t MAX_MEMBERS = 16u;
+
+    /// A zero @a timeout disables the timeout.
+    FrameSynchronizer(
+        size_t number_of_members,
+        time_duration timeout,
+        size_t ring_size,
+        CallbackFunctionType callback);
+
+    ~FrameSynchronizer();
+
+    size_t GetNumberOfMembers() const {
+      return _number_of_members;
+    }
+
+    /// Add the @a data delivered by the member at @a index. May call the
+    /// callback in this thread.
+    void Push(size_t index, SharedPtr<sensor::SensorData> data);
+
+    /// Emit every incomplete bundle.
+    void Flush();
+
+    /// Number of data objects dropped because they arrived too late.
+    size_t GetDroppedCount() const {
+      return _dropped;
+    }
+
+  private:
+
+    struct Slot;
+
+    void EmitPending(bool only_expired);
+
+    bool TryEmit(Slot &slot, uint64_t state);
+
+    const size_t _number_of_members;
+
+    const int64_t _timeout_ns;
+
+    const size_t _ring_size;
+
+    const CallbackFunctionType _callback;
+
+    std::unique_ptr<Slot[]> _slots;
+
+    std::atomic_size_t _dropped{0u};
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
@@ -12,6 +12,7 @@
 #include "carla/RecurrentSharedFuture.h"
 #include "carla/client/BlueprintLibrary.h"
 #include "carla/client/Map.h"
+#include "carla/client/MapCache.h"
 #include "carla/client/Sensor.h"
 #include "carla/client/TimeoutException.h"
 #include "carla/client/WalkerAIController.h"
@@ -99,7 +100,26 @@ namespace detail {
   }
 
   SharedPtr<Map> Simulator::GetCurrentMap() {
-    return MakeShared<Map>(_client.GetMapInfo());
+    const auto episode_id = GetCurrentEpisode().GetId();
+    {
+      std::lock_guard<std::mutex> lock(_map_mutex);
+      if (_map_hash.has_value() && (_map_hash->episode_id == episode_id)) {
+        auto map = MapCache::Find(_map_hash->hash);
+        if (map != nullptr) {
+          return map;
+        }
+      }
+    }
+    auto map = MapCache::Find(_client.GetMapHash());
+    if (map == nullptr) {
+      auto info = _client.GetMapInfo();
+      // Hash what we actually received, the map may have changed since.
+      const auto hash = info.GetHash();
+      map = MapCache::Add(hash, MakeShared<Map>(std::move(info)));
+    }
+    std::lock_guard<std::mutex> lock(_map_mutex);
+    _map_hash = CurrentMapHash{episode_id, map->GetHash()};
+    return map;
   }
 
   // ===========================================================================
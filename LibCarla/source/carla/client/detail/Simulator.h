@@ -10,6 +10,7 @@
 #include "carla/Memory.h"
 #include "carla/NonCopyable.h"
 #include "carla/client/Actor.h"
+#include "carla/client/CallbackPolicy.h"
 #include "carla/client/GarbageCollectionPolicy.h"
 #include "carla/client/TrafficLight.h"
 #include "carla/client/Vehicle.h"
@@ -24,6 +25,7 @@
 #include "carla/rpc/TrafficLightState.h"
 
 #include <memory>
+#include <mutex>
 #include <optional>
 
 namespace carla {
@@ -92,12 +94,39 @@ namespace detail {
       return WorldSnapshot{_episode->GetState()};
     }
 
+    void SetSnapshotHistorySize(size_t size) {
+      DEBUG_ASSERT(_episode != nullptr);
+      _episode->SetStateHistorySize(size);
+    }
+
+    size_t GetSnapshotHistorySize() const {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->GetStateHistorySize();
+    }
+
+    boost::optional<WorldSnapshot> GetWorldSnapshotByFrame(size_t frame) const {
+      DEBUG_ASSERT(_episode != nullptr);
+      auto state = _episode->GetStateByFrame(frame);
+      if (state == nullptr) {
+        return boost::none;
+      }
+      return WorldSnapshot{std::move(state)};
+    }
+
+    boost::optional<ActorSnapshot> GetActorSnapshotAt(ActorId id, double elapsed_seconds) const {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->GetActorSnapshotAt(id, elapsed_seconds);
+    }
+
     /// @}
     // =========================================================================
     /// @name Map related methods
     // =========================================================================
     /// @{
 
+    /// Return the map of the current episode. Maps are shared through
+    /// MapCache, the OpenDRIVE file is only transferred and parsed if no
+    /// map with the same hash is alive in this process.
     SharedPtr<Map> GetCurrentMap();
 
     std::vector<std::string> GetAvailableMaps() {
@@ -140,9 +169,11 @@ namespace detail {
 
     WorldSnapshot WaitForTick(time_duration timeout);
 
-    size_t RegisterOnTickEvent(std::function<void(WorldSnapshot)> callback) {
+    size_t RegisterOnTickEvent(
+        std::function<void(WorldSnapshot)> callback,
+        CallbackPolicy policy = CallbackPolicy{}) {
       DEBUG_ASSERT(_episode != nullptr);
-      return _episode->RegisterOnTickEvent(std::move(callback));
+      return _episode->RegisterOnTickEvent(std::move(callback), policy);
     }
 
     void RemoveOnTickEvent(size_t id) {
@@ -150,6 +181,11 @@ namespace detail {
       _episode->RemoveOnTickEvent(id);
     }
 
+    boost::optional<CallbackStats> GetOnTickEventStats(size_t id) const {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->GetOnTickEventStats(id);
+    }
+
     uint64_t Tick();
 
     /// @}
@@ -212,9 +248,15 @@ namespace detail {
       return _episode->GetActorsById(actor_ids);
     }
 
-    std::vector<rpc::Actor> GetAllTheActorsInTheEpisode() const {
+    std::shared_ptr<const EpisodeState> GetEpisodeState() const {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->GetState();
+    }
+
+    /// Return the descriptions of the actors present in @a state.
+    std::vector<CachedActorList::ActorPtr> GetAllTheActorsInTheEpisode(const EpisodeState &state) const {
       DEBUG_ASSERT(_episode != nullptr);
-      return _episode->GetActors();
+      return _episode->GetActors(state);
     }
 
     /// Creates an actor instance out of a description of an existing actor.
@@ -432,6 +474,17 @@ namespace detail {
     std::shared_ptr<Episode> _episode;
 
     const GarbageCollectionPolicy _gc_policy;
+
+    /// Hash of the map of the episode @a episode_id, the map does not change
+    /// during an episode so no RPC is needed to find it again.
+    struct CurrentMapHash {
+      uint64_t episode_id;
+      uint64_t hash;
+    };
+
+    std::mutex _map_mutex;
+
+    boost::optional<CurrentMapHash> _map_hash;
   };
 
 } // namespace detail
@@ -0,0 +1,128 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/detail/WaypointProjector.h"
+
+#include "carla/Debug.h"
+
+#include <algorithm>
+#include <exception>
+#include <future>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  constexpr size_t WaypointProjector::MIN_LOCATIONS_PER_CHUNK;
+  constexpr size_t WaypointProjector::MIN_ROADS_PER_CHUNK;
+
+  WaypointProjector::WaypointProjector(size_t worker_threads)
+    : _worker_threads(worker_threads) {
+    if (_worker_threads > 0u) {
+      _pool = std::make_unique<ThreadPool>();
+      _pool->AsyncRun(_worker_threads);
+    }
+  }
+
+  WaypointProjector::~WaypointProjector() = default;
+
+  template <typename T, typename FunctorT>
+  auto WaypointProjector::ForEachChunk(
+      const T *begin,
+      const T *end,
+      const size_t min_chunk_size,
+      FunctorT &&functor) -> decltype(functor(begin, end)) {
+    using ResultT = decltype(functor(begin, end));
+    DEBUG_ASSERT(begin <= end);
+    const auto size = static_cast<size_t>(end - begin);
+    const size_t number_of_chunks = std::max<size_t>(
+        1u,
+        std::min(_worker_threads + 1u, size / min_chunk_size));
+    if (number_of_chunks == 1u) {
+      return functor(begin, end);
+    }
+    const size_t chunk_size = (size + number_of_chunks - 1u) / number_of_chunks;
+    std::vector<ResultT> chunks(number_of_chunks);
+    std::vector<std::future<void>> futures;
+    futures.reserve(number_of_chunks);
+    size_t chunk = 1u;
+    for (size_t first = chunk_size; first < size; first += chunk_size, ++chunk) {
+      const size_t last = std::min(first + chunk_size, size);
+      futures.emplace_back(_pool->Post([&functor, &chunks, chunk, begin, first, last]() {
+        chunks[chunk] = functor(begin + first, begin + last);
+      }));
+    }
+    std::exception_ptr exception;
+    try {
+      chunks[0u] = functor(begin, begin + chunk_size);
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    // Wait for every chunk before leaving, they reference the functor.
+    for (auto &future : futures) {
+      try {
+        future.get();
+      } catch (...) {
+        exception = std::current_exception();
+      }
+    }
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+    size_t total_size = 0u;
+    for (auto &items : chunks) {
+      total_size += items.size();
+    }
+    ResultT result;
+    result.reserve(total_size);
+    for (auto &items : chunks) {
+      result.insert(result.end(), items.begin(), items.end());
+    }
+    return result;
+  }
+
+  std::vector<boost::optional<road::element::Waypoint>> WaypointProjector::GetClosestWaypointsOnRoad(
+      const road::Map &map,
+      const geom::Location *begin,
+      const geom::Location *end,
+      const uint32_t lane_type) {
+    return ForEachChunk(begin, end, MIN_LOCATIONS_PER_CHUNK, [&](auto *first, auto *last) {
+      return map.GetClosestWaypointsOnRoad(first, last, lane_type);
+    });
+  }
+
+  std::vector<boost::optional<road::element::Waypoint>> WaypointProjector::GetWaypoints(
+      const road::Map &map,
+      const geom::Location *begin,
+      const geom::Location *end,
+      const uint32_t lane_type) {
+    return ForEachChunk(begin, end, MIN_LOCATIONS_PER_CHUNK, [&](auto *first, auto *last) {
+      return map.GetWaypoints(first, last, lane_type);
+    });
+  }
+
+  std::vector<road::element::Waypoint> WaypointProjector::GenerateWaypoints(
+      const road::Map &map,
+      const double approx_distance) {
+    const auto road_ids = map.GetRoadIds();
+    const auto *begin = road_ids.data();
+    return ForEachChunk(begin, begin + road_ids.size(), MIN_ROADS_PER_CHUNK, [&](auto *first, auto *last) {
+      return map.GenerateWaypoints(approx_distance, first, last);
+    });
+  }
+
+  std::vector<std::pair<road::element::Waypoint, road::element::Waypoint>> WaypointProjector::GenerateTopology(
+      const road::Map &map) {
+    const auto road_ids = map.GetRoadIds();
+    const auto *begin = road_ids.data();
+    return ForEachChunk(begin, begin + road_ids.size(), MIN_ROADS_PER_CHUNK, [&](auto *first, auto *last) {
+      return map.GenerateTopology(first, last);
+    });
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
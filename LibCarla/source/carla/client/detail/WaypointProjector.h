@@ -0,0 +1,92 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+#include "carla/geom/Location.h"
+#include "carla/road/Map.h"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Project batches of locations to the lanes of a road::Map, as
+  /// road::Map::GetWaypoints and road::Map::GetClosestWaypointsOnRoad do, and
+  /// generate the waypoints and topology of a whole road::Map.
+  ///
+  /// Large batches, and the roads of the map, are split in chunks processed
+  /// in parallel by a ThreadPool, the calling thread processes one of the
+  /// chunks too. The result does not depend on the number of threads.
+  class WaypointProjector : private NonCopyable {
+  public:
+
+    using Waypoint = road::element::Waypoint;
+
+    /// Locations per chunk below which splitting is not worth it.
+    static constexpr size_t MIN_LOCATIONS_PER_CHUNK = 256u;
+
+    /// Roads per chunk below which splitting is not worth it.
+    static constexpr size_t MIN_ROADS_PER_CHUNK = 16u;
+
+    /// Launch @a worker_threads threads, if zero everything runs in the
+    /// calling thread.
+    explicit WaypointProjector(size_t worker_threads = 0u);
+
+    ~WaypointProjector();
+
+    size_t GetWorkerThreads() const {
+      return _worker_threads;
+    }
+
+    /// @copydoc road::Map::GetClosestWaypointsOnRoad
+    std::vector<boost::optional<Waypoint>> GetClosestWaypointsOnRoad(
+        const road::Map &map,
+        const geom::Location *begin,
+        const geom::Location *end,
+        uint32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving));
+
+    /// @copydoc road::Map::GetWaypoints
+    std::vector<boost::optional<Waypoint>> GetWaypoints(
+        const road::Map &map,
+        const geom::Location *begin,
+        const geom::Location *end,
+        uint32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving));
+
+    /// @copydoc road::Map::GenerateWaypoints(double) const
+    std::vector<Waypoint> GenerateWaypoints(const road::Map &map, double approx_distance);
+
+    /// @copydoc road::Map::GenerateTopology() const
+    std::vector<std::pair<Waypoint, Waypoint>> GenerateTopology(const road::Map &map);
+
+  private:
+
+    /// Call @a functor(begin, end) on consecutive ranges of at least @a
+    /// min_chunk_size items covering [@a begin, @a end) in parallel, and join
+    /// the vectors returned in order.
+    template <typename T, typename FunctorT>
+    auto ForEachChunk(
+        const T *begin,
+        const T *end,
+        size_t min_chunk_size,
+        FunctorT &&functor) -> decltype(functor(begin, end));
+
+    const size_t _worker_threads;
+
+    std::unique_ptr<ThreadPool> _pool;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
@@ -48,6 +48,19 @@ namespace geom {
              d} },
         _s(s) {}
 
+    /// Polynomial with coefficients @a a, @a b, @a c and @a d already moved to
+    /// the lateral offset @a s, i.e., the values returned by the getters.
+    static CubicPolynomial MakeDisplaced(
+        const value_type &a,
+        const value_type &b,
+        const value_type &c,
+        const value_type &d,
+        const value_type &s) {
+      CubicPolynomial result{a, b, c, d};
+      result._s = s;
+      return result;
+    }
+
     // =========================================================================
     // -- Getters --------------------------------------------------------------
     // =========================================================================
@@ -118,5 +118,93 @@ namespace geom {
     return {cy * cp, sy * cp, sp};
   }
 
+  namespace {
+
+    struct Quaternion {
+      double x, y, z, w;
+    };
+
+  } // namespace
+
+  // Same conventions as UE4's FRotator::Quaternion and FQuat::Rotator.
+  static Quaternion ToQuaternion(const Rotation &rotation) {
+    const double half = Math::Pi<double>() / 360.0;
+    const double sp = std::sin(half * rotation.pitch);
+    const double cp = std::cos(half * rotation.pitch);
+    const double sy = std::sin(half * rotation.yaw);
+    const double cy = std::cos(half * rotation.yaw);
+    const double sr = std::sin(half * rotation.roll);
+    const double cr = std::cos(half * rotation.roll);
+    return {
+       cr * sp * sy - sr * cp * cy,
+      -cr * sp * cy - sr * cp * sy,
+       cr * cp * sy - sr * sp * cy,
+       cr * cp * cy + sr * sp * sy};
+  }
+
+  static double NormalizeDegrees(double angle) {
+    angle = std::fmod(angle, 360.0);
+    if (angle > 180.0) {
+      angle -= 360.0;
+    } else if (angle < -180.0) {
+      angle += 360.0;
+    }
+    return angle;
+  }
+
+  static Rotation ToRotation(const Quaternion &q) {
+    constexpr double singularity_threshold = 0.4999995;
+    const double singularity_test = q.z * q.x - q.w * q.y;
+    const double yaw_y = 2.0 * (q.w * q.z + q.x * q.y);
+    const double yaw_x = 1.0 - 2.0 * (q.y * q.y + q.z * q.z);
+    const double yaw = Math::ToDegrees(std::atan2(yaw_y, yaw_x));
+    double pitch;
+    double roll;
+    if (singularity_test < -singularity_threshold) {
+      pitch = -90.0;
+      roll = NormalizeDegrees(-yaw - 2.0 * Math::ToDegrees(std::atan2(q.x, q.w)));
+    } else if (singularity_test > singularity_threshold) {
+      pitch = 90.0;
+      roll = NormalizeDegrees(yaw - 2.0 * Math::ToDegrees(std::atan2(q.x, q.w)));
+    } else {
+      pitch = Math::ToDegrees(std::asin(2.0 * singularity_test));
+      roll = Math::ToDegrees(std::atan2(
+          -2.0 * (q.w * q.x + q.y * q.z),
+          1.0 - 2.0 * (q.x * q.x + q.y * q.y)));
+    }
+    return {
+        static_cast<float>(pitch),
+        static_cast<float>(yaw),
+        static_cast<float>(roll)};
+  }
+
+  Rotation Math::Slerp(const Rotation &a, const Rotation &b, const float t) {
+    const Quaternion qa = ToQuaternion(a);
+    Quaternion qb = ToQuaternion(b);
+    double cos_theta = qa.x * qb.x + qa.y * qb.y + qa.z * qb.z + qa.w * qb.w;
+    // Take the shortest path.
+    if (cos_theta < 0.0) {
+      qb = {-qb.x, -qb.y, -qb.z, -qb.w};
+      cos_theta = -cos_theta;
+    }
+    double wa = 1.0 - t;
+    double wb = t;
+    // Fall back to linear interpolation for nearly identical orientations.
+    if (cos_theta < 0.9999) {
+      const double theta = std::acos(cos_theta);
+      const double sin_theta = std::sin(theta);
+      wa = std::sin((1.0 - t) * theta) / sin_theta;
+      wb = std::sin(t * theta) / sin_theta;
+    }
+    Quaternion q{
+        wa * qa.x + wb * qb.x,
+        wa * qa.y + wb * qb.y,
+        wa * qa.z + wb * qb.z,
+        wa * qa.w + wb * qb.w};
+    const double norm = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    q = {q.x / norm, q.y / norm, q.z / norm, q.w / norm};
+    return ToRotation(q);
+  }
+
 } // namespace geom
 } // namespace carla
@@ -106,6 +106,17 @@ namespace geom {
 
     /// Compute the unit vector pointing towards the X-axis of @a rotation.
     static Vector3D GetForwardVector(const Rotation &rotation);
+
+    /// Linear interpolation between @a a and @a b, @a t in [0, 1].
+    template <typename T>
+    static T Lerp(const T &a, const T &b, float t) {
+      return a + t * (b - a);
+    }
+
+    /// Spherical linear interpolation between the orientations @a a and @a b,
+    /// @a t in [0, 1]. Follows the shortest arc, so interpolating yaw from
+    /// 170 to -170 degrees goes through 180.
+    static Rotation Slerp(const Rotation &a, const Rotation &b, float t);
   };
 
 } // namespace geom
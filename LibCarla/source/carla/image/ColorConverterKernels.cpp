@@ -0,0 +1,378 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/image/ColorConverterKernels.h"
+
+#include "carla/image/BoostGil.h"
+#include "carla/image/CityScapesPalette.h"
+#include "carla/image/ColorConverter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define LIBCARLA_IMAGE_WITH_X86_KERNELS
+#  include <immintrin.h>
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#    define LIBCARLA_TARGET_AVX2
+#  else
+#    define LIBCARLA_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#endif
+
+namespace carla {
+namespace image {
+
+  using sensor::data::Color;
+  using InstructionSet = ColorConverterKernels::InstructionSet;
+
+  static_assert(sizeof(Color) == sizeof(uint32_t), "Invalid color size!");
+
+  // ===========================================================================
+  // -- Scalar helpers ---------------------------------------------------------
+  // ===========================================================================
+
+  /// Number of depth values, depth is encoded in 24 bits.
+  static constexpr uint32_t DEPTH_RANGE = 256u * 256u * 256u;
+
+  /// Pixels are read as little-endian 32-bit words, i.e. 0xAARRGGBB.
+  static uint32_t LoadPixel(const Color *pixel) {
+    uint32_t value;
+    std::memcpy(&value, pixel, sizeof(value));
+    return value;
+  }
+
+  static void StorePixel(Color *pixel, uint32_t value) {
+    std::memcpy(static_cast<void *>(pixel), &value, sizeof(value));
+  }
+
+  /// Depth encoded as R + G * 256 + B * 256 * 256.
+  static uint32_t DecodeDepth(uint32_t bgra) {
+    return ((bgra >> 16u) & 0xFFu) | (bgra & 0xFF00u) | ((bgra & 0xFFu) << 16u);
+  }
+
+  /// Gray level replicated in the BGR channels, opaque alpha.
+  static uint32_t EncodeGray(uint32_t level) {
+    return level | (level << 8u) | (level << 16u) | 0xFF000000u;
+  }
+
+  /// Same computation as ColorConverter::Depth followed by the float to
+  /// uint8_t channel conversion of boost::gil.
+  static uint32_t DepthToLevel(uint32_t depth) {
+    const float normalized = static_cast<float>(depth) / static_cast<float>(DEPTH_RANGE - 1u);
+    return static_cast<uint32_t>(normalized * 255.0f + 0.5f);
+  }
+
+  /// Gray level of ColorConverter::LogarithmicDepth, computed with the
+  /// boost::gil converters themselves.
+  static uint32_t LogarithmicDepthToLevel(uint32_t depth) {
+    using namespace boost::gil;
+    bgra8_pixel_t src;
+    get_color(src, red_t()) = static_cast<uint8_t>(depth & 0xFFu);
+    get_color(src, green_t()) = static_cast<uint8_t>((depth >> 8u) & 0xFFu);
+    get_color(src, blue_t()) = static_cast<uint8_t>((depth >> 16u) & 0xFFu);
+    gray32f_pixel_t intermediate;
+    ColorConverter::Depth()(src, intermediate);
+    gray8_pixel_t dst;
+    ColorConverter::LogarithmicLinear()(intermediate, dst);
+    return dst[0u];
+  }
+
+  /// The logarithmic depth level is a non-decreasing function of the depth,
+  /// so instead of computing a logarithm per pixel we keep, for each level,
+  /// the first depth that reaches it; and find the level of a depth with a
+  /// binary search. Element 0 is always 0.
+  using LevelThresholds = std::array<int32_t, 256u>;
+
+  static const LevelThresholds &GetLogarithmicDepthThresholds() {
+    static const LevelThresholds thresholds = []() {
+      LevelThresholds result;
+      result[0u] = 0;
+      for (uint32_t level = 1u; level < result.size(); ++level) {
+        // Smallest depth with level greater or equal, DEPTH_RANGE if none.
+        uint32_t first = 0u;
+        uint32_t count = DEPTH_RANGE;
+        while (count > 0u) {
+          const uint32_t step = count / 2u;
+          if (LogarithmicDepthToLevel(first + step) < level) {
+            first += step + 1u;
+            count -= step + 1u;
+          } else {
+            count = step;
+          }
+        }
+        result[level] = static_cast<int32_t>(first);
+      }
+      return result;
+    }();
+    return thresholds;
+  }
+
+  static uint32_t FindLevel(const LevelThresholds &thresholds, uint32_t depth) {
+    uint32_t level = 0u;
+    for (uint32_t step = 128u; step > 0u; step /= 2u) {
+      if (static_cast<uint32_t>(thresholds[level + step]) <= depth) {
+        level += step;
+      }
+    }
+    return level;
+  }
+
+  /// BGRA color of each possible tag in the red channel.
+  using PaletteTable = std::array<uint32_t, 256u>;
+
+  static const PaletteTable &GetPaletteTable() {
+    static const PaletteTable table = []() {
+      PaletteTable result;
+      for (uint32_t tag = 0u; tag < result.size(); ++tag) {
+        const auto color = image::CityScapesPalette::GetColor(static_cast<uint8_t>(tag));
+        result[tag] =
+            static_cast<uint32_t>(color[2u]) |
+            (static_cast<uint32_t>(color[1u]) << 8u) |
+            (static_cast<uint32_t>(color[0u]) << 16u) |
+            0xFF000000u;
+      }
+      return result;
+    }();
+    return table;
+  }
+
+  // ===========================================================================
+  // -- Scalar kernels ---------------------------------------------------------
+  // ===========================================================================
+
+  static void DepthScalar(const Color *src, Color *dst, size_t size) {
+    for (size_t i = 0u; i < size; ++i) {
+      StorePixel(dst + i, EncodeGray(DepthToLevel(DecodeDepth(LoadPixel(src + i)))));
+    }
+  }
+
+  static void LogarithmicDepthScalar(const Color *src, Color *dst, size_t size) {
+    const auto &thresholds = GetLogarithmicDepthThresholds();
+    for (size_t i = 0u; i < size; ++i) {
+      const auto depth = DecodeDepth(LoadPixel(src + i));
+      StorePixel(dst + i, EncodeGray(FindLevel(thresholds, depth)));
+    }
+  }
+
+  static void CityScapesPaletteScalar(const Color *src, Color *dst, size_t size) {
+    const auto &table = GetPaletteTable();
+    for (size_t i = 0u; i < size; ++i) {
+      StorePixel(dst + i, table[(LoadPixel(src + i) >> 16u) & 0xFFu]);
+    }
+  }
+
+#ifdef LIBCARLA_IMAGE_WITH_X86_KERNELS
+
+  // ===========================================================================
+  // -- SSE2 kernels -----------------------------------------------------------
+  // ===========================================================================
+
+  // SSE2 is part of x86-64, so no target attribute is needed. The
+  // table-based kernels gain nothing from SSE2 (no gather), they use the
+  // scalar version at this level.
+
+  static __m128i DecodeDepthSSE2(__m128i bgra) {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i r = _mm_and_si128(_mm_srli_epi32(bgra, 16), mask);
+    const __m128i g = _mm_and_si128(bgra, _mm_set1_epi32(0xFF00));
+    const __m128i b = _mm_slli_epi32(_mm_and_si128(bgra, mask), 16);
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+  }
+
+  static __m128i EncodeGraySSE2(__m128i level) {
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    return _mm_or_si128(
+        _mm_or_si128(level, _mm_slli_epi32(level, 8)),
+        _mm_or_si128(_mm_slli_epi32(level, 16), alpha));
+  }
+
+  static void DepthSSE2(const Color *src, Color *dst, size_t size) {
+    const __m128 range = _mm_set1_ps(static_cast<float>(DEPTH_RANGE - 1u));
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t i = 0u;
+    for (; i + 4u <= size; i += 4u) {
+      const __m128i bgra = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+      const __m128 normalized = _mm_div_ps(_mm_cvtepi32_ps(DecodeDepthSSE2(bgra)), range);
+      // Multiply and add separately to match the rounding of the scalar path.
+      const __m128i level = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(normalized, scale), half));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), EncodeGraySSE2(level));
+    }
+    DepthScalar(src + i, dst + i, size - i);
+  }
+
+  // ===========================================================================
+  // -- AVX2 kernels -----------------------------------------------------------
+  // ===========================================================================
+
+  LIBCARLA_TARGET_AVX2
+  static __m256i DecodeDepthAVX2(__m256i bgra) {
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    const __m256i r = _mm256_and_si256(_mm256_srli_epi32(bgra, 16), mask);
+    const __m256i g = _mm256_and_si256(bgra, _mm256_set1_epi32(0xFF00));
+    const __m256i b = _mm256_slli_epi32(_mm256_and_si256(bgra, mask), 16);
+    return _mm256_or_si256(_mm256_or_si256(r, g), b);
+  }
+
+  LIBCARLA_TARGET_AVX2
+  static __m256i EncodeGrayAVX2(__m256i level) {
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+    return _mm256_or_si256(
+        _mm256_or_si256(level, _mm256_slli_epi32(level, 8)),
+        _mm256_or_si256(_mm256_slli_epi32(level, 16), alpha));
+  }
+
+  LIBCARLA_TARGET_AVX2
+  static void DepthAVX2(const Color *src, Color *dst, size_t size) {
+    const __m256 range = _mm256_set1_ps(static_cast<float>(DEPTH_RANGE - 1u));
+    const __m256 scale = _mm256_set1_ps(255.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t i = 0u;
+    for (; i + 8u <= size; i += 8u) {
+      const __m256i bgra = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      const __m256 normalized = _mm256_div_ps(_mm256_cvtepi32_ps(DecodeDepthAVX2(bgra)), range);
+      const __m256i level = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(normalized, scale), half));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), EncodeGrayAVX2(level));
+    }
+    DepthScalar(src + i, dst + i, size - i);
+  }
+
+  LIBCARLA_TARGET_AVX2
+  static void LogarithmicDepthAVX2(const Color *src, Color *dst, size_t size) {
+    const auto &thresholds = GetLogarithmicDepthThresholds();
+    size_t i = 0u;
+    for (; i + 8u <= size; i += 8u) {
+      const __m256i bgra = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      const __m256i depth = DecodeDepthAVX2(bgra);
+      // Branchless binary search, all the values fit in a signed integer.
+      __m256i level = _mm256_setzero_si256();
+      for (int step = 128; step > 0; step /= 2) {
+        const __m256i step_vector = _mm256_set1_epi32(step);
+        const __m256i candidate = _mm256_add_epi32(level, step_vector);
+        const __m256i threshold = _mm256_i32gather_epi32(thresholds.data(), candidate, 4);
+        const __m256i above = _mm256_cmpgt_epi32(threshold, depth);
+        level = _mm256_add_epi32(level, _mm256_andnot_si256(above, step_vector));
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), EncodeGrayAVX2(level));
+    }
+    LogarithmicDepthScalar(src + i, dst + i, size - i);
+  }
+
+  LIBCARLA_TARGET_AVX2
+  static void CityScapesPaletteAVX2(const Color *src, Color *dst, size_t size) {
+    const auto &table = GetPaletteTable();
+    const int *table_data = reinterpret_cast<const int *>(table.data());
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    size_t i = 0u;
+    for (; i + 8u <= size; i += 8u) {
+      const __m256i bgra = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+      const __m256i tag = _mm256_and_si256(_mm256_srli_epi32(bgra, 16), mask);
+      const __m256i color = _mm256_i32gather_epi32(table_data, tag, 4);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), color);
+    }
+    CityScapesPaletteScalar(src + i, dst + i, size - i);
+  }
+
+#endif // LIBCARLA_IMAGE_WITH_X86_KERNELS
+
+  // ===========================================================================
+  // -- ColorConverterKernels --------------------------------------------------
+  // ===========================================================================
+
+  static InstructionSet DetectInstructionSet() {
+#ifdef LIBCARLA_IMAGE_WITH_X86_KERNELS
+#  ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+      __cpuid(info, 1);
+      const bool os_saves_avx = ((info[2] & (1 << 27)) != 0) && ((_xgetbv(0) & 6u) == 6u);
+      __cpuidex(info, 7, 0);
+      const bool has_avx2 = (info[1] & (1 << 5)) != 0;
+      if (os_saves_avx && has_avx2) {
+        return InstructionSet::AVX2;
+      }
+    }
+    return InstructionSet::SSE2;
+#  else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? InstructionSet::AVX2 : InstructionSet::SSE2;
+#  endif // _MSC_VER
+#else
+    return InstructionSet::Scalar;
+#endif // LIBCARLA_IMAGE_WITH_X86_KERNELS
+  }
+
+  InstructionSet ColorConverterKernels::GetSupportedInstructionSet() {
+    static const InstructionSet instruction_set = DetectInstructionSet();
+    return instruction_set;
+  }
+
+  const char *ColorConverterKernels::ToString(InstructionSet instruction_set) {
+    switch (instruction_set) {
+      case InstructionSet::Scalar: return "Scalar";
+      case InstructionSet::SSE2:   return "SSE2";
+      case InstructionSet::AVX2:   return "AVX2";
+      default:                     return "Invalid";
+    }
+  }
+
+  static InstructionSet Select(InstructionSet requested) {
+    return std::min(requested, ColorConverterKernels::GetSupportedInstructionSet());
+  }
+
+  void ColorConverterKernels::Depth(
+      const Color *src,
+      Color *dst,
+      const size_t size,
+      const InstructionSet instruction_set) {
+    switch (Select(instruction_set)) {
+#ifdef LIBCARLA_IMAGE_WITH_X86_KERNELS
+      case InstructionSet::AVX2:
+        return DepthAVX2(src, dst, size);
+      case InstructionSet::SSE2:
+        return DepthSSE2(src, dst, size);
+#endif // LIBCARLA_IMAGE_WITH_X86_KERNELS
+      default:
+        return DepthScalar(src, dst, size);
+    }
+  }
+
+  void ColorConverterKernels::LogarithmicDepth(
+      const Color *src,
+      Color *dst,
+      const size_t size,
+      const InstructionSet instruction_set) {
+    switch (Select(instruction_set)) {
+#ifdef LIBCARLA_IMAGE_WITH_X86_KERNELS
+      case InstructionSet::AVX2:
+        return LogarithmicDepthAVX2(src, dst, size);
+#endif // LIBCARLA_IMAGE_WITH_X86_KERNELS
+      default:
+        return LogarithmicDepthScalar(src, dst, size);
+    }
+  }
+
+  void ColorConverterKernels::CityScapesPalette(
+      const Color *src,
+      Color *dst,
+      const size_t size,
+      const InstructionSet instruction_set) {
+    switch (Select(instruction_set)) {
+#ifdef LIBCARLA_IMAGE_WITH_X86_KERNELS
+      case InstructionSet::AVX2:
+        return CityScapesPaletteAVX2(src, dst, size);
+#endif // LIBCARLA_IMAGE_WITH_X86_KERNELS
+      default:
+        return CityScapesPaletteScalar(src, dst, size);
+    }
+  }
+
+} // namespace image
+} // namespace carla
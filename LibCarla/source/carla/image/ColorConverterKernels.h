@@ -0,0 +1,87 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/sensor/data/Color.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace carla {
+namespace image {
+
+  /// Vectorized versions of the ColorConverter functors for contiguous BGRA
+  /// buffers, as the ones of sensor::data::Image. The output is the same as
+  /// converting in place with ImageConverter::ConvertInPlace, i.e. the
+  /// converted value is written to the BGR channels and alpha is set to 255.
+  ///
+  /// The implementation is selected at runtime based on the instruction sets
+  /// supported by the CPU. Source and destination may be the same buffer.
+  class ColorConverterKernels {
+  public:
+
+    enum class InstructionSet : uint8_t {
+      Scalar,
+      SSE2,
+      AVX2
+    };
+
+    /// Best instruction set supported by this CPU.
+    static InstructionSet GetSupportedInstructionSet();
+
+    static const char *ToString(InstructionSet instruction_set);
+
+    static void Depth(
+        const sensor::data::Color *src,
+        sensor::data::Color *dst,
+        size_t size) {
+      Depth(src, dst, size, GetSupportedInstructionSet());
+    }
+
+    static void LogarithmicDepth(
+        const sensor::data::Color *src,
+        sensor::data::Color *dst,
+        size_t size) {
+      LogarithmicDepth(src, dst, size, GetSupportedInstructionSet());
+    }
+
+    static void CityScapesPalette(
+        const sensor::data::Color *src,
+        sensor::data::Color *dst,
+        size_t size) {
+      CityScapesPalette(src, dst, size, GetSupportedInstructionSet());
+    }
+
+    /// @name Explicit instruction set
+    ///
+    /// Run the kernels with a given instruction set, falls back to the best
+    /// supported one if @a instruction_set is not supported by this CPU.
+    /// @{
+
+    static void Depth(
+        const sensor::data::Color *src,
+        sensor::data::Color *dst,
+        size_t size,
+        InstructionSet instruction_set);
+
+    static void LogarithmicDepth(
+        const sensor::data::Color *src,
+        sensor::data::Color *dst,
+        size_t size,
+        InstructionSet instruction_set);
+
+    static void CityScapesPalette(
+        const sensor::data::Color *src,
+        sensor::data::Color *dst,
+        size_t size,
+        InstructionSet instruction_set);
+
+    /// @}
+  };
+
+} // namespace image
+} // namespace carla
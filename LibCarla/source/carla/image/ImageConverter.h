@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "carla/image/ColorConverterKernels.h"
 #include "carla/image/ImageView.h"
 
 namespace carla {
@@ -28,6 +29,32 @@ namespace image {
           ImageView::MakeColorConvertedView<MutableImageView, DstPixelT>(image_view, converter),
           image_view);
     }
+
+    /// @name Sensor images
+    ///
+    /// Convert in place the BGRA buffer of a sensor image with the
+    /// vectorized ColorConverterKernels, same result as converting its view.
+    /// @{
+
+    static void ConvertInPlace(
+        sensor::data::ImageTmpl<sensor::data::Color> &image,
+        ColorConverter::Depth) {
+      ColorConverterKernels::Depth(image.data(), image.data(), image.size());
+    }
+
+    static void ConvertInPlace(
+        sensor::data::ImageTmpl<sensor::data::Color> &image,
+        ColorConverter::LogarithmicDepth) {
+      ColorConverterKernels::LogarithmicDepth(image.data(), image.data(), image.size());
+    }
+
+    static void ConvertInPlace(
+        sensor::data::ImageTmpl<sensor::data::Color> &image,
+        ColorConverter::CityScapesPalette) {
+      ColorConverterKernels::CityScapesPalette(image.data(), image.data(), image.size());
+    }
+
+    /// @}
   };
 
 } // namespace image
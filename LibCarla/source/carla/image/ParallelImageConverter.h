@@ -0,0 +1,124 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+#include "carla/image/ImageConverter.h"
+
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace carla {
+namespace image {
+
+  /// Converts images splitting them in tiles of rows, processed in parallel
+  /// by a ThreadPool. The calling thread converts one of the tiles too, and
+  /// the conversion functions block until all the tiles are done.
+  class ParallelImageConverter : private NonCopyable {
+  public:
+
+    /// Rows per tile below which splitting is not worth it.
+    static constexpr size_t MIN_ROWS_PER_TILE = 16u;
+
+    /// Launch @a worker_threads threads, or one per hardware thread if zero.
+    explicit ParallelImageConverter(size_t worker_threads = 0u)
+      : _worker_threads(
+            worker_threads > 0u ?
+                worker_threads :
+                std::max<size_t>(std::thread::hardware_concurrency(), 1u)) {
+      _pool.AsyncRun(_worker_threads);
+    }
+
+    size_t GetWorkerThreads() const {
+      return _worker_threads;
+    }
+
+    /// Convert in place the BGRA buffer of a sensor image, each tile with
+    /// the vectorized ColorConverterKernels.
+    template <typename ColorConverter>
+    void ConvertInPlace(
+        sensor::data::ImageTmpl<sensor::data::Color> &image,
+        ColorConverter converter = ColorConverter()) {
+      const size_t width = image.GetWidth();
+      auto *data = image.data();
+      ForEachTile(image.GetHeight(), [=](size_t begin, size_t end) {
+        ConvertRange(data + begin * width, (end - begin) * width, converter);
+      });
+    }
+
+    /// Copy @a src into @a dst (e.g. a color converted view into an image),
+    /// both views must have the same dimensions.
+    template <typename SrcViewT, typename DstViewT>
+    void CopyPixels(const SrcViewT &src, const DstViewT &dst) {
+      DEBUG_ASSERT(src.dimensions() == dst.dimensions());
+      const auto width = src.width();
+      ForEachTile(static_cast<size_t>(src.height()), [&](size_t begin, size_t end) {
+        const auto y = static_cast<std::ptrdiff_t>(begin);
+        const auto height = static_cast<std::ptrdiff_t>(end - begin);
+        auto dst_tile = boost::gil::subimage_view(dst, 0, y, width, height);
+        ImageConverter::CopyPixels(boost::gil::subimage_view(src, 0, y, width, height), dst_tile);
+      });
+    }
+
+    /// Call @a functor(begin, end) for consecutive ranges of rows covering
+    /// [0, @a rows) in parallel. Exceptions thrown by @a functor are
+    /// rethrown here once all the tiles finish.
+    template <typename FunctorT>
+    void ForEachTile(size_t rows, FunctorT &&functor) {
+      const size_t number_of_tiles = std::max<size_t>(
+          1u,
+          std::min(_worker_threads + 1u, rows / MIN_ROWS_PER_TILE));
+      const size_t rows_per_tile = (rows + number_of_tiles - 1u) / number_of_tiles;
+      std::vector<std::future<void>> futures;
+      futures.reserve(number_of_tiles);
+      for (size_t begin = rows_per_tile; begin < rows; begin += rows_per_tile) {
+        const size_t end = std::min(begin + rows_per_tile, rows);
+        futures.emplace_back(_pool.Post([&functor, begin, end]() { functor(begin, end); }));
+      }
+      std::exception_ptr exception;
+      try {
+        functor(0u, std::min(rows_per_tile, rows));
+      } catch (...) {
+        exception = std::current_exception();
+      }
+      // Wait for every tile before leaving, they reference the functor.
+      for (auto &future : futures) {
+        try {
+          future.get();
+        } catch (...) {
+          exception = std::current_exception();
+        }
+      }
+      if (exception) {
+        std::rethrow_exception(exception);
+      }
+    }
+
+  private:
+
+    static void ConvertRange(sensor::data::Color *data, size_t size, ColorConverter::Depth) {
+      ColorConverterKernels::Depth(data, data, size);
+    }
+
+    static void ConvertRange(sensor::data::Color *data, size_t size, ColorConverter::LogarithmicDepth) {
+      ColorConverterKernels::LogarithmicDepth(data, data, size);
+    }
+
+    static void ConvertRange(sensor::data::Color *data, size_t size, ColorConverter::CityScapesPalette) {
+      ColorConverterKernels::CityScapesPalette(data, data, size);
+    }
+
+    const size_t _worker_threads;
+
+    ThreadPool _pool;
+  };
+
+} // namespace image
+} // namespace carla
@@ -0,0 +1,567 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/pointcloud/PointCloudFilter.h"
+
+#include "carla/Debug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <limits>
+#include <numeric>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define LIBCARLA_POINTCLOUD_WITH_SSE2
+#  include <emmintrin.h>
+#endif
+
+namespace carla {
+namespace pointcloud {
+
+  using Point = PointCloudFilter::Point;
+
+  // ===========================================================================
+  // -- Crop kernels -----------------------------------------------------------
+  // ===========================================================================
+
+  /// Axis-aligned box, points on the faces are inside.
+  struct BoxTest {
+    Point min;
+    Point max;
+
+    bool operator()(const Point &point) const {
+      return
+          (min.x <= point.x) && (point.x <= max.x) &&
+          (min.y <= point.y) && (point.y <= max.y) &&
+          (min.z <= point.z) && (point.z <= max.z);
+    }
+  };
+
+  /// Sphere, points on the surface are inside.
+  struct SphereTest {
+    Point center;
+    float squared_radius;
+
+    bool operator()(const Point &point) const {
+      const float dx = point.x - center.x;
+      const float dy = point.y - center.y;
+      const float dz = point.z - center.z;
+      return (dx * dx + dy * dy + dz * dz) <= squared_radius;
+    }
+  };
+
+  /// Append to @a indices the points in [begin, end) for which @a test is
+  /// different than @a negative, in increasing order.
+  template <typename TestT>
+  static void CropScalar(
+      const Point *points,
+      size_t begin,
+      size_t end,
+      const TestT &test,
+      bool negative,
+      std::vector<uint32_t> &indices) {
+    for (size_t i = begin; i < end; ++i) {
+      if (test(points[i]) != negative) {
+        indices.emplace_back(static_cast<uint32_t>(i));
+      }
+    }
+  }
+
+#ifdef LIBCARLA_POINTCLOUD_WITH_SSE2
+
+  // SSE2 is part of x86-64, so no target attribute or runtime dispatch is
+  // needed. Four points are loaded at once as three registers and
+  // transposed to x, y and z registers.
+
+  struct PointsSSE2 {
+    __m128 x;
+    __m128 y;
+    __m128 z;
+  };
+
+  static PointsSSE2 LoadPointsSSE2(const Point *points) {
+    const float *data = &points->x;
+    const __m128 m0 = _mm_loadu_ps(data);       // x0 y0 z0 x1
+    const __m128 m1 = _mm_loadu_ps(data + 4);   // y1 z1 x2 y2
+    const __m128 m2 = _mm_loadu_ps(data + 8);   // z2 x3 y3 z3
+    const __m128 x23 = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(0, 1, 0, 2));
+    const __m128 y01 = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(0, 0, 0, 1));
+    const __m128 y23 = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(0, 2, 0, 3));
+    const __m128 z01 = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(0, 1, 0, 2));
+    return {
+        _mm_shuffle_ps(m0, x23, _MM_SHUFFLE(2, 0, 3, 0)),
+        _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0)),
+        _mm_shuffle_ps(z01, m2, _MM_SHUFFLE(3, 0, 2, 0))};
+  }
+
+  static int TestSSE2(const PointsSSE2 &p, const BoxTest &test) {
+    const __m128 x = _mm_and_ps(
+        _mm_cmple_ps(_mm_set1_ps(test.min.x), p.x),
+        _mm_cmple_ps(p.x, _mm_set1_ps(test.max.x)));
+    const __m128 y = _mm_and_ps(
+        _mm_cmple_ps(_mm_set1_ps(test.min.y), p.y),
+        _mm_cmple_ps(p.y, _mm_set1_ps(test.max.y)));
+    const __m128 z = _mm_and_ps(
+        _mm_cmple_ps(_mm_set1_ps(test.min.z), p.z),
+        _mm_cmple_ps(p.z, _mm_set1_ps(test.max.z)));
+    return _mm_movemask_ps(_mm_and_ps(_mm_and_ps(x, y), z));
+  }
+
+  static int TestSSE2(const PointsSSE2 &p, const SphereTest &test) {
+    const __m128 dx = _mm_sub_ps(p.x, _mm_set1_ps(test.center.x));
+    const __m128 dy = _mm_sub_ps(p.y, _mm_set1_ps(test.center.y));
+    const __m128 dz = _mm_sub_ps(p.z, _mm_set1_ps(test.center.z));
+    const __m128 squared_distance = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+        _mm_mul_ps(dz, dz));
+    return _mm_movemask_ps(_mm_cmple_ps(squared_distance, _mm_set1_ps(test.squared_radius)));
+  }
+
+  template <typename TestT>
+  static void Crop(
+      const Point *points,
+      size_t begin,
+      size_t end,
+      const TestT &test,
+      bool negative,
+      std::vector<uint32_t> &indices) {
+    const int flip = negative ? 0xF : 0x0;
+    // Write directly to the storage, at most every point is selected.
+    const size_t offset = indices.size();
+    indices.resize(offset + end - begin);
+    uint32_t *output = indices.data() + offset;
+    size_t i = begin;
+    for (; i + 4u <= end; i += 4u) {
+      const int mask = TestSSE2(LoadPointsSSE2(points + i), test) ^ flip;
+      for (uint32_t j = 0u; j < 4u; ++j) {
+        *output = static_cast<uint32_t>(i) + j;
+        output += (mask >> j) & 1;
+      }
+    }
+    indices.resize(static_cast<size_t>(output - indices.data()));
+    CropScalar(points, i, end, test, negative, indices);
+  }
+
+#else
+
+  template <typename TestT>
+  static void Crop(
+      const Point *points,
+      size_t begin,
+      size_t end,
+      const TestT &test,
+      bool negative,
+      std::vector<uint32_t> &indices) {
+    CropScalar(points, begin, end, test, negative, indices);
+  }
+
+#endif // LIBCARLA_POINTCLOUD_WITH_SSE2
+
+  // ===========================================================================
+  // -- Voxel grid -------------------------------------------------------------
+  // ===========================================================================
+
+  /// Hash table of voxels with open addressing, keeping the sum of the
+  /// points of each voxel in the order they were first seen.
+  class VoxelGrid {
+  public:
+
+    struct Voxel {
+      uint64_t key;
+      double x;
+      double y;
+      double z;
+      uint32_t count;
+    };
+
+    VoxelGrid() {
+      Rehash(INITIAL_CAPACITY);
+    }
+
+    /// Key of the voxel containing @a point, each coordinate of the voxel is
+    /// clamped to 21 bits.
+    static uint64_t MakeKey(const Point &point, float inverse_voxel_size) {
+      return
+          (ToGrid(point.x * inverse_voxel_size) << 42u) |
+          (ToGrid(point.y * inverse_voxel_size) << 21u) |
+          ToGrid(point.z * inverse_voxel_size);
+    }
+
+    void Add(uint64_t key, double x, double y, double z, uint32_t count) {
+      auto &voxel = Find(key);
+      voxel.x += x;
+      voxel.y += y;
+      voxel.z += z;
+      voxel.count += count;
+    }
+
+    void Add(const Point &point, float inverse_voxel_size) {
+      Add(MakeKey(point, inverse_voxel_size), point.x, point.y, point.z, 1u);
+    }
+
+    const std::vector<Voxel> &GetVoxels() const {
+      return _voxels;
+    }
+
+  private:
+
+    static constexpr size_t INITIAL_CAPACITY = 4096u;
+
+    /// The key is kept in the slot so probing does not touch the voxels.
+    struct Slot {
+      uint64_t key;
+      uint32_t index;
+    };
+
+    static constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+
+    static uint64_t ToGrid(float value) {
+      constexpr float limit = static_cast<float>(1 << 20);
+      // NaN goes to the voxel of the origin.
+      const float cell = std::isnan(value) ? 0.0f : std::floor(value);
+      const float clamped = std::max(-limit, std::min(cell, limit - 1.0f));
+      return static_cast<uint64_t>(static_cast<int64_t>(clamped) + (1 << 20));
+    }
+
+    size_t Hash(uint64_t key) const {
+      return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> _shift);
+    }
+
+    Voxel &Find(uint64_t key) {
+      const size_t mask = _slots.size() - 1u;
+      for (size_t i = Hash(key); _slots[i].index != EMPTY; i = (i + 1u) & mask) {
+        if (_slots[i].key == key) {
+          return _voxels[_slots[i].index];
+        }
+      }
+      _voxels.push_back(Voxel{key, 0.0, 0.0, 0.0, 0u});
+      // Keep the load factor below one half.
+      if (2u * _voxels.size() > _slots.size()) {
+        Rehash(2u * _slots.size());
+      } else {
+        Insert(key, static_cast<uint32_t>(_voxels.size() - 1u));
+      }
+      return _voxels.back();
+    }
+
+    void Insert(uint64_t key, uint32_t index) {
+      const size_t mask = _slots.size() - 1u;
+      size_t i = Hash(key);
+      while (_slots[i].index != EMPTY) {
+        i = (i + 1u) & mask;
+      }
+      _slots[i] = Slot{key, index};
+    }
+
+    void Rehash(size_t capacity) {
+      DEBUG_ASSERT((capacity & (capacity - 1u)) == 0u);
+      _slots.assign(capacity, Slot{0u, EMPTY});
+      _shift = 64u;
+      for (size_t i = capacity; i > 1u; i /= 2u) {
+        --_shift;
+      }
+      for (size_t i = 0u; i < _voxels.size(); ++i) {
+        Insert(_voxels[i].key, static_cast<uint32_t>(i));
+      }
+    }
+
+    std::vector<Slot> _slots;
+
+    std::vector<Voxel> _voxels;
+
+    uint32_t _shift;
+  };
+
+  // ===========================================================================
+  // -- Range image ------------------------------------------------------------
+  // ===========================================================================
+
+  static constexpr float PI = 3.14159265358979323846f;
+
+  /// Coefficients of the polynomial approximation of atan(a) / a in [0, 1],
+  /// in powers of a^2 from the highest.
+  static constexpr float ATAN_COEFFICIENTS[] = {
+      -0.0117212f, 0.05265332f, -0.11643287f, 0.19354346f, -0.33262347f, 0.99997726f};
+
+  /// Approximation of atan2 with an error below 1e-5 radians; much faster
+  /// than std::atan2 and precise enough to pick the column of a range image.
+  static float FastAtan2(float y, float x) {
+    const float abs_x = std::abs(x);
+    const float abs_y = std::abs(y);
+    const float max = std::max(abs_x, abs_y);
+    const float a = max > 0.0f ? std::min(abs_x, abs_y) / max : 0.0f;
+    const float s = a * a;
+    float r = ATAN_COEFFICIENTS[0u];
+    for (auto i = 1u; i < 6u; ++i) {
+      r = r * s + ATAN_COEFFICIENTS[i];
+    }
+    r *= a;
+    r = abs_y > abs_x ? 0.5f * PI - r : r;
+    r = x < 0.0f ? PI - r : r;
+    return y < 0.0f ? -r : r;
+  }
+
+  /// Keep the closest range of each pixel, zero is an empty pixel.
+  static void UpdatePixel(float *pixels, size_t width, float column, float range) {
+    if (!(column >= 0.0f)) {
+      return; // NaN.
+    }
+    const size_t x = std::min(static_cast<size_t>(column), width - 1u);
+    const float previous = pixels[x];
+    pixels[x] = ((previous == 0.0f) || (range < previous)) ? range : previous;
+  }
+
+  static void ProjectScalar(
+      const Point *points,
+      size_t begin,
+      size_t end,
+      float columns_per_radian,
+      float *pixels,
+      size_t width) {
+    for (size_t i = begin; i < end; ++i) {
+      const auto &point = points[i];
+      const float range = std::sqrt(point.x * point.x + point.y * point.y + point.z * point.z);
+      const float column = (FastAtan2(point.y, point.x) + PI) * columns_per_radian;
+      UpdatePixel(pixels, width, column, range);
+    }
+  }
+
+#ifdef LIBCARLA_POINTCLOUD_WITH_SSE2
+
+  static __m128 SelectSSE2(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+  }
+
+  /// Same operations as FastAtan2, without the branches the compiler emits
+  /// for the unpredictable quadrant of each point.
+  static __m128 FastAtan2SSE2(__m128 y, __m128 x) {
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 abs_x = _mm_andnot_ps(sign, x);
+    const __m128 abs_y = _mm_andnot_ps(sign, y);
+    const __m128 max = _mm_max_ps(abs_x, abs_y);
+    const __m128 a = SelectSSE2(
+        _mm_cmpgt_ps(max, zero),
+        _mm_div_ps(_mm_min_ps(abs_x, abs_y), max),
+        zero);
+    const __m128 s = _mm_mul_ps(a, a);
+    __m128 r = _mm_set1_ps(ATAN_COEFFICIENTS[0u]);
+    for (auto i = 1u; i < 6u; ++i) {
+      r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(ATAN_COEFFICIENTS[i]));
+    }
+    r = _mm_mul_ps(r, a);
+    r = SelectSSE2(_mm_cmpgt_ps(abs_y, abs_x), _mm_sub_ps(_mm_set1_ps(0.5f * PI), r), r);
+    r = SelectSSE2(_mm_cmplt_ps(x, zero), _mm_sub_ps(_mm_set1_ps(PI), r), r);
+    return _mm_xor_ps(r, _mm_and_ps(_mm_cmplt_ps(y, zero), sign));
+  }
+
+  static void Project(
+      const Point *points,
+      size_t begin,
+      size_t end,
+      float columns_per_radian,
+      float *pixels,
+      size_t width) {
+    alignas(16) float columns[4u];
+    alignas(16) float ranges[4u];
+    size_t i = begin;
+    for (; i + 4u <= end; i += 4u) {
+      const auto p = LoadPointsSSE2(points + i);
+      const __m128 squared_range = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(p.x, p.x), _mm_mul_ps(p.y, p.y)),
+          _mm_mul_ps(p.z, p.z));
+      _mm_store_ps(ranges, _mm_sqrt_ps(squared_range));
+      _mm_store_ps(columns, _mm_mul_ps(
+          _mm_add_ps(FastAtan2SSE2(p.y, p.x), _mm_set1_ps(PI)),
+          _mm_set1_ps(columns_per_radian)));
+      for (auto j = 0u; j < 4u; ++j) {
+        UpdatePixel(pixels, width, columns[j], ranges[j]);
+      }
+    }
+    ProjectScalar(points, i, end, columns_per_radian, pixels, width);
+  }
+
+#else
+
+  static void Project(
+      const Point *points,
+      size_t begin,
+      size_t end,
+      float columns_per_radian,
+      float *pixels,
+      size_t width) {
+    ProjectScalar(points, begin, end, columns_per_radian, pixels, width);
+  }
+
+#endif // LIBCARLA_POINTCLOUD_WITH_SSE2
+
+  // ===========================================================================
+  // -- PointCloudFilter -------------------------------------------------------
+  // ===========================================================================
+
+  PointCloudFilter::PointCloudFilter(size_t worker_threads)
+    : _worker_threads(worker_threads) {
+    if (_worker_threads > 0u) {
+      _pool = std::make_unique<ThreadPool>();
+      _pool->AsyncRun(_worker_threads);
+    }
+  }
+
+  PointCloudFilter::~PointCloudFilter() = default;
+
+  template <typename FunctorT>
+  size_t PointCloudFilter::ForEachChunk(size_t size, size_t min_chunk_size, FunctorT &&functor) {
+    const size_t number_of_chunks = std::max<size_t>(
+        1u,
+        std::min(_worker_threads + 1u, size / std::max<size_t>(min_chunk_size, 1u)));
+    const size_t chunk_size = (size + number_of_chunks - 1u) / number_of_chunks;
+    std::vector<std::future<void>> futures;
+    futures.reserve(number_of_chunks);
+    size_t chunk = 1u;
+    for (size_t begin = chunk_size; begin < size; begin += chunk_size, ++chunk) {
+      const size_t end = std::min(begin + chunk_size, size);
+      futures.emplace_back(_pool->Post([&functor, chunk, begin, end]() { functor(chunk, begin, end); }));
+    }
+    std::exception_ptr exception;
+    try {
+      functor(0u, 0u, std::min(chunk_size, size));
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    // Wait for every chunk before leaving, they reference the functor.
+    for (auto &future : futures) {
+      try {
+        future.get();
+      } catch (...) {
+        exception = std::current_exception();
+      }
+    }
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+    return number_of_chunks;
+  }
+
+  /// Join the indices found by each chunk, in order.
+  static std::vector<uint32_t> Concatenate(std::vector<std::vector<uint32_t>> &chunks) {
+    if (chunks.size() == 1u) {
+      return std::move(chunks.front());
+    }
+    std::vector<uint32_t> result;
+    result.reserve(std::accumulate(chunks.begin(), chunks.end(), size_t(0u), [](size_t sum, const auto &chunk) {
+      return sum + chunk.size();
+    }));
+    for (auto &chunk : chunks) {
+      result.insert(result.end(), chunk.begin(), chunk.end());
+    }
+    return result;
+  }
+
+  std::vector<uint32_t> PointCloudFilter::CropBox(
+      const Point *begin,
+      const Point *end,
+      const Point &min,
+      const Point &max,
+      const bool negative) {
+    DEBUG_ASSERT(begin <= end);
+    const BoxTest test{min, max};
+    std::vector<std::vector<uint32_t>> chunks(_worker_threads + 1u);
+    const auto number_of_chunks = ForEachChunk(
+        static_cast<size_t>(end - begin),
+        MIN_POINTS_PER_CHUNK,
+        [&](size_t chunk, size_t first, size_t last) {
+          Crop(begin, first, last, test, negative, chunks[chunk]);
+        });
+    chunks.resize(number_of_chunks);
+    return Concatenate(chunks);
+  }
+
+  std::vector<uint32_t> PointCloudFilter::CropRadius(
+      const Point *begin,
+      const Point *end,
+      const Point &center,
+      const float radius,
+      const bool negative) {
+    DEBUG_ASSERT(begin <= end);
+    const SphereTest test{center, radius * radius};
+    std::vector<std::vector<uint32_t>> chunks(_worker_threads + 1u);
+    const auto number_of_chunks = ForEachChunk(
+        static_cast<size_t>(end - begin),
+        MIN_POINTS_PER_CHUNK,
+        [&](size_t chunk, size_t first, size_t last) {
+          Crop(begin, first, last, test, negative, chunks[chunk]);
+        });
+    chunks.resize(number_of_chunks);
+    return Concatenate(chunks);
+  }
+
+  std::vector<Point> PointCloudFilter::VoxelDownsample(
+      const Point *begin,
+      const Point *end,
+      const float voxel_size) {
+    DEBUG_ASSERT(begin <= end);
+    DEBUG_ASSERT(voxel_size > 0.0f);
+    const float inverse_voxel_size = 1.0f / voxel_size;
+    const auto size = static_cast<size_t>(end - begin);
+    // Each chunk fills its own grid, then the grids are merged in order so
+    // the voxels keep the order of their first point.
+    std::vector<std::unique_ptr<VoxelGrid>> grids(_worker_threads + 1u);
+    const auto number_of_chunks = ForEachChunk(size, MIN_POINTS_PER_CHUNK, [&](size_t chunk, size_t first, size_t last) {
+      auto grid = std::make_unique<VoxelGrid>();
+      for (size_t i = first; i < last; ++i) {
+        grid->Add(begin[i], inverse_voxel_size);
+      }
+      grids[chunk] = std::move(grid);
+    });
+    for (size_t i = 1u; i < number_of_chunks; ++i) {
+      for (auto &voxel : grids[i]->GetVoxels()) {
+        grids[0u]->Add(voxel.key, voxel.x, voxel.y, voxel.z, voxel.count);
+      }
+    }
+    std::vector<Point> result;
+    if (grids[0u] != nullptr) {
+      const auto &voxels = grids[0u]->GetVoxels();
+      result.reserve(voxels.size());
+      for (auto &voxel : voxels) {
+        const double count = voxel.count;
+        result.emplace_back(
+            static_cast<float>(voxel.x / count),
+            static_cast<float>(voxel.y / count),
+            static_cast<float>(voxel.z / count));
+      }
+    }
+    return result;
+  }
+
+  std::vector<float> PointCloudFilter::ProjectToRangeImage(
+      const Point *begin,
+      const Point *end,
+      const std::vector<uint32_t> &points_per_channel,
+      const size_t width) {
+    DEBUG_ASSERT(begin <= end);
+    DEBUG_ASSERT(width > 0u);
+    const auto size = static_cast<size_t>(end - begin);
+    const size_t height = points_per_channel.size();
+    DEBUG_ASSERT(std::accumulate(points_per_channel.begin(), points_per_channel.end(), size_t(0u)) == size);
+    std::vector<size_t> offsets(height + 1u, 0u);
+    std::partial_sum(points_per_channel.begin(), points_per_channel.end(), offsets.begin() + 1);
+    std::vector<float> image(height * width, 0.0f);
+    const float columns_per_radian = static_cast<float>(width) / (2.0f * PI);
+    // Each chunk writes its own rows.
+    const size_t min_rows = (size == 0u) ? height :
+        (MIN_POINTS_PER_CHUNK * height + size - 1u) / size;
+    ForEachChunk(height, min_rows, [&](size_t, size_t first_row, size_t last_row) {
+      for (size_t row = first_row; row < last_row; ++row) {
+        Project(begin, offsets[row], offsets[row + 1u], columns_per_radian, image.data() + row * width, width);
+      }
+    });
+    return image;
+  }
+
+} // namespace pointcloud
+} // namespace carla
@@ -0,0 +1,111 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+#include "carla/geom/Location.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace carla {
+namespace pointcloud {
+
+  /// Crop, downsample and project point clouds stored contiguously as three
+  /// floats per point, e.g. the array of a sensor::data::LidarMeasurement.
+  ///
+  /// Large clouds are split in chunks processed in parallel by a ThreadPool,
+  /// the calling thread processes one of the chunks too. The result does not
+  /// depend on the number of threads; except for the centroids of the voxels,
+  /// that may differ in the last bits due to the order of the sums.
+  class PointCloudFilter : private NonCopyable {
+  public:
+
+    using Point = geom::Location;
+
+    static_assert(sizeof(Point) == 3u * sizeof(float), "Invalid point size");
+
+    /// Points per chunk below which splitting is not worth it.
+    static constexpr size_t MIN_POINTS_PER_CHUNK = 16384u;
+
+    /// Launch @a worker_threads threads, if zero everything runs in the
+    /// calling thread.
+    explicit PointCloudFilter(size_t worker_threads = 0u);
+
+    ~PointCloudFilter();
+
+    size_t GetWorkerThreads() const {
+      return _worker_threads;
+    }
+
+    /// Indices, in increasing order, of the points inside the axis-aligned
+    /// box [@a min, @a max]; or outside if @a negative.
+    std::vector<uint32_t> CropBox(
+        const Point *begin,
+        const Point *end,
+        const Point &min,
+        const Point &max,
+        bool negative = false);
+
+    /// Indices, in increasing order, of the points at a distance less or
+    /// equal than @a radius from @a center; or further if @a negative.
+    std::vector<uint32_t> CropRadius(
+        const Point *begin,
+        const Point *end,
+        const Point &center,
+        float radius,
+        bool negative = false);
+
+    /// Replace the points falling in each cube of side @a voxel_size by their
+    /// centroid. Voxels are returned in the order of their first point.
+    /// Points further than 2^20 voxels from the origin are clamped to the
+    /// outermost voxels.
+    std::vector<Point> VoxelDownsample(
+        const Point *begin,
+        const Point *end,
+        float voxel_size);
+
+    /// Project the points of a Lidar measurement to a range image of
+    /// points_per_channel.size() rows and @a width columns, row-major.
+    ///
+    /// Each row is a channel, the points must be sorted by channel as in a
+    /// LidarMeasurement. The column is given by the azimuth, atan2(y, x),
+    /// increasing from -pi at column zero. Each pixel holds the distance to
+    /// the closest point projected to it, or zero if none.
+    std::vector<float> ProjectToRangeImage(
+        const Point *begin,
+        const Point *end,
+        const std::vector<uint32_t> &points_per_channel,
+        size_t width);
+
+    /// Copy the points at @a indices.
+    static std::vector<Point> Gather(const Point *begin, const std::vector<uint32_t> &indices) {
+      std::vector<Point> result;
+      result.reserve(indices.size());
+      for (auto index : indices) {
+        result.emplace_back(begin[index]);
+      }
+      return result;
+    }
+
+  private:
+
+    /// Call @a functor(chunk, begin, end) for consecutive ranges covering
+    /// [0, @a size) in parallel, and return the number of chunks. Chunks
+    /// have at least @a min_chunk_size elements, except if there is only one.
+    template <typename FunctorT>
+    size_t ForEachChunk(size_t size, size_t min_chunk_size, FunctorT &&functor);
+
+    const size_t _worker_threads;
+
+    std::unique_ptr<ThreadPool> _pool;
+  };
+
+} // namespace pointcloud
+} // namespace carla
@@ -6,8 +6,14 @@
 
 #include "carla/pointcloud/PointCloudIO.h"
 
+#include <boost/predef/other/endian.h>
+
 #include <iomanip>
 
+#if !BOOST_ENDIAN_LITTLE_BYTE
+#  error "binary point cloud formats assume a little endian platform"
+#endif
+
 namespace carla {
 namespace pointcloud {
 
@@ -25,5 +31,56 @@ namespace pointcloud {
     out << std::fixed << std::setprecision(4u);
   }
 
+  void PointCloudIO::WriteHeader(
+      std::ostream &out,
+      const size_t number_of_points,
+      const Format format,
+      const bool with_ring) {
+    switch (format) {
+      case Format::PlyAscii:
+        WriteHeader(out, number_of_points);
+        break;
+      case Format::PlyBinary:
+        out << "ply\n"
+               "format binary_little_endian 1.0\n"
+               "element vertex " << std::to_string(number_of_points) << "\n"
+               "property float32 x\n"
+               "property float32 y\n"
+               "property float32 z\n";
+        if (with_ring) {
+          out << "property uint16 ring\n";
+        }
+        out << "end_header\n";
+        break;
+      case Format::PcdBinary:
+        out << "# .PCD v0.7 - Point Cloud Data file format\n"
+               "VERSION 0.7\n"
+            << (with_ring ? "FIELDS x y z ring\n" : "FIELDS x y z\n")
+            << (with_ring ? "SIZE 4 4 4 2\n" : "SIZE 4 4 4\n")
+            << (with_ring ? "TYPE F F F U\n" : "TYPE F F F\n")
+            << (with_ring ? "COUNT 1 1 1 1\n" : "COUNT 1 1 1\n")
+            << "WIDTH " << std::to_string(number_of_points) << "\n"
+               "HEIGHT 1\n"
+               "VIEWPOINT 0 0 0 1 0 0 0\n"
+               "POINTS " << std::to_string(number_of_points) << "\n"
+               "DATA binary\n";
+        break;
+      case Format::KittiBin:
+        // No header.
+        break;
+    }
+  }
+
+  const char *PointCloudIO::GetDefaultExtension(const Format format) {
+    switch (format) {
+      case Format::PcdBinary:
+        return ".pcd";
+      case Format::KittiBin:
+        return ".bin";
+      default:
+        return ".ply";
+    }
+  }
+
 } // namespace pointcloud
 } // namespace carla
@@ -6,10 +6,19 @@
 
 #pragma once
 
+#include "carla/Debug.h"
 #include "carla/FileSystem.h"
+#include "carla/geom/Vector3D.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
 namespace carla {
 namespace pointcloud {
@@ -17,6 +26,18 @@ namespace pointcloud {
   class PointCloudIO {
   public:
 
+    enum class Format : uint8_t {
+      /// PLY with a line of text per point.
+      PlyAscii,
+      /// PLY with binary_little_endian float32 coordinates.
+      PlyBinary,
+      /// PCD (Point Cloud Library) with binary data.
+      PcdBinary,
+      /// Raw float32 x, y, z, intensity per point, as in the KITTI dataset.
+      /// Intensity is zero if not given.
+      KittiBin
+    };
+
     template <typename PointIt>
     static void Dump(std::ostream &out, PointIt begin, PointIt end) {
       DEBUG_ASSERT(std::distance(begin, end) >= 0);
@@ -26,6 +47,45 @@ namespace pointcloud {
       }
     }
 
+    /// Write the points in @a format. If @a points_per_channel is not empty,
+    /// binary PLY and PCD files get an extra "ring" property with the channel
+    /// of each point; the points must be sorted by channel, as in a
+    /// LidarMeasurement. If @a intensity is not empty, KITTI files get the
+    /// intensity of each point, in the same order as the points.
+    template <typename PointIt>
+    static void Dump(
+        std::ostream &out,
+        PointIt begin,
+        PointIt end,
+        Format format,
+        const std::vector<uint32_t> &points_per_channel = {},
+        const std::vector<float> &intensity = {}) {
+      if (format == Format::PlyAscii) {
+        Dump(out, begin, end);
+        return;
+      }
+      DEBUG_ASSERT(std::distance(begin, end) >= 0);
+      const auto number_of_points = static_cast<size_t>(std::distance(begin, end));
+      DEBUG_ASSERT(
+          points_per_channel.empty() ||
+          (std::accumulate(points_per_channel.begin(), points_per_channel.end(), size_t(0u)) == number_of_points));
+      DEBUG_ASSERT(intensity.empty() || (intensity.size() == number_of_points));
+      const bool with_ring = (format != Format::KittiBin) && !points_per_channel.empty();
+      WriteHeader(out, number_of_points, format, with_ring);
+      if (format == Format::KittiBin) {
+        auto next_intensity = intensity.begin();
+        WriteRecords(out, begin, end, [&](const auto &point, unsigned char *record) {
+          const float value = intensity.empty() ? 0.0f : *next_intensity++;
+          const std::array<float, 4u> values = {point.x, point.y, point.z, value};
+          std::memcpy(record, values.data(), sizeof(values));
+        }, 4u * sizeof(float));
+      } else if (with_ring) {
+        WriteRecordsWithRing(out, begin, points_per_channel);
+      } else {
+        WriteCoordinates(out, begin, end);
+      }
+    }
+
     template <typename PointIt>
     static std::string SaveToDisk(std::string path, PointIt begin, PointIt end) {
       FileSystem::ValidateFilePath(path, ".ply");
@@ -34,9 +94,89 @@ namespace pointcloud {
       return path;
     }
 
+    template <typename PointIt>
+    static std::string SaveToDisk(
+        std::string path,
+        PointIt begin,
+        PointIt end,
+        Format format,
+        const std::vector<uint32_t> &points_per_channel = {},
+        const std::vector<float> &intensity = {}) {
+      if (format == Format::PlyAscii) {
+        return SaveToDisk(std::move(path), begin, end);
+      }
+      FileSystem::ValidateFilePath(path, GetDefaultExtension(format));
+      std::ofstream out(path, std::ios::binary);
+      Dump(out, begin, end, format, points_per_channel, intensity);
+      return path;
+    }
+
   private:
 
+    /// Points written per call to std::ostream::write when the points need
+    /// to be packed first.
+    static constexpr size_t CHUNK_SIZE = 4096u;
+
     static void WriteHeader(std::ostream &out, size_t number_of_points);
+
+    static void WriteHeader(std::ostream &out, size_t number_of_points, Format format, bool with_ring);
+
+    static const char *GetDefaultExtension(Format format);
+
+    /// Pack each point in a record of @a record_size bytes with
+    /// @a pack(point, record), and write them in chunks.
+    template <typename PointIt, typename PackFunctor>
+    static void WriteRecords(
+        std::ostream &out,
+        PointIt begin,
+        PointIt end,
+        PackFunctor &&pack,
+        size_t record_size) {
+      std::vector<unsigned char> chunk(CHUNK_SIZE * record_size);
+      while (begin != end) {
+        size_t count = 0u;
+        for (; (begin != end) && (count < CHUNK_SIZE); ++begin, ++count) {
+          pack(*begin, chunk.data() + count * record_size);
+        }
+        out.write(reinterpret_cast<const char *>(chunk.data()), static_cast<std::streamsize>(count * record_size));
+      }
+    }
+
+    template <typename PointIt>
+    static void WriteRecordsWithRing(
+        std::ostream &out,
+        PointIt begin,
+        const std::vector<uint32_t> &points_per_channel) {
+      constexpr size_t record_size = 3u * sizeof(float) + sizeof(uint16_t);
+      for (size_t channel = 0u; channel < points_per_channel.size(); ++channel) {
+        const auto end = std::next(begin, points_per_channel[channel]);
+        const auto ring = static_cast<uint16_t>(channel);
+        WriteRecords(out, begin, end, [ring](const auto &point, unsigned char *record) {
+          const std::array<float, 3u> values = {point.x, point.y, point.z};
+          std::memcpy(record, values.data(), sizeof(values));
+          std::memcpy(record + sizeof(values), &ring, sizeof(ring));
+        }, record_size);
+        begin = end;
+      }
+    }
+
+    /// Points stored contiguously as three floats, e.g. the array of a
+    /// LidarMeasurement, are written as they are.
+    template <typename T>
+    static auto WriteCoordinates(std::ostream &out, T *begin, T *end)
+        -> std::enable_if_t<std::is_base_of<geom::Vector3D, T>::value && (sizeof(T) == 3u * sizeof(float))> {
+      out.write(
+          reinterpret_cast<const char *>(begin),
+          static_cast<std::streamsize>(sizeof(T) * static_cast<size_t>(end - begin)));
+    }
+
+    template <typename PointIt, typename... Dummy>
+    static void WriteCoordinates(std::ostream &out, PointIt begin, PointIt end, Dummy...) {
+      WriteRecords(out, begin, end, [](const auto &point, unsigned char *record) {
+        const std::array<float, 3u> values = {point.x, point.y, point.z};
+        std::memcpy(record, values.data(), sizeof(values));
+      }, 3u * sizeof(float));
+    }
   };
 
 } // namespace pointcloud
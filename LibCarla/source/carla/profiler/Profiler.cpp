@@ -70,8 +70,13 @@ namespace detail {
     const std::string _filename;
   };
 
-  ProfilerData::~ProfilerData() {
+  static StaticProfiler &GetStaticProfiler() {
     static StaticProfiler PROFILER{"profiler.csv"};
+    return PROFILER;
+  }
+
+  ProfilerData::~ProfilerData() {
+    auto &PROFILER = GetStaticProfiler();
     if (_count > 0u) {
       if (_print_fps) {
         PROFILER.write_line(_name, fps(average()), fps(minimum()), fps(maximum()), "FPS", _count);
@@ -83,6 +88,13 @@ namespace detail {
     }
   }
 
+  CounterData::~CounterData() {
+    const size_t count = _count;
+    if (count > 0u) {
+      GetStaticProfiler().write_line(_name, count, count, count, "count", count);
+    }
+  }
+
 } // namespace detail
 } // namespace profiler
 } // namespace carla
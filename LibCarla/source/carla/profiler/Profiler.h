@@ -9,11 +9,13 @@
 #ifndef LIBCARLA_ENABLE_PROFILER
 #  define CARLA_PROFILE_SCOPE(context, profiler_name)
 #  define CARLA_PROFILE_FPS(context, profiler_name)
+#  define CARLA_PROFILE_COUNT(context, counter_name)
 #else
 
 #include "carla/StopWatch.h"
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
 #include <string>
 
@@ -73,6 +75,26 @@ namespace detail {
     size_t _min_elapsed = std::numeric_limits<size_t>::max();
   };
 
+  /// Counts events, e.g. allocations, from any thread.
+  class CounterData {
+  public:
+
+    explicit CounterData(std::string name)
+      : _name(std::move(name)) {}
+
+    ~CounterData();
+
+    void Increment() {
+      ++_count;
+    }
+
+  private:
+
+    const std::string _name;
+
+    std::atomic_size_t _count{0u};
+  };
+
   class ScopedProfiler {
   public:
 
@@ -106,6 +128,13 @@ namespace detail {
     ::carla::profiler::detail::ScopedProfiler carla_profiler_ ## context ## _ ## profiler_name ## _scoped_profiler( \
         carla_profiler_ ## context ## _ ## profiler_name ## _data);
 
+#define CARLA_PROFILE_COUNT(context, counter_name) \
+    { \
+      static ::carla::profiler::detail::CounterData carla_profiler_ ## context ## _ ## counter_name ## _data( \
+          LIBCARLA_GTEST_GET_TEST_NAME() + "." #context "." #counter_name); \
+      carla_profiler_ ## context ## _ ## counter_name ## _data.Increment(); \
+    }
+
 #define CARLA_PROFILE_FPS(context, profiler_name) \
     { \
       static thread_local ::carla::StopWatch stop_watch; \
@@ -0,0 +1,881 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/CompiledMap.h"
+
+#include "carla/Exception.h"
+#include "carla/road/Map.h"
+#include "carla/road/MapBuilder.h"
+#include "carla/road/element/RoadInfoElevation.h"
+#include "carla/road/element/RoadInfoGeometry.h"
+#include "carla/road/element/RoadInfoLaneAccess.h"
+#include "carla/road/element/RoadInfoLaneBorder.h"
+#include "carla/road/element/RoadInfoLaneHeight.h"
+#include "carla/road/element/RoadInfoLaneMaterial.h"
+#include "carla/road/element/RoadInfoLaneOffset.h"
+#include "carla/road/element/RoadInfoLaneRule.h"
+#include "carla/road/element/RoadInfoLaneVisibility.h"
+#include "carla/road/element/RoadInfoLaneWidth.h"
+#include "carla/road/element/RoadInfoMarkRecord.h"
+#include "carla/road/element/RoadInfoMarkTypeLine.h"
+#include "carla/road/element/RoadInfoSpeed.h"
+#include "carla/road/element/RoadInfoVisitor.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace carla {
+namespace road {
+
+  using namespace carla::road::element;
+
+  using Format = CompiledMapFormat;
+  using ArrayId = Format::ArrayId;
+  using InfoKind = Format::InfoKind;
+
+  // Contents of the Info records according to their kind:
+  //
+  //   Elevation, LaneBorder, LaneOffset, LaneWidth:
+  //     values = {a, b, c, d, s} of the polynomial, as returned by its getters.
+  //   GeometryLine:
+  //     values = {start offset, length, heading, x, y, z}.
+  //   GeometryArc:
+  //     values = {start offset, length, heading, x, y, z, curvature}.
+  //   LaneAccess:
+  //     strings = {restriction}.
+  //   LaneHeight:
+  //     values = {inner, outer}.
+  //   LaneMaterial:
+  //     values = {friction, roughness}, strings = {surface}.
+  //   LaneRule:
+  //     strings = {value}.
+  //   LaneVisibility:
+  //     values = {forward, back, left, right}.
+  //   MarkRecord:
+  //     id = road mark id, values = {width, lane change, height, type width},
+  //     strings = {type, weight, color, material, type name},
+  //     children = its MarkTypeLine records.
+  //   MarkTypeLine:
+  //     id = road mark id, values = {length, space, t offset, width},
+  //     strings = {rule}.
+  //   Speed:
+  //     values = {speed}.
+
+  /// Index of the links to missing lanes or roads.
+  static constexpr uint32_t NULL_INDEX = std::numeric_limits<uint32_t>::max();
+
+  static constexpr size_t ToIndex(ArrayId id) {
+    return static_cast<size_t>(id);
+  }
+
+  template <typename T>
+  static uint32_t Size(const T &container) {
+    return static_cast<uint32_t>(container.size());
+  }
+
+  /// Elements of a hash table sorted by key, so they are written in the same
+  /// order whatever the iteration order of the table.
+  template <typename Key, typename T>
+  static std::vector<const T *> SortByKey(const std::unordered_map<Key, T> &table) {
+    std::vector<std::pair<Key, const T *>> pairs;
+    pairs.reserve(table.size());
+    for (auto &pair : table) {
+      pairs.emplace_back(pair.first, &pair.second);
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const auto &lhs, const auto &rhs) {
+      return lhs.first < rhs.first;
+    });
+    std::vector<const T *> result;
+    result.reserve(pairs.size());
+    for (auto &pair : pairs) {
+      result.emplace_back(pair.second);
+    }
+    return result;
+  }
+
+  [[noreturn]] static void ThrowCorrupted() {
+    throw_exception(std::runtime_error("CompiledMap: corrupted file"));
+  }
+
+  // ===========================================================================
+  // -- CompiledMap::Serializer ------------------------------------------------
+  // ===========================================================================
+
+  class CompiledMap::Serializer : private RoadInfoVisitor {
+  public:
+
+    std::vector<unsigned char> Serialize(const Map &map, const std::string &metadata);
+
+  private:
+
+    Format::String AddString(const std::string &str);
+
+    Format::Range AddInfos(const InformationSet &info_set);
+
+    Format::Info MakeInfo(RoadInfo &info);
+
+    template <typename T>
+    static Format::Range AddLinks(
+        const std::vector<T *> &links,
+        const std::unordered_map<const T *, uint32_t> &indices,
+        std::vector<uint32_t> &array);
+
+    Format::Range AddValidities(const std::vector<general::Validity> &validities);
+
+    void SetPolynomial(InfoKind kind, const geom::CubicPolynomial &polynomial);
+
+    void SetGeometry(const Geometry &geometry);
+
+    void Visit(RoadInfoElevation &info) final {
+      SetPolynomial(InfoKind::Elevation, info.GetPolynomial());
+    }
+
+    void Visit(RoadInfoGeometry &info) final {
+      SetGeometry(info.GetGeometry());
+    }
+
+    void Visit(RoadInfoLaneAccess &info) final {
+      _record.kind = static_cast<uint32_t>(InfoKind::LaneAccess);
+      _record.strings[0u] = AddString(info.GetRestriction());
+    }
+
+    void Visit(RoadInfoLaneBorder &info) final {
+      SetPolynomial(InfoKind::LaneBorder, info.GetPolynomial());
+    }
+
+    void Visit(RoadInfoLaneHeight &info) final {
+      _record.kind = static_cast<uint32_t>(InfoKind::LaneHeight);
+      _record.values[0u] = info.GetInner();
+      _record.values[1u] = info.GetOuter();
+    }
+
+    void Visit(RoadInfoLaneMaterial &info) final {
+      _record.kind = static_cast<uint32_t>(InfoKind::LaneMaterial);
+      _record.values[0u] = info.GetFriction();
+      _record.values[1u] = info.GetRoughness();
+      _record.strings[0u] = AddString(info.GetSurface());
+    }
+
+    void Visit(RoadInfoLaneOffset &info) final {
+      SetPolynomial(InfoKind::LaneOffset, info.GetPolynomial());
+    }
+
+    void Visit(RoadInfoLaneRule &info) final {
+      _record.kind = static_cast<uint32_t>(InfoKind::LaneRule);
+      _record.strings[0u] = AddString(info.GetValue());
+    }
+
+    void Visit(RoadInfoLaneVisibility &info) final {
+      _record.kind = static_cast<uint32_t>(InfoKind::LaneVisibility);
+      _record.values[0u] = info.GetForward();
+      _record.values[1u] = info.GetBack();
+      _record.values[2u] = info.GetLeft();
+      _record.values[3u] = info.GetRight();
+    }
+
+    void Visit(RoadInfoLaneWidth &info) final {
+      SetPolynomial(InfoKind::LaneWidth, info.GetPolynomial());
+    }
+
+    void Visit(RoadInfoMarkRecord &info) final {
+      _record.kind = static_cast<uint32_t>(InfoKind::MarkRecord);
+      _record.id = info.GetRoadMarkId();
+      _record.values[0u] = info.GetWidth();
+      _record.values[1u] = static_cast<double>(info.GetLaneChange());
+      _record.values[2u] = info.GetHeight();
+      _record.values[3u] = info.GetTypeWidth();
+      _record.strings[0u] = AddString(info.GetType());
+      _record.strings[1u] = AddString(info.GetWeight());
+      _record.strings[2u] = AddString(info.GetColor());
+      _record.strings[3u] = AddString(info.GetMaterial());
+      _record.strings[4u] = AddString(info.GetTypeName());
+      _lines = &info.GetLines();
+    }
+
+    void Visit(RoadInfoMarkTypeLine &info) final {
+      _record.kind = static_cast<uint32_t>(InfoKind::MarkTypeLine);
+      _record.id = info.GetRoadMarkId();
+      _record.values[0u] = info.GetLength();
+      _record.values[1u] = info.GetSpace();
+      _record.values[2u] = info.GetTOffset();
+      _record.values[3u] = info.GetWidth();
+      _record.strings[0u] = AddString(info.GetRule());
+    }
+
+    void Visit(RoadInfoSpeed &info) final {
+      _record.kind = static_cast<uint32_t>(InfoKind::Speed);
+      _record.values[0u] = info.GetSpeed();
+    }
+
+    /// Record filled by the Visit methods.
+    Format::Info _record;
+
+    /// Type lines of the last mark record visited.
+    std::vector<std::unique_ptr<RoadInfoMarkTypeLine>> *_lines = nullptr;
+
+    std::string _strings;
+
+    std::unordered_map<std::string, Format::String> _string_table;
+
+    std::vector<Format::Road> _roads;
+
+    std::vector<uint32_t> _road_links;
+
+    std::vector<Format::Section> _sections;
+
+    std::vector<Format::Lane> _lanes;
+
+    std::vector<uint32_t> _lane_links;
+
+    std::vector<Format::Info> _infos;
+
+    std::vector<Format::Junction> _junctions;
+
+    std::vector<Format::Connection> _connections;
+
+    std::vector<Format::JunctionLaneLink> _junction_lane_links;
+
+    std::vector<Format::Signal> _signals;
+
+    std::vector<Format::SignalReference> _signal_references;
+
+    std::vector<Format::Validity> _validities;
+
+    std::vector<Format::Dependency> _dependencies;
+  };
+
+  Format::String CompiledMap::Serializer::AddString(const std::string &str) {
+    auto it = _string_table.find(str);
+    if (it != _string_table.end()) {
+      return it->second;
+    }
+    const Format::String result{Size(_strings), Size(str)};
+    _strings += str;
+    _string_table.emplace(str, result);
+    return result;
+  }
+
+  Format::Info CompiledMap::Serializer::MakeInfo(RoadInfo &info) {
+    _record = Format::Info{};
+    _record.kind = NULL_INDEX;
+    _record.s = info.GetDistance();
+    _lines = nullptr;
+    info.AcceptVisitor(*this);
+    if (_record.kind == NULL_INDEX) {
+      throw_exception(std::invalid_argument("CompiledMap: unsupported road info"));
+    }
+    return _record;
+  }
+
+  Format::Range CompiledMap::Serializer::AddInfos(const InformationSet &info_set) {
+    const auto &infos = info_set.GetAll();
+    const Format::Range range{Size(_infos), Size(infos)};
+    // The infos of an element must be contiguous, the type lines of the mark
+    // records go after them.
+    _infos.resize(_infos.size() + infos.size());
+    for (auto i = 0u; i < infos.size(); ++i) {
+      auto record = MakeInfo(*infos[i]);
+      if (_lines != nullptr) {
+        auto lines = _lines;
+        record.children.first = Size(_infos);
+        record.children.count = Size(*lines);
+        for (auto &line : *lines) {
+          _infos.emplace_back(MakeInfo(*line));
+        }
+      }
+      _infos[range.first + i] = record;
+    }
+    return range;
+  }
+
+  template <typename T>
+  Format::Range CompiledMap::Serializer::AddLinks(
+      const std::vector<T *> &links,
+      const std::unordered_map<const T *, uint32_t> &indices,
+      std::vector<uint32_t> &array) {
+    const Format::Range range{Size(array), Size(links)};
+    for (auto *link : links) {
+      array.emplace_back(link != nullptr ? indices.at(link) : NULL_INDEX);
+    }
+    return range;
+  }
+
+  Format::Range CompiledMap::Serializer::AddValidities(
+      const std::vector<general::Validity> &validities) {
+    const Format::Range range{Size(_validities), Size(validities)};
+    for (auto &validity : validities) {
+      _validities.emplace_back(Format::Validity{validity._from_lane, validity._to_lane});
+    }
+    return range;
+  }
+
+  void CompiledMap::Serializer::SetPolynomial(
+      const InfoKind kind,
+      const geom::CubicPolynomial &polynomial) {
+    _record.kind = static_cast<uint32_t>(kind);
+    _record.values[0u] = polynomial.GetA();
+    _record.values[1u] = polynomial.GetB();
+    _record.values[2u] = polynomial.GetC();
+    _record.values[3u] = polynomial.GetD();
+    _record.values[4u] = polynomial.GetS();
+  }
+
+  void CompiledMap::Serializer::SetGeometry(const Geometry &geometry) {
+    _record.values[0u] = geometry.GetStartOffset();
+    _record.values[1u] = geometry.GetLength();
+    _record.values[2u] = geometry.GetHeading();
+    _record.values[3u] = geometry.GetStartPosition().x;
+    _record.values[4u] = geometry.GetStartPosition().y;
+    _record.values[5u] = geometry.GetStartPosition().z;
+    switch (geometry.GetType()) {
+      case GeometryType::LINE:
+        _record.kind = static_cast<uint32_t>(InfoKind::GeometryLine);
+        break;
+      case GeometryType::ARC:
+        _record.kind = static_cast<uint32_t>(InfoKind::GeometryArc);
+        _record.values[6u] = static_cast<const GeometryArc &>(geometry).GetCurvature();
+        break;
+      default:
+        // MapBuilder does not support any other geometry either.
+        throw_exception(std::invalid_argument("CompiledMap: unsupported geometry type"));
+    }
+  }
+
+  std::vector<unsigned char> CompiledMap::Serializer::Serialize(
+      const Map &map,
+      const std::string &metadata) {
+    const auto &data = map._data;
+
+    // Index of every road and lane in the order they are written.
+    std::unordered_map<const Road *, uint32_t> road_indices;
+    std::unordered_map<const Lane *, uint32_t> lane_indices;
+    for (auto road_id : data._road_ids) {
+      const auto &road = data.GetRoad(road_id);
+      road_indices.emplace(&road, Size(road_indices));
+      for (auto &section : road._lane_sections) {
+        for (auto &lane : section.second.GetLanes()) {
+          lane_indices.emplace(&lane.second, Size(lane_indices));
+        }
+      }
+    }
+
+    for (auto road_id : data._road_ids) {
+      const auto &road = data.GetRoad(road_id);
+      Format::Road record{};
+      record.id = road._id;
+      record.junction_id = road._junction_id;
+      record.successor = road._successor;
+      record.predecessor = road._predecessor;
+      record.length = road._length;
+      record.name = AddString(road._name);
+      record.sections.first = Size(_sections);
+      for (auto &section_pair : road._lane_sections) {
+        const auto &section = section_pair.second;
+        Format::Section section_record{};
+        section_record.id = section.GetId();
+        section_record.s = section.GetDistance();
+        section_record.lanes.first = Size(_lanes);
+        for (auto &lane_pair : section.GetLanes()) {
+          const auto &lane = lane_pair.second;
+          Format::Lane lane_record{};
+          lane_record.id = lane._id;
+          lane_record.type = static_cast<uint32_t>(lane._type);
+          lane_record.successor = lane._successor;
+          lane_record.predecessor = lane._predecessor;
+          lane_record.level = lane._level ? 1u : 0u;
+          lane_record.infos = AddInfos(lane._info);
+          lane_record.next_lanes = AddLinks(lane._next_lanes, lane_indices, _lane_links);
+          lane_record.prev_lanes = AddLinks(lane._prev_lanes, lane_indices, _lane_links);
+          _lanes.emplace_back(lane_record);
+        }
+        section_record.lanes.count = Size(_lanes) - section_record.lanes.first;
+        _sections.emplace_back(section_record);
+      }
+      record.sections.count = Size(_sections) - record.sections.first;
+      record.infos = AddInfos(road._info);
+      record.nexts = AddLinks(road._nexts, road_indices, _road_links);
+      record.prevs = AddLinks(road._prevs, road_indices, _road_links);
+
+      record.signals.first = Size(_signals);
+      for (auto *signal_pointer : SortByKey(road._signals)) {
+        const auto &signal = *signal_pointer;
+        Format::Signal signal_record{};
+        signal_record.id = signal._signal_id;
+        const std::array<double, 9u> values = {
+            signal._s, signal._t, signal._zOffset, signal._value, signal._height,
+            signal._width, signal._hOffset, signal._pitch, signal._roll};
+        std::copy(values.begin(), values.end(), signal_record.values);
+        const std::array<const std::string *, 8u> strings = {
+            &signal._name, &signal._dynamic, &signal._orientation, &signal._country,
+            &signal._type, &signal._subtype, &signal._unit, &signal._text};
+        for (auto i = 0u; i < strings.size(); ++i) {
+          signal_record.strings[i] = AddString(*strings[i]);
+        }
+        signal_record.validities = AddValidities(signal._validities);
+        signal_record.dependencies.first = Size(_dependencies);
+        for (auto &dependency : signal._dependencies) {
+          Format::Dependency dependency_record{};
+          dependency_record.dependency_id = dependency._dependency_id;
+          dependency_record.type = AddString(dependency._type);
+          _dependencies.emplace_back(dependency_record);
+        }
+        signal_record.dependencies.count = Size(_dependencies) - signal_record.dependencies.first;
+        _signals.emplace_back(signal_record);
+      }
+      record.signals.count = Size(_signals) - record.signals.first;
+
+      record.signal_references.first = Size(_signal_references);
+      for (auto *reference_pointer : SortByKey(road._sign_ref)) {
+        const auto &reference = *reference_pointer;
+        Format::SignalReference reference_record{};
+        reference_record.id = reference._signal_id;
+        reference_record.s = reference._s;
+        reference_record.t = reference._t;
+        reference_record.orientation = AddString(reference._orientation);
+        reference_record.validities = AddValidities(reference._validities);
+        _signal_references.emplace_back(reference_record);
+      }
+      record.signal_references.count = Size(_signal_references) - record.signal_references.first;
+
+      _roads.emplace_back(record);
+    }
+
+    for (auto junction_id : data._junction_ids) {
+      const auto &junction = data._junctions.at(junction_id);
+      Format::Junction record{};
+      record.id = junction._id;
+      record.name = AddString(junction._name);
+      record.connections.first = Size(_connections);
+      for (auto *connection_pointer : SortByKey(junction._connections)) {
+        const auto &connection = *connection_pointer;
+        Format::Connection connection_record{};
+        connection_record.id = connection.id;
+        connection_record.incoming_road = connection.incoming_road;
+        connection_record.connecting_road = connection.connecting_road;
+        connection_record.lane_links.first = Size(_junction_lane_links);
+        for (auto &link : connection.lane_links) {
+          _junction_lane_links.emplace_back(Format::JunctionLaneLink{link.from, link.to});
+        }
+        connection_record.lane_links.count = Size(connection.lane_links);
+        _connections.emplace_back(connection_record);
+      }
+      record.connections.count = Size(_connections) - record.connections.first;
+      _junctions.emplace_back(record);
+    }
+
+    // Layout.
+    std::array<std::pair<const void *, size_t>, ToIndex(ArrayId::SIZE)> contents;
+    auto set_contents = [&](ArrayId id, const auto &array) {
+      contents[ToIndex(id)] = {array.data(), array.size() * sizeof(array[0u])};
+    };
+    set_contents(ArrayId::Strings, _strings);
+    set_contents(ArrayId::Roads, _roads);
+    set_contents(ArrayId::RoadLinks, _road_links);
+    set_contents(ArrayId::Sections, _sections);
+    set_contents(ArrayId::Lanes, _lanes);
+    set_contents(ArrayId::LaneLinks, _lane_links);
+    set_contents(ArrayId::Infos, _infos);
+    set_contents(ArrayId::Junctions, _junctions);
+    set_contents(ArrayId::Connections, _connections);
+    set_contents(ArrayId::JunctionLaneLinks, _junction_lane_links);
+    set_contents(ArrayId::Signals, _signals);
+    set_contents(ArrayId::SignalReferences, _signal_references);
+    set_contents(ArrayId::Validities, _validities);
+    set_contents(ArrayId::Dependencies, _dependencies);
+    set_contents(ArrayId::Metadata, metadata);
+
+    std::array<Format::Array, ToIndex(ArrayId::SIZE)> arrays;
+    uint64_t offset = sizeof(Format::FileHeader) + sizeof(arrays);
+    for (auto i = 0u; i < arrays.size(); ++i) {
+      offset = Format::Align(offset);
+      arrays[i] = Format::Array{offset, contents[i].second};
+      offset += contents[i].second;
+    }
+
+    Format::FileHeader header{};
+    std::memcpy(header.magic, Format::magic(), sizeof(header.magic));
+    header.version = Format::version;
+    header.latitude = data._geo_reference.latitude;
+    header.longitude = data._geo_reference.longitude;
+    header.altitude = data._geo_reference.altitude;
+
+    std::vector<unsigned char> result(Format::Align(offset), 0u);
+    auto copy = [&](uint64_t position, const void *source, size_t size) {
+      std::copy_n(static_cast<const unsigned char *>(source), size, result.begin() + static_cast<std::ptrdiff_t>(position));
+    };
+    copy(0u, &header, sizeof(header));
+    copy(sizeof(header), arrays.data(), sizeof(arrays));
+    for (auto i = 0u; i < arrays.size(); ++i) {
+      copy(arrays[i].offset, contents[i].first, contents[i].second);
+    }
+    return result;
+  }
+
+  // ===========================================================================
+  // -- CompiledMap: serialization ---------------------------------------------
+  // ===========================================================================
+
+  std::vector<unsigned char> CompiledMap::Serialize(
+      const Map &map,
+      const std::string &metadata) {
+    return Serializer{}.Serialize(map, metadata);
+  }
+
+  void CompiledMap::Write(
+      const Map &map,
+      const std::string &path,
+      const std::string &metadata) {
+    const auto data = Serialize(map, metadata);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file) {
+      throw_exception(std::runtime_error("CompiledMap: failed to write " + path));
+    }
+  }
+
+  // ===========================================================================
+  // -- CompiledMap: loading ---------------------------------------------------
+  // ===========================================================================
+
+  CompiledMap::CompiledMap(const unsigned char *data, const size_t size)
+    : _data(data),
+      _size(size) {
+    Validate();
+  }
+
+  CompiledMap::~CompiledMap() = default;
+
+  void CompiledMap::Validate() const {
+    const size_t header_size = sizeof(Format::FileHeader) + ToIndex(ArrayId::SIZE) * sizeof(Format::Array);
+    if ((_data == nullptr) ||
+        (_size < header_size) ||
+        (std::memcmp(_data, Format::magic(), sizeof(Format::FileHeader::magic)) != 0)) {
+      throw_exception(std::runtime_error("CompiledMap: not a compiled map"));
+    }
+    if (GetHeader().version != Format::version) {
+      throw_exception(std::runtime_error("CompiledMap: unsupported version"));
+    }
+    const std::array<size_t, ToIndex(ArrayId::SIZE)> record_sizes = {
+        sizeof(char),
+        sizeof(Format::Road),
+        sizeof(uint32_t),
+        sizeof(Format::Section),
+        sizeof(Format::Lane),
+        sizeof(uint32_t),
+        sizeof(Format::Info),
+        sizeof(Format::Junction),
+        sizeof(Format::Connection),
+        sizeof(Format::JunctionLaneLink),
+        sizeof(Format::Signal),
+        sizeof(Format::SignalReference),
+        sizeof(Format::Validity),
+        sizeof(Format::Dependency),
+        sizeof(char)};
+    for (auto i = 0u; i < record_sizes.size(); ++i) {
+      Format::Array array;
+      std::memcpy(&array, _data + sizeof(Format::FileHeader) + i * sizeof(Format::Array), sizeof(array));
+      if ((array.offset < header_size) ||
+          (array.offset > _size) ||
+          (array.size > _size - array.offset) ||
+          ((array.offset % Format::alignment) != 0u) ||
+          ((array.size % record_sizes[i]) != 0u)) {
+        ThrowCorrupted();
+      }
+    }
+  }
+
+  const Format::FileHeader &CompiledMap::GetHeader() const {
+    return *reinterpret_cast<const Format::FileHeader *>(_data);
+  }
+
+  template <typename T>
+  std::pair<const T *, size_t> CompiledMap::GetArray(const ArrayId id) const {
+    const auto &array = reinterpret_cast<const Format::Array *>(_data + sizeof(Format::FileHeader))[ToIndex(id)];
+    return {reinterpret_cast<const T *>(_data + array.offset), array.size / sizeof(T)};
+  }
+
+  std::string CompiledMap::GetMetadata() const {
+    const auto metadata = GetArray<char>(ArrayId::Metadata);
+    return std::string(metadata.first, metadata.second);
+  }
+
+  Map CompiledMap::Load() const {
+    const auto &header = GetHeader();
+    const auto strings = GetArray<char>(ArrayId::Strings);
+    const auto roads = GetArray<Format::Road>(ArrayId::Roads);
+    const auto road_links = GetArray<uint32_t>(ArrayId::RoadLinks);
+    const auto sections = GetArray<Format::Section>(ArrayId::Sections);
+    const auto lanes = GetArray<Format::Lane>(ArrayId::Lanes);
+    const auto lane_links = GetArray<uint32_t>(ArrayId::LaneLinks);
+    const auto infos = GetArray<Format::Info>(ArrayId::Infos);
+    const auto junctions = GetArray<Format::Junction>(ArrayId::Junctions);
+    const auto connections = GetArray<Format::Connection>(ArrayId::Connections);
+    const auto junction_lane_links = GetArray<Format::JunctionLaneLink>(ArrayId::JunctionLaneLinks);
+    const auto signals = GetArray<Format::Signal>(ArrayId::Signals);
+    const auto signal_references = GetArray<Format::SignalReference>(ArrayId::SignalReferences);
+    const auto validities = GetArray<Format::Validity>(ArrayId::Validities);
+    const auto dependencies = GetArray<Format::Dependency>(ArrayId::Dependencies);
+
+    auto get_string = [&](const Format::String &str) {
+      if (uint64_t(str.offset) + str.length > strings.second) {
+        ThrowCorrupted();
+      }
+      return std::string(strings.first + str.offset, str.length);
+    };
+
+    // Return the records of @a range, checking it is inside @a array.
+    auto get_range = [](const auto &array, const Format::Range &range) {
+      if (uint64_t(range.first) + range.count > array.second) {
+        ThrowCorrupted();
+      }
+      return std::make_pair(array.first + range.first, array.first + range.first + range.count);
+    };
+
+    auto make_polynomial = [](const Format::Info &record) {
+      return geom::CubicPolynomial::MakeDisplaced(
+          record.values[0u],
+          record.values[1u],
+          record.values[2u],
+          record.values[3u],
+          record.values[4u]);
+    };
+
+    auto make_geometry_location = [](const Format::Info &record) {
+      return geom::Location(
+          static_cast<float>(record.values[3u]),
+          static_cast<float>(record.values[4u]),
+          static_cast<float>(record.values[5u]));
+    };
+
+    auto make_info = [&](const Format::Info &record) -> std::unique_ptr<RoadInfo> {
+      const double s = record.s;
+      switch (static_cast<InfoKind>(record.kind)) {
+        case InfoKind::Elevation:
+          return std::make_unique<RoadInfoElevation>(s, make_polynomial(record));
+        case InfoKind::GeometryLine:
+          return std::make_unique<RoadInfoGeometry>(s, std::make_unique<GeometryLine>(
+              record.values[0u],
+              record.values[1u],
+              record.values[2u],
+              make_geometry_location(record)));
+        case InfoKind::GeometryArc:
+          return std::make_unique<RoadInfoGeometry>(s, std::make_unique<GeometryArc>(
+              record.values[0u],
+              record.values[1u],
+              record.values[2u],
+              make_geometry_location(record),
+              record.values[6u]));
+        case InfoKind::LaneAccess:
+          return std::make_unique<RoadInfoLaneAccess>(s, get_string(record.strings[0u]));
+        case InfoKind::LaneBorder:
+          return std::make_unique<RoadInfoLaneBorder>(s, make_polynomial(record));
+        case InfoKind::LaneHeight:
+          return std::make_unique<RoadInfoLaneHeight>(s, record.values[0u], record.values[1u]);
+        case InfoKind::LaneMaterial:
+          return std::make_unique<RoadInfoLaneMaterial>(
+              s,
+              get_string(record.strings[0u]),
+              record.values[0u],
+              record.values[1u]);
+        case InfoKind::LaneOffset:
+          return std::make_unique<RoadInfoLaneOffset>(s, make_polynomial(record));
+        case InfoKind::LaneRule:
+          return std::make_unique<RoadInfoLaneRule>(s, get_string(record.strings[0u]));
+        case InfoKind::LaneVisibility:
+          return std::make_unique<RoadInfoLaneVisibility>(
+              s,
+              record.values[0u],
+              record.values[1u],
+              record.values[2u],
+              record.values[3u]);
+        case InfoKind::LaneWidth:
+          return std::make_unique<RoadInfoLaneWidth>(s, make_polynomial(record));
+        case InfoKind::MarkRecord: {
+          auto mark = std::make_unique<RoadInfoMarkRecord>(
+              s,
+              record.id,
+              get_string(record.strings[0u]),
+              get_string(record.strings[1u]),
+              get_string(record.strings[2u]),
+              get_string(record.strings[3u]),
+              record.values[0u],
+              static_cast<RoadInfoMarkRecord::LaneChange>(static_cast<uint8_t>(record.values[1u])),
+              record.values[2u],
+              get_string(record.strings[4u]),
+              record.values[3u]);
+          const auto children = get_range(infos, record.children);
+          for (auto line = children.first; line != children.second; ++line) {
+            if (static_cast<InfoKind>(line->kind) != InfoKind::MarkTypeLine) {
+              ThrowCorrupted();
+            }
+            mark->GetLines().emplace_back(std::make_unique<RoadInfoMarkTypeLine>(
+                line->s,
+                line->id,
+                line->values[0u],
+                line->values[1u],
+                line->values[2u],
+                get_string(line->strings[0u]),
+                line->values[3u]));
+          }
+          return mark;
+        }
+        case InfoKind::Speed:
+          return std::make_unique<RoadInfoSpeed>(s, record.values[0u]);
+        default:
+          ThrowCorrupted();
+      }
+    };
+
+    MapBuilder builder;
+    builder.SetGeoReference(geom::GeoLocation{header.latitude, header.longitude, header.altitude});
+
+    // Roads and junctions are added in the order of the file, which is the
+    // order of MapData::GetRoadIds and GetJunctionIds of the original map.
+    std::vector<Road *> road_pointers(roads.second);
+    for (auto i = 0u; i < roads.second; ++i) {
+      const auto &record = roads.first[i];
+      road_pointers[i] = builder.AddRoad(
+          record.id,
+          get_string(record.name),
+          record.length,
+          record.junction_id,
+          record.predecessor,
+          record.successor);
+    }
+
+    std::vector<Lane *> lane_pointers(lanes.second, nullptr);
+    for (auto i = 0u; i < roads.second; ++i) {
+      const auto &record = roads.first[i];
+      auto *road = road_pointers[i];
+      const auto road_sections = get_range(sections, record.sections);
+      for (auto section_record = road_sections.first; section_record != road_sections.second; ++section_record) {
+        auto *section = builder.AddRoadSection(road, section_record->id, section_record->s);
+        const auto section_lanes = get_range(lanes, section_record->lanes);
+        for (auto lane_record = section_lanes.first; lane_record != section_lanes.second; ++lane_record) {
+          auto *lane = builder.AddRoadSectionLane(
+              section,
+              lane_record->id,
+              lane_record->type,
+              lane_record->level != 0u,
+              lane_record->predecessor,
+              lane_record->successor);
+          lane_pointers[static_cast<size_t>(lane_record - lanes.first)] = lane;
+          const auto lane_infos = get_range(infos, lane_record->infos);
+          for (auto info = lane_infos.first; info != lane_infos.second; ++info) {
+            builder.AddLaneInfo(lane, make_info(*info));
+          }
+        }
+      }
+      const auto road_infos = get_range(infos, record.infos);
+      for (auto info = road_infos.first; info != road_infos.second; ++info) {
+        builder.AddRoadInfo(road, make_info(*info));
+      }
+
+      const auto road_signals = get_range(signals, record.signals);
+      for (auto signal = road_signals.first; signal != road_signals.second; ++signal) {
+        const auto &v = signal->values;
+        const auto &str = signal->strings;
+        builder.AddSignal(
+            record.id, signal->id, v[0u], v[1u],
+            get_string(str[0u]), get_string(str[1u]), get_string(str[2u]),
+            v[2u],
+            get_string(str[3u]), get_string(str[4u]), get_string(str[5u]),
+            v[3u],
+            get_string(str[6u]),
+            v[4u], v[5u],
+            get_string(str[7u]),
+            v[6u], v[7u], v[8u]);
+        const auto signal_validities = get_range(validities, signal->validities);
+        for (auto validity = signal_validities.first; validity != signal_validities.second; ++validity) {
+          builder.AddValidityToSignal(record.id, signal->id, validity->from_lane, validity->to_lane);
+        }
+        const auto signal_dependencies = get_range(dependencies, signal->dependencies);
+        for (auto dependency = signal_dependencies.first; dependency != signal_dependencies.second; ++dependency) {
+          builder.AddDependencyToSignal(
+              record.id,
+              signal->id,
+              dependency->dependency_id,
+              get_string(dependency->type));
+        }
+      }
+
+      const auto road_references = get_range(signal_references, record.signal_references);
+      for (auto reference = road_references.first; reference != road_references.second; ++reference) {
+        builder.AddSignalReference(
+            record.id,
+            reference->id,
+            reference->s,
+            reference->t,
+            get_string(reference->orientation));
+        const auto reference_validities = get_range(validities, reference->validities);
+        for (auto validity = reference_validities.first; validity != reference_validities.second; ++validity) {
+          builder.AddValidityToSignalReference(record.id, reference->id, validity->from_lane, validity->to_lane);
+        }
+      }
+    }
+
+    // The links are stored, no need to compute them again.
+    auto make_links = [&](const auto &pointers, const auto &links, const Format::Range &range) {
+      const auto indices = get_range(links, range);
+      std::remove_const_t<std::remove_reference_t<decltype(pointers)>> result;
+      result.reserve(range.count);
+      for (auto index = indices.first; index != indices.second; ++index) {
+        if (*index == NULL_INDEX) {
+          result.emplace_back(nullptr);
+        } else if (*index < pointers.size()) {
+          result.emplace_back(pointers[*index]);
+        } else {
+          ThrowCorrupted();
+        }
+      }
+      return result;
+    };
+    for (auto i = 0u; i < roads.second; ++i) {
+      const auto &record = roads.first[i];
+      builder.SetRoadLinks(
+          road_pointers[i],
+          make_links(road_pointers, road_links, record.nexts),
+          make_links(road_pointers, road_links, record.prevs));
+    }
+    for (auto i = 0u; i < lanes.second; ++i) {
+      if (lane_pointers[i] == nullptr) {
+        ThrowCorrupted();
+      }
+      builder.SetLaneLinks(
+          lane_pointers[i],
+          make_links(lane_pointers, lane_links, lanes.first[i].next_lanes),
+          make_links(lane_pointers, lane_links, lanes.first[i].prev_lanes));
+    }
+
+    for (auto i = 0u; i < junctions.second; ++i) {
+      const auto &record = junctions.first[i];
+      builder.AddJunction(record.id, get_string(record.name));
+    }
+    for (auto i = 0u; i < junctions.second; ++i) {
+      const auto &record = junctions.first[i];
+      const auto junction_connections = get_range(connections, record.connections);
+      for (auto connection = junction_connections.first; connection != junction_connections.second; ++connection) {
+        builder.AddConnection(record.id, connection->id, connection->incoming_road, connection->connecting_road);
+        const auto links = get_range(junction_lane_links, connection->lane_links);
+        for (auto link = links.first; link != links.second; ++link) {
+          builder.AddLaneLink(record.id, connection->id, link->from, link->to);
+        }
+      }
+    }
+
+    auto map = builder.Build();
+    DEBUG_ASSERT(map.has_value());
+    return std::move(*map);
+  }
+
+} // namespace road
+} // namespace carla
@@ -0,0 +1,80 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/road/CompiledMapFormat.h"
+
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  class Map;
+
+  /// Binary representation of a road::Map (see CompiledMapFormat) that can be
+  /// loaded without parsing the OpenDRIVE file.
+  ///
+  /// The map is written once with Write, and every process that needs it
+  /// memory maps the file (see client::Map::LoadCompiled) and builds the map
+  /// from its flat arrays with Load.
+  /// The loaded map gives the same results to every query as the original
+  /// one.
+  class CompiledMap : private NonCopyable {
+  public:
+
+    /// Return the compiled representation of @a map. @a metadata is stored
+    /// as is and can be retrieved with GetMetadata.
+    ///
+    /// @throw std::invalid_argument if the map contains geometries that
+    /// cannot be compiled.
+    static std::vector<unsigned char> Serialize(
+        const Map &map,
+        const std::string &metadata = std::string());
+
+    /// Write the compiled representation of @a map to @a path.
+    ///
+    /// @throw std::runtime_error if the file cannot be written.
+    static void Write(
+        const Map &map,
+        const std::string &path,
+        const std::string &metadata = std::string());
+
+    /// Use the compiled map at [@a data, @a data + @a size), that must
+    /// outlive this object but not the maps built from it.
+    ///
+    /// @throw std::runtime_error if it is not a valid compiled map.
+    CompiledMap(const unsigned char *data, size_t size);
+
+    ~CompiledMap();
+
+    std::string GetMetadata() const;
+
+    /// Build the map.
+    Map Load() const;
+
+  private:
+
+    using Format = CompiledMapFormat;
+
+    class Serializer;
+
+    void Validate() const;
+
+    const Format::FileHeader &GetHeader() const;
+
+    template <typename T>
+    std::pair<const T *, size_t> GetArray(Format::ArrayId id) const;
+
+    const unsigned char *_data = nullptr;
+
+    size_t _size = 0u;
+  };
+
+} // namespace road
+} // namespace carla
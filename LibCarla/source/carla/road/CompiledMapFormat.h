@@ -0,0 +1,229 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace carla {
+namespace road {
+
+  /// On-disk layout of the compiled maps written and read by CompiledMap. All
+  /// the values are little endian.
+  ///
+  ///   FileHeader
+  ///   Array                             (one per ArrayId)
+  ///   array contents + padding          (one per ArrayId)
+  ///
+  /// Every record references other records by their index in the
+  /// corresponding array, and strings by offset and length in the strings
+  /// array, so the file can be used in place from any address.
+  ///
+  /// Roads and junctions are stored in the order of MapData::GetRoadIds and
+  /// GetJunctionIds, which the loaded map keeps. Signals, signal references
+  /// and connections are stored sorted by id.
+  class CompiledMapFormat {
+  public:
+
+    static constexpr uint32_t version = 2u;
+
+    /// Arrays are aligned so the records can be used in place.
+    static constexpr size_t alignment = 8u;
+
+    enum class ArrayId : uint32_t {
+      Strings,
+      Roads,
+      RoadLinks,
+      Sections,
+      Lanes,
+      LaneLinks,
+      Infos,
+      Junctions,
+      Connections,
+      JunctionLaneLinks,
+      Signals,
+      SignalReferences,
+      Validities,
+      Dependencies,
+      /// Opaque bytes stored by the caller, e.g. the description of the map.
+      Metadata,
+      SIZE
+    };
+
+    /// Kind of the records in ArrayId::Infos, one per RoadInfo type.
+    enum class InfoKind : uint32_t {
+      Elevation,
+      GeometryLine,
+      GeometryArc,
+      LaneAccess,
+      LaneBorder,
+      LaneHeight,
+      LaneMaterial,
+      LaneOffset,
+      LaneRule,
+      LaneVisibility,
+      LaneWidth,
+      MarkRecord,
+      MarkTypeLine,
+      Speed
+    };
+
+#pragma pack(push, 1)
+    struct FileHeader {
+      char magic[8u];
+      uint32_t version;
+      uint32_t reserved;
+      double latitude;
+      double longitude;
+      double altitude;
+    };
+
+    struct Array {
+      /// Offset from the file start.
+      uint64_t offset;
+      /// Size in bytes.
+      uint64_t size;
+    };
+
+    struct String {
+      uint32_t offset;
+      uint32_t length;
+    };
+
+    /// A range [first, first + count) of records of another array.
+    struct Range {
+      uint32_t first;
+      uint32_t count;
+    };
+
+    struct Road {
+      uint32_t id;
+      int32_t junction_id;
+      uint32_t successor;
+      uint32_t predecessor;
+      double length;
+      String name;
+      Range sections;
+      Range infos;
+      /// Into ArrayId::RoadLinks.
+      Range nexts;
+      Range prevs;
+      Range signals;
+      Range signal_references;
+    };
+
+    struct Section {
+      uint32_t id;
+      uint32_t reserved;
+      double s;
+      Range lanes;
+    };
+
+    struct Lane {
+      int32_t id;
+      uint32_t type;
+      int32_t successor;
+      int32_t predecessor;
+      uint32_t level;
+      uint32_t reserved;
+      Range infos;
+      /// Into ArrayId::LaneLinks.
+      Range next_lanes;
+      Range prev_lanes;
+    };
+
+    /// Common record of every RoadInfo, @a values and @a strings are
+    /// interpreted according to @a kind (see CompiledMap.cpp). Mark records
+    /// reference their type lines in @a children.
+    struct Info {
+      uint32_t kind;
+      int32_t id;
+      double s;
+      double values[8u];
+      String strings[5u];
+      Range children;
+    };
+
+    struct Junction {
+      int32_t id;
+      uint32_t reserved;
+      String name;
+      Range connections;
+    };
+
+    struct Connection {
+      uint32_t id;
+      uint32_t incoming_road;
+      uint32_t connecting_road;
+      uint32_t reserved;
+      Range lane_links;
+    };
+
+    struct JunctionLaneLink {
+      int32_t from;
+      int32_t to;
+    };
+
+    struct Signal {
+      uint32_t id;
+      uint32_t reserved;
+      double values[9u];
+      String strings[8u];
+      Range validities;
+      Range dependencies;
+    };
+
+    struct SignalReference {
+      uint32_t id;
+      uint32_t reserved;
+      double s;
+      double t;
+      String orientation;
+      Range validities;
+    };
+
+    /// Validity of a signal or signal reference, the parent is the record
+    /// referencing it.
+    struct Validity {
+      int32_t from_lane;
+      int32_t to_lane;
+    };
+
+    /// Dependency of a signal, the road and signal ids are the ones of the
+    /// record referencing it.
+    struct Dependency {
+      uint32_t dependency_id;
+      uint32_t reserved;
+      String type;
+    };
+#pragma pack(pop)
+
+    static constexpr const char *magic() {
+      return "CARLAMAP";
+    }
+
+    static constexpr uint64_t Align(uint64_t offset) {
+      return (offset + alignment - 1u) & ~(uint64_t(alignment) - 1u);
+    }
+
+    static_assert(sizeof(FileHeader) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(Array) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(Road) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(Section) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(Lane) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(Info) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(Junction) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(Connection) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(JunctionLaneLink) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(Signal) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(SignalReference) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(Validity) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(Dependency) % alignment == 0u, "Invalid alignment");
+  };
+
+} // namespace road
+} // namespace carla
@@ -0,0 +1,461 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/ContractionHierarchy.h"
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace carla {
+namespace road {
+
+  constexpr size_t ContractionHierarchy::DEFAULT_WITNESS_SEARCH_LIMIT;
+
+  static constexpr double INFINITE_COST = std::numeric_limits<double>::infinity();
+
+namespace detail {
+
+  /// Graph under contraction, edges between the remaining nodes are added or
+  /// shortened as nodes get contracted. The edges of contracted nodes are
+  /// kept but skipped by the searches.
+  class Contraction {
+  public:
+
+    using NodeId = LaneGraph::NodeId;
+
+    /// Edge as seen from one of its nodes, @a node is the other one.
+    struct Arc {
+      NodeId node;
+      NodeId middle;
+      double cost;
+    };
+
+    Contraction(const LaneGraph &graph, const size_t witness_search_limit)
+      : _out(graph.GetNumberOfNodes()),
+        _in(graph.GetNumberOfNodes()),
+        _contracted(graph.GetNumberOfNodes(), false),
+        _contracted_neighbours(graph.GetNumberOfNodes(), 0),
+        _witness_search_limit(witness_search_limit),
+        _distance(graph.GetNumberOfNodes(), INFINITE_COST) {
+      for (auto node = 0u; node < graph.GetNumberOfNodes(); ++node) {
+        for (const auto &edge : graph.GetEdges(node)) {
+          if (edge.target != node) {
+            AddArc(node, edge.target, LaneGraph::INVALID_NODE, edge.cost);
+          }
+        }
+      }
+    }
+
+    const std::vector<Arc> &GetOutgoing(NodeId node) const {
+      return _out[node];
+    }
+
+    const std::vector<Arc> &GetIncoming(NodeId node) const {
+      return _in[node];
+    }
+
+    bool IsContracted(NodeId node) const {
+      return _contracted[node];
+    }
+
+    /// Edge difference plus the number of contracted neighbours, nodes with
+    /// lower priority are contracted first.
+    int64_t GetPriority(const NodeId node) {
+      int64_t degree = 0;
+      for (const auto &arc : _in[node]) {
+        degree += _contracted[arc.node] ? 0 : 1;
+      }
+      for (const auto &arc : _out[node]) {
+        degree += _contracted[arc.node] ? 0 : 1;
+      }
+      const auto shortcuts = static_cast<int64_t>(AddShortcuts(node, true));
+      return shortcuts - degree + _contracted_neighbours[node];
+    }
+
+    /// Add the shortcuts needed to remove @a node from the graph, and mark it
+    /// as contracted.
+    void Contract(const NodeId node) {
+      AddShortcuts(node, false);
+      _contracted[node] = true;
+      for (const auto &arc : _in[node]) {
+        ++_contracted_neighbours[arc.node];
+      }
+      for (const auto &arc : _out[node]) {
+        ++_contracted_neighbours[arc.node];
+      }
+    }
+
+  private:
+
+    void AddArc(const NodeId from, const NodeId to, const NodeId middle, const double cost) {
+      auto update = [&](std::vector<Arc> &arcs, const NodeId other) {
+        for (auto &arc : arcs) {
+          if (arc.node == other) {
+            if (cost < arc.cost) {
+              arc.middle = middle;
+              arc.cost = cost;
+            }
+            return;
+          }
+        }
+        arcs.emplace_back(Arc{other, middle, cost});
+      };
+      update(_out[from], to);
+      update(_in[to], from);
+    }
+
+    /// For each pair of remaining neighbours (u, w) of @a node, add a
+    /// shortcut u -> w unless a path without @a node at most as costly is
+    /// found. Return the number of shortcuts needed.
+    size_t AddShortcuts(const NodeId node, const bool simulate) {
+      size_t shortcuts = 0u;
+      for (size_t i = 0u; i < _in[node].size(); ++i) {
+        const auto incoming = _in[node][i];
+        if (_contracted[incoming.node]) {
+          continue;
+        }
+        double max_cost = -1.0;
+        for (const auto &outgoing : _out[node]) {
+          if (!_contracted[outgoing.node] && (outgoing.node != incoming.node)) {
+            max_cost = std::max(max_cost, incoming.cost + outgoing.cost);
+          }
+        }
+        if (max_cost < 0.0) {
+          continue;
+        }
+        WitnessSearch(incoming.node, node, max_cost);
+        for (size_t j = 0u; j < _out[node].size(); ++j) {
+          const auto outgoing = _out[node][j];
+          if (_contracted[outgoing.node] || (outgoing.node == incoming.node)) {
+            continue;
+          }
+          const auto cost = incoming.cost + outgoing.cost;
+          if (_distance[outgoing.node] > cost) {
+            ++shortcuts;
+            if (!simulate) {
+              AddArc(incoming.node, outgoing.node, node, cost);
+            }
+          }
+        }
+        ClearSearch();
+      }
+      return shortcuts;
+    }
+
+    /// Dijkstra search from @a source avoiding @a excluded, up to @a max_cost
+    /// or the search limit. Leaves the costs found in _distance.
+    void WitnessSearch(const NodeId source, const NodeId excluded, const double max_cost) {
+      using Entry = std::pair<double, NodeId>;
+      std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+      _distance[source] = 0.0;
+      _touched.emplace_back(source);
+      open.emplace(0.0, source);
+      size_t settled = 0u;
+      while (!open.empty() && (settled < _witness_search_limit)) {
+        const auto cost = open.top().first;
+        const auto node = open.top().second;
+        open.pop();
+        if (cost > _distance[node]) {
+          continue;
+        }
+        if (cost > max_cost) {
+          break;
+        }
+        ++settled;
+        for (const auto &arc : _out[node]) {
+          if ((arc.node == excluded) || _contracted[arc.node]) {
+            continue;
+          }
+          const auto new_cost = cost + arc.cost;
+          if (new_cost < _distance[arc.node]) {
+            if (_distance[arc.node] == INFINITE_COST) {
+              _touched.emplace_back(arc.node);
+            }
+            _distance[arc.node] = new_cost;
+            open.emplace(new_cost, arc.node);
+          }
+        }
+      }
+    }
+
+    void ClearSearch() {
+      for (auto node : _touched) {
+        _distance[node] = INFINITE_COST;
+      }
+      _touched.clear();
+    }
+
+    std::vector<std::vector<Arc>> _out;
+
+    std::vector<std::vector<Arc>> _in;
+
+    std::vector<bool> _contracted;
+
+    std::vector<int64_t> _contracted_neighbours;
+
+    const size_t _witness_search_limit;
+
+    std::vector<double> _distance;
+
+    std::vector<NodeId> _touched;
+  };
+
+  /// Cost of a node reached by a query, and the node and shortcut middle node
+  /// of the edge used to reach it.
+  struct Label {
+    double cost;
+    LaneGraph::NodeId parent;
+    LaneGraph::NodeId middle;
+  };
+
+  /// Labels of the nodes reached by a query, indexed by node. Only the labels
+  /// stamped with the current query are valid, so starting a query does not
+  /// touch the arrays.
+  class QueryLabels {
+  public:
+
+    using NodeId = LaneGraph::NodeId;
+
+    void Reset(const size_t number_of_nodes) {
+      if (_stamps.size() < number_of_nodes) {
+        _labels.resize(number_of_nodes);
+        _stamps.resize(number_of_nodes, 0u);
+      }
+      if (++_stamp == 0u) {
+        std::fill(_stamps.begin(), _stamps.end(), 0u);
+        _stamp = 1u;
+      }
+    }
+
+    double GetCost(const NodeId node) const {
+      return _stamps[node] == _stamp ? _labels[node].cost : INFINITE_COST;
+    }
+
+    const Label &Get(const NodeId node) const {
+      DEBUG_ASSERT(_stamps[node] == _stamp);
+      return _labels[node];
+    }
+
+    void Set(const NodeId node, const Label &label) {
+      _stamps[node] = _stamp;
+      _labels[node] = label;
+    }
+
+  private:
+
+    std::vector<Label> _labels;
+
+    std::vector<uint32_t> _stamps;
+
+    uint32_t _stamp = 0u;
+  };
+
+} // namespace detail
+
+  // ===========================================================================
+  // -- ContractionHierarchy ---------------------------------------------------
+  // ===========================================================================
+
+  ContractionHierarchy::ContractionHierarchy(
+      const LaneGraph &graph,
+      const size_t witness_search_limit) {
+    const auto number_of_nodes = graph.GetNumberOfNodes();
+    detail::Contraction contraction(graph, witness_search_limit);
+
+    // Lazy updates: a node is contracted if its priority is still the lowest
+    // after recomputing it, otherwise it goes back to the queue.
+    using Entry = std::pair<int64_t, NodeId>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (auto node = 0u; node < number_of_nodes; ++node) {
+      queue.emplace(contraction.GetPriority(node), node);
+    }
+
+    std::vector<std::vector<Edge>> up(number_of_nodes);
+    std::vector<std::vector<Edge>> down(number_of_nodes);
+    while (!queue.empty()) {
+      const auto node = queue.top().second;
+      queue.pop();
+      const auto priority = contraction.GetPriority(node);
+      if (!queue.empty() && (priority > queue.top().first)) {
+        queue.emplace(priority, node);
+        continue;
+      }
+      contraction.Contract(node);
+      // The edges between remaining nodes are final, store them at the
+      // contracted node, the less important one.
+      for (const auto &arc : contraction.GetOutgoing(node)) {
+        if (!contraction.IsContracted(arc.node)) {
+          up[node].emplace_back(Edge{arc.node, arc.middle, arc.cost});
+        }
+      }
+      for (const auto &arc : contraction.GetIncoming(node)) {
+        if (!contraction.IsContracted(arc.node)) {
+          down[node].emplace_back(Edge{arc.node, arc.middle, arc.cost});
+        }
+      }
+    }
+
+    auto flatten = [this](
+        const std::vector<std::vector<Edge>> &lists,
+        std::vector<uint32_t> &offsets,
+        std::vector<Edge> &edges) {
+      offsets.reserve(lists.size() + 1u);
+      offsets.emplace_back(0u);
+      for (const auto &list : lists) {
+        for (const auto &edge : list) {
+          edges.emplace_back(edge);
+          _number_of_shortcuts += (edge.middle != LaneGraph::INVALID_NODE) ? 1u : 0u;
+        }
+        offsets.emplace_back(static_cast<uint32_t>(edges.size()));
+      }
+    };
+    flatten(up, _up_offsets, _up_edges);
+    flatten(down, _down_offsets, _down_edges);
+  }
+
+  auto ContractionHierarchy::FindEdge(
+      const std::vector<uint32_t> &offsets,
+      const std::vector<Edge> &edges,
+      const NodeId node,
+      const NodeId target) -> const Edge & {
+    const Edge *result = nullptr;
+    for (auto i = offsets[node]; i < offsets[node + 1u]; ++i) {
+      if ((edges[i].target == target) && ((result == nullptr) || (edges[i].cost < result->cost))) {
+        result = &edges[i];
+      }
+    }
+    RELEASE_ASSERT(result != nullptr);
+    return *result;
+  }
+
+  void ContractionHierarchy::Unpack(
+      const NodeId from,
+      const NodeId to,
+      const NodeId middle,
+      std::vector<NodeId> &nodes) const {
+    if (middle == LaneGraph::INVALID_NODE) {
+      nodes.emplace_back(to);
+      return;
+    }
+    // The middle node is less important than both ends.
+    Unpack(from, middle, FindEdge(_down_offsets, _down_edges, middle, from).middle, nodes);
+    Unpack(middle, to, FindEdge(_up_offsets, _up_edges, middle, to).middle, nodes);
+  }
+
+  boost::optional<ContractionHierarchy::Route> ContractionHierarchy::FindRoute(
+      const NodeId origin,
+      const NodeId destination) const {
+    const auto number_of_nodes = GetNumberOfNodes();
+    if ((origin >= number_of_nodes) || (destination >= number_of_nodes)) {
+      throw_exception(std::out_of_range("ContractionHierarchy: invalid node id"));
+    }
+
+    using Entry = std::pair<double, NodeId>;
+    using Queue = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+    struct Search {
+      detail::QueryLabels &labels;
+      Queue open;
+    };
+
+    // The labels are reused by the queries of each thread, a query reaches
+    // few nodes and clearing arrays of the size of the graph would dominate.
+    static thread_local detail::QueryLabels forward_labels;
+    static thread_local detail::QueryLabels backward_labels;
+    forward_labels.Reset(number_of_nodes);
+    backward_labels.Reset(number_of_nodes);
+
+    Search forward{forward_labels, Queue{}};
+    Search backward{backward_labels, Queue{}};
+    forward.labels.Set(origin, detail::Label{0.0, LaneGraph::INVALID_NODE, LaneGraph::INVALID_NODE});
+    forward.open.emplace(0.0, origin);
+    backward.labels.Set(destination, detail::Label{0.0, LaneGraph::INVALID_NODE, LaneGraph::INVALID_NODE});
+    backward.open.emplace(0.0, destination);
+
+    double best = INFINITE_COST;
+    NodeId meeting = LaneGraph::INVALID_NODE;
+
+    auto step = [&](
+        Search &search,
+        const Search &other,
+        const auto &offsets,
+        const auto &edges,
+        const auto &opposite_offsets,
+        const auto &opposite_edges) {
+      const auto cost = search.open.top().first;
+      const auto node = search.open.top().second;
+      search.open.pop();
+      if (cost > search.labels.GetCost(node)) {
+        return;
+      }
+      const auto other_cost = other.labels.GetCost(node);
+      if (cost + other_cost < best) {
+        best = cost + other_cost;
+        meeting = node;
+      }
+      // Stall-on-demand: if a more important node already reached gives a
+      // shorter path to this node, it is not on a shortest route and
+      // expanding it is useless.
+      for (auto i = opposite_offsets[node]; i < opposite_offsets[node + 1u]; ++i) {
+        const auto &edge = opposite_edges[i];
+        if (search.labels.GetCost(edge.target) + edge.cost < cost) {
+          return;
+        }
+      }
+      for (auto i = offsets[node]; i < offsets[node + 1u]; ++i) {
+        const auto &edge = edges[i];
+        const auto new_cost = cost + edge.cost;
+        if (new_cost < search.labels.GetCost(edge.target)) {
+          search.labels.Set(edge.target, detail::Label{new_cost, node, edge.middle});
+          search.open.emplace(new_cost, edge.target);
+        }
+      }
+    };
+
+    // Each search stops once it cannot improve the best route found.
+    while (true) {
+      const bool forward_open = !forward.open.empty() && (forward.open.top().first < best);
+      const bool backward_open = !backward.open.empty() && (backward.open.top().first < best);
+      if (forward_open && (!backward_open || (forward.open.top().first <= backward.open.top().first))) {
+        step(forward, backward, _up_offsets, _up_edges, _down_offsets, _down_edges);
+      } else if (backward_open) {
+        step(backward, forward, _down_offsets, _down_edges, _up_offsets, _up_edges);
+      } else {
+        break;
+      }
+    }
+
+    if (meeting == LaneGraph::INVALID_NODE) {
+      return {};
+    }
+
+    Route route;
+    route.cost = best;
+    route.nodes.emplace_back(origin);
+    std::vector<NodeId> forward_path;
+    for (auto node = meeting; node != origin; node = forward.labels.Get(node).parent) {
+      forward_path.emplace_back(node);
+    }
+    for (auto it = forward_path.rbegin(); it != forward_path.rend(); ++it) {
+      const auto &label = forward.labels.Get(*it);
+      Unpack(label.parent, *it, label.middle, route.nodes);
+    }
+    for (auto node = meeting; node != destination; node = backward.labels.Get(node).parent) {
+      const auto &label = backward.labels.Get(node);
+      Unpack(node, label.parent, label.middle, route.nodes);
+    }
+    return route;
+  }
+
+} // namespace road
+} // namespace carla
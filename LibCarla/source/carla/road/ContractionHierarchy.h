@@ -0,0 +1,95 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/road/LaneGraph.h"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  /// Contraction hierarchy of a LaneGraph, answers the same queries as
+  /// LaneGraph::FindRoute exploring a small fraction of the graph.
+  ///
+  /// On construction the nodes are contracted one by one in order of
+  /// importance, adding shortcut edges that preserve the shortest paths among
+  /// the remaining nodes. A query runs a Dijkstra search from each end
+  /// following only edges towards more important nodes, and the shortcuts of
+  /// the route are unpacked into the nodes of the graph.
+  ///
+  /// The hierarchy only depends on the graph, it must be rebuilt if the
+  /// graph changes.
+  class ContractionHierarchy : private MovableNonCopyable {
+  public:
+
+    using NodeId = LaneGraph::NodeId;
+
+    using Route = LaneGraph::Route;
+
+    /// Maximum number of nodes settled by each search for a path that makes
+    /// a shortcut unnecessary. Lower values preprocess faster but add more
+    /// shortcuts, the routes found are optimal anyway.
+    static constexpr size_t DEFAULT_WITNESS_SEARCH_LIMIT = 500u;
+
+    explicit ContractionHierarchy(
+        const LaneGraph &graph,
+        size_t witness_search_limit = DEFAULT_WITNESS_SEARCH_LIMIT);
+
+    size_t GetNumberOfNodes() const {
+      return _up_offsets.size() - 1u;
+    }
+
+    /// Number of edges added by the contraction.
+    size_t GetNumberOfShortcuts() const {
+      return _number_of_shortcuts;
+    }
+
+    /// @copydoc LaneGraph::FindRoute(NodeId, NodeId) const
+    boost::optional<Route> FindRoute(NodeId origin, NodeId destination) const;
+
+  private:
+
+    /// Edge of the hierarchy, @a middle is the node contracted to create the
+    /// edge if it is a shortcut, LaneGraph::INVALID_NODE otherwise.
+    struct Edge {
+      NodeId target;
+      NodeId middle;
+      double cost;
+    };
+
+    /// Find the edge stored at @a node towards @a target with minimum cost.
+    static const Edge &FindEdge(
+        const std::vector<uint32_t> &offsets,
+        const std::vector<Edge> &edges,
+        NodeId node,
+        NodeId target);
+
+    /// Append to @a nodes the nodes of the edge from @a from to @a to,
+    /// excluding @a from.
+    void Unpack(NodeId from, NodeId to, NodeId middle, std::vector<NodeId> &nodes) const;
+
+    size_t _number_of_shortcuts = 0u;
+
+    /// Edges from each node to more important nodes, stored at the source.
+    std::vector<uint32_t> _up_offsets;
+
+    std::vector<Edge> _up_edges;
+
+    /// Edges from more important nodes to each node, stored at the target
+    /// with the source as Edge::target.
+    std::vector<uint32_t> _down_offsets;
+
+    std::vector<Edge> _down_edges;
+  };
+
+} // namespace road
+} // namespace carla
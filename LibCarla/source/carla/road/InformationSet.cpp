@@ -0,0 +1,69 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/InformationSet.h"
+
+#include "carla/Debug.h"
+#include "carla/road/element/RoadInfoVisitor.h"
+
+namespace carla {
+namespace road {
+
+  using namespace carla::road::element;
+
+  /// Finds the position in InformationSet::_infos_by_type of the visited
+  /// info.
+  class RoadInfoTypeIndexVisitor : private RoadInfoVisitor {
+  public:
+
+    static constexpr size_t invalid_index = detail::RoadInfoTypes::size();
+
+    size_t GetIndex(RoadInfo &info) {
+      _index = invalid_index;
+      info.AcceptVisitor(*this);
+      return _index;
+    }
+
+  private:
+
+    template <typename T>
+    void SetIndex() {
+      _index = detail::RoadInfoTypes::index<T>();
+    }
+
+    void Visit(RoadInfoElevation &) final { SetIndex<RoadInfoElevation>(); }
+    void Visit(RoadInfoGeometry &) final { SetIndex<RoadInfoGeometry>(); }
+    void Visit(RoadInfoLaneAccess &) final { SetIndex<RoadInfoLaneAccess>(); }
+    void Visit(RoadInfoLaneBorder &) final { SetIndex<RoadInfoLaneBorder>(); }
+    void Visit(RoadInfoLaneHeight &) final { SetIndex<RoadInfoLaneHeight>(); }
+    void Visit(RoadInfoLaneMaterial &) final { SetIndex<RoadInfoLaneMaterial>(); }
+    void Visit(RoadInfoLaneOffset &) final { SetIndex<RoadInfoLaneOffset>(); }
+    void Visit(RoadInfoLaneRule &) final { SetIndex<RoadInfoLaneRule>(); }
+    void Visit(RoadInfoLaneVisibility &) final { SetIndex<RoadInfoLaneVisibility>(); }
+    void Visit(RoadInfoLaneWidth &) final { SetIndex<RoadInfoLaneWidth>(); }
+    void Visit(RoadInfoMarkRecord &) final { SetIndex<RoadInfoMarkRecord>(); }
+    void Visit(RoadInfoMarkTypeLine &) final { SetIndex<RoadInfoMarkTypeLine>(); }
+    void Visit(RoadInfoSpeed &) final { SetIndex<RoadInfoSpeed>(); }
+
+    size_t _index = invalid_index;
+  };
+
+  InformationSet::InformationSet(std::vector<std::unique_ptr<RoadInfo>> &&vec)
+    : _road_set(std::move(vec)) {
+    RoadInfoTypeIndexVisitor visitor;
+    // The infos are already sorted by distance, so is every group.
+    for (auto &info : _road_set.GetAll()) {
+      DEBUG_ASSERT(info != nullptr);
+      const auto index = visitor.GetIndex(*info);
+      if (index < _infos_by_type.size()) {
+        _infos_by_type[index].distances.emplace_back(info->GetDistance());
+        _infos_by_type[index].infos.emplace_back(info.get());
+      }
+    }
+  }
+
+} // namespace road
+} // namespace carla
@@ -9,29 +9,86 @@
 #include "carla/NonCopyable.h"
 #include "carla/road/RoadElementSet.h"
 #include "carla/road/element/RoadInfo.h"
-#include "carla/road/element/RoadInfoIterator.h"
 
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <iterator>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 namespace carla {
 namespace road {
 
+namespace detail {
+
+  /// Position of @a T in the list of types @a Types.
+  template <typename T, typename... Types>
+  struct TypeIndex;
+
+  template <typename T, typename... Rest>
+  struct TypeIndex<T, T, Rest...> : std::integral_constant<size_t, 0u> {};
+
+  template <typename T, typename First, typename... Rest>
+  struct TypeIndex<T, First, Rest...>
+    : std::integral_constant<size_t, 1u + TypeIndex<T, Rest...>::value> {};
+
+  template <typename... Types>
+  struct RoadInfoTypeList {
+
+    static constexpr size_t size() {
+      return sizeof...(Types);
+    }
+
+    template <typename T>
+    static constexpr size_t index() {
+      return TypeIndex<T, Types...>::value;
+    }
+  };
+
+  /// Every type of RoadInfo that can be retrieved from an InformationSet.
+  using RoadInfoTypes = RoadInfoTypeList<
+      element::RoadInfoElevation,
+      element::RoadInfoGeometry,
+      element::RoadInfoLaneAccess,
+      element::RoadInfoLaneBorder,
+      element::RoadInfoLaneHeight,
+      element::RoadInfoLaneMaterial,
+      element::RoadInfoLaneOffset,
+      element::RoadInfoLaneRule,
+      element::RoadInfoLaneVisibility,
+      element::RoadInfoLaneWidth,
+      element::RoadInfoMarkRecord,
+      element::RoadInfoMarkTypeLine,
+      element::RoadInfoSpeed>;
+
+} // namespace detail
+
+  /// Set of the RoadInfo records of a road or lane.
+  ///
+  /// On construction the records are grouped by type into arrays sorted by
+  /// distance, retrieving a record of a given type is a binary search in its
+  /// array.
   class InformationSet : private MovableNonCopyable {
   public:
 
     InformationSet() = default;
 
-    InformationSet(std::vector<std::unique_ptr<element::RoadInfo>> &&vec)
-      : _road_set(std::move(vec)) {}
+    InformationSet(std::vector<std::unique_ptr<element::RoadInfo>> &&vec);
+
+    /// Return all infos sorted by distance (s).
+    const std::vector<std::unique_ptr<element::RoadInfo>> &GetAll() const {
+      return _road_set.GetAll();
+    }
 
     /// Return all infos given a type from the start of the road
     template <typename T>
     std::vector<const T *> GetInfos() const {
+      const auto &infos = GetInfosOfType<T>().infos;
       std::vector<const T *> vec;
-      auto it = element::MakeRoadInfoIterator<T>(_road_set.GetAll());
-      for (; !it.IsAtEnd(); ++it) {
-        vec.emplace_back(&*it);
+      vec.reserve(infos.size());
+      for (auto *info : infos) {
+        vec.emplace_back(static_cast<const T *>(info));
       }
       return vec;
     }
@@ -40,13 +97,33 @@ namespace road {
     /// the start of the road
     template <typename T>
     const T *GetInfo(const double s) const {
-      auto it = element::MakeRoadInfoIterator<T>(_road_set.GetReverseSubset(s));
-      return it.IsAtEnd() ? nullptr : &*it;
+      const auto &infos = GetInfosOfType<T>();
+      // Last info at a distance <= s.
+      const auto it = std::upper_bound(infos.distances.begin(), infos.distances.end(), s);
+      if (it == infos.distances.begin()) {
+        return nullptr;
+      }
+      const auto index = std::distance(infos.distances.begin(), it) - 1;
+      return static_cast<const T *>(infos.infos[static_cast<size_t>(index)]);
     }
 
   private:
 
+    /// Infos of a single type, @a distances holds the distance of each info
+    /// in @a infos so the search runs over a contiguous array.
+    struct InfosOfType {
+      std::vector<double> distances;
+      std::vector<const element::RoadInfo *> infos;
+    };
+
+    template <typename T>
+    const InfosOfType &GetInfosOfType() const {
+      return _infos_by_type[detail::RoadInfoTypes::index<T>()];
+    }
+
     RoadElementSet<std::unique_ptr<element::RoadInfo>> _road_set;
+
+    std::array<InfosOfType, detail::RoadInfoTypes::size()> _infos_by_type;
   };
 
 } // road
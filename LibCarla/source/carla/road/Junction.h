@@ -17,6 +17,7 @@ namespace carla {
 namespace road {
 
   class MapBuilder;
+  class CompiledMap;
 
   class Junction : private MovableNonCopyable {
   public:
@@ -68,6 +69,8 @@ namespace road {
 
     friend MapBuilder;
 
+    friend CompiledMap;
+
     JuncId _id;
 
     std::string _name;
@@ -18,6 +18,7 @@ namespace road {
 
   class LaneSection;
   class MapBuilder;
+  class CompiledMap;
   class Road;
 
   class Lane : private MovableNonCopyable {
@@ -103,6 +104,8 @@ namespace road {
 
     friend MapBuilder;
 
+    friend CompiledMap;
+
     LaneSection *_lane_section = nullptr;
 
     LaneId _id = 0;
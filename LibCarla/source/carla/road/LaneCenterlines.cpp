@@ -0,0 +1,191 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/LaneCenterlines.h"
+
+#include "carla/Exception.h"
+#include "carla/geom/Math.h"
+#include "carla/road/Map.h"
+#include "carla/road/element/RoadInfoLaneWidth.h"
+
+#include <boost/container_hash/hash.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace carla {
+namespace road {
+
+  using geom::Math;
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  /// Difference @a b - @a a in degrees wrapped to [-180, 180].
+  static float AngleDifference(float a, float b) {
+    auto diff = std::fmod(b - a, 360.0f);
+    if (diff > 180.0f) {
+      diff -= 360.0f;
+    } else if (diff < -180.0f) {
+      diff += 360.0f;
+    }
+    return diff;
+  }
+
+  /// Interpolate the angles following the shortest arc. The result stays in
+  /// the range of @a a, as the angles returned by Map::ComputeTransform are
+  /// not normalized.
+  static float LerpAngle(float a, float b, float t) {
+    return a + t * AngleDifference(a, b);
+  }
+
+  static double RotationDifference(const geom::Rotation &a, const geom::Rotation &b) {
+    return std::max({
+        std::abs(AngleDifference(a.pitch, b.pitch)),
+        std::abs(AngleDifference(a.yaw, b.yaw)),
+        std::abs(AngleDifference(a.roll, b.roll))});
+  }
+
+  /// Whether every lane of @a section has a width record at the start of the
+  /// section, otherwise Map::ComputeTransform cannot be evaluated.
+  static bool HasLaneWidths(const LaneSection &section) {
+    for (const auto &pair : section.GetLanes()) {
+      if ((pair.first != 0) &&
+          (pair.second.GetInfo<element::RoadInfoLaneWidth>(section.GetDistance()) == nullptr)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // ===========================================================================
+  // -- LaneCenterlines --------------------------------------------------------
+  // ===========================================================================
+
+  size_t LaneCenterlines::LaneKeyHash::operator()(const LaneKey &key) const {
+    size_t seed = 0u;
+    boost::hash_combine(seed, key.road_id);
+    boost::hash_combine(seed, key.section_id);
+    boost::hash_combine(seed, key.lane_id);
+    return seed;
+  }
+
+  LaneCenterlines::LaneCenterlines(const Map &map, const double resolution)
+    : _resolution(resolution) {
+    if (!(resolution > 0.0)) {
+      throw_exception(std::invalid_argument("LaneCenterlines: resolution must be positive"));
+    }
+    for (const auto road_id : map._data.GetRoadIds()) {
+      const auto &road = map._data.GetRoad(road_id);
+      for (const auto &section : road.GetLaneSections()) {
+        if (!HasLaneWidths(section)) {
+          continue;
+        }
+        const auto s0 = section.GetDistance();
+        const auto s1 = std::min(road.UpperBound(s0), road.GetLength());
+        const auto length = s1 - s0;
+        if (!(length > 0.0)) {
+          continue;
+        }
+        const auto count = static_cast<uint32_t>(std::ceil(length / resolution)) + 1u;
+        const auto step = length / static_cast<double>(count - 1u);
+        for (const auto &lane_pair : section.GetLanes()) {
+          const auto lane_id = lane_pair.first;
+          if (lane_id == 0) {
+            continue;
+          }
+          const LaneSamples lane{s0, step, static_cast<uint32_t>(_samples.size()), count};
+          Waypoint waypoint{road.GetId(), section.GetId(), lane_id, s0};
+          for (auto i = 0u; i < count; ++i) {
+            // Avoid rounding the last sample past the end of the road.
+            waypoint.s = (i + 1u == count) ? s1 : s0 + i * step;
+            const auto transform = map.ComputeTransform(waypoint);
+            _samples.emplace_back(Sample{
+                transform.location,
+                transform.rotation,
+                static_cast<float>(map.GetLaneWidth(waypoint))});
+          }
+          _lanes.emplace(LaneKey{road.GetId(), section.GetId(), lane_id}, lane);
+
+          // Measure the error halfway between each pair of samples, where the
+          // interpolation is the furthest from them.
+          for (auto i = 0u; i + 1u < count; ++i) {
+            waypoint.s = s0 + (i + 0.5) * step;
+            const auto expected = map.ComputeTransform(waypoint);
+            const auto expected_width = map.GetLaneWidth(waypoint);
+            const auto sample = GetSample(waypoint);
+            DEBUG_ASSERT(sample.has_value());
+            _stats.max_location_error = std::max(
+                _stats.max_location_error,
+                static_cast<double>(Math::Distance(sample->location, expected.location)));
+            _stats.max_rotation_error = std::max(
+                _stats.max_rotation_error,
+                RotationDifference(sample->rotation, expected.rotation));
+            _stats.max_width_error = std::max(
+                _stats.max_width_error,
+                std::abs(sample->width - expected_width));
+          }
+        }
+      }
+    }
+    _samples.shrink_to_fit();
+    _stats.samples = _samples.size();
+    _stats.memory =
+        _samples.capacity() * sizeof(Sample) +
+        _lanes.size() * (sizeof(LaneKey) + sizeof(LaneSamples) + sizeof(void *)) +
+        _lanes.bucket_count() * sizeof(void *);
+  }
+
+  auto LaneCenterlines::GetSample(const Waypoint &waypoint) const
+      -> boost::optional<Sample> {
+    const auto it = _lanes.find(LaneKey{waypoint.road_id, waypoint.section_id, waypoint.lane_id});
+    if (it == _lanes.end()) {
+      return {};
+    }
+    const auto &lane = it->second;
+    DEBUG_ASSERT(lane.count >= 2u);
+    const auto last = static_cast<double>(lane.count - 1u);
+    const auto u = (waypoint.s - lane.s) / lane.step;
+    // Waypoints of a lane section may be slightly past its end, but
+    // extrapolating further would not be accurate.
+    constexpr double margin = 1e-3;
+    if ((u < -margin) || (u > last + margin)) {
+      return {};
+    }
+    const auto index = static_cast<uint32_t>(Math::Clamp(std::floor(u), 0.0, last - 1.0));
+    const auto t = static_cast<float>(Math::Clamp(u - index, 0.0, 1.0));
+    const auto &a = _samples[lane.first + index];
+    const auto &b = _samples[lane.first + index + 1u];
+    return Sample{
+        Math::Lerp<geom::Vector3D>(a.location, b.location, t),
+        geom::Rotation{
+            LerpAngle(a.rotation.pitch, b.rotation.pitch, t),
+            LerpAngle(a.rotation.yaw, b.rotation.yaw, t),
+            LerpAngle(a.rotation.roll, b.rotation.roll, t)},
+        Math::Lerp(a.width, b.width, t)};
+  }
+
+  boost::optional<geom::Transform> LaneCenterlines::ComputeTransform(
+      const Waypoint waypoint) const {
+    const auto sample = GetSample(waypoint);
+    if (!sample.has_value()) {
+      return {};
+    }
+    return geom::Transform{sample->location, sample->rotation};
+  }
+
+  boost::optional<double> LaneCenterlines::GetLaneWidth(const Waypoint waypoint) const {
+    const auto sample = GetSample(waypoint);
+    if (!sample.has_value()) {
+      return {};
+    }
+    return static_cast<double>(sample->width);
+  }
+
+} // namespace road
+} // namespace carla
@@ -0,0 +1,117 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/geom/Transform.h"
+#include "carla/road/RoadTypes.h"
+#include "carla/road/element/Waypoint.h"
+
+#include <boost/optional.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  class Map;
+
+  /// The center line of every lane of a map sampled at a fixed resolution
+  /// along the road.
+  ///
+  /// ComputeTransform and GetLaneWidth return the same values as the
+  /// functions of Map interpolated between the two closest samples, instead
+  /// of evaluating the road geometry and the width of every inner lane. The
+  /// error is measured on construction halfway between each pair of samples,
+  /// see Stats.
+  class LaneCenterlines : private MovableNonCopyable {
+  public:
+
+    using Waypoint = element::Waypoint;
+
+    struct Stats {
+      /// Number of samples of all the lanes.
+      size_t samples = 0u;
+      /// Bytes used by the samples and the table of lanes.
+      size_t memory = 0u;
+      /// Maximum distance in meters between the interpolated and the exact
+      /// location.
+      double max_location_error = 0.0;
+      /// Maximum difference in degrees between the interpolated and the exact
+      /// rotation.
+      double max_rotation_error = 0.0;
+      /// Maximum difference in meters between the interpolated and the exact
+      /// lane width.
+      double max_width_error = 0.0;
+    };
+
+    /// Sample every lane of @a map each @a resolution meters.
+    LaneCenterlines(const Map &map, double resolution);
+
+    double GetResolution() const {
+      return _resolution;
+    }
+
+    const Stats &GetStats() const {
+      return _stats;
+    }
+
+    /// Return nothing if the lane of @a waypoint was not sampled.
+    boost::optional<geom::Transform> ComputeTransform(Waypoint waypoint) const;
+
+    /// Return nothing if the lane of @a waypoint was not sampled.
+    boost::optional<double> GetLaneWidth(Waypoint waypoint) const;
+
+  private:
+
+    struct Sample {
+      geom::Location location;
+      geom::Rotation rotation;
+      float width;
+    };
+
+    /// Samples [first, first + count) of a lane, the i-th one at distance
+    /// s + i * step.
+    struct LaneSamples {
+      double s;
+      double step;
+      uint32_t first;
+      uint32_t count;
+    };
+
+    struct LaneKey {
+      RoadId road_id;
+      SectionId section_id;
+      LaneId lane_id;
+
+      bool operator==(const LaneKey &rhs) const {
+        return (road_id == rhs.road_id) &&
+            (section_id == rhs.section_id) &&
+            (lane_id == rhs.lane_id);
+      }
+    };
+
+    struct LaneKeyHash {
+      size_t operator()(const LaneKey &key) const;
+    };
+
+    /// Interpolate the samples of the lane of @a waypoint. Return nothing if
+    /// the lane was not sampled or @a waypoint is out of its lane section.
+    boost::optional<Sample> GetSample(const Waypoint &waypoint) const;
+
+    double _resolution;
+
+    std::unordered_map<LaneKey, LaneSamples, LaneKeyHash> _lanes;
+
+    std::vector<Sample> _samples;
+
+    Stats _stats;
+  };
+
+} // namespace road
+} // namespace carla
@@ -0,0 +1,194 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/LaneGraph.h"
+
+#include "carla/Exception.h"
+#include "carla/geom/Math.h"
+#include "carla/road/Map.h"
+
+#include <boost/container_hash/hash.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace carla {
+namespace road {
+
+  using geom::Math;
+
+  constexpr LaneGraph::NodeId LaneGraph::INVALID_NODE;
+  constexpr double LaneGraph::DEFAULT_LANE_CHANGE_COST;
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  static double Distance(const geom::Location &a, const geom::Location &b) {
+    return static_cast<double>(Math::Distance(a, b));
+  }
+
+  // ===========================================================================
+  // -- LaneGraph --------------------------------------------------------------
+  // ===========================================================================
+
+  size_t LaneGraph::LaneKeyHash::operator()(const LaneKey &key) const {
+    size_t seed = 0u;
+    boost::hash_combine(seed, key.road_id);
+    boost::hash_combine(seed, key.section_id);
+    boost::hash_combine(seed, key.lane_id);
+    return seed;
+  }
+
+  LaneGraph::LaneGraph(const Map &map, const double lane_change_cost)
+    : _lane_change_cost(lane_change_cost) {
+    if (!(lane_change_cost >= 0.0)) {
+      throw_exception(std::invalid_argument("LaneGraph: lane change cost must not be negative"));
+    }
+
+    for (const auto &waypoint : map.GenerateWaypointsOnLaneEntries()) {
+      const auto id = static_cast<NodeId>(_nodes.size());
+      _nodes.emplace_back(NodeData{
+          waypoint,
+          map.ComputeTransform(waypoint).location,
+          map.GetLane(waypoint).GetLength()});
+      _node_ids.emplace(LaneKey{waypoint.road_id, waypoint.section_id, waypoint.lane_id}, id);
+    }
+
+    _edge_offsets.reserve(_nodes.size() + 1u);
+    _edge_offsets.emplace_back(0u);
+    for (auto i = 0u; i < _nodes.size(); ++i) {
+      const auto &node = _nodes[i];
+      const auto first_edge = _edges.size();
+      auto add_edge = [&](const NodeId target, const EdgeType type, const double cost) {
+        // Keep a single edge, the cheapest, to each target.
+        for (auto j = first_edge; j < _edges.size(); ++j) {
+          if (_edges[j].target == target) {
+            if (cost < _edges[j].cost) {
+              _edges[j] = Edge{target, type, cost};
+            }
+            return;
+          }
+        }
+        _edges.emplace_back(Edge{target, type, cost});
+      };
+
+      for (const auto &successor : map.GetSuccessors(node.waypoint)) {
+        const auto target = GetNode(successor);
+        if (target.has_value() && (*target != i)) {
+          const auto distance = Distance(node.location, _nodes[*target].location);
+          add_edge(*target, EdgeType::Successor, std::max(node.length, distance));
+        }
+      }
+
+      if (!map.IsJunction(node.waypoint.road_id)) {
+        auto add_lane_change = [&](const boost::optional<Waypoint> &lane, const EdgeType type) {
+          if (!lane.has_value() || ((lane->lane_id < 0) != (node.waypoint.lane_id < 0))) {
+            return;
+          }
+          const auto target = GetNode(*lane);
+          if (target.has_value()) {
+            const auto distance = Distance(node.location, _nodes[*target].location);
+            add_edge(*target, type, distance + _lane_change_cost);
+          }
+        };
+        add_lane_change(map.GetLeft(node.waypoint), EdgeType::LaneChangeLeft);
+        add_lane_change(map.GetRight(node.waypoint), EdgeType::LaneChangeRight);
+      }
+
+      _edge_offsets.emplace_back(static_cast<uint32_t>(_edges.size()));
+    }
+    _edges.shrink_to_fit();
+  }
+
+  auto LaneGraph::GetNodeData(const NodeId node) const -> const NodeData & {
+    if (node >= _nodes.size()) {
+      throw_exception(std::out_of_range("LaneGraph: invalid node id"));
+    }
+    return _nodes[node];
+  }
+
+  boost::optional<LaneGraph::NodeId> LaneGraph::GetNode(const Waypoint &waypoint) const {
+    const auto it = _node_ids.find(LaneKey{waypoint.road_id, waypoint.section_id, waypoint.lane_id});
+    if (it == _node_ids.end()) {
+      return {};
+    }
+    return it->second;
+  }
+
+  LaneGraph::EdgeList LaneGraph::GetEdges(const NodeId node) const {
+    GetNodeData(node);
+    return EdgeList(
+        _edges.begin() + _edge_offsets[node],
+        _edges.begin() + _edge_offsets[node + 1u]);
+  }
+
+  boost::optional<LaneGraph::Route> LaneGraph::FindRoute(
+      const NodeId origin,
+      const NodeId destination) const {
+    GetNodeData(origin);
+    const auto &target = GetNodeData(destination).location;
+
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    std::vector<double> cost(_nodes.size(), infinity);
+    std::vector<NodeId> parent(_nodes.size(), INVALID_NODE);
+
+    // Pairs of (cost + heuristic, node), the heuristic being consistent each
+    // node is settled once.
+    using Entry = std::pair<double, NodeId>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    cost[origin] = 0.0;
+    open.emplace(Distance(_nodes[origin].location, target), origin);
+
+    while (!open.empty()) {
+      const auto node = open.top().second;
+      const auto estimate = open.top().first;
+      open.pop();
+      if (node == destination) {
+        break;
+      }
+      if (estimate > cost[node] + Distance(_nodes[node].location, target)) {
+        continue; // Stale entry.
+      }
+      for (auto i = _edge_offsets[node]; i < _edge_offsets[node + 1u]; ++i) {
+        const auto &edge = _edges[i];
+        const auto new_cost = cost[node] + edge.cost;
+        if (new_cost < cost[edge.target]) {
+          cost[edge.target] = new_cost;
+          parent[edge.target] = node;
+          open.emplace(new_cost + Distance(_nodes[edge.target].location, target), edge.target);
+        }
+      }
+    }
+
+    if (cost[destination] == infinity) {
+      return {};
+    }
+    Route route;
+    route.cost = cost[destination];
+    for (auto node = destination; node != INVALID_NODE; node = parent[node]) {
+      route.nodes.emplace_back(node);
+    }
+    std::reverse(route.nodes.begin(), route.nodes.end());
+    return route;
+  }
+
+  boost::optional<LaneGraph::Route> LaneGraph::FindRoute(
+      const Waypoint &origin,
+      const Waypoint &destination) const {
+    const auto origin_node = GetNode(origin);
+    const auto destination_node = GetNode(destination);
+    if (!origin_node.has_value() || !destination_node.has_value()) {
+      return {};
+    }
+    return FindRoute(*origin_node, *destination_node);
+  }
+
+} // namespace road
+} // namespace carla
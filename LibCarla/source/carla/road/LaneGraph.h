@@ -0,0 +1,158 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/ListView.h"
+#include "carla/NonCopyable.h"
+#include "carla/geom/Location.h"
+#include "carla/road/RoadTypes.h"
+#include "carla/road/element/Waypoint.h"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  class Map;
+
+  /// Directed graph of the drivable lanes of a Map, used for routing.
+  ///
+  /// There is a node for each drivable lane of each lane section, placed at
+  /// the entrance of the lane. A node has an edge to each of its successor
+  /// lanes, with the length of the lane as cost, and an edge to its left and
+  /// right lanes in the same direction, except in junctions, with the
+  /// distance between the entrances plus a fixed lane change cost. Lane
+  /// markings are not taken into account.
+  ///
+  /// The cost of every edge is at least the distance between the entrances
+  /// of its nodes, so the straight-line distance to the destination is a
+  /// consistent heuristic for A*.
+  class LaneGraph : private MovableNonCopyable {
+  public:
+
+    using Waypoint = element::Waypoint;
+
+    using NodeId = uint32_t;
+
+    static constexpr NodeId INVALID_NODE = std::numeric_limits<NodeId>::max();
+
+    static constexpr double DEFAULT_LANE_CHANGE_COST = 10.0;
+
+    enum class EdgeType : uint8_t {
+      Successor,
+      LaneChangeLeft,
+      LaneChangeRight
+    };
+
+    struct Edge {
+      NodeId target;
+      EdgeType type;
+      double cost;
+    };
+
+    using EdgeList = ListView<std::vector<Edge>::const_iterator>;
+
+    /// The nodes of a route in driving order, from the origin to the
+    /// destination both included.
+    struct Route {
+      std::vector<NodeId> nodes;
+      double cost = 0.0;
+    };
+
+    /// Build the graph of @a map. @a lane_change_cost is added to the cost of
+    /// every lane change edge, it must not be negative.
+    explicit LaneGraph(const Map &map, double lane_change_cost = DEFAULT_LANE_CHANGE_COST);
+
+    size_t GetNumberOfNodes() const {
+      return _nodes.size();
+    }
+
+    size_t GetNumberOfEdges() const {
+      return _edges.size();
+    }
+
+    double GetLaneChangeCost() const {
+      return _lane_change_cost;
+    }
+
+    /// Node of the lane of @a waypoint, nothing if it is not a drivable lane.
+    boost::optional<NodeId> GetNode(const Waypoint &waypoint) const;
+
+    /// Waypoint at the entrance of the lane of @a node.
+    const Waypoint &GetWaypoint(NodeId node) const {
+      return GetNodeData(node).waypoint;
+    }
+
+    /// Location of the entrance of the lane of @a node.
+    const geom::Location &GetLocation(NodeId node) const {
+      return GetNodeData(node).location;
+    }
+
+    /// Length of the lane of @a node.
+    double GetLength(NodeId node) const {
+      return GetNodeData(node).length;
+    }
+
+    /// Outgoing edges of @a node.
+    EdgeList GetEdges(NodeId node) const;
+
+    /// Find the route of minimum cost between the entrances of the lanes of
+    /// @a origin and @a destination using A*. Return nothing if there is no
+    /// route.
+    boost::optional<Route> FindRoute(NodeId origin, NodeId destination) const;
+
+    /// @copydoc FindRoute(NodeId, NodeId) const
+    ///
+    /// Return nothing too if any of the waypoints is not on a drivable lane.
+    boost::optional<Route> FindRoute(const Waypoint &origin, const Waypoint &destination) const;
+
+  private:
+
+    struct NodeData {
+      Waypoint waypoint;
+      geom::Location location;
+      double length;
+    };
+
+    struct LaneKey {
+      RoadId road_id;
+      SectionId section_id;
+      LaneId lane_id;
+
+      bool operator==(const LaneKey &rhs) const {
+        return (road_id == rhs.road_id) &&
+            (section_id == rhs.section_id) &&
+            (lane_id == rhs.lane_id);
+      }
+    };
+
+    struct LaneKeyHash {
+      size_t operator()(const LaneKey &key) const;
+    };
+
+    /// Throw std::out_of_range if @a node is not a node of this graph.
+    const NodeData &GetNodeData(NodeId node) const;
+
+    double _lane_change_cost;
+
+    std::vector<NodeData> _nodes;
+
+    std::unordered_map<LaneKey, NodeId, LaneKeyHash> _node_ids;
+
+    /// Edges of the i-th node are [_edge_offsets[i], _edge_offsets[i + 1]).
+    std::vector<uint32_t> _edge_offsets;
+
+    std::vector<Edge> _edges;
+  };
+
+} // namespace road
+} // namespace carla
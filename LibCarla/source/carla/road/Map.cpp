@@ -14,6 +14,9 @@
 #include "carla/road/element/RoadInfoLaneOffset.h"
 #include "carla/geom/Math.h"
 
+#include <boost/container/small_vector.hpp>
+
+#include <algorithm>
 #include <stdexcept>
 
 namespace carla {
@@ -29,18 +32,6 @@ namespace road {
   // -- Static local methods ---------------------------------------------------
   // ===========================================================================
 
-  template <typename T>
-  static std::vector<T> ConcatVectors(std::vector<T> dst, std::vector<T> src) {
-    if (src.size() > dst.size()) {
-      return ConcatVectors(src, dst);
-    }
-    dst.insert(
-        dst.end(),
-        std::make_move_iterator(src.begin()),
-        std::make_move_iterator(src.end()));
-    return dst;
-  }
-
   static double GetDistanceAtStartOfLane(const Lane &lane) {
     if (lane.GetId() <= 0) {
       return lane.GetDistance() + 10.0 * EPSILON;
@@ -57,6 +48,104 @@ namespace road {
     }
   }
 
+  /// Move @a waypoint @a distance along its lane, towards the successors of
+  /// the lane if @a towards_successors, towards its predecessors otherwise.
+  /// If the lane ends before, return false and subtract the rest of the lane
+  /// from @a distance.
+  static bool MoveAlongLane(
+      const Lane &lane,
+      Waypoint &waypoint,
+      double &distance,
+      const bool towards_successors) {
+    const bool increasing_s = ((waypoint.lane_id <= 0) == towards_successors);
+    const double relative_s = waypoint.s - lane.GetDistance() + EPSILON;
+    const double remaining_lane_length = increasing_s ? lane.GetLength() - relative_s : relative_s;
+    DEBUG_ASSERT(remaining_lane_length >= 0.0);
+    if (distance <= remaining_lane_length) {
+      waypoint.s += increasing_s ? distance : -distance;
+      waypoint.s += increasing_s ? -EPSILON : EPSILON;
+      RELEASE_ASSERT(waypoint.s > 0.0);
+      return true;
+    }
+    distance -= remaining_lane_length;
+    return false;
+  }
+
+  /// Append to @a result the waypoints at @a distance from @a waypoint,
+  /// following the successors of the lanes, or their predecessors if not @a
+  /// towards_successors.
+  ///
+  /// Walks the linked lanes depth-first with an explicit stack. The order of
+  /// the result is the one of the former recursive implementation: the
+  /// waypoints found through each linked lane went after the ones found
+  /// through the previous links, or before them if there were more.
+  static void WalkLanes(
+      const Map &map,
+      const Waypoint waypoint,
+      const double distance,
+      const bool towards_successors,
+      std::vector<Waypoint> &result) {
+    RELEASE_ASSERT(distance > 0.0);
+
+    struct Frame {
+      const Lane *lane;
+      /// Distance left at the end of the lane.
+      double distance;
+      size_t next_link;
+      /// Index in result of the first waypoint found through this lane, and
+      /// through its current link.
+      size_t begin;
+      size_t link_begin;
+    };
+    boost::container::small_vector<Frame, 16u> stack;
+
+    auto visit = [&](Waypoint current, double remaining) {
+      const auto &lane = map.GetLane(current);
+      if (MoveAlongLane(lane, current, remaining, towards_successors)) {
+        result.emplace_back(current);
+      } else {
+        stack.emplace_back(Frame{&lane, remaining, 0u, result.size(), result.size()});
+      }
+    };
+
+    visit(waypoint, distance);
+    while (!stack.empty()) {
+      auto &frame = stack.back();
+      if (frame.next_link > 0u) {
+        const auto previous = frame.link_begin - frame.begin;
+        const auto added = result.size() - frame.link_begin;
+        if (added > previous) {
+          std::rotate(
+              result.begin() + static_cast<std::ptrdiff_t>(frame.begin),
+              result.begin() + static_cast<std::ptrdiff_t>(frame.link_begin),
+              result.end());
+        }
+      }
+      const auto &links = towards_successors ?
+          frame.lane->GetNextLanes() :
+          frame.lane->GetPreviousLanes();
+      if (frame.next_link == links.size()) {
+        stack.pop_back();
+        continue;
+      }
+      const auto *link = links[frame.next_link++];
+      RELEASE_ASSERT(link != nullptr);
+      DEBUG_ASSERT(link != frame.lane);
+      const auto lane_id = link->GetId();
+      RELEASE_ASSERT(lane_id != 0);
+      const auto *section = link->GetLaneSection();
+      RELEASE_ASSERT(section != nullptr);
+      const auto *road = link->GetRoad();
+      RELEASE_ASSERT(road != nullptr);
+      const auto s = towards_successors ?
+          GetDistanceAtStartOfLane(*link) :
+          GetDistanceAtEndOfLane(*link);
+      frame.link_begin = result.size();
+      // May reallocate the stack, frame is not used afterwards.
+      visit(Waypoint{road->GetId(), section->GetId(), lane_id, s}, frame.distance);
+    }
+  }
+
   /// Return a waypoint for each drivable lane on @a lane_section.
   template <typename FuncT>
   static void ForEachDrivableLaneImpl(
@@ -88,15 +177,40 @@ namespace road {
     }
   }
 
-  /// Return a waypoint for each drivable lane at @a distance on @a road.
+  /// Return a waypoint for each drivable lane every @a distance along @a
+  /// road. The lane sections are walked once in order instead of searched at
+  /// each step.
   template <typename FuncT>
-  static void ForEachDrivableLaneAt(const Road &road, double distance, FuncT &&func) {
-    for (const auto &lane_section : road.GetLaneSectionsAt(distance)) {
-      ForEachDrivableLaneImpl(
-          road.GetId(),
-          lane_section,
-          distance,
-          std::forward<FuncT>(func));
+  static void ForEachDrivableLaneAlong(const Road &road, double distance, FuncT &&func) {
+    boost::container::small_vector<const LaneSection *, 8u> sections;
+    for (const auto &lane_section : road.GetLaneSections()) {
+      sections.emplace_back(&lane_section);
+    }
+    // Sections starting at the same s are visited together, as
+    // Road::GetLaneSectionsAt does.
+    auto next_group = [&](size_t i) {
+      const auto start = sections[i]->GetDistance();
+      while ((i < sections.size()) && (sections[i]->GetDistance() == start)) {
+        ++i;
+      }
+      return i;
+    };
+    if (sections.empty()) {
+      return;
+    }
+    size_t group_begin = 0u;
+    size_t group_end = next_group(group_begin);
+    for (double s = EPSILON; s < (road.GetLength() - EPSILON); s += distance) {
+      while ((group_end < sections.size()) && (sections[group_end]->GetDistance() <= s)) {
+        group_begin = group_end;
+        group_end = next_group(group_begin);
+      }
+      if (sections[group_begin]->GetDistance() > s) {
+        continue;
+      }
+      for (auto i = group_begin; i < group_end; ++i) {
+        ForEachDrivableLaneImpl(road.GetId(), *sections[i], s, std::forward<FuncT>(func));
+      }
     }
   }
 
@@ -129,6 +243,28 @@ namespace road {
     return std::make_pair(dist, tangent);
   }
 
+  /// Waypoint of the lane @a lane_id of @a road at distance @a s, kept
+  /// slightly inside the road.
+  static Waypoint MakeWaypointOnRoad(const Road &road, const LaneId lane_id, const double s) {
+    Waypoint waypoint;
+    waypoint.road_id = road.GetId();
+    waypoint.lane_id = lane_id;
+
+    // Make sure 0.0 < waipoint.s < Road's length
+    constexpr double margin = 5.0 * EPSILON;
+    DEBUG_ASSERT(margin < road.GetLength() - margin);
+    waypoint.s = geom::Math::Clamp(s, margin, road.GetLength() - margin);
+
+    auto &lane = road.GetLaneByDistance(waypoint.s, waypoint.lane_id);
+
+    const auto lane_section = lane.GetLaneSection();
+    RELEASE_ASSERT(lane_section != nullptr);
+    const auto lane_section_id = lane_section->GetId();
+    waypoint.section_id = lane_section_id;
+
+    return waypoint;
+  }
+
   /// Assumes road_id and section_id are valid.
   static bool IsLanePresent(const MapData &data, Waypoint waypoint) {
     const auto &section = data.GetRoad(waypoint.road_id).GetLaneSectionById(waypoint.section_id);
@@ -142,58 +278,34 @@ namespace road {
   boost::optional<Waypoint> Map::GetClosestWaypointOnRoad(
       const geom::Location &pos,
       uint32_t lane_type) const {
+    RoadSpatialIndex::SearchBuffers buffers;
+    return GetClosestWaypointOnRoad(pos, lane_type, buffers);
+  }
+
+  boost::optional<Waypoint> Map::GetClosestWaypointOnRoad(
+      const geom::Location &pos,
+      const uint32_t lane_type,
+      RoadSpatialIndex::SearchBuffers &buffers) const {
     // max_nearests represents the max nearests roads
     // where we will search for nearests lanes
     constexpr size_t max_nearests = 50u;
-    // in case that map has less than max_nearests lanes,
-    // we will use the maximum lanes
-    const size_t max_nearest_allowed = std::min(_data.GetRoadCount(), max_nearests);
 
     // Unreal's Y axis hack
     const auto pos_inverted_y = geom::Location(pos.x, -pos.y, pos.z);
 
-    double nearest_dist[max_nearests];
-    std::fill(nearest_dist, nearest_dist + max_nearest_allowed,
-        std::numeric_limits<double>::max());
+    const auto &nearest_roads = _road_index.FindKNearest(_data, pos_inverted_y, max_nearests, buffers);
 
-    RoadId ids[max_nearests];
-    std::fill(ids, ids + max_nearest_allowed, 0);
-
-    double dists[max_nearests];
-    std::fill(dists, dists + max_nearest_allowed, 0.0);
-
-    for (const auto &road_pair : _data.GetRoads()) {
-      const auto road = &road_pair.second;
-      const auto current_dist = road->GetNearestPoint(pos_inverted_y);
-
-      for (size_t i = 0u; i < max_nearest_allowed; ++i) {
-        if (current_dist.second < nearest_dist[i]) {
-          // reorder nearest_dist
-          for (size_t j = max_nearest_allowed - 1u; j > i; --j) {
-            DEBUG_ASSERT(j > 0u);
-            nearest_dist[j] = nearest_dist[j - 1];
-            ids[j] = ids[j - 1];
-            dists[j] = dists[j - 1];
-          }
-          nearest_dist[i] = current_dist.second;
-          ids[i] = road->GetId();
-          dists[i] = current_dist.first;
-          break;
-        }
-      }
-    }
-
-    // search for the nearest lane in nearest_dist
+    // search for the nearest lane in nearest_roads
     Waypoint waypoint;
     auto nearest_lane_dist = std::numeric_limits<double>::max();
-    for (size_t i = 0u; i < max_nearest_allowed; ++i) {
-      auto lane_dist = _data.GetRoad(ids[i]).GetNearestLane(dists[i], pos_inverted_y, lane_type);
+    for (const auto &road : nearest_roads) {
+      auto lane_dist = _data.GetRoad(road.road_id).GetNearestLane(road.s, pos_inverted_y, lane_type);
 
       if (lane_dist.second < nearest_lane_dist) {
         nearest_lane_dist = lane_dist.second;
         waypoint.lane_id = lane_dist.first->GetId();
-        waypoint.road_id = ids[i];
-        waypoint.s = dists[i];
+        waypoint.road_id = road.road_id;
+        waypoint.s = road.s;
       }
     }
 
@@ -201,48 +313,140 @@ namespace road {
       return boost::optional<Waypoint>{};
     }
 
-    const auto &road = _data.GetRoad(waypoint.road_id);
-
-    // Make sure 0.0 < waipoint.s < Road's length
-    constexpr double margin = 5.0 * EPSILON;
-    DEBUG_ASSERT(margin < road.GetLength() - margin);
-    waypoint.s = geom::Math::Clamp(waypoint.s, margin, road.GetLength() - margin);
-
-    auto &lane = road.GetLaneByDistance(waypoint.s, waypoint.lane_id);
-
-    const auto lane_section = lane.GetLaneSection();
-    RELEASE_ASSERT(lane_section != nullptr);
-    const auto lane_section_id = lane_section->GetId();
-    waypoint.section_id = lane_section_id;
-
-    return waypoint;
+    return MakeWaypointOnRoad(_data.GetRoad(waypoint.road_id), waypoint.lane_id, waypoint.s);
   }
 
   boost::optional<Waypoint> Map::GetWaypoint(
       const geom::Location &pos,
       uint32_t lane_type) const {
-    boost::optional<Waypoint> w = GetClosestWaypointOnRoad(pos, lane_type);
+    RoadSpatialIndex::SearchBuffers buffers;
+    return GetWaypoint(pos, lane_type, buffers);
+  }
+
+  boost::optional<Waypoint> Map::GetWaypoint(
+      const geom::Location &pos,
+      const uint32_t lane_type,
+      RoadSpatialIndex::SearchBuffers &buffers) const {
+    boost::optional<Waypoint> w = GetClosestWaypointOnRoad(pos, lane_type, buffers);
 
     if (!w.has_value()) {
       return w;
     }
 
-    const auto dist = geom::Math::Distance2D(ComputeTransform(*w).location, pos);
-    const auto lane_width_info = GetLane(*w).GetInfo<RoadInfoLaneWidth>(w->s);
-    const auto half_lane_width =
-        lane_width_info->GetPolynomial().Evaluate(w->s) * 0.5;
-
-    if (dist < half_lane_width) {
+    if (IsInsideLane(*w, pos)) {
       return w;
     }
 
     return boost::optional<Waypoint>{};
   }
 
+  boost::optional<Waypoint> Map::GetClosestWaypointOnRoad(
+      const geom::Location &pos,
+      const Waypoint &hint,
+      const uint32_t lane_type) const {
+    auto w = GetWaypointNearHint(pos, hint, lane_type);
+    return w.has_value() ? w : GetClosestWaypointOnRoad(pos, lane_type);
+  }
+
+  boost::optional<Waypoint> Map::GetWaypoint(
+      const geom::Location &pos,
+      const Waypoint &hint,
+      const uint32_t lane_type) const {
+    auto w = GetWaypointNearHint(pos, hint, lane_type);
+    return w.has_value() ? w : GetWaypoint(pos, lane_type);
+  }
+
+  bool Map::IsInsideLane(const Waypoint waypoint, const geom::Location &pos) const {
+    const auto dist = geom::Math::Distance2D(ComputeTransform(waypoint).location, pos);
+    const auto lane_width_info = GetLane(waypoint).GetInfo<RoadInfoLaneWidth>(waypoint.s);
+    const auto half_lane_width =
+        lane_width_info->GetPolynomial().Evaluate(waypoint.s) * 0.5;
+    return dist < half_lane_width;
+  }
+
+  boost::optional<Waypoint> Map::GetWaypointNearHint(
+      const geom::Location &pos,
+      const Waypoint &hint,
+      const uint32_t lane_type) const {
+    if (!_data.ContainsRoad(hint.road_id)) {
+      return boost::optional<Waypoint>{};
+    }
+
+    // Unreal's Y axis hack
+    const auto pos_inverted_y = geom::Location(pos.x, -pos.y, pos.z);
+
+    // Same as GetClosestWaypointOnRoad but only over the given road, the
+    // waypoint is kept if the location is inside its lane.
+    boost::optional<Waypoint> result;
+    auto nearest_lane_dist = std::numeric_limits<double>::max();
+    auto visit_road = [&](const Road &road) {
+      const auto nearest = road.GetNearestPoint(pos_inverted_y);
+      const auto lane_dist = road.GetNearestLane(nearest.first, pos_inverted_y, lane_type);
+      if ((lane_dist.first == nullptr) || (lane_dist.second >= nearest_lane_dist)) {
+        return;
+      }
+      const auto waypoint = MakeWaypointOnRoad(road, lane_dist.first->GetId(), nearest.first);
+      if (IsInsideLane(waypoint, pos)) {
+        result = waypoint;
+        nearest_lane_dist = lane_dist.second;
+      }
+    };
+
+    // Most of the time the location is still on the road of the hint.
+    const auto &road = _data.GetRoad(hint.road_id);
+    visit_road(road);
+    if (result.has_value()) {
+      return result;
+    }
+
+    for (const auto *next : road.GetNexts()) {
+      visit_road(*next);
+    }
+    for (const auto *prev : road.GetPrevs()) {
+      visit_road(*prev);
+    }
+    return result;
+  }
+
+  std::vector<boost::optional<Waypoint>> Map::GetClosestWaypointsOnRoad(
+      const geom::Location *begin,
+      const geom::Location *end,
+      const uint32_t lane_type) const {
+    DEBUG_ASSERT(begin <= end);
+    std::vector<boost::optional<Waypoint>> result;
+    result.reserve(static_cast<size_t>(end - begin));
+    RoadSpatialIndex::SearchBuffers buffers;
+    for (auto it = begin; it != end; ++it) {
+      result.emplace_back(GetClosestWaypointOnRoad(*it, lane_type, buffers));
+    }
+    return result;
+  }
+
+  std::vector<boost::optional<Waypoint>> Map::GetWaypoints(
+      const geom::Location *begin,
+      const geom::Location *end,
+      const uint32_t lane_type) const {
+    DEBUG_ASSERT(begin <= end);
+    std::vector<boost::optional<Waypoint>> result;
+    result.reserve(static_cast<size_t>(end - begin));
+    RoadSpatialIndex::SearchBuffers buffers;
+    for (auto it = begin; it != end; ++it) {
+      result.emplace_back(GetWaypoint(*it, lane_type, buffers));
+    }
+    return result;
+  }
+
   geom::Transform Map::ComputeTransform(Waypoint waypoint) const {
     // lane_id can't be 0
     RELEASE_ASSERT(waypoint.lane_id != 0);
 
+    if (_lane_centerlines != nullptr) {
+      const auto transform = _lane_centerlines->ComputeTransform(waypoint);
+      if (transform.has_value()) {
+        return *transform;
+      }
+    }
+
     const auto &road = _data.GetRoad(waypoint.road_id);
 
     // must s be smaller (or eq) than road lenght and bigger (or eq) than 0?
@@ -308,6 +512,17 @@ namespace road {
     return geom::Transform(dp.location, rot);
   }
 
+  // ===========================================================================
+  // -- Map: Lane centerlines --------------------------------------------------
+  // ===========================================================================
+
+  const LaneCenterlines::Stats &Map::BuildLaneCenterlines(const double resolution) {
+    // The samples are taken from the analytic path.
+    _lane_centerlines.reset();
+    _lane_centerlines = std::make_unique<LaneCenterlines>(*this, resolution);
+    return _lane_centerlines->GetStats();
+  }
+
   // ===========================================================================
   // -- Map: Road information --------------------------------------------------
   // ===========================================================================
@@ -317,6 +532,13 @@ namespace road {
   }
 
   double Map::GetLaneWidth(const Waypoint waypoint) const {
+    if (_lane_centerlines != nullptr) {
+      const auto width = _lane_centerlines->GetLaneWidth(waypoint);
+      if (width.has_value()) {
+        return *width;
+      }
+    }
+
     const auto s = waypoint.s;
 
     const auto &lane = GetLane(waypoint);
@@ -406,36 +628,61 @@ namespace road {
   std::vector<Waypoint> Map::GetNext(
       const Waypoint waypoint,
       const double distance) const {
-    RELEASE_ASSERT(distance > 0.0);
-    const auto &lane = GetLane(waypoint);
-    const bool forward = (waypoint.lane_id <= 0);
-    const double signed_distance = forward ? distance : -distance;
-    const double relative_s = waypoint.s - lane.GetDistance() + EPSILON;
-    const double remaining_lane_length = forward ? lane.GetLength() - relative_s : relative_s;
-    DEBUG_ASSERT(remaining_lane_length >= 0.0);
+    std::vector<Waypoint> result;
+    GetNext(waypoint, distance, result);
+    return result;
+  }
 
-    // If after subtracting the distance we are still in the same lane, return
-    // same waypoint with the extra distance.
-    if (distance <= remaining_lane_length) {
-      Waypoint result = waypoint;
-      result.s += signed_distance;
-      result.s += forward ? -EPSILON : EPSILON;
-      RELEASE_ASSERT(result.s > 0.0);
-      return { result };
-    }
+  void Map::GetNext(
+      const Waypoint waypoint,
+      const double distance,
+      std::vector<Waypoint> &result) const {
+    WalkLanes(*this, waypoint, distance, true, result);
+  }
 
-    // If we run out of remaining_lane_length we have to go to the successors.
+  std::vector<Waypoint> Map::GetPrevious(
+      const Waypoint waypoint,
+      const double distance) const {
     std::vector<Waypoint> result;
-    for (const auto &successor : GetSuccessors(waypoint)) {
-      DEBUG_ASSERT(
-          successor.road_id != waypoint.road_id ||
-          successor.section_id != waypoint.section_id ||
-          successor.lane_id != waypoint.lane_id);
-      result = ConcatVectors(result, GetNext(successor, distance - remaining_lane_length));
-    }
+    GetPrevious(waypoint, distance, result);
     return result;
   }
 
+  void Map::GetPrevious(
+      const Waypoint waypoint,
+      const double distance,
+      std::vector<Waypoint> &result) const {
+    WalkLanes(*this, waypoint, distance, false, result);
+  }
+
+  std::vector<Waypoint> Map::GetNextUntilLaneEnd(
+      const Waypoint waypoint,
+      const double distance) const {
+    std::vector<Waypoint> result;
+    GetNextUntilLaneEnd(waypoint, distance, result);
+    return result;
+  }
+
+  void Map::GetNextUntilLaneEnd(
+      Waypoint waypoint,
+      const double distance,
+      std::vector<Waypoint> &result) const {
+    RELEASE_ASSERT(distance > 0.0);
+    const auto &lane = GetLane(waypoint);
+    auto step = distance;
+    while (MoveAlongLane(lane, waypoint, step, true)) {
+      result.emplace_back(waypoint);
+      step = distance;
+    }
+    // Finish at the end of the lane, unless the last step already got there.
+    const auto end = GetDistanceAtEndOfLane(lane);
+    const bool at_end = (waypoint.lane_id <= 0) ? (waypoint.s >= end) : (waypoint.s <= end);
+    if (!at_end) {
+      waypoint.s = end;
+      result.emplace_back(waypoint);
+    }
+  }
+
   boost::optional<Waypoint> Map::GetRight(Waypoint waypoint) const {
     RELEASE_ASSERT(waypoint.lane_id != 0);
     if (waypoint.lane_id > 0) {
@@ -459,23 +706,32 @@ namespace road {
   }
 
   std::vector<Waypoint> Map::GenerateWaypoints(const double distance) const {
+    const auto &road_ids = _data.GetRoadIds();
+    return GenerateWaypoints(distance, road_ids.data(), road_ids.data() + road_ids.size());
+  }
+
+  std::vector<Waypoint> Map::GenerateWaypoints(
+      const double distance,
+      const RoadId *begin,
+      const RoadId *end) const {
     RELEASE_ASSERT(distance > 0.0);
     std::vector<Waypoint> result;
-    for (const auto &pair : _data.GetRoads()) {
-      const auto &road = pair.second;
-      for (double s = EPSILON; s < (road.GetLength() - EPSILON); s += distance) {
-        ForEachDrivableLaneAt(road, s, [&](auto &&waypoint) {
-          result.emplace_back(waypoint);
-        });
-      }
+    for (auto it = begin; it != end; ++it) {
+      ForEachDrivableLaneAlong(_data.GetRoad(*it), distance, [&](auto &&waypoint) {
+        result.emplace_back(waypoint);
+      });
     }
     return result;
   }
 
+  std::vector<RoadId> Map::GetRoadIds() const {
+    return _data.GetRoadIds();
+  }
+
   std::vector<Waypoint> Map::GenerateWaypointsOnRoadEntries() const {
     std::vector<Waypoint> result;
-    for (const auto &pair : _data.GetRoads()) {
-      const auto &road = pair.second;
+    for (const auto road_id : _data.GetRoadIds()) {
+      const auto &road = _data.GetRoad(road_id);
       // right lanes start at s 0
       for (const auto &lane_section : road.GetLaneSectionsAt(0.0)) {
         for (const auto &lane : lane_section.GetLanes()) {
@@ -499,11 +755,27 @@ namespace road {
     return result;
   }
 
+  std::vector<Waypoint> Map::GenerateWaypointsOnLaneEntries() const {
+    std::vector<Waypoint> result;
+    for (const auto road_id : _data.GetRoadIds()) {
+      ForEachDrivableLane(_data.GetRoad(road_id), [&](auto &&waypoint) {
+        result.emplace_back(waypoint);
+      });
+    }
+    return result;
+  }
+
   std::vector<std::pair<Waypoint, Waypoint>> Map::GenerateTopology() const {
+    const auto &road_ids = _data.GetRoadIds();
+    return GenerateTopology(road_ids.data(), road_ids.data() + road_ids.size());
+  }
+
+  std::vector<std::pair<Waypoint, Waypoint>> Map::GenerateTopology(
+      const RoadId *begin,
+      const RoadId *end) const {
     std::vector<std::pair<Waypoint, Waypoint>> result;
-    for (const auto &pair : _data.GetRoads()) {
-      const auto &road = pair.second;
-      ForEachDrivableLane(road, [&](auto &&waypoint) {
+    for (auto it = begin; it != end; ++it) {
+      ForEachDrivableLane(_data.GetRoad(*it), [&](auto &&waypoint) {
         for (auto &&successor : GetSuccessors(waypoint)) {
           result.push_back({waypoint, successor});
         }
@@ -8,7 +8,9 @@
 
 #include "carla/NonCopyable.h"
 #include "carla/geom/Transform.h"
+#include "carla/road/LaneCenterlines.h"
 #include "carla/road/MapData.h"
+#include "carla/road/RoadSpatialIndex.h"
 #include "carla/road/RoadTypes.h"
 #include "carla/road/element/LaneMarking.h"
 #include "carla/road/element/RoadInfoMarkRecord.h"
@@ -16,6 +18,7 @@
 
 #include <boost/optional.hpp>
 
+#include <memory>
 #include <vector>
 
 namespace carla {
@@ -30,7 +33,10 @@ namespace road {
     /// -- Constructor ---------------------------------------------------------
     /// ========================================================================
 
-    Map(MapData m) : _data(std::move(m)) {}
+    /// Builds the spatial index of the roads of @a m.
+    Map(MapData m)
+      : _data(std::move(m)),
+        _road_index(_data) {}
 
     /// ========================================================================
     /// -- Georeference --------------------------------------------------------
@@ -52,8 +58,65 @@ namespace road {
         const geom::Location &location,
         uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
 
+    /// Same as GetClosestWaypointOnRoad, but first looks for @a location in
+    /// the lanes of the road of @a hint and of the roads linked to it; e.g.,
+    /// @a hint can be the previous waypoint of a moving actor. The search
+    /// over the whole map only runs if @a location is not inside any of
+    /// these lanes.
+    ///
+    /// Where several lanes overlap, e.g. in junctions, the result may be a
+    /// different lane containing @a location than the one returned without
+    /// hint.
+    boost::optional<element::Waypoint> GetClosestWaypointOnRoad(
+        const geom::Location &location,
+        const Waypoint &hint,
+        uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
+
+    /// Same as GetWaypoint, using @a hint as GetClosestWaypointOnRoad does.
+    boost::optional<element::Waypoint> GetWaypoint(
+        const geom::Location &location,
+        const Waypoint &hint,
+        uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
+
+    /// Same as GetClosestWaypointOnRoad for each location in [@a begin,
+    /// @a end). The buffers of the spatial index are shared by all the
+    /// searches.
+    std::vector<boost::optional<element::Waypoint>> GetClosestWaypointsOnRoad(
+        const geom::Location *begin,
+        const geom::Location *end,
+        uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
+
+    /// Same as GetWaypoint for each location in [@a begin, @a end). The
+    /// buffers of the spatial index are shared by all the searches.
+    std::vector<boost::optional<element::Waypoint>> GetWaypoints(
+        const geom::Location *begin,
+        const geom::Location *end,
+        uint32_t lane_type = static_cast<uint32_t>(Lane::LaneType::Driving)) const;
+
     geom::Transform ComputeTransform(Waypoint waypoint) const;
 
+    /// ========================================================================
+    /// -- Lane centerlines ----------------------------------------------------
+    /// ========================================================================
+
+    /// Sample the center line of every lane each @a resolution meters.
+    /// Afterwards ComputeTransform and GetLaneWidth interpolate these samples
+    /// instead of evaluating the road geometry, within the errors reported by
+    /// the returned LaneCenterlines::Stats.
+    ///
+    /// Not thread-safe, must not be called while other threads query the map.
+    const LaneCenterlines::Stats &BuildLaneCenterlines(double resolution);
+
+    /// Go back to evaluating the road geometry on every query.
+    void ClearLaneCenterlines() {
+      _lane_centerlines.reset();
+    }
+
+    /// Return nullptr if BuildLaneCenterlines was not called.
+    const LaneCenterlines *GetLaneCenterlines() const {
+      return _lane_centerlines.get();
+    }
+
     /// ========================================================================
     /// -- Road information ----------------------------------------------------
     /// ========================================================================
@@ -89,6 +152,24 @@ namespace road {
     /// waypoint could drive to.
     std::vector<Waypoint> GetNext(Waypoint waypoint, double distance) const;
 
+    /// Same as above, but appends the waypoints to @a result, e.g. to reuse
+    /// its memory between calls.
+    void GetNext(Waypoint waypoint, double distance, std::vector<Waypoint> &result) const;
+
+    /// Return the list of waypoints at @a distance such that a vehicle could
+    /// drive from them to @a waypoint.
+    std::vector<Waypoint> GetPrevious(Waypoint waypoint, double distance) const;
+
+    /// Same as above, but appends the waypoints to @a result.
+    void GetPrevious(Waypoint waypoint, double distance, std::vector<Waypoint> &result) const;
+
+    /// Return the waypoints every @a distance from @a waypoint to the end of
+    /// its lane, the last one at the end of the lane.
+    std::vector<Waypoint> GetNextUntilLaneEnd(Waypoint waypoint, double distance) const;
+
+    /// Same as above, but appends the waypoints to @a result.
+    void GetNextUntilLaneEnd(Waypoint waypoint, double distance, std::vector<Waypoint> &result) const;
+
     /// Return a waypoint at the lane of @a waypoint's right lane.
     boost::optional<Waypoint> GetRight(Waypoint waypoint) const;
 
@@ -98,13 +179,36 @@ namespace road {
     /// Generate all the waypoints in @a map separated by @a approx_distance.
     std::vector<Waypoint> GenerateWaypoints(double approx_distance) const;
 
+    /// Same as GenerateWaypoints only for the roads in [@a begin, @a end).
+    /// Splitting GetRoadIds and joining the results in order gives the same
+    /// waypoints as the whole map at once.
+    std::vector<Waypoint> GenerateWaypoints(
+        double approx_distance,
+        const RoadId *begin,
+        const RoadId *end) const;
+
+    /// Ids of all the roads, in the order GenerateWaypoints and
+    /// GenerateTopology visit them: the order of the OpenDRIVE file, also
+    /// kept by compiled maps.
+    std::vector<RoadId> GetRoadIds() const;
+
     /// Generate waypoints on each @a lane at the start of each @a road
     std::vector<Waypoint> GenerateWaypointsOnRoadEntries() const;
 
+    /// Generate a waypoint at the entrance of each drivable lane of each lane
+    /// section, the same waypoints GenerateTopology connects.
+    std::vector<Waypoint> GenerateWaypointsOnLaneEntries() const;
+
     /// Generate the minimum set of waypoints that define the topology of @a
     /// map. The waypoints are placed at the entrance of each lane.
     std::vector<std::pair<Waypoint, Waypoint>> GenerateTopology() const;
 
+    /// Same as GenerateTopology only for the lanes of the roads in [@a
+    /// begin, @a end).
+    std::vector<std::pair<Waypoint, Waypoint>> GenerateTopology(
+        const RoadId *begin,
+        const RoadId *end) const;
+
 #ifdef LIBCARLA_WITH_GTEST
     MapData &GetMap() {
       return _data;
@@ -113,7 +217,36 @@ namespace road {
 
 private:
 
+    boost::optional<element::Waypoint> GetClosestWaypointOnRoad(
+        const geom::Location &location,
+        uint32_t lane_type,
+        RoadSpatialIndex::SearchBuffers &buffers) const;
+
+    boost::optional<element::Waypoint> GetWaypoint(
+        const geom::Location &location,
+        uint32_t lane_type,
+        RoadSpatialIndex::SearchBuffers &buffers) const;
+
+    /// Whether @a location is inside the lane of @a waypoint, i.e. closer to
+    /// its center than half the lane width.
+    bool IsInsideLane(Waypoint waypoint, const geom::Location &location) const;
+
+    /// Waypoint of the lane containing @a location among the roads around
+    /// @a hint, if any.
+    boost::optional<element::Waypoint> GetWaypointNearHint(
+        const geom::Location &location,
+        const Waypoint &hint,
+        uint32_t lane_type) const;
+
+    friend CompiledMap;
+
+    friend LaneCenterlines;
+
     MapData _data;
+
+    RoadSpatialIndex _road_index;
+
+    std::unique_ptr<LaneCenterlines> _lane_centerlines;
   };
 
 } // namespace road
@@ -8,6 +8,7 @@
 #include "carla/road/MapBuilder.h"
 #include "carla/road/element/RoadInfoElevation.h"
 #include "carla/road/element/RoadInfoGeometry.h"
+#include "carla/road/element/RoadInfoIterator.h"
 #include "carla/road/element/RoadInfoLaneAccess.h"
 #include "carla/road/element/RoadInfoLaneBorder.h"
 #include "carla/road/element/RoadInfoLaneHeight.h"
@@ -36,7 +37,9 @@ namespace road {
 
   boost::optional<Map> MapBuilder::Build() {
 
-    CreatePointersBetweenRoadSegments();
+    if (!_has_explicit_links) {
+      CreatePointersBetweenRoadSegments();
+    }
 
     for (auto &&info : _temp_road_info_container) {
       DEBUG_ASSERT(info.first != nullptr);
@@ -251,7 +254,11 @@ namespace road {
       const RoadId successor) {
 
     // add it
-    auto road = &(_map_data._roads.emplace(road_id, Road()).first->second);
+    const auto result = _map_data._roads.emplace(road_id, Road());
+    if (result.second) {
+      _map_data._road_ids.emplace_back(road_id);
+    }
+    auto road = &(result.first->second);
 
     // set road data
     road->_map_data = &_map_data;
@@ -406,7 +413,9 @@ namespace road {
   }
 
   void MapBuilder::AddJunction(const int32_t id, const std::string name) {
-    _map_data.GetJunctions().emplace(id, Junction(id, name));
+    if (_map_data.GetJunctions().emplace(id, Junction(id, name)).second) {
+      _map_data._junction_ids.emplace_back(id);
+    }
   }
 
   void MapBuilder::AddConnection(
@@ -473,6 +482,32 @@ namespace road {
         dependency_type));
   }
 
+  void MapBuilder::AddRoadInfo(Road *road, std::unique_ptr<RoadInfo> info) {
+    DEBUG_ASSERT(road != nullptr);
+    DEBUG_ASSERT(info != nullptr);
+    _temp_road_info_container[road].emplace_back(std::move(info));
+  }
+
+  void MapBuilder::AddLaneInfo(Lane *lane, std::unique_ptr<RoadInfo> info) {
+    DEBUG_ASSERT(lane != nullptr);
+    DEBUG_ASSERT(info != nullptr);
+    _temp_lane_info_container[lane].emplace_back(std::move(info));
+  }
+
+  void MapBuilder::SetRoadLinks(Road *road, std::vector<Road *> nexts, std::vector<Road *> prevs) {
+    DEBUG_ASSERT(road != nullptr);
+    road->_nexts = std::move(nexts);
+    road->_prevs = std::move(prevs);
+    _has_explicit_links = true;
+  }
+
+  void MapBuilder::SetLaneLinks(Lane *lane, std::vector<Lane *> next_lanes, std::vector<Lane *> prev_lanes) {
+    DEBUG_ASSERT(lane != nullptr);
+    lane->_next_lanes = std::move(next_lanes);
+    lane->_prev_lanes = std::move(prev_lanes);
+    _has_explicit_links = true;
+  }
+
   Lane *MapBuilder::GetLane(
       const RoadId road_id,
       const LaneId lane_id,
@@ -315,6 +315,18 @@ namespace road {
         const uint32_t dependency_id,
         const std::string dependency_type);
 
+    // called from the compiled map reader
+
+    void AddRoadInfo(Road *road, std::unique_ptr<element::RoadInfo> info);
+
+    void AddLaneInfo(Lane *lane, std::unique_ptr<element::RoadInfo> info);
+
+    /// Set the links between roads explicitly. If called, Build() does not
+    /// compute the links from the successors, predecessors and junctions.
+    void SetRoadLinks(Road *road, std::vector<Road *> nexts, std::vector<Road *> prevs);
+
+    void SetLaneLinks(Lane *lane, std::vector<Lane *> next_lanes, std::vector<Lane *> prev_lanes);
+
     Road *GetRoad(
         const RoadId road_id);
 
@@ -331,6 +343,8 @@ namespace road {
 
     MapData _map_data;
 
+    bool _has_explicit_links = false;
+
     /// Create the pointers between RoadSegments based on the ids.
     void CreatePointersBetweenRoadSegments();
 
@@ -18,6 +18,7 @@
 #include <boost/iterator/transform_iterator.hpp>
 
 #include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace road {
@@ -39,6 +40,18 @@ namespace road {
 
     std::unordered_map<JuncId, Junction> &GetJunctions();
 
+    /// Ids of the roads in the order they were added, the order in which
+    /// Map visits every road. Unlike the iteration order of GetRoads(), it
+    /// does not depend on the standard library.
+    const std::vector<RoadId> &GetRoadIds() const {
+      return _road_ids;
+    }
+
+    /// Ids of the junctions in the order they were added.
+    const std::vector<JuncId> &GetJunctionIds() const {
+      return _junction_ids;
+    }
+
     bool ContainsRoad(RoadId id) const {
       return (_roads.find(id) != _roads.end());
     }
@@ -71,6 +84,8 @@ namespace road {
 
     friend class MapBuilder;
 
+    friend class CompiledMap;
+
     MapData() = default;
 
     geom::GeoLocation _geo_reference;
@@ -78,6 +93,10 @@ namespace road {
     std::unordered_map<RoadId, Road> _roads;
 
     std::unordered_map<JuncId, Junction> _junctions;
+
+    std::vector<RoadId> _road_ids;
+
+    std::vector<JuncId> _junction_ids;
   };
 
 } // namespace road
@@ -18,7 +18,8 @@
 namespace carla {
 namespace road {
 
-  /// A set of elements ordered by its position on the road.
+  /// A set of elements ordered by its position on the road. Elements at the
+  /// same position keep their input order.
   template <typename T>
   class RoadElementSet : private MovableNonCopyable {
   public:
@@ -34,7 +35,7 @@ namespace road {
     RoadElementSet(std::vector<InputTypeT> &&range)
       : _vec([](auto &&input) {
           static_assert(!std::is_const<InputTypeT>::value, "Input type cannot be const");
-          std::sort(std::begin(input), std::end(input), LessComp());
+          std::stable_sort(std::begin(input), std::end(input), LessComp());
           return decltype(_vec){
               std::make_move_iterator(std::begin(input)),
               std::make_move_iterator(std::end(input))};
@@ -0,0 +1,237 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/RoadSpatialIndex.h"
+
+#include "carla/Debug.h"
+#include "carla/road/MapData.h"
+#include "carla/road/element/RoadInfoGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace carla {
+namespace road {
+
+  /// Maximum number of geometries in a leaf.
+  static constexpr uint32_t MAX_LEAF_SIZE = 4u;
+
+  /// Meters added around each geometry, Geometry::DistanceTo works in single
+  /// precision so the nearest point it finds may be slightly off the curve.
+  static constexpr double BOX_MARGIN = 1.0;
+
+  /// Maximum distance between the points sampled along curved geometries.
+  static constexpr double SAMPLE_STEP = 1.0;
+
+  // ===========================================================================
+  // -- RoadSpatialIndex -------------------------------------------------------
+  // ===========================================================================
+
+  RoadSpatialIndex::Box RoadSpatialIndex::GetBoundingBox(const element::Geometry &geometry) {
+    const double length = geometry.GetLength();
+    std::vector<geom::Location> points;
+    double margin = BOX_MARGIN;
+    if (length <= 0.0) {
+      points.emplace_back(geometry.PosFromDist(0.0).location);
+    } else if (geometry.GetType() == element::GeometryType::LINE) {
+      points.emplace_back(geometry.PosFromDist(0.0).location);
+      points.emplace_back(geometry.PosFromDist(length).location);
+    } else {
+      const auto steps = static_cast<size_t>(std::ceil(length / SAMPLE_STEP));
+      const double step = length / static_cast<double>(steps);
+      for (auto i = 0u; i <= steps; ++i) {
+        points.emplace_back(geometry.PosFromDist(static_cast<double>(i) * step).location);
+      }
+      margin += 0.5 * step;
+    }
+    Box box{
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::lowest(),
+        std::numeric_limits<float>::lowest()};
+    for (auto &point : points) {
+      box.min_x = std::min(box.min_x, point.x);
+      box.min_y = std::min(box.min_y, point.y);
+      box.max_x = std::max(box.max_x, point.x);
+      box.max_y = std::max(box.max_y, point.y);
+    }
+    box.min_x -= static_cast<float>(margin);
+    box.min_y -= static_cast<float>(margin);
+    box.max_x += static_cast<float>(margin);
+    box.max_y += static_cast<float>(margin);
+    return box;
+  }
+
+  RoadSpatialIndex::RoadSpatialIndex(const MapData &data) {
+    for (const auto road_id : data.GetRoadIds()) {
+      const auto road_index = static_cast<uint32_t>(_road_ids.size());
+      _road_ids.emplace_back(road_id);
+      for (auto *info : data.GetRoad(road_id).GetInfos<element::RoadInfoGeometry>()) {
+        DEBUG_ASSERT(info != nullptr);
+        _items.push_back(Item{GetBoundingBox(info->GetGeometry()), road_index});
+      }
+    }
+    if (!_items.empty()) {
+      _nodes.reserve(2u * _items.size());
+      Build(0u, static_cast<uint32_t>(_items.size()));
+    }
+  }
+
+  uint32_t RoadSpatialIndex::Build(const uint32_t begin, const uint32_t end) {
+    DEBUG_ASSERT(begin < end);
+    const auto node_index = static_cast<uint32_t>(_nodes.size());
+    _nodes.emplace_back();
+    Box box = _items[begin].box;
+    for (auto i = begin + 1u; i < end; ++i) {
+      const auto &item_box = _items[i].box;
+      box.min_x = std::min(box.min_x, item_box.min_x);
+      box.min_y = std::min(box.min_y, item_box.min_y);
+      box.max_x = std::max(box.max_x, item_box.max_x);
+      box.max_y = std::max(box.max_y, item_box.max_y);
+    }
+    _nodes[node_index].box = box;
+    if ((end - begin) <= MAX_LEAF_SIZE) {
+      _nodes[node_index].index = begin;
+      _nodes[node_index].count = end - begin;
+      return node_index;
+    }
+    // Split at the median of the centers along the longest axis.
+    const bool split_x = (box.max_x - box.min_x) >= (box.max_y - box.min_y);
+    const auto middle = begin + (end - begin) / 2u;
+    std::nth_element(
+        _items.begin() + begin,
+        _items.begin() + middle,
+        _items.begin() + end,
+        [split_x](const Item &lhs, const Item &rhs) {
+          return split_x ?
+              (lhs.box.min_x + lhs.box.max_x) < (rhs.box.min_x + rhs.box.max_x) :
+              (lhs.box.min_y + lhs.box.max_y) < (rhs.box.min_y + rhs.box.max_y);
+        });
+    Build(begin, middle);
+    const auto second_child = Build(middle, end);
+    _nodes[node_index].index = second_child;
+    _nodes[node_index].count = 0u;
+    return node_index;
+  }
+
+  float RoadSpatialIndex::DistanceSquared(const Box &box, const geom::Location &point) {
+    const float dx = std::max({box.min_x - point.x, 0.0f, point.x - box.max_x});
+    const float dy = std::max({box.min_y - point.y, 0.0f, point.y - box.max_y});
+    return dx * dx + dy * dy;
+  }
+
+  std::vector<RoadSpatialIndex::Result> RoadSpatialIndex::FindKNearest(
+      const MapData &data,
+      const geom::Location &point,
+      const size_t k) const {
+    SearchBuffers buffers;
+    FindKNearest(data, point, k, buffers);
+    return std::move(buffers._result);
+  }
+
+  const std::vector<RoadSpatialIndex::Result> &RoadSpatialIndex::FindKNearest(
+      const MapData &data,
+      const geom::Location &point,
+      const size_t k,
+      SearchBuffers &buffers) const {
+    auto &result = buffers._result;
+    result.clear();
+    if ((k == 0u) || _nodes.empty()) {
+      return result;
+    }
+
+    // The k closest roads so far, sorted by distance then by road index.
+    auto &best = buffers._best;
+    best.clear();
+    best.reserve(k + 1u);
+
+    auto add_road = [&](uint32_t road_index) {
+      const auto road_id = _road_ids[road_index];
+      const auto nearest = data.GetRoad(road_id).GetNearestPoint(point);
+      const Candidate candidate{{road_id, nearest.first, nearest.second}, road_index};
+      const auto position = std::upper_bound(
+          best.begin(),
+          best.end(),
+          candidate,
+          [](const Candidate &lhs, const Candidate &rhs) {
+            return
+                (lhs.result.distance < rhs.result.distance) ||
+                ((lhs.result.distance == rhs.result.distance) && (lhs.road_index < rhs.road_index));
+          });
+      best.insert(position, candidate);
+      if (best.size() > k) {
+        best.pop_back();
+      }
+    };
+
+    // Anything inside a box whose distance is greater than the k-th distance
+    // found so far cannot be in the result.
+    auto is_worth_visiting = [&](float distance_squared) {
+      return
+          (best.size() < k) ||
+          (static_cast<double>(std::sqrt(distance_squared)) <= best.back().result.distance);
+    };
+
+    if (k >= _road_ids.size()) {
+      // Every road is in the result, the tree would not save any work.
+      for (auto i = 0u; i < _road_ids.size(); ++i) {
+        add_road(i);
+      }
+    } else {
+      // Best-first traversal, closest boxes first.
+      auto &visited_roads = buffers._visited_roads;
+      visited_roads.clear();
+      // A min-heap, as a std::priority_queue over a reusable vector.
+      using Entry = std::pair<float, uint32_t>;
+      const auto compare = std::greater<Entry>();
+      auto &queue = buffers._queue;
+      queue.clear();
+      auto push = [&](uint32_t node_index) {
+        queue.emplace_back(DistanceSquared(_nodes[node_index].box, point), node_index);
+        std::push_heap(queue.begin(), queue.end(), compare);
+      };
+      push(0u);
+      while (!queue.empty() && is_worth_visiting(queue.front().first)) {
+        const auto &node = _nodes[queue.front().second];
+        const auto first_child = queue.front().second + 1u;
+        std::pop_heap(queue.begin(), queue.end(), compare);
+        queue.pop_back();
+        if (node.count == 0u) {
+          push(first_child);
+          push(node.index);
+          continue;
+        }
+        for (auto i = node.index; i < node.index + node.count; ++i) {
+          const auto &item = _items[i];
+          if (is_worth_visiting(DistanceSquared(item.box, point)) &&
+              (std::find(visited_roads.begin(), visited_roads.end(), item.road_index) == visited_roads.end())) {
+            visited_roads.emplace_back(item.road_index);
+            add_road(item.road_index);
+          }
+        }
+      }
+    }
+
+    for (auto &candidate : best) {
+      result.emplace_back(candidate.result);
+    }
+    return result;
+  }
+
+  boost::optional<RoadSpatialIndex::Result> RoadSpatialIndex::FindNearest(
+      const MapData &data,
+      const geom::Location &point) const {
+    auto result = FindKNearest(data, point, 1u);
+    if (result.empty()) {
+      return boost::none;
+    }
+    return result.front();
+  }
+
+} // namespace road
+} // namespace carla
@@ -0,0 +1,138 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/geom/Location.h"
+#include "carla/road/RoadTypes.h"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  class MapData;
+  namespace element { class Geometry; }
+
+  /// Bounding volume hierarchy over the 2D bounding boxes of the geometries
+  /// (plan view records) of every road of a map, used to find the roads
+  /// closest to a point without visiting every road.
+  ///
+  /// The distance from a point to a road is the one given by
+  /// Road::GetNearestPoint, so the results are the same as computing it for
+  /// every road. Ties are broken by the order of MapData::GetRoadIds().
+  class RoadSpatialIndex : private MovableNonCopyable {
+  public:
+
+    struct Result {
+      RoadId road_id;
+      /// Distance along the road (s) to the nearest point of its center.
+      double s;
+      /// Distance from the point to the nearest point of the road center.
+      double distance;
+    };
+
+  private:
+
+    struct Candidate {
+      Result result;
+      uint32_t road_index;
+    };
+
+  public:
+
+    /// Buffers used by FindKNearest, reusing them between searches avoids
+    /// allocating them on every call.
+    class SearchBuffers {
+    private:
+
+      friend RoadSpatialIndex;
+
+      std::vector<Candidate> _best;
+
+      std::vector<uint32_t> _visited_roads;
+
+      std::vector<std::pair<float, uint32_t>> _queue;
+
+      std::vector<Result> _result;
+    };
+
+    RoadSpatialIndex() = default;
+
+    /// Build the index of the roads in @a data. The index does not keep any
+    /// reference to @a data, but it is only valid for the same roads.
+    explicit RoadSpatialIndex(const MapData &data);
+
+    bool empty() const {
+      return _nodes.empty();
+    }
+
+    /// Return the @a k roads closest to @a point, sorted by distance. The
+    /// point must be in OpenDRIVE coordinates.
+    std::vector<Result> FindKNearest(
+        const MapData &data,
+        const geom::Location &point,
+        size_t k) const;
+
+    /// @copydoc FindKNearest(const MapData &, const geom::Location &, size_t) const
+    ///
+    /// The result is stored in @a buffers and valid until the next search
+    /// with the same buffers.
+    const std::vector<Result> &FindKNearest(
+        const MapData &data,
+        const geom::Location &point,
+        size_t k,
+        SearchBuffers &buffers) const;
+
+    /// Return the road closest to @a point, if any.
+    boost::optional<Result> FindNearest(const MapData &data, const geom::Location &point) const;
+
+  private:
+
+    struct Box {
+      float min_x, min_y, max_x, max_y;
+    };
+
+    struct Item {
+      Box box;
+      /// Position of the road in MapData::GetRoadIds().
+      uint32_t road_index;
+    };
+
+    struct Node {
+      Box box;
+      /// Leaves: first item. Inner nodes: second child, the first child is
+      /// the next node.
+      uint32_t index;
+      /// Number of items, zero for inner nodes.
+      uint32_t count;
+    };
+
+    /// A box containing every point of @a geometry. Lines are bounded by
+    /// their end points; other geometries by points sampled along them,
+    /// enlarged by half the distance between samples.
+    static Box GetBoundingBox(const element::Geometry &geometry);
+
+    /// Build the subtree of the items in [@a begin, @a end), return the
+    /// index of its root.
+    uint32_t Build(uint32_t begin, uint32_t end);
+
+    static float DistanceSquared(const Box &box, const geom::Location &point);
+
+    std::vector<RoadId> _road_ids;
+
+    std::vector<Item> _items;
+
+    std::vector<Node> _nodes;
+  };
+
+} // namespace road
+} // namespace carla
@@ -53,8 +53,8 @@ namespace element {
     return {};
   }
 
-  static bool IsOffRoad(const Map &map, const geom::Location &location) {
-    return !map.GetWaypoint(location, FLAGS).has_value();
+  static bool IsOffRoad(const Map &map, const geom::Location &location, const Waypoint &hint) {
+    return !map.GetWaypoint(location, hint, FLAGS).has_value();
   }
 
   std::vector<LaneMarking> LaneCrossingCalculator::Calculate(
@@ -62,9 +62,12 @@ namespace element {
       const geom::Location &origin,
       const geom::Location &destination) {
     auto w0 = map.GetClosestWaypointOnRoad(origin, FLAGS);
-    auto w1 = map.GetClosestWaypointOnRoad(destination, FLAGS);
-
-    if (!w0.has_value() || !w1.has_value()) {
+    if (!w0.has_value()) {
+      return {};
+    }
+    // Origin and destination are close, start the searches around w0.
+    auto w1 = map.GetClosestWaypointOnRoad(destination, *w0, FLAGS);
+    if (!w1.has_value()) {
       return {};
     }
 
@@ -77,8 +80,8 @@ namespace element {
       return {};
     }
 
-    const auto w0_is_offroad = IsOffRoad(map, origin);
-    const auto w1_is_offroad = IsOffRoad(map, destination);
+    const auto w0_is_offroad = IsOffRoad(map, origin, *w0);
+    const auto w1_is_offroad = IsOffRoad(map, destination, *w1);
 
     if (w0_is_offroad && w1_is_offroad) {
       // outside the road
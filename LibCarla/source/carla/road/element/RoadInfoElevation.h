@@ -25,6 +25,10 @@ namespace element {
       : RoadInfo(s),
         _elevation(a, b, c, d, s) {}
 
+    RoadInfoElevation(double s, const geom::CubicPolynomial &polynomial)
+      : RoadInfo(s),
+        _elevation(polynomial) {}
+
     void AcceptVisitor(RoadInfoVisitor &v) final {
       v.Visit(*this);
     }
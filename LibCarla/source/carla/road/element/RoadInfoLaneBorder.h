@@ -32,6 +32,10 @@ namespace element {
       : RoadInfo(s),
         _border(a, b, c, d, s) {}
 
+    RoadInfoLaneBorder(double s, const geom::CubicPolynomial &polynomial)
+      : RoadInfo(s),
+        _border(polynomial) {}
+
     void AcceptVisitor(RoadInfoVisitor &v) final {
       v.Visit(*this);
     }
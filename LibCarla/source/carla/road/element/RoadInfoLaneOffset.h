@@ -31,6 +31,10 @@ namespace element {
       : RoadInfo(s),
         _offset(a, b, c, d, s) {}
 
+    RoadInfoLaneOffset(double s, const geom::CubicPolynomial &polynomial)
+      : RoadInfo(s),
+        _offset(polynomial) {}
+
     void AcceptVisitor(RoadInfoVisitor &v) final {
       v.Visit(*this);
     }
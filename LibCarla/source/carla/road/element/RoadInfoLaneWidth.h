@@ -30,6 +30,10 @@ namespace element {
       : RoadInfo(s),
         _width(a, b, c, d, s) {}
 
+    RoadInfoLaneWidth(double s, const geom::CubicPolynomial &polynomial)
+      : RoadInfo(s),
+        _width(polynomial) {}
+
     void AcceptVisitor(RoadInfoVisitor &v) final {
       v.Visit(*this);
     }
@@ -16,6 +16,9 @@
 
 namespace carla {
 namespace road {
+
+  class CompiledMap;
+
 namespace signal {
 
   class Signal : private MovableNonCopyable {
@@ -71,6 +74,8 @@ namespace signal {
 
   private:
 
+    friend road::CompiledMap;
+
 #if defined(__clang__)
 #  pragma clang diagnostic push
 #  pragma clang diagnostic ignored "-Wunused-private-field"
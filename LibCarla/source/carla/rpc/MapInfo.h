@@ -9,6 +9,8 @@
 #include "carla/MsgPack.h"
 #include "carla/geom/Transform.h"
 
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -24,6 +26,50 @@ namespace rpc {
 
     std::vector<geom::Transform> recommended_spawn_points;
 
+    /// Hash identifying a map by its name, its OpenDRIVE contents and its
+    /// recommended spawn points (64-bit FNV-1a), the client uses it to reuse
+    /// an already parsed map without transferring the OpenDRIVE file again.
+    static uint64_t Hash(
+        const std::string &name,
+        const std::string &open_drive_file,
+        const std::vector<geom::Transform> &spawn_points) {
+      uint64_t hash = 14695981039346656037ull;
+      auto add_byte = [&hash](uint8_t byte) {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+      };
+      auto add = [&](const std::string &str) {
+        for (auto c : str) {
+          add_byte(static_cast<uint8_t>(c));
+        }
+        // Separator so "ab" + "c" and "a" + "bc" differ.
+        add_byte(0xFFu);
+      };
+      auto add_float = [&](float value) {
+        uint32_t bits;
+        static_assert(sizeof(bits) == sizeof(value), "Invalid float size.");
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (auto i = 0u; i < sizeof(bits); ++i) {
+          add_byte(static_cast<uint8_t>(bits >> (8u * i)));
+        }
+      };
+      add(name);
+      add(open_drive_file);
+      for (auto &transform : spawn_points) {
+        add_float(transform.location.x);
+        add_float(transform.location.y);
+        add_float(transform.location.z);
+        add_float(transform.rotation.pitch);
+        add_float(transform.rotation.yaw);
+        add_float(transform.rotation.roll);
+      }
+      return hash;
+    }
+
+    uint64_t GetHash() const {
+      return Hash(name, open_drive_file, recommended_spawn_points);
+    }
+
     MSGPACK_DEFINE_ARRAY(name, open_drive_file, recommended_spawn_points);
   };
 
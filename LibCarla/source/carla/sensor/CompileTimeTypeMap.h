@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <array>
 #include <type_traits>
 #include <utility>
 
@@ -74,6 +75,32 @@ namespace detail {
     };
   };
 
+  constexpr bool AnyOf() {
+    return false;
+  }
+
+  template <typename... Bools>
+  constexpr bool AnyOf(bool head, Bools... tail) {
+    return head || AnyOf(tail...);
+  }
+
+  /// Whether no key appears twice, otherwise the elements with a repeated
+  /// key would not be reachable by key.
+  template <typename... Items>
+  struct HasUniqueKeys : std::true_type {};
+
+  template <typename Key, typename Value, typename... Rest>
+  struct HasUniqueKeys<std::pair<Key, Value>, Rest...>
+    : std::integral_constant<
+          bool,
+          !AnyOf(std::is_same<Key, typename Rest::first_type>::value...) &&
+              HasUniqueKeys<Rest...>::value> {};
+
+  template <typename T, template <size_t> class Make, size_t... Is>
+  constexpr std::array<T, sizeof...(Is)> MakeTable(std::index_sequence<Is...>) {
+    return {{Make<Is>::value...}};
+  }
+
 } // namespace detail
 
   /// A compile time structure for mapping two types. Lookup elements by Key or
@@ -86,9 +113,13 @@ namespace detail {
   ///     constexpr size_t index_B = MyMap::get<A>::index;
   ///     using type_B_too = MyMap::get_by_index<index_B>::type;
   ///
+  /// The index of an element is its position in the map, adding elements at
+  /// the end keeps the indices of the existing ones.
   template <typename... Items>
   struct CompileTimeTypeMap {
 
+    static_assert(detail::HasUniqueKeys<Items...>::value, "CompileTimeTypeMap keys must be unique");
+
     static constexpr size_t size() {
       return sizeof...(Items);
     }
@@ -98,6 +129,22 @@ namespace detail {
 
     template <size_t Index>
     using get_by_index = typename detail::CompileTimeTypeMapImpl<sizeof...(Items), Items...>::template get_by_index<Index>;
+
+    /// Array of size() elements computed at compile time, the element at
+    /// each index is @a Make<Index>::value. Used to build dispatch tables
+    /// indexed by the index of the elements:
+    ///
+    ///     template <size_t Index>
+    ///     struct MakeFunction {
+    ///       static constexpr FunctionType value = &Function<Index>;
+    ///     };
+    ///     static constexpr auto table = MyMap::make_table<FunctionType, MakeFunction>();
+    ///     table[index](args...);
+    ///
+    template <typename T, template <size_t> class Make>
+    static constexpr std::array<T, sizeof...(Items)> make_table() {
+      return detail::MakeTable<T, Make>(std::make_index_sequence<sizeof...(Items)>());
+    }
   };
 
 } // namespace sensor
@@ -44,31 +44,18 @@ namespace sensor {
 
   private:
 
-    template <size_t Index, typename Data>
-    static interpreted_type Deserialize_impl(Data &&data) {
-      using Serializer = typename Super::template get_by_index<Index>::type;
-      return Serializer::Deserialize(std::forward<Data>(data));
-    }
+    using DeserializeFunctionType = interpreted_type (*)(RawData &&);
 
-    template <typename Data, size_t... Is>
-    static interpreted_type Deserialize_impl(size_t i, Data &&data, std::index_sequence<Is...>) {
-      // This function is equivalent to creating a switch statement with a case
-      // for each element in the map, the compiler should be able to optimize it
-      // into a jump table. See https://stackoverflow.com/a/46282159/5308925.
-      interpreted_type result;
-      std::initializer_list<int> ({
-          (i == Is ? (result = Deserialize_impl<Is>(std::forward<Data>(data))), 0 : 0)...
-      });
-      return result;
+    template <size_t Index>
+    static interpreted_type Deserialize_impl(RawData &&data) {
+      using Serializer = typename Super::template get_by_index<Index>::type;
+      return Serializer::Deserialize(std::move(data));
     }
 
-    template <typename Data>
-    static interpreted_type Deserialize(size_t index, Data &&data) {
-      return Deserialize_impl(
-          index,
-          std::forward<Data>(data),
-          std::make_index_sequence<Super::size()>());
-    }
+    template <size_t Index>
+    struct MakeDeserializer {
+      static constexpr DeserializeFunctionType value = &Deserialize_impl<Index>;
+    };
   };
 
   // ===========================================================================
@@ -86,9 +73,16 @@ namespace sensor {
   template <typename... Items>
   inline typename CompositeSerializer<Items...>::interpreted_type
   CompositeSerializer<Items...>::Deserialize(Buffer &&data) {
+    // Table of deserializers indexed by sensor type id, the cost of the
+    // dispatch does not depend on the number of sensors registered.
+    static constexpr auto deserializers =
+        Super::template make_table<DeserializeFunctionType, MakeDeserializer>();
     RawData message{std::move(data)};
-    size_t index = message.GetSensorTypeId();
-    return Deserialize(index, std::move(message));
+    const auto index = message.GetSensorTypeId();
+    if (index >= deserializers.size()) {
+      return nullptr;
+    }
+    return deserializers[index](std::move(message));
   }
 
 } // namespace sensor
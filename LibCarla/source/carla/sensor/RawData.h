@@ -15,6 +15,10 @@
 namespace carla {
 namespace sensor {
 
+namespace s11n {
+  class LidarSerializer;
+} // namespace s11n
+
   /// Wrapper around the raw data generated by a sensor plus some useful
   /// meta-information.
   class RawData {
@@ -89,6 +93,8 @@ namespace sensor {
     template <typename... Items>
     friend class CompositeSerializer;
 
+    friend class s11n::LidarSerializer;
+
     RawData(Buffer &&buffer) : _buffer(std::move(buffer)) {}
 
     Buffer _buffer;
@@ -0,0 +1,192 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/profiler/Profiler.h"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+#include "moodycamel/ConcurrentQueue.h"
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace carla {
+namespace sensor {
+namespace detail {
+
+  /// A pool of memory blocks of a fixed size. Deallocated blocks return to
+  /// the pool so the memory can be reused by the next allocation.
+  ///
+  /// @warning As with BufferPool, the allocated memory is only deleted when
+  /// this pool is destroyed.
+  class BlockPool : private NonCopyable {
+  public:
+
+    explicit BlockPool(size_t block_size) : _block_size(block_size) {}
+
+    ~BlockPool() {
+      void *block;
+      while (_queue.try_dequeue(block)) {
+        ::operator delete(block);
+      }
+    }
+
+    void *Allocate() {
+      void *block = nullptr;
+      if (_queue.try_dequeue(block)) {
+        ++_reuses;
+        CARLA_PROFILE_COUNT(sensor_data_pool, reuses);
+        return block;
+      }
+      ++_heap_allocations;
+      CARLA_PROFILE_COUNT(sensor_data_pool, heap_allocations);
+      return ::operator new(_block_size);
+    }
+
+    void Deallocate(void *block) {
+      _queue.enqueue(block);
+    }
+
+    size_t GetHeapAllocations() const {
+      return _heap_allocations;
+    }
+
+    size_t GetReuses() const {
+      return _reuses;
+    }
+
+  private:
+
+    const size_t _block_size;
+
+    moodycamel::ConcurrentQueue<void *> _queue;
+
+    std::atomic_size_t _heap_allocations{0u};
+
+    std::atomic_size_t _reuses{0u};
+  };
+
+  /// The pool of blocks of type @a T. Every object and allocator keeps a
+  /// reference, so the pool outlives the objects even at exit.
+  template <typename T>
+  inline const std::shared_ptr<BlockPool> &GetBlockPool() {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+    static const auto pool = std::make_shared<BlockPool>(sizeof(T));
+    return pool;
+  }
+
+  /// Allocator of single objects from the BlockPool of their type, arrays are
+  /// allocated in the heap.
+  template <typename T>
+  class PoolAllocator {
+  public:
+
+    using value_type = T;
+
+    PoolAllocator() : _pool(GetBlockPool<T>()) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &) : PoolAllocator() {}
+
+    T *allocate(size_t n) {
+      return static_cast<T *>(n == 1u ? _pool->Allocate() : ::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t n) {
+      if (n == 1u) {
+        _pool->Deallocate(ptr);
+      } else {
+        ::operator delete(ptr);
+      }
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> &) const {
+      return std::is_same<T, U>::value;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> &rhs) const {
+      return !(*this == rhs);
+    }
+
+  private:
+
+    std::shared_ptr<BlockPool> _pool;
+  };
+
+  template <typename T>
+  class PoolDeleter {
+  public:
+
+    PoolDeleter() : _pool(GetBlockPool<T>()) {}
+
+    void operator()(T *ptr) const {
+      ptr->~T();
+      _pool->Deallocate(ptr);
+    }
+
+  private:
+
+    std::shared_ptr<BlockPool> _pool;
+  };
+
+} // namespace detail
+
+  /// Creates the sensor data objects received each frame reusing the memory
+  /// of the objects already released, one pool per type. Both the object
+  /// and the control block of its SharedPtr come from the pools, so once
+  /// the pools are warm deserializing a message does not touch the heap
+  /// (the message itself comes from the BufferPool of the stream).
+  class SensorDataPool {
+  public:
+
+    struct Stats {
+      /// Blocks allocated in the heap, i.e. not available in the pool.
+      size_t heap_allocations;
+      /// Blocks taken from the pool.
+      size_t reuses;
+    };
+
+    /// Construct a @a T with @a factory(memory), that must return
+    /// `new (memory) T(...)`. Taking a factory allows the serializers to
+    /// call the constructors they have access to.
+    template <typename T, typename FactoryT>
+    static SharedPtr<T> Make(FactoryT &&factory) {
+      const auto &pool = detail::GetBlockPool<T>();
+      void *memory = pool->Allocate();
+      T *object;
+      try {
+        object = factory(memory);
+      } catch (...) {
+        pool->Deallocate(memory);
+        throw;
+      }
+      return SharedPtr<T>(object, detail::PoolDeleter<T>(), detail::PoolAllocator<T>());
+    }
+
+    /// Statistics of the pool of objects of type @a T.
+    template <typename T>
+    static Stats GetStats() {
+      const auto &pool = detail::GetBlockPool<T>();
+      return {pool->GetHeapAllocations(), pool->GetReuses()};
+    }
+  };
+
+} // namespace sensor
+} // namespace carla
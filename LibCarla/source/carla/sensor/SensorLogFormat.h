@@ -0,0 +1,80 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace carla {
+namespace sensor {
+
+  /// On-disk layout of the sensor log files written by SensorLogWriter and
+  /// read by SensorLogReader. All the values are little endian.
+  ///
+  ///   FileHeader
+  ///   RecordHeader + buffer + padding   (repeated, one per sensor message)
+  ///   IndexEntry                        (repeated, sorted by sensor, frame)
+  ///   Trailer
+  ///
+  /// Each buffer is the message as received from the sensor's stream, i.e.
+  /// the SensorHeaderSerializer::Header followed by the payload. Records are
+  /// self-describing, so the index can be rebuilt from them if the file was
+  /// not closed properly.
+  class SensorLogFormat {
+  public:
+
+    static constexpr uint32_t version = 1u;
+
+    /// Records are aligned so the buffers can be used in place.
+    static constexpr size_t alignment = 8u;
+
+#pragma pack(push, 1)
+    struct FileHeader {
+      char magic[8u];
+      uint32_t version;
+      uint32_t reserved;
+    };
+
+    struct RecordHeader {
+      uint32_t sensor_id;
+      uint32_t size;
+    };
+
+    struct IndexEntry {
+      /// Offset of the buffer (past the RecordHeader) from the file start.
+      uint64_t offset;
+      uint64_t frame;
+      uint32_t sensor_id;
+      uint32_t size;
+    };
+
+    struct Trailer {
+      uint64_t index_offset;
+      uint64_t number_of_entries;
+      char magic[8u];
+    };
+#pragma pack(pop)
+
+    static constexpr const char *file_magic() {
+      return "CARLALOG";
+    }
+
+    static constexpr const char *index_magic() {
+      return "CARLAIDX";
+    }
+
+    static constexpr uint64_t Align(uint64_t offset) {
+      return (offset + alignment - 1u) & ~(uint64_t(alignment) - 1u);
+    }
+
+    static_assert(sizeof(FileHeader) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(RecordHeader) % alignment == 0u, "Invalid alignment");
+    static_assert(sizeof(IndexEntry) % alignment == 0u, "Invalid alignment");
+  };
+
+} // namespace sensor
+} // namespace carla
@@ -0,0 +1,162 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/SensorLogReader.h"
+
+#include "carla/Exception.h"
+#include "carla/Logging.h"
+#include "carla/sensor/Deserializer.h"
+#include "carla/sensor/s11n/SensorHeaderSerializer.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+
+namespace carla {
+namespace sensor {
+
+  using Format = SensorLogFormat;
+
+  template <typename T>
+  static T ReadAt(const unsigned char *data, size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+  }
+
+  static bool IsLess(const SensorLogFormat::IndexEntry &lhs, const SensorLogFormat::IndexEntry &rhs) {
+    return std::tie(lhs.sensor_id, lhs.frame) < std::tie(rhs.sensor_id, rhs.frame);
+  }
+
+  SensorLogReader::SensorLogReader(const std::string &path) {
+    namespace bip = boost::interprocess;
+    try {
+      bip::file_mapping file(path.c_str(), bip::read_only);
+      _region = std::make_shared<bip::mapped_region>(file, bip::copy_on_write);
+    } catch (const bip::interprocess_exception &e) {
+      throw_exception(std::runtime_error("SensorLogReader: failed to map " + path + ": " + e.what()));
+    }
+    if ((GetSize() < sizeof(Format::FileHeader)) ||
+        (std::memcmp(GetBegin(), Format::file_magic(), sizeof(Format::FileHeader::magic)) != 0)) {
+      throw_exception(std::runtime_error("SensorLogReader: " + path + " is not a sensor log"));
+    }
+    const auto header = ReadAt<Format::FileHeader>(GetBegin(), 0u);
+    if (header.version != Format::version) {
+      throw_exception(std::runtime_error("SensorLogReader: unsupported version of " + path));
+    }
+    if (!ReadIndex()) {
+      log_warning("SensorLogReader:", path, "has no index, scanning records");
+      ScanRecords();
+    }
+  }
+
+  SensorLogReader::~SensorLogReader() = default;
+
+  std::vector<uint32_t> SensorLogReader::GetSensorIds() const {
+    std::vector<uint32_t> result;
+    for (auto &entry : _index) {
+      if (result.empty() || (result.back() != entry.sensor_id)) {
+        result.emplace_back(entry.sensor_id);
+      }
+    }
+    return result;
+  }
+
+  std::pair<const SensorLogReader::Entry *, const SensorLogReader::Entry *>
+  SensorLogReader::GetEntries(const uint32_t sensor_id) const {
+    auto begin = std::lower_bound(_index.begin(), _index.end(), sensor_id, [](const Entry &entry, uint32_t id) {
+      return entry.sensor_id < id;
+    });
+    auto end = std::upper_bound(begin, _index.end(), sensor_id, [](uint32_t id, const Entry &entry) {
+      return id < entry.sensor_id;
+    });
+    return {_index.data() + (begin - _index.begin()), _index.data() + (end - _index.begin())};
+  }
+
+  boost::optional<SensorLogReader::Entry> SensorLogReader::Find(
+      const uint32_t sensor_id,
+      const uint64_t frame) const {
+    const Entry key{0u, frame, sensor_id, 0u};
+    auto it = std::lower_bound(_index.begin(), _index.end(), key, IsLess);
+    if ((it != _index.end()) && (it->sensor_id == sensor_id) && (it->frame == frame)) {
+      return *it;
+    }
+    return boost::none;
+  }
+
+  Buffer SensorLogReader::GetBuffer(const Entry &entry) const {
+    DEBUG_ASSERT(entry.offset + entry.size <= GetSize());
+    auto *data = static_cast<unsigned char *>(_region->get_address()) + entry.offset;
+    return Buffer{data, entry.size, _region};
+  }
+
+  SharedPtr<SensorData> SensorLogReader::GetSensorData(const Entry &entry) const {
+    return Deserializer::Deserialize(GetBuffer(entry));
+  }
+
+  SharedPtr<SensorData> SensorLogReader::GetSensorData(
+      const uint32_t sensor_id,
+      const uint64_t frame) const {
+    auto entry = Find(sensor_id, frame);
+    if (!entry.has_value()) {
+      throw_exception(std::out_of_range("SensorLogReader: message not found"));
+    }
+    return GetSensorData(*entry);
+  }
+
+  bool SensorLogReader::ReadIndex() {
+    const size_t size = GetSize();
+    if (size < sizeof(Format::FileHeader) + sizeof(Format::Trailer)) {
+      return false;
+    }
+    const auto trailer = ReadAt<Format::Trailer>(GetBegin(), size - sizeof(Format::Trailer));
+    if (std::memcmp(trailer.magic, Format::index_magic(), sizeof(trailer.magic)) != 0) {
+      return false;
+    }
+    const auto index_size = sizeof(Format::IndexEntry) * trailer.number_of_entries;
+    if ((trailer.index_offset < sizeof(Format::FileHeader)) ||
+        (trailer.index_offset + index_size + sizeof(Format::Trailer) != size)) {
+      return false;
+    }
+    _index.resize(trailer.number_of_entries);
+    std::memcpy(_index.data(), GetBegin() + trailer.index_offset, index_size);
+    return std::all_of(_index.begin(), _index.end(), [&](const auto &entry) {
+      return entry.offset + entry.size <= trailer.index_offset;
+    });
+  }
+
+  void SensorLogReader::ScanRecords() {
+    using HeaderSerializer = s11n::SensorHeaderSerializer;
+    _index.clear();
+    const size_t size = GetSize();
+    uint64_t offset = sizeof(Format::FileHeader);
+    while (offset + sizeof(Format::RecordHeader) <= size) {
+      const auto record = ReadAt<Format::RecordHeader>(GetBegin(), offset);
+      const uint64_t begin = offset + sizeof(Format::RecordHeader);
+      if ((record.size < HeaderSerializer::header_offset) || (begin + record.size > size)) {
+        break;
+      }
+      const auto header = ReadAt<HeaderSerializer::Header>(GetBegin(), begin);
+      _index.push_back(Entry{begin, header.frame, record.sensor_id, record.size});
+      offset = Format::Align(begin + record.size);
+    }
+    std::stable_sort(_index.begin(), _index.end(), IsLess);
+  }
+
+  const unsigned char *SensorLogReader::GetBegin() const {
+    return static_cast<const unsigned char *>(_region->get_address());
+  }
+
+  size_t SensorLogReader::GetSize() const {
+    return _region->get_size();
+  }
+
+} // namespace sensor
+} // namespace carla
@@ -0,0 +1,99 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/sensor/SensorLogFormat.h"
+
+#include <boost/optional.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace interprocess {
+
+  class mapped_region;
+
+} // namespace interprocess
+} // namespace boost
+
+namespace carla {
+namespace sensor {
+
+  class SensorData;
+
+  /// Reads a sensor log written by SensorLogWriter. The file is memory
+  /// mapped, and the buffers returned point directly to the mapped memory,
+  /// which stays mapped while any of them is alive (even if the reader is
+  /// destroyed).
+  ///
+  /// The mapping is copy-on-write, modifying a buffer does not modify the
+  /// file.
+  ///
+  /// If the file has no index, because the writer was not closed, the index
+  /// is rebuilt by scanning the records, ignoring a truncated one at the end.
+  class SensorLogReader : private NonCopyable {
+  public:
+
+    using Entry = SensorLogFormat::IndexEntry;
+
+    /// @throw std::runtime_error if the file cannot be mapped or is not a
+    /// sensor log.
+    explicit SensorLogReader(const std::string &path);
+
+    ~SensorLogReader();
+
+    /// Entries of every message in the log, sorted by sensor id and frame.
+    const std::vector<Entry> &GetIndex() const {
+      return _index;
+    }
+
+    size_t size() const {
+      return _index.size();
+    }
+
+    /// Ids of the sensors with messages in the log, sorted.
+    std::vector<uint32_t> GetSensorIds() const;
+
+    /// Entries of the messages of @a sensor_id, sorted by frame.
+    std::pair<const Entry *, const Entry *> GetEntries(uint32_t sensor_id) const;
+
+    /// Entry of the message of @a sensor_id at @a frame, if any.
+    boost::optional<Entry> Find(uint32_t sensor_id, uint64_t frame) const;
+
+    /// Buffer with the message of @a entry, without copying it.
+    Buffer GetBuffer(const Entry &entry) const;
+
+    /// Deserialize the message of @a entry.
+    SharedPtr<SensorData> GetSensorData(const Entry &entry) const;
+
+    /// Deserialize the message of @a sensor_id at @a frame.
+    ///
+    /// @throw std::out_of_range if there is no such message.
+    SharedPtr<SensorData> GetSensorData(uint32_t sensor_id, uint64_t frame) const;
+
+  private:
+
+    bool ReadIndex();
+
+    void ScanRecords();
+
+    const unsigned char *GetBegin() const;
+
+    size_t GetSize() const;
+
+    std::shared_ptr<boost::interprocess::mapped_region> _region;
+
+    std::vector<Entry> _index;
+  };
+
+} // namespace sensor
+} // namespace carla
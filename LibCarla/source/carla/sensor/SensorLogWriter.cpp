@@ -0,0 +1,107 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/SensorLogWriter.h"
+
+#include "carla/Exception.h"
+#include "carla/FileSystem.h"
+#include "carla/Logging.h"
+#include "carla/sensor/s11n/SensorHeaderSerializer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <tuple>
+
+namespace carla {
+namespace sensor {
+
+  using Format = SensorLogFormat;
+
+  SensorLogWriter::SensorLogWriter(std::string path)
+    : _path([&]() {
+        FileSystem::ValidateFilePath(path, ".log");
+        return std::move(path);
+      }()),
+      _file(_path, std::ios::binary | std::ios::trunc) {
+    if (!_file.is_open()) {
+      throw_exception(std::runtime_error("SensorLogWriter: failed to open " + _path));
+    }
+    Format::FileHeader header;
+    std::memcpy(header.magic, Format::file_magic(), sizeof(header.magic));
+    header.version = Format::version;
+    header.reserved = 0u;
+    WriteBytes(&header, sizeof(header));
+  }
+
+  SensorLogWriter::~SensorLogWriter() {
+    try {
+      Close();
+    } catch (const std::exception &e) {
+      log_error("SensorLogWriter: failed to close", _path, ':', e.what());
+    }
+  }
+
+  void SensorLogWriter::Write(const uint32_t sensor_id, const Buffer &buffer) {
+    using HeaderSerializer = s11n::SensorHeaderSerializer;
+    if (buffer.size() < HeaderSerializer::header_offset) {
+      throw_exception(std::invalid_argument("SensorLogWriter: buffer has no sensor header"));
+    }
+    const auto frame = HeaderSerializer::Deserialize(buffer).frame;
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_file.is_open()) {
+      throw_exception(std::runtime_error("SensorLogWriter: " + _path + " is closed"));
+    }
+    const Format::RecordHeader header{sensor_id, buffer.size()};
+    WriteBytes(&header, sizeof(header));
+    const auto offset = _position;
+    WriteBytes(buffer.data(), buffer.size());
+    WritePadding();
+    // Indexed only once complete, a failed write leaves no entry pointing to
+    // a partial record.
+    _index.push_back(Format::IndexEntry{offset, frame, sensor_id, buffer.size()});
+  }
+
+  size_t SensorLogWriter::GetNumberOfRecords() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _index.size();
+  }
+
+  void SensorLogWriter::Close() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_file.is_open()) {
+      return;
+    }
+    std::stable_sort(_index.begin(), _index.end(), [](const auto &lhs, const auto &rhs) {
+      return std::tie(lhs.sensor_id, lhs.frame) < std::tie(rhs.sensor_id, rhs.frame);
+    });
+    Format::Trailer trailer;
+    trailer.index_offset = _position;
+    trailer.number_of_entries = _index.size();
+    std::memcpy(trailer.magic, Format::index_magic(), sizeof(trailer.magic));
+    WriteBytes(_index.data(), sizeof(Format::IndexEntry) * _index.size());
+    WriteBytes(&trailer, sizeof(trailer));
+    _file.close();
+    if (_file.fail()) {
+      throw_exception(std::runtime_error("SensorLogWriter: failed to write " + _path));
+    }
+  }
+
+  void SensorLogWriter::WriteBytes(const void *data, const size_t size) {
+    _file.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+    if (_file.fail()) {
+      throw_exception(std::runtime_error("SensorLogWriter: failed to write " + _path));
+    }
+    _position += size;
+  }
+
+  void SensorLogWriter::WritePadding() {
+    constexpr char zeros[Format::alignment] = {0};
+    WriteBytes(zeros, Format::Align(_position) - _position);
+  }
+
+} // namespace sensor
+} // namespace carla
@@ -0,0 +1,72 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/NonCopyable.h"
+#include "carla/sensor/SensorLogFormat.h"
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+
+  /// Appends the raw messages of one or several sensors to a single sensor
+  /// log file, see SensorLogFormat. The index is written on Close; until
+  /// then the file can only be read by scanning its records.
+  ///
+  /// Writing is thread-safe.
+  class SensorLogWriter : private NonCopyable {
+  public:
+
+    /// Create (or truncate) the log file at @a path.
+    ///
+    /// @throw std::runtime_error if the file cannot be opened.
+    explicit SensorLogWriter(std::string path);
+
+    /// Closes the file if still open.
+    ~SensorLogWriter();
+
+    const std::string &GetPath() const {
+      return _path;
+    }
+
+    /// Append @a buffer, a message received from the stream of the sensor
+    /// identified by @a sensor_id (usually its actor id).
+    ///
+    /// @throw std::invalid_argument if @a buffer has no sensor header.
+    /// @throw std::runtime_error if the file is closed or on I/O errors.
+    void Write(uint32_t sensor_id, const Buffer &buffer);
+
+    /// Number of messages written so far.
+    size_t GetNumberOfRecords() const;
+
+    /// Write the index and close the file.
+    void Close();
+
+  private:
+
+    void WriteBytes(const void *data, size_t size);
+
+    void WritePadding();
+
+    const std::string _path;
+
+    mutable std::mutex _mutex;
+
+    std::ofstream _file;
+
+    uint64_t _position = 0u;
+
+    std::vector<SensorLogFormat::IndexEntry> _index;
+  };
+
+} // namespace sensor
+} // namespace carla
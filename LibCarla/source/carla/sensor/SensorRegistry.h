@@ -38,7 +38,8 @@ class FWorldObserver;
 namespace carla {
 namespace sensor {
 
-  // 3. Register the sensor and its serializer in the SensorRegistry.
+  // 3. Register the sensor and its serializer in the SensorRegistry, at the
+  //    end of the list.
 
   /// Contains a registry of all the sensors available and allows serializing
   /// and deserializing sensor data for the types registered.
@@ -58,6 +59,20 @@ namespace sensor {
     std::pair<AObstacleDetectionSensor *, s11n::ObstacleDetectionEventSerializer>
   >;
 
+  // The type id of a sensor is its position in the registry, it is written
+  // in the header of every message and in the sensor logs. Type ids must not
+  // change, so old logs can still be read.
+  static_assert(SensorRegistry::get<FWorldObserver *>::index == 0u, "Sensor type ids must be stable");
+  static_assert(SensorRegistry::get<ASceneCaptureCamera *>::index == 1u, "Sensor type ids must be stable");
+  static_assert(SensorRegistry::get<ADepthCamera *>::index == 2u, "Sensor type ids must be stable");
+  static_assert(SensorRegistry::get<AInertialMeasurementUnit *>::index == 3u, "Sensor type ids must be stable");
+  static_assert(SensorRegistry::get<ASemanticSegmentationCamera *>::index == 4u, "Sensor type ids must be stable");
+  static_assert(SensorRegistry::get<ARayCastLidar *>::index == 5u, "Sensor type ids must be stable");
+  static_assert(SensorRegistry::get<ACollisionSensor *>::index == 6u, "Sensor type ids must be stable");
+  static_assert(SensorRegistry::get<AGnssSensor *>::index == 7u, "Sensor type ids must be stable");
+  static_assert(SensorRegistry::get<ALaneInvasionSensor *>::index == 8u, "Sensor type ids must be stable");
+  static_assert(SensorRegistry::get<AObstacleDetectionSensor *>::index == 9u, "Sensor type ids must be stable");
+
 } // namespace sensor
 } // namespace carla
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "carla/Debug.h"
+#include "carla/ListView.h"
 #include "carla/rpc/Location.h"
 #include "carla/sensor/data/Array.h"
 #include "carla/sensor/s11n/LidarSerializer.h"
@@ -16,7 +17,8 @@ namespace sensor {
 namespace data {
 
   /// Measurement produced by a Lidar. Consists of an array of 3D points plus
-  /// some extra meta-information about the Lidar.
+  /// some extra meta-information about the Lidar. Optionally, the intensity
+  /// and the channel (ring) of each point are available as separate columns.
   class LidarMeasurement : public Array<rpc::Location>  {
     static_assert(sizeof(rpc::Location) == 3u * sizeof(float), "Location size missmatch");
     using Super = Array<rpc::Location>;
@@ -27,12 +29,15 @@ namespace data {
     friend Serializer;
 
     explicit LidarMeasurement(RawData data)
-      : Super(std::move(data)) {
-      Super::SetOffset(Serializer::GetHeaderOffset(Super::GetRawData()));
-    }
+      : LidarMeasurement(Serializer::GetPointsOffset(data), data) {}
 
   private:
 
+    /// The offset is computed before @a data is moved into the array, the
+    /// header and the columns are not a multiple of the size of a point.
+    LidarMeasurement(size_t points_offset, RawData &data)
+      : Super(points_offset, std::move(data)) {}
+
     auto GetHeader() const {
       return Serializer::DeserializeHeader(Super::GetRawData());
     }
@@ -55,6 +60,36 @@ namespace data {
     auto GetPointCount(size_t channel) const {
       return GetHeader().GetPointCount(channel);
     }
+
+    bool HasIntensity() const {
+      return (GetHeader().GetFlags() & s11n::LidarFlags::Intensity) != 0u;
+    }
+
+    bool HasRing() const {
+      return (GetHeader().GetFlags() & s11n::LidarFlags::Ring) != 0u;
+    }
+
+    /// Intensity of each point, in the same order as the points. Empty if
+    /// the Lidar does not send intensities.
+    ListView<const float *> GetIntensity() const {
+      const auto layout = Serializer::GetColumnLayout(Super::GetRawData());
+      const auto *begin = reinterpret_cast<const float *>(GetColumnsBegin() + layout.intensity_offset);
+      return ListView<const float *>(begin, begin + layout.intensity_size / sizeof(float));
+    }
+
+    /// Channel of each point, in the same order as the points. Empty if the
+    /// Lidar does not send the rings, use GetPointCount(channel) instead.
+    ListView<const uint16_t *> GetRing() const {
+      const auto layout = Serializer::GetColumnLayout(Super::GetRawData());
+      const auto *begin = reinterpret_cast<const uint16_t *>(GetColumnsBegin() + layout.ring_offset);
+      return ListView<const uint16_t *>(begin, begin + layout.ring_size / sizeof(uint16_t));
+    }
+
+  private:
+
+    const unsigned char *GetColumnsBegin() const {
+      return Super::GetRawData().begin() + Serializer::GetHeaderOffset(Super::GetRawData());
+    }
   };
 
 } // namespace data
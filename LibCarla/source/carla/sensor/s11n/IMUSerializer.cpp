@@ -5,6 +5,7 @@
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
 #include "carla/sensor/s11n/IMUSerializer.h"
+#include "carla/sensor/SensorDataPool.h"
 #include "carla/sensor/data/IMUMeasurement.h"
 
 namespace carla {
@@ -12,7 +13,9 @@ namespace sensor {
 namespace s11n {
 
   SharedPtr<SensorData> IMUSerializer::Deserialize(RawData &&data) {
-    return SharedPtr<SensorData>(new data::IMUMeasurement(std::move(data)));
+    return SensorDataPool::Make<data::IMUMeasurement>([&](void *memory) {
+      return new (memory) data::IMUMeasurement(std::move(data));
+    });
   }
 
 } // namespace s11n
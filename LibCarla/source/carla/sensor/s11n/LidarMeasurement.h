@@ -6,15 +6,33 @@
 
 #pragma once
 
+#include "carla/Debug.h"
 #include "carla/rpc/Location.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <vector>
 
 namespace carla {
 namespace sensor {
 namespace s11n {
 
+  /// Optional columns and encodings of a Lidar measurement.
+  struct LidarFlags {
+    enum : uint32_t {
+      /// Intensity of each point.
+      Intensity = 1u << 0u,
+      /// Channel (ring) of each point.
+      Ring = 1u << 1u,
+      /// Points and intensities are sent as 16-bit fixed point. The client
+      /// expands them back to floats on deserialization.
+      CompactPoints = 1u << 2u
+    };
+  };
+
   /// Helper class to store and serialize the data generated by a Lidar.
   ///
   /// The header of a Lidar measurement consists of an array of uint32_t's in
@@ -23,19 +41,25 @@ namespace s11n {
   ///    {
   ///      Horizontal angle (float),
   ///      Channel count,
+  ///      Layout (version << 16 | LidarFlags),
+  ///      Point scale (float, only for CompactPoints),
   ///      Point count of channel 0,
   ///      ...
   ///      Point count of channel n,
   ///    }
   ///
-  /// The points are stored in an array of floats
+  /// followed by the columns, one value per point in the same order
   ///
   ///    {
-  ///      X0, Y0, Z0,
-  ///      ...
-  ///      Xn, Yn, Zn,
+  ///      Intensity (float, or uint16 / 65535 if compact), if present
+  ///      Ring (uint16), if present
+  ///      Padding to 4 bytes
+  ///      X0, Y0, Z0, ..., Xn, Yn, Zn (float, or int16 * scale if compact)
   ///    }
   ///
+  /// Points are last so the client can access them as an array of
+  /// rpc::Location, as before the columns were added.
+  ///
   /// @warning WritePoint should be called sequentially in the order in which
   /// the points are going to be stored, i.e., starting at channel zero and
   /// increasing steadily.
@@ -48,14 +72,19 @@ namespace s11n {
     enum Index : size_t {
       HorizontalAngle,
       ChannelCount,
+      Layout,
+      PointScale,
       SIZE
     };
 
   public:
 
+    static constexpr uint32_t Version = 2u;
+
     explicit LidarMeasurement(uint32_t ChannelCount = 0u)
       : _header(Index::SIZE + ChannelCount, 0u) {
       _header[Index::ChannelCount] = ChannelCount;
+      SetLayout(0u);
     }
 
     LidarMeasurement &operator=(LidarMeasurement &&) = default;
@@ -72,25 +101,98 @@ namespace s11n {
       return _header[Index::ChannelCount];
     }
 
+    uint32_t GetFlags() const {
+      return _header[Index::Layout] & 0xFFFFu;
+    }
+
+    /// Select the columns sent with the points, a combination of LidarFlags.
+    /// With CompactPoints, the points must lie within @a range of the sensor,
+    /// in the same units as the points (meters).
+    void SetLayout(uint32_t flags, float range = 0.0f) {
+      DEBUG_ASSERT(((flags & LidarFlags::CompactPoints) == 0u) || (range > 0.0f));
+      _header[Index::Layout] = (Version << 16u) | flags;
+      const float scale = (flags & LidarFlags::CompactPoints) ?
+          range / static_cast<float>(std::numeric_limits<int16_t>::max()) :
+          0.0f;
+      std::memcpy(&_header[Index::PointScale], &scale, sizeof(uint32_t));
+    }
+
+    /// Same as SetLayout, but @a range_in_centimeters comes from the sensor
+    /// description, in Unreal units. The points are still written in meters,
+    /// as rpc::Location converts them from FVector.
+    void SetLayoutFromCentimeters(uint32_t flags, float range_in_centimeters) {
+      SetLayout(flags, 1e-2f * range_in_centimeters);
+    }
+
     void Reset(uint32_t total_point_count) {
       std::memset(_header.data() + Index::SIZE, 0, sizeof(uint32_t) * GetChannelCount());
       _points.clear();
-      _points.reserve(3u * total_point_count);
+      _compact_points.clear();
+      _intensity.clear();
+      _compact_intensity.clear();
+      _ring.clear();
+      const auto flags = GetFlags();
+      if (flags & LidarFlags::CompactPoints) {
+        _compact_points.reserve(3u * total_point_count);
+        if (flags & LidarFlags::Intensity) {
+          _compact_intensity.reserve(total_point_count);
+        }
+      } else {
+        _points.reserve(3u * total_point_count);
+        if (flags & LidarFlags::Intensity) {
+          _intensity.reserve(total_point_count);
+        }
+      }
+      if (flags & LidarFlags::Ring) {
+        _ring.reserve(total_point_count);
+      }
     }
 
-    void WritePoint(uint32_t channel, rpc::Location point) {
+    void WritePoint(uint32_t channel, rpc::Location point, float intensity = 0.0f) {
       DEBUG_ASSERT(GetChannelCount() > channel);
       _header[Index::SIZE + channel] += 1u;
-      _points.emplace_back(point.x);
-      _points.emplace_back(point.y);
-      _points.emplace_back(point.z);
+      const auto flags = GetFlags();
+      if (flags & LidarFlags::CompactPoints) {
+        float scale;
+        std::memcpy(&scale, &_header[Index::PointScale], sizeof(float));
+        _compact_points.emplace_back(Quantize(point.x / scale));
+        _compact_points.emplace_back(Quantize(point.y / scale));
+        _compact_points.emplace_back(Quantize(point.z / scale));
+        if (flags & LidarFlags::Intensity) {
+          const float value = std::max(0.0f, std::min(intensity, 1.0f));
+          _compact_intensity.emplace_back(static_cast<uint16_t>(std::lround(value * 65535.0f)));
+        }
+      } else {
+        _points.emplace_back(point.x);
+        _points.emplace_back(point.y);
+        _points.emplace_back(point.z);
+        if (flags & LidarFlags::Intensity) {
+          _intensity.emplace_back(intensity);
+        }
+      }
+      if (flags & LidarFlags::Ring) {
+        _ring.emplace_back(static_cast<uint16_t>(channel));
+      }
     }
 
   private:
 
+    static int16_t Quantize(float value) {
+      constexpr float max = std::numeric_limits<int16_t>::max();
+      return static_cast<int16_t>(std::lround(std::max(-max, std::min(value, max))));
+    }
+
     std::vector<uint32_t> _header;
 
     std::vector<float> _points;
+
+    std::vector<int16_t> _compact_points;
+
+    std::vector<float> _intensity;
+
+    std::vector<uint16_t> _compact_intensity;
+
+    std::vector<uint16_t> _ring;
   };
 
 } // namespace s11n
@@ -6,6 +6,7 @@
 
 #include "carla/sensor/s11n/LidarSerializer.h"
 
+#include "carla/sensor/SensorDataPool.h"
 #include "carla/sensor/data/LidarMeasurement.h"
 
 namespace carla {
@@ -13,8 +14,63 @@ namespace sensor {
 namespace s11n {
 
   SharedPtr<SensorData> LidarSerializer::Deserialize(RawData &&data) {
-    return SharedPtr<data::LidarMeasurement>(
-        new data::LidarMeasurement{std::move(data)});
+    DEBUG_ASSERT(DeserializeHeader(data).GetVersion() == LidarMeasurement::Version);
+    if (DeserializeHeader(data).GetFlags() & LidarFlags::CompactPoints) {
+      return SensorDataPool::Make<data::LidarMeasurement>([&](void *memory) {
+        return new (memory) data::LidarMeasurement{ExpandCompactPoints(data)};
+      });
+    }
+    return SensorDataPool::Make<data::LidarMeasurement>([&](void *memory) {
+      return new (memory) data::LidarMeasurement{std::move(data)};
+    });
+  }
+
+  template <typename T>
+  static T ReadValue(const unsigned char *data, size_t index) {
+    T value;
+    std::memcpy(&value, data + index * sizeof(T), sizeof(T));
+    return value;
+  }
+
+  RawData LidarSerializer::ExpandCompactPoints(const RawData &data) {
+    const auto header = DeserializeHeader(data);
+    const auto number_of_points = header.GetPointCount();
+    const auto scale = header.GetPointScale();
+    const auto flags = header.GetFlags();
+    const auto expanded_flags = flags & ~uint32_t(LidarFlags::CompactPoints);
+    const auto src_layout = GetColumnLayout(flags, number_of_points);
+    const auto dst_layout = GetColumnLayout(expanded_flags, number_of_points);
+
+    // The sensor header and the Lidar header are kept, only the layout
+    // changes.
+    const size_t prefix_size = SensorHeaderSerializer::header_offset + GetHeaderOffset(data);
+    Buffer buffer(static_cast<uint64_t>(prefix_size + dst_layout.points_offset + dst_layout.points_size));
+    std::memcpy(buffer.data(), data._buffer.data(), prefix_size);
+    const uint32_t layout = (LidarMeasurement::Version << 16u) | expanded_flags;
+    const float no_scale = 0.0f;
+    auto *lidar_header = buffer.data() + SensorHeaderSerializer::header_offset;
+    std::memcpy(lidar_header + sizeof(uint32_t) * LidarMeasurement::Index::Layout, &layout, sizeof(uint32_t));
+    std::memcpy(lidar_header + sizeof(uint32_t) * LidarMeasurement::Index::PointScale, &no_scale, sizeof(float));
+
+    const unsigned char *src = data.begin() + GetHeaderOffset(data);
+    unsigned char *dst = buffer.data() + prefix_size;
+
+    for (size_t i = 0u; i < dst_layout.intensity_size / sizeof(float); ++i) {
+      const float intensity =
+          static_cast<float>(ReadValue<uint16_t>(src + src_layout.intensity_offset, i)) / 65535.0f;
+      std::memcpy(dst + dst_layout.intensity_offset + i * sizeof(float), &intensity, sizeof(float));
+    }
+    std::memcpy(dst + dst_layout.ring_offset, src + src_layout.ring_offset, src_layout.ring_size);
+    std::memset(
+        dst + dst_layout.ring_offset + dst_layout.ring_size,
+        0,
+        dst_layout.points_offset - dst_layout.ring_offset - dst_layout.ring_size);
+    for (size_t i = 0u; i < 3u * number_of_points; ++i) {
+      const float value =
+          scale * static_cast<float>(ReadValue<int16_t>(src + src_layout.points_offset, i));
+      std::memcpy(dst + dst_layout.points_offset + i * sizeof(float), &value, sizeof(float));
+    }
+    return RawData{std::move(buffer)};
   }
 
 } // namespace s11n
@@ -40,6 +40,29 @@ namespace s11n {
       return _begin[Index::SIZE + channel];
     }
 
+    /// Number of points of all the channels.
+    size_t GetPointCount() const {
+      size_t count = 0u;
+      for (auto i = 0u; i < GetChannelCount(); ++i) {
+        count += GetPointCount(i);
+      }
+      return count;
+    }
+
+    uint32_t GetVersion() const {
+      return _begin[Index::Layout] >> 16u;
+    }
+
+    /// Combination of LidarFlags.
+    uint32_t GetFlags() const {
+      return _begin[Index::Layout] & 0xFFFFu;
+    }
+
+    /// Size of a step of the compact points.
+    float GetPointScale() const {
+      return reinterpret_cast<const float &>(_begin[Index::PointScale]);
+    }
+
   private:
 
     friend class LidarSerializer;
@@ -59,6 +82,31 @@ namespace s11n {
   class LidarSerializer {
   public:
 
+    /// Position of the columns after the header, in bytes.
+    struct ColumnLayout {
+      size_t intensity_offset;
+      size_t intensity_size;
+      size_t ring_offset;
+      size_t ring_size;
+      size_t points_offset;
+      size_t points_size;
+    };
+
+    static ColumnLayout GetColumnLayout(uint32_t flags, size_t number_of_points) {
+      const bool compact = (flags & LidarFlags::CompactPoints) != 0u;
+      ColumnLayout layout;
+      layout.intensity_offset = 0u;
+      layout.intensity_size = (flags & LidarFlags::Intensity) ?
+          number_of_points * (compact ? sizeof(uint16_t) : sizeof(float)) :
+          0u;
+      layout.ring_offset = layout.intensity_offset + layout.intensity_size;
+      layout.ring_size = (flags & LidarFlags::Ring) ? number_of_points * sizeof(uint16_t) : 0u;
+      // Keep the points aligned to 4 bytes.
+      layout.points_offset = (layout.ring_offset + layout.ring_size + 3u) & ~size_t(3u);
+      layout.points_size = 3u * number_of_points * (compact ? sizeof(int16_t) : sizeof(float));
+      return layout;
+    }
+
     static LidarHeaderView DeserializeHeader(const RawData &data) {
       return LidarHeaderView{reinterpret_cast<const uint32_t *>(data.begin())};
     }
@@ -68,6 +116,16 @@ namespace s11n {
       return sizeof(uint32_t) * (View.GetChannelCount() + LidarMeasurement::Index::SIZE);
     }
 
+    static ColumnLayout GetColumnLayout(const RawData &data) {
+      auto View = DeserializeHeader(data);
+      return GetColumnLayout(View.GetFlags(), View.GetPointCount());
+    }
+
+    /// Offset of the array of points, past the header and the columns.
+    static size_t GetPointsOffset(const RawData &data) {
+      return GetHeaderOffset(data) + GetColumnLayout(data).points_offset;
+    }
+
     template <typename Sensor>
     static Buffer Serialize(
         const Sensor &sensor,
@@ -75,6 +133,11 @@ namespace s11n {
         Buffer &&bitmap);
 
     static SharedPtr<SensorData> Deserialize(RawData &&data);
+
+  private:
+
+    /// Convert the compact points and intensities to floats.
+    static RawData ExpandCompactPoints(const RawData &data);
   };
 
   // ===========================================================================
@@ -86,9 +149,23 @@ namespace s11n {
       const Sensor &,
       const LidarMeasurement &measurement,
       Buffer &&output) {
-    std::array<boost::asio::const_buffer, 2u> seq = {
+    const auto flags = measurement.GetFlags();
+    const bool compact = (flags & LidarFlags::CompactPoints) != 0u;
+    const auto number_of_points = (compact ?
+        measurement._compact_points.size() :
+        measurement._points.size()) / 3u;
+    const auto layout = GetColumnLayout(flags, number_of_points);
+    const uint32_t padding = 0u;
+    std::array<boost::asio::const_buffer, 5u> seq = {
         boost::asio::buffer(measurement._header),
-        boost::asio::buffer(measurement._points)};
+        compact ?
+            boost::asio::buffer(measurement._compact_intensity) :
+            boost::asio::buffer(measurement._intensity),
+        boost::asio::buffer(measurement._ring),
+        boost::asio::buffer(&padding, layout.points_offset - layout.ring_offset - layout.ring_size),
+        compact ?
+            boost::asio::buffer(measurement._compact_points) :
+            boost::asio::buffer(measurement._points)};
     output.copy_from(seq);
     return std::move(output);
   }
@@ -0,0 +1,147 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/AsyncDiskWriter.h>
+
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+using carla::AsyncDiskWriter;
+using carla::Buffer;
+
+/// Keeps the writes blocked until opened.
+class Gate {
+public:
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this]() { return _open; });
+  }
+
+  void Open() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _open = true;
+    }
+    _condition.notify_all();
+  }
+
+private:
+
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  bool _open = false;
+};
+
+TEST(async_disk_writer, write_files) {
+  namespace fs = boost::filesystem;
+  const auto folder = fs::temp_directory_path() / fs::unique_path();
+  fs::create_directories(folder);
+  constexpr auto number_of_files = 50u;
+  {
+    AsyncDiskWriter writer(4u, 8u, AsyncDiskWriter::OverflowPolicy::Block);
+    for (auto i = 0u; i < number_of_files; ++i) {
+      const std::string content = "file " + std::to_string(i);
+      const auto path = (folder / (std::to_string(i) + ".txt")).string();
+      ASSERT_TRUE(writer.Write(Buffer(content), path, [](const Buffer &data, const std::string &file) {
+        std::ofstream out(file, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(data.data()), data.size());
+      }));
+    }
+    writer.Flush();
+    const auto stats = writer.GetStats();
+    ASSERT_EQ(stats.pending, 0u);
+    ASSERT_EQ(stats.written, number_of_files);
+    ASSERT_EQ(stats.dropped, 0u);
+    ASSERT_EQ(stats.failed, 0u);
+    ASSERT_GT(stats.bytes_written, 0u);
+  }
+  for (auto i = 0u; i < number_of_files; ++i) {
+    std::ifstream in((folder / (std::to_string(i) + ".txt")).string());
+    const std::string content{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    ASSERT_EQ(content, "file " + std::to_string(i));
+  }
+  fs::remove_all(folder);
+}
+
+TEST(async_disk_writer, drop_policies) {
+  for (auto policy : {AsyncDiskWriter::OverflowPolicy::DropNewest, AsyncDiskWriter::OverflowPolicy::DropOldest}) {
+    Gate gate;
+    std::atomic_bool started{false};
+    std::mutex mutex;
+    std::set<std::string> written;
+    {
+      AsyncDiskWriter writer(1u, 2u, policy);
+      auto write = [&](const Buffer &, const std::string &path) {
+        started = true;
+        gate.Wait();
+        std::lock_guard<std::mutex> lock(mutex);
+        written.insert(path);
+      };
+      // The first write blocks the only worker.
+      ASSERT_TRUE(writer.Write(Buffer(), "0", write));
+      while (!started) {
+        std::this_thread::yield();
+      }
+      ASSERT_TRUE(writer.Write(Buffer(), "1", write));
+      ASSERT_TRUE(writer.Write(Buffer(), "2", write));
+      // Queue full.
+      const bool queued = writer.Write(Buffer(), "3", write);
+      ASSERT_EQ(queued, policy == AsyncDiskWriter::OverflowPolicy::DropOldest);
+      ASSERT_EQ(writer.GetStats().dropped, 1u);
+      gate.Open();
+      writer.Flush();
+      ASSERT_EQ(writer.GetStats().written, 3u);
+    }
+    if (policy == AsyncDiskWriter::OverflowPolicy::DropNewest) {
+      ASSERT_EQ(written, (std::set<std::string>{"0", "1", "2"}));
+    } else {
+      ASSERT_EQ(written, (std::set<std::string>{"0", "2", "3"}));
+    }
+  }
+}
+
+TEST(async_disk_writer, flush_and_destroy) {
+  std::atomic_size_t count{0u};
+  auto write = [&](const Buffer &, const std::string &) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ++count;
+  };
+  {
+    AsyncDiskWriter writer(2u, 4u);
+    for (auto i = 0u; i < 20u; ++i) {
+      writer.Write(Buffer(), "", write);
+    }
+    writer.Flush();
+    ASSERT_EQ(count, 20u);
+    for (auto i = 0u; i < 10u; ++i) {
+      writer.Write(Buffer(), "", write);
+    }
+  }
+  // Pending writes are finished on destruction.
+  ASSERT_EQ(count, 30u);
+}
+
+TEST(async_disk_writer, failures) {
+  AsyncDiskWriter writer;
+  writer.Write(Buffer(), "failing", [](const Buffer &, const std::string &) {
+    throw std::runtime_error("disk full");
+  });
+  writer.Flush();
+  const auto stats = writer.GetStats();
+  ASSERT_EQ(stats.failed, 1u);
+  ASSERT_EQ(stats.written, 0u);
+}
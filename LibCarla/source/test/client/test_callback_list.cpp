@@ -0,0 +1,239 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/client/detail/CallbackList.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace carla::client;
+using carla::client::detail::CallbackList;
+
+template <typename PredicateT>
+static bool WaitUntil(PredicateT &&predicate) {
+  for (auto i = 0u; i < 500u; ++i) {
+    if (predicate()) {
+      return true;
+    }
+    std::this_thread::sleep_for(10ms);
+  }
+  return false;
+}
+
+TEST(callback_list, inline_by_default) {
+  CallbackList<int> list;
+  const auto caller = std::this_thread::get_id();
+  std::thread::id callee;
+  int received = 0;
+  auto id = list.Push([&](int value) {
+    callee = std::this_thread::get_id();
+    received = value;
+  });
+  list.Call(42);
+  ASSERT_EQ(received, 42);
+  ASSERT_EQ(callee, caller);
+  auto stats = list.GetStats(id);
+  ASSERT_TRUE(stats.has_value());
+  ASSERT_EQ(stats->calls, 1u);
+  ASSERT_EQ(stats->dropped, 0u);
+  list.Remove(id);
+  ASSERT_FALSE(list.GetStats(id).has_value());
+}
+
+TEST(callback_list, dedicated_thread_does_not_block_caller) {
+  CallbackList<int> list;
+  std::atomic_bool release{false};
+  std::atomic_int last{0};
+  CallbackPolicy policy;
+  policy.executor = CallbackExecutor::DedicatedThread;
+  policy.queue_size = 1u;
+  policy.overflow = CallbackOverflowPolicy::DropOldest;
+  auto id = list.Push([&](int value) {
+    while (!release) {
+      std::this_thread::sleep_for(1ms);
+    }
+    last = value;
+  }, policy);
+  list.Call(1);
+  ASSERT_TRUE(WaitUntil([&]() { return list.GetStats(id)->pending == 0u; }));
+  // The callback is blocked, only the latest value has to be kept.
+  for (auto i = 2; i <= 10; ++i) {
+    list.Call(i);
+  }
+  release = true;
+  ASSERT_TRUE(WaitUntil([&]() { return last == 10; }));
+  auto stats = list.GetStats(id);
+  ASSERT_TRUE(stats.has_value());
+  ASSERT_EQ(stats->calls, 2u);
+  ASSERT_EQ(stats->dropped, 8u);
+  ASSERT_GT(stats->max_latency, 0.0f);
+}
+
+TEST(callback_list, drop_newest) {
+  CallbackList<int> list;
+  std::atomic_bool release{false};
+  std::mutex mutex;
+  std::vector<int> values;
+  CallbackPolicy policy;
+  policy.executor = CallbackExecutor::DedicatedThread;
+  policy.queue_size = 3u;
+  policy.overflow = CallbackOverflowPolicy::DropNewest;
+  auto id = list.Push([&](int value) {
+    while (!release) {
+      std::this_thread::sleep_for(1ms);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    values.push_back(value);
+  }, policy);
+  list.Call(0);
+  ASSERT_TRUE(WaitUntil([&]() { return list.GetStats(id)->pending == 0u; }));
+  for (auto i = 1; i < 10; ++i) {
+    list.Call(i);
+  }
+  release = true;
+  ASSERT_TRUE(WaitUntil([&]() { return list.GetStats(id)->calls == 4u; }));
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(values, (std::vector<int>{0, 1, 2, 3}));
+  ASSERT_EQ(list.GetStats(id)->dropped, 6u);
+}
+
+TEST(callback_list, shared_pool_keeps_order) {
+  constexpr int number_of_callbacks = 8;
+  constexpr int number_of_calls = 100;
+  CallbackList<int> list;
+  std::vector<std::vector<int>> results(number_of_callbacks);
+  std::vector<size_t> ids;
+  CallbackPolicy policy;
+  policy.executor = CallbackExecutor::SharedPool;
+  policy.queue_size = number_of_calls;
+  for (auto i = 0; i < number_of_callbacks; ++i) {
+    auto &result = results[static_cast<size_t>(i)];
+    ids.push_back(list.Push([&result](int value) { result.push_back(value); }, policy));
+  }
+  for (auto i = 0; i < number_of_calls; ++i) {
+    list.Call(i);
+  }
+  for (auto id : ids) {
+    ASSERT_TRUE(WaitUntil([&]() {
+      return list.GetStats(id)->calls == static_cast<uint64_t>(number_of_calls);
+    }));
+    ASSERT_EQ(list.GetStats(id)->dropped, 0u);
+  }
+  for (auto &result : results) {
+    ASSERT_EQ(result.size(), static_cast<size_t>(number_of_calls));
+    for (auto i = 0; i < number_of_calls; ++i) {
+      ASSERT_EQ(result[static_cast<size_t>(i)], i);
+    }
+  }
+}
+
+TEST(callback_list, remove_from_within_callback) {
+  CallbackList<int> list;
+  std::atomic_bool removed{false};
+  CallbackPolicy policy;
+  policy.executor = CallbackExecutor::DedicatedThread;
+  std::atomic_size_t id{0u};
+  id = list.Push([&](int) {
+    list.Remove(id);
+    removed = true;
+  }, policy);
+  list.Call(0);
+  ASSERT_TRUE(WaitUntil([&]() { return removed.load(); }));
+  ASSERT_FALSE(list.GetStats(id).has_value());
+}
+
+TEST(callback_list, remove_does_not_wait_for_callback) {
+  std::atomic_bool started{false};
+  std::atomic_bool release{false};
+  std::atomic_bool finished{false};
+  CallbackPolicy policy;
+  policy.executor = CallbackExecutor::DedicatedThread;
+  CallbackList<int> list;
+  auto id = list.Push([&](int) {
+    started = true;
+    while (!release) {
+      std::this_thread::sleep_for(1ms);
+    }
+    finished = true;
+  }, policy);
+  list.Call(0);
+  ASSERT_TRUE(WaitUntil([&]() { return started.load(); }));
+  // The callback is still running, e.g. waiting for a lock held by the
+  // caller; removing it does not block.
+  list.Remove(id);
+  ASSERT_FALSE(list.GetStats(id).has_value());
+  list.Call(1);
+  ASSERT_FALSE(finished);
+  release = true;
+  ASSERT_TRUE(WaitUntil([&]() { return finished.load(); }));
+}
+
+TEST(callback_list, destroy_waits_for_blocked_callbacks) {
+  for (auto executor : {CallbackExecutor::SharedPool, CallbackExecutor::DedicatedThread}) {
+    std::atomic_bool started{false};
+    std::atomic_bool release{false};
+    std::atomic_int calls{0};
+    CallbackPolicy policy;
+    policy.executor = executor;
+    policy.queue_size = 10u;
+    std::thread releaser;
+    {
+      CallbackList<int> list;
+      list.Push([&](int) {
+        started = true;
+        while (!release) {
+          std::this_thread::sleep_for(1ms);
+        }
+        ++calls;
+      }, policy);
+      for (auto i = 0; i < 5; ++i) {
+        list.Call(i);
+      }
+      ASSERT_TRUE(WaitUntil([&]() { return started.load(); }));
+      // The callback is blocked until after the destruction started, like a
+      // Python callback waiting for the GIL held by the destroying thread.
+      releaser = std::thread([&]() {
+        std::this_thread::sleep_for(50ms);
+        release = true;
+      });
+    }
+    // The call in progress completed, the pending ones were discarded and
+    // no thread is left running.
+    ASSERT_EQ(calls, 1);
+    releaser.join();
+    std::this_thread::sleep_for(20ms);
+    ASSERT_EQ(calls, 1);
+  }
+}
+
+TEST(callback_list, destroyed_from_within_callback) {
+  for (auto executor : {CallbackExecutor::SharedPool, CallbackExecutor::DedicatedThread}) {
+    std::atomic_bool released{false};
+    std::atomic_bool destroyed{false};
+    CallbackPolicy policy;
+    policy.executor = executor;
+    auto owner = std::make_shared<CallbackList<int>>();
+    owner->Push([&](int) {
+      while (!released) {
+        std::this_thread::sleep_for(1ms);
+      }
+      // Drop the last reference from the callback's own thread.
+      owner.reset();
+      destroyed = true;
+    }, policy);
+    {
+      auto list = owner;
+      list->Call(0);
+    }
+    released = true;
+    ASSERT_TRUE(WaitUntil([&]() { return destroyed.load(); }));
+  }
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+#include "Random.h"
+
+#include <carla/StopWatch.h>
+#include <carla/opendrive/OpenDriveParser.h>
+#include <carla/road/CompiledMap.h>
+#include <carla/road/Map.h>
+
+#include <boost/filesystem/operations.hpp>
+#include <pugixml/pugixml.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace carla;
+using namespace carla::road;
+using carla::opendrive::OpenDriveParser;
+using util::Random;
+
+static void CompareTransforms(const geom::Transform &lhs, const geom::Transform &rhs) {
+  ASSERT_EQ(lhs.location, rhs.location);
+  ASSERT_EQ(lhs.rotation.pitch, rhs.rotation.pitch);
+  ASSERT_EQ(lhs.rotation.yaw, rhs.rotation.yaw);
+  ASSERT_EQ(lhs.rotation.roll, rhs.rotation.roll);
+}
+
+static void CompareMaps(const Map &expected, const Map &map) {
+  // Same containers in the same order.
+  ASSERT_EQ(CompiledMap::Serialize(expected), CompiledMap::Serialize(map));
+
+  const auto expected_waypoints = expected.GenerateWaypoints(2.0);
+  const auto waypoints = map.GenerateWaypoints(2.0);
+  ASSERT_EQ(waypoints, expected_waypoints);
+  for (auto &waypoint : waypoints) {
+    CompareTransforms(map.ComputeTransform(waypoint), expected.ComputeTransform(waypoint));
+    ASSERT_EQ(map.GetNext(waypoint, 5.0), expected.GetNext(waypoint, 5.0));
+    ASSERT_EQ(map.GetLaneWidth(waypoint), expected.GetLaneWidth(waypoint));
+  }
+
+  ASSERT_EQ(map.GenerateTopology(), expected.GenerateTopology());
+
+  for (auto i = 0u; i < 1000u; ++i) {
+    const auto location = Random::Location(-500.0f, 500.0f);
+    const auto waypoint = map.GetClosestWaypointOnRoad(location);
+    const auto expected_waypoint = expected.GetClosestWaypointOnRoad(location);
+    ASSERT_TRUE(waypoint.has_value());
+    ASSERT_TRUE(expected_waypoint.has_value());
+    ASSERT_EQ(*waypoint, *expected_waypoint);
+  }
+}
+
+TEST(compiled_map, same_results_as_parsed_map) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    const auto xodr = util::OpenDrive::Load(file);
+    StopWatch stop_watch;
+    auto expected = OpenDriveParser::Load(xodr);
+    const auto parse_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    ASSERT_TRUE(expected.has_value());
+
+    const auto data = CompiledMap::Serialize(*expected, file);
+    stop_watch.Restart();
+    const CompiledMap compiled(data.data(), data.size());
+    auto map = compiled.Load();
+    const auto load_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    ASSERT_EQ(compiled.GetMetadata(), file);
+
+    CompareMaps(*expected, map);
+    carla::logging::log(file, "parsed in", parse_time, "us, loaded in", load_time, "us");
+  }
+}
+
+TEST(compiled_map, road_order) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    const auto xodr = util::OpenDrive::Load(file);
+    pugi::xml_document document;
+    ASSERT_TRUE(document.load_string(xodr.c_str()));
+    std::vector<RoadId> expected;
+    for (auto road : document.child("OpenDRIVE").children("road")) {
+      expected.emplace_back(road.attribute("id").as_uint());
+    }
+    auto map = OpenDriveParser::Load(xodr);
+    ASSERT_TRUE(map.has_value());
+    ASSERT_EQ(map->GetRoadIds(), expected);
+    const auto data = CompiledMap::Serialize(*map);
+    ASSERT_EQ(CompiledMap(data.data(), data.size()).Load().GetRoadIds(), expected);
+  }
+}
+
+TEST(compiled_map, write) {
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  ASSERT_FALSE(files.empty());
+  auto expected = OpenDriveParser::Load(util::OpenDrive::Load(files[0u]));
+  ASSERT_TRUE(expected.has_value());
+  const auto path = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("%%%%-%%%%-%%%%.carlamap")).string();
+  CompiledMap::Write(*expected, path, "metadata");
+  std::ifstream file(path, std::ios::binary);
+  const std::vector<unsigned char> data{
+      std::istreambuf_iterator<char>(file),
+      std::istreambuf_iterator<char>()};
+  file.close();
+  boost::filesystem::remove(path);
+  ASSERT_EQ(data, CompiledMap::Serialize(*expected, "metadata"));
+  const CompiledMap compiled(data.data(), data.size());
+  ASSERT_EQ(compiled.GetMetadata(), "metadata");
+  CompareMaps(*expected, compiled.Load());
+}
+
+TEST(compiled_map, invalid_data) {
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  ASSERT_FALSE(files.empty());
+  auto map = OpenDriveParser::Load(util::OpenDrive::Load(files[0u]));
+  ASSERT_TRUE(map.has_value());
+  const auto data = CompiledMap::Serialize(*map);
+  ASSERT_THROW(CompiledMap(data.data(), 16u), std::runtime_error);
+  auto bad_magic = data;
+  bad_magic[0u] = 'X';
+  ASSERT_THROW(CompiledMap(bad_magic.data(), bad_magic.size()), std::runtime_error);
+  // Truncated arrays.
+  ASSERT_THROW(CompiledMap(data.data(), data.size() / 2u), std::runtime_error);
+}
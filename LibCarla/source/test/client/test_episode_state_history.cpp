@@ -0,0 +1,202 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/client/detail/EpisodeStateHistory.h>
+
+#include <memory>
+#include <vector>
+
+using namespace carla;
+using namespace carla::client;
+using carla::client::detail::EpisodeState;
+using carla::client::detail::EpisodeStateHistory;
+
+/// Seconds between consecutive frames.
+static constexpr double DELTA_SECONDS = 0.1;
+
+static ActorSnapshot MakeActor(ActorId id, float x, float yaw) {
+  ActorSnapshot actor;
+  actor.id = id;
+  actor.transform.location = geom::Location{x, 2.0f * x, 0.0f};
+  actor.transform.rotation = geom::Rotation{0.0f, yaw, 0.0f};
+  actor.velocity = geom::Vector3D{x, 0.0f, 0.0f};
+  return actor;
+}
+
+/// State at @a frame where actor 1 is at x = frame with yaw = 10 * frame,
+/// and actor 2 too if @a with_second_actor.
+static EpisodeStateHistory::StatePtr MakeState(size_t frame, bool with_second_actor = true) {
+  const auto x = static_cast<float>(frame);
+  std::vector<ActorSnapshot> actors{MakeActor(1u, x, 10.0f * x)};
+  if (with_second_actor) {
+    actors.emplace_back(MakeActor(2u, -x, 0.0f));
+  }
+  const Timestamp timestamp{frame, DELTA_SECONDS * static_cast<double>(frame), DELTA_SECONDS, 0.0};
+  return std::make_shared<const EpisodeState>(1u, timestamp, actors);
+}
+
+static double Seconds(size_t frame) {
+  return DELTA_SECONDS * static_cast<double>(frame);
+}
+
+/// Check that the history holds exactly the frames in [@a first, @a last].
+static void CheckFrames(const EpisodeStateHistory &history, size_t first, size_t last) {
+  ASSERT_EQ(history.size(), last - first + 1u);
+  for (auto frame = first > 2u ? first - 2u : 0u; frame <= last + 2u; ++frame) {
+    const auto state = history.FindByFrame(frame);
+    if ((frame < first) || (frame > last)) {
+      ASSERT_EQ(state, nullptr) << "frame " << frame;
+    } else {
+      ASSERT_NE(state, nullptr) << "frame " << frame;
+      ASSERT_EQ(state->GetFrame(), frame);
+    }
+  }
+}
+
+TEST(episode_state_history, disabled_by_default) {
+  EpisodeStateHistory history;
+  ASSERT_EQ(history.GetCapacity(), 0u);
+  history.Push(MakeState(1u));
+  ASSERT_EQ(history.size(), 0u);
+  ASSERT_EQ(history.FindByFrame(1u), nullptr);
+  ASSERT_FALSE(history.GetActorSnapshotAt(1u, Seconds(1u)).has_value());
+}
+
+TEST(episode_state_history, capacity) {
+  EpisodeStateHistory history{3u};
+  for (auto frame = 1u; frame <= 10u; ++frame) {
+    history.Push(MakeState(frame));
+    CheckFrames(history, frame > 3u ? frame - 2u : 1u, frame);
+  }
+
+  // Shrinking keeps the most recent states.
+  history.SetCapacity(2u);
+  ASSERT_EQ(history.GetCapacity(), 2u);
+  CheckFrames(history, 9u, 10u);
+  history.Push(MakeState(11u));
+  CheckFrames(history, 10u, 11u);
+
+  // Growing keeps every state.
+  history.SetCapacity(5u);
+  ASSERT_EQ(history.GetCapacity(), 5u);
+  CheckFrames(history, 10u, 11u);
+  for (auto frame = 12u; frame <= 16u; ++frame) {
+    history.Push(MakeState(frame));
+  }
+  CheckFrames(history, 12u, 16u);
+
+  history.SetCapacity(0u);
+  ASSERT_EQ(history.size(), 0u);
+  history.Push(MakeState(17u));
+  ASSERT_EQ(history.size(), 0u);
+
+  history.SetCapacity(3u);
+  history.Push(MakeState(18u));
+  history.Clear();
+  ASSERT_EQ(history.size(), 0u);
+  ASSERT_EQ(history.FindByFrame(18u), nullptr);
+  ASSERT_EQ(history.GetCapacity(), 3u);
+}
+
+TEST(episode_state_history, out_of_order_push) {
+  EpisodeStateHistory history{4u};
+  for (auto frame : {2u, 3u, 5u, 6u}) {
+    history.Push(MakeState(frame));
+  }
+  // A missing frame goes in its place, evicting the oldest.
+  history.Push(MakeState(4u));
+  CheckFrames(history, 3u, 6u);
+  // Older than every state in a full history, dropped.
+  history.Push(MakeState(1u));
+  CheckFrames(history, 3u, 6u);
+  // A frame already present is ignored.
+  const auto previous = history.FindByFrame(5u);
+  history.Push(MakeState(5u));
+  ASSERT_EQ(history.FindByFrame(5u), previous);
+  CheckFrames(history, 3u, 6u);
+  // The order is kept across the ring wrapping around.
+  history.Push(MakeState(8u));
+  history.Push(MakeState(7u));
+  CheckFrames(history, 5u, 8u);
+  const auto states = history.FindByElapsedSeconds(0.5 * (Seconds(6u) + Seconds(7u)));
+  ASSERT_NE(states.first, nullptr);
+  ASSERT_EQ(states.first->GetFrame(), 6u);
+  ASSERT_EQ(states.second->GetFrame(), 7u);
+}
+
+TEST(episode_state_history, find_by_elapsed_seconds) {
+  EpisodeStateHistory history{4u};
+  for (auto frame = 1u; frame <= 6u; ++frame) {
+    history.Push(MakeState(frame));
+  }
+  // Frames 3 to 6 are kept.
+  auto check = [&](double seconds, size_t lower, size_t upper) {
+    const auto states = history.FindByElapsedSeconds(seconds);
+    ASSERT_NE(states.first, nullptr) << seconds;
+    ASSERT_NE(states.second, nullptr) << seconds;
+    ASSERT_EQ(states.first->GetFrame(), lower) << seconds;
+    ASSERT_EQ(states.second->GetFrame(), upper) << seconds;
+  };
+  auto check_none = [&](double seconds) {
+    const auto states = history.FindByElapsedSeconds(seconds);
+    ASSERT_EQ(states.first, nullptr) << seconds;
+    ASSERT_EQ(states.second, nullptr) << seconds;
+  };
+  check(Seconds(3u), 3u, 3u);
+  check(Seconds(6u), 6u, 6u);
+  check(Seconds(4u), 4u, 4u);
+  check(0.5 * (Seconds(3u) + Seconds(4u)), 3u, 4u);
+  check(0.5 * (Seconds(5u) + Seconds(6u)), 5u, 6u);
+  check_none(Seconds(2u));
+  check_none(Seconds(3u) - 1e-3);
+  check_none(Seconds(6u) + 1e-3);
+  check_none(Seconds(20u));
+}
+
+TEST(episode_state_history, interpolated_actor_snapshot) {
+  EpisodeStateHistory history{8u};
+  history.Push(MakeState(1u));
+  history.Push(MakeState(2u));
+  history.Push(MakeState(3u, false));
+  history.Push(MakeState(4u));
+
+  // Exact match, the snapshot as received.
+  auto snapshot = history.GetActorSnapshotAt(1u, Seconds(2u));
+  ASSERT_TRUE(snapshot.has_value());
+  ASSERT_EQ(snapshot->id, 1u);
+  ASSERT_EQ(snapshot->transform.location, (geom::Location{2.0f, 4.0f, 0.0f}));
+  ASSERT_EQ(snapshot->transform.rotation.yaw, 20.0f);
+
+  // A quarter of the way between frames 1 and 2.
+  snapshot = history.GetActorSnapshotAt(1u, Seconds(1u) + 0.25 * DELTA_SECONDS);
+  ASSERT_TRUE(snapshot.has_value());
+  ASSERT_EQ(snapshot->id, 1u);
+  ASSERT_NEAR(snapshot->transform.location.x, 1.25f, 1e-4f);
+  ASSERT_NEAR(snapshot->transform.location.y, 2.5f, 1e-4f);
+  ASSERT_NEAR(snapshot->transform.location.z, 0.0f, 1e-4f);
+  ASSERT_NEAR(snapshot->transform.rotation.yaw, 12.5f, 1e-3f);
+  ASSERT_NEAR(snapshot->transform.rotation.pitch, 0.0f, 1e-3f);
+  ASSERT_NEAR(snapshot->transform.rotation.roll, 0.0f, 1e-3f);
+  ASSERT_NEAR(snapshot->velocity.x, 1.25f, 1e-4f);
+
+  snapshot = history.GetActorSnapshotAt(2u, Seconds(1u) + 0.5 * DELTA_SECONDS);
+  ASSERT_TRUE(snapshot.has_value());
+  ASSERT_NEAR(snapshot->transform.location.x, -1.5f, 1e-4f);
+
+  // Actor 2 is missing at frame 3, so in both intervals around it.
+  ASSERT_TRUE(history.GetActorSnapshotAt(2u, Seconds(2u)).has_value());
+  ASSERT_FALSE(history.GetActorSnapshotAt(2u, Seconds(3u)).has_value());
+  ASSERT_FALSE(history.GetActorSnapshotAt(2u, Seconds(2u) + 0.5 * DELTA_SECONDS).has_value());
+  ASSERT_FALSE(history.GetActorSnapshotAt(2u, Seconds(3u) + 0.5 * DELTA_SECONDS).has_value());
+  ASSERT_TRUE(history.GetActorSnapshotAt(1u, Seconds(3u) + 0.5 * DELTA_SECONDS).has_value());
+
+  // Unknown actor, or out of the history.
+  ASSERT_FALSE(history.GetActorSnapshotAt(3u, Seconds(2u)).has_value());
+  ASSERT_FALSE(history.GetActorSnapshotAt(1u, Seconds(0u)).has_value());
+  ASSERT_FALSE(history.GetActorSnapshotAt(1u, Seconds(5u)).has_value());
+}
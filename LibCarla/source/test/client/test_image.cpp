@@ -6,11 +6,17 @@
 
 #include "test.h"
 
+#include <carla/StopWatch.h>
+#include <carla/image/ColorConverterKernels.h>
 #include <carla/image/ImageConverter.h>
 #include <carla/image/ImageIO.h>
 #include <carla/image/ImageView.h>
+#include <carla/image/ParallelImageConverter.h>
 
+#include <atomic>
 #include <memory>
+#include <stdexcept>
+#include <vector>
 
 template <typename ViewT, typename PixelT>
 struct TestImage {
@@ -186,3 +192,189 @@ TEST(image, semantic_segmentation) {
     }
   }
 }
+
+template <typename TestImageT>
+static auto *AsColors(TestImageT &image) {
+  return reinterpret_cast<carla::sensor::data::Color *>(image.data.get());
+}
+
+/// Compare the kernels with every instruction set available against the
+/// boost::gil path, @a fill sets the pixel i of the source image.
+template <typename CC, typename KernelT, typename FillT>
+static void CompareKernels(size_t width, KernelT kernel, FillT fill) {
+  using namespace boost::gil;
+  using namespace carla::image;
+  using InstructionSet = ColorConverterKernels::InstructionSet;
+
+  auto source = MakeTestImage<bgra8_pixel_t>(width, 1u);
+  for (auto i = 0u; i < width; ++i) {
+    fill(i, source.view(static_cast<long>(i), 0));
+  }
+  auto expected = MakeTestImage<bgra8_pixel_t>(width, 1u);
+  ImageConverter::CopyPixels(source.view, expected.view);
+  ImageConverter::ConvertInPlace(expected.view, CC());
+
+  for (auto instruction_set : {InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2}) {
+    if (instruction_set > ColorConverterKernels::GetSupportedInstructionSet()) {
+      continue;
+    }
+    auto result = MakeTestImage<bgra8_pixel_t>(width, 1u);
+    kernel(AsColors(source), AsColors(result), width, instruction_set);
+    // Also in place, with an odd offset to exercise the unaligned tail.
+    auto in_place = MakeTestImage<bgra8_pixel_t>(width, 1u);
+    ImageConverter::CopyPixels(source.view, in_place.view);
+    kernel(AsColors(in_place) + 1, AsColors(in_place) + 1, width - 1u, instruction_set);
+    kernel(AsColors(in_place), AsColors(in_place), 1u, instruction_set);
+    for (auto i = 0u; i < width; ++i) {
+      const auto x = static_cast<long>(i);
+      ASSERT_EQ(result.view(x, 0), expected.view(x, 0))
+          << ColorConverterKernels::ToString(instruction_set) << " at XY(" << i << ",0)";
+      ASSERT_EQ(in_place.view(x, 0), expected.view(x, 0))
+          << ColorConverterKernels::ToString(instruction_set) << " at XY(" << i << ",0)";
+    }
+  }
+}
+
+static void FillDepth(size_t depth, boost::gil::bgra8_pixel_t &pixel) {
+  using namespace boost::gil;
+  get_color(pixel, red_t()) = static_cast<uint8_t>(depth & 0xFFu);
+  get_color(pixel, green_t()) = static_cast<uint8_t>((depth >> 8u) & 0xFFu);
+  get_color(pixel, blue_t()) = static_cast<uint8_t>((depth >> 16u) & 0xFFu);
+  get_color(pixel, alpha_t()) = static_cast<uint8_t>(depth * 7u);
+}
+
+TEST(image, color_converter_kernels) {
+  using namespace carla::image;
+  carla::logging::log(
+      "color converter kernels:",
+      ColorConverterKernels::ToString(ColorConverterKernels::GetSupportedInstructionSet()));
+#ifdef NDEBUG
+  constexpr size_t stride = 1u; // every depth value.
+#else
+  constexpr size_t stride = 97u;
+#endif // NDEBUG
+  constexpr size_t width = 256u * 256u * 256u / stride + 3u;
+  auto fill_depth = [=](size_t i, auto &pixel) {
+    FillDepth(std::min<size_t>(i * stride, 256u * 256u * 256u - 1u), pixel);
+  };
+  CompareKernels<ColorConverter::Depth>(width, [](auto... args) {
+    ColorConverterKernels::Depth(args...);
+  }, fill_depth);
+  CompareKernels<ColorConverter::LogarithmicDepth>(width, [](auto... args) {
+    ColorConverterKernels::LogarithmicDepth(args...);
+  }, fill_depth);
+  CompareKernels<ColorConverter::CityScapesPalette>(256u * 4u + 5u, [](auto... args) {
+    ColorConverterKernels::CityScapesPalette(args...);
+  }, [](size_t i, auto &pixel) {
+    FillDepth(i * 13u + i / 256u, pixel);
+  });
+}
+
+TEST(image, color_converter_kernels_benchmark) {
+  using namespace boost::gil;
+  using namespace carla::image;
+  using InstructionSet = ColorConverterKernels::InstructionSet;
+  constexpr size_t width = 1920u;
+  constexpr size_t height = 1080u;
+  constexpr size_t repetitions = 10u;
+
+  auto source = MakeTestImage<bgra8_pixel_t>(width, height);
+  auto *pixels = AsColors(source);
+  for (auto i = 0u; i < width * height; ++i) {
+    pixels[i] = carla::sensor::data::Color{
+        static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8u), static_cast<uint8_t>(i >> 16u)};
+  }
+  auto image = MakeTestImage<bgra8_pixel_t>(width, height);
+
+  auto measure = [&](auto convert) {
+    carla::StopWatch stop_watch;
+    for (auto i = 0u; i < repetitions; ++i) {
+      ImageConverter::CopyPixels(source.view, image.view);
+      convert();
+    }
+    stop_watch.Stop();
+    return stop_watch.GetElapsedTime<std::chrono::microseconds>() / repetitions;
+  };
+
+  auto benchmark = [&](const char *name, auto cc, auto kernel) {
+    auto gil = measure([&]() { ImageConverter::ConvertInPlace(image.view, cc); });
+    for (auto instruction_set : {InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2}) {
+      if (instruction_set > ColorConverterKernels::GetSupportedInstructionSet()) {
+        continue;
+      }
+      auto time = measure([&]() {
+        kernel(AsColors(image), AsColors(image), width * height, instruction_set);
+      });
+      carla::logging::log(
+          name, "1920x1080: boost::gil", gil, "us,",
+          ColorConverterKernels::ToString(instruction_set), time, "us");
+    }
+  };
+
+  benchmark("Depth", ColorConverter::Depth(), [](auto... args) {
+    ColorConverterKernels::Depth(args...);
+  });
+  benchmark("LogarithmicDepth", ColorConverter::LogarithmicDepth(), [](auto... args) {
+    ColorConverterKernels::LogarithmicDepth(args...);
+  });
+  benchmark("CityScapesPalette", ColorConverter::CityScapesPalette(), [](auto... args) {
+    ColorConverterKernels::CityScapesPalette(args...);
+  });
+}
+
+TEST(image, parallel_tiles) {
+  using namespace carla::image;
+  ParallelImageConverter converter(3u);
+  ASSERT_EQ(converter.GetWorkerThreads(), 3u);
+  for (auto rows : {0u, 1u, 15u, 64u, 1000u, 1081u}) {
+    std::vector<std::atomic_int> visits(rows);
+    converter.ForEachTile(rows, [&](size_t begin, size_t end) {
+      ASSERT_LE(begin, end);
+      for (auto i = begin; i < end; ++i) {
+        ++visits[i];
+      }
+    });
+    for (auto &count : visits) {
+      ASSERT_EQ(count, 1);
+    }
+  }
+  ASSERT_THROW(converter.ForEachTile(1000u, [](size_t begin, size_t) {
+    if (begin > 0u) {
+      throw std::runtime_error("tile failed");
+    }
+  }), std::runtime_error);
+}
+
+TEST(image, parallel_conversion) {
+  using namespace boost::gil;
+  using namespace carla::image;
+  constexpr size_t width = 1920u;
+  constexpr size_t height = 1080u;
+
+  auto source = MakeTestImage<bgra8_pixel_t>(width, height);
+  auto *pixels = AsColors(source);
+  for (auto i = 0u; i < width * height; ++i) {
+    pixels[i] = carla::sensor::data::Color{
+        static_cast<uint8_t>(i * 7u), static_cast<uint8_t>(i >> 5u), static_cast<uint8_t>(i >> 13u)};
+  }
+  auto converted_view = ImageView::MakeColorConvertedView(source.view, ColorConverter::LogarithmicDepth());
+  using PixelT = decltype(converted_view)::value_type;
+
+  carla::StopWatch serial_time;
+  auto serial = MakeTestImage<PixelT>(width, height);
+  ImageConverter::CopyPixels(converted_view, serial.view);
+  serial_time.Stop();
+
+  ParallelImageConverter converter;
+  carla::StopWatch parallel_time;
+  auto parallel = MakeTestImage<PixelT>(width, height);
+  converter.CopyPixels(converted_view, parallel.view);
+  parallel_time.Stop();
+
+  ASSERT_TRUE(equal_pixels(serial.view, parallel.view));
+  carla::logging::log(
+      "LogarithmicDepth view 1920x1080: serial",
+      serial_time.GetElapsedTime<std::chrono::microseconds>(), "us,",
+      converter.GetWorkerThreads(), "workers",
+      parallel_time.GetElapsedTime<std::chrono::microseconds>(), "us");
+}
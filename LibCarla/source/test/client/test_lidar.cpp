@@ -0,0 +1,167 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/StopWatch.h>
+#include <carla/sensor/CompositeSerializer.h>
+#include <carla/sensor/data/LidarMeasurement.h>
+#include <carla/sensor/s11n/LidarSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <vector>
+
+using namespace carla;
+using namespace carla::sensor;
+using s11n::LidarFlags;
+using util::Random;
+
+namespace {
+
+  class FakeLidar {};
+
+  using Registry = CompositeSerializer<std::pair<FakeLidar *, s11n::LidarSerializer>>;
+
+  struct Point {
+    uint32_t channel;
+    rpc::Location location;
+    float intensity;
+  };
+
+} // namespace
+
+static constexpr float RANGE = 5000.0f;
+
+static std::vector<Point> MakePoints(uint32_t channels, size_t points_per_channel) {
+  std::vector<Point> points;
+  for (auto channel = 0u; channel < channels; ++channel) {
+    for (auto i = 0u; i < points_per_channel; ++i) {
+      const auto location = Random::Location(-RANGE / 2.0f, RANGE / 2.0f);
+      points.push_back({channel, location, static_cast<float>(Random::Uniform(0.0, 1.0))});
+    }
+  }
+  return points;
+}
+
+static Buffer Serialize(uint32_t channels, uint32_t flags, const std::vector<Point> &points) {
+  s11n::LidarMeasurement measurement(channels);
+  measurement.SetLayout(flags, RANGE);
+  measurement.Reset(static_cast<uint32_t>(points.size()));
+  for (auto &point : points) {
+    measurement.WritePoint(point.channel, point.location, point.intensity);
+  }
+  measurement.SetHorizontalAngle(1.5f);
+  FakeLidar sensor;
+  auto payload = Registry::Serialize(sensor, measurement, Buffer());
+  auto message = s11n::SensorHeaderSerializer::Serialize(0u, 42u, 1.0, rpc::Transform{});
+  const auto header_size = message.size();
+  std::vector<unsigned char> bytes(message.begin(), message.end());
+  bytes.insert(bytes.end(), payload.begin(), payload.end());
+  message.copy_from(bytes);
+  EXPECT_EQ(message.size(), header_size + payload.size());
+  return message;
+}
+
+static SharedPtr<data::LidarMeasurement> Deserialize(Buffer &&message) {
+  auto data = Registry::Deserialize(std::move(message));
+  return boost::static_pointer_cast<data::LidarMeasurement>(data);
+}
+
+TEST(lidar, layouts) {
+  constexpr uint32_t channels = 4u;
+  const auto points = MakePoints(channels, 101u);
+  for (uint32_t flags = 0u; flags < 8u; ++flags) {
+    auto measurement = Deserialize(Serialize(channels, flags, points));
+    ASSERT_EQ(measurement->GetFrame(), 42u);
+    ASSERT_EQ(measurement->GetHorizontalAngle(), 1.5f);
+    ASSERT_EQ(measurement->GetChannelCount(), channels);
+    ASSERT_EQ(measurement->size(), points.size());
+    ASSERT_EQ(measurement->HasIntensity(), (flags & LidarFlags::Intensity) != 0u);
+    ASSERT_EQ(measurement->HasRing(), (flags & LidarFlags::Ring) != 0u);
+    const auto intensity = measurement->GetIntensity();
+    const auto ring = measurement->GetRing();
+    ASSERT_EQ(intensity.size(), measurement->HasIntensity() ? points.size() : 0u);
+    ASSERT_EQ(ring.size(), measurement->HasRing() ? points.size() : 0u);
+    const bool compact = (flags & LidarFlags::CompactPoints) != 0u;
+    const float tolerance = compact ? RANGE / 32767.0f : 0.0f;
+    for (auto i = 0u; i < points.size(); ++i) {
+      const auto &expected = points[i];
+      const auto &point = (*measurement)[i];
+      ASSERT_NEAR(point.x, expected.location.x, tolerance);
+      ASSERT_NEAR(point.y, expected.location.y, tolerance);
+      ASSERT_NEAR(point.z, expected.location.z, tolerance);
+      if (measurement->HasIntensity()) {
+        ASSERT_NEAR(*(intensity.begin() + i), expected.intensity, compact ? 1.0f / 65535.0f : 0.0f);
+      }
+      if (measurement->HasRing()) {
+        ASSERT_EQ(*(ring.begin() + i), expected.channel);
+      }
+    }
+  }
+}
+
+TEST(lidar, payload_size) {
+  constexpr uint32_t channels = 64u;
+  const auto points = MakePoints(channels, 2000u);
+  const std::vector<std::pair<const char *, uint32_t>> layouts = {
+      {"points", 0u},
+      {"points + intensity", LidarFlags::Intensity},
+      {"points + intensity + ring", LidarFlags::Intensity | LidarFlags::Ring},
+      {"compact points", LidarFlags::CompactPoints},
+      {"compact points + intensity", LidarFlags::CompactPoints | LidarFlags::Intensity},
+      {"compact points + intensity + ring", LidarFlags::CompactPoints | LidarFlags::Intensity | LidarFlags::Ring}};
+  for (auto &layout : layouts) {
+    auto message = Serialize(channels, layout.second, points);
+    const auto size = message.size();
+    StopWatch stop_watch;
+    auto measurement = Deserialize(std::move(message));
+    stop_watch.Stop();
+    ASSERT_EQ(measurement->size(), points.size());
+    carla::logging::log(
+        layout.first, ':',
+        static_cast<double>(size) / static_cast<double>(points.size()), "bytes per point,",
+        "deserialized in", stop_watch.GetElapsedTime<std::chrono::microseconds>(), "us");
+  }
+}
+
+TEST(lidar, compact_points_resolution_in_meters) {
+  // As ARayCastLidar sets it up: the range of the description is in
+  // centimeters, and the hits are converted from centimeters to meters when
+  // written as rpc::Location.
+  constexpr float range_in_meters = 100.0f;
+  constexpr float range_in_centimeters = range_in_meters * 1e2f;
+  constexpr uint32_t channels = 2u;
+  s11n::LidarMeasurement measurement(channels);
+  measurement.SetLayoutFromCentimeters(LidarFlags::CompactPoints, range_in_centimeters);
+  std::vector<rpc::Location> expected;
+  for (auto i = 0u; i < 1000u; ++i) {
+    const auto hit_in_centimeters = Random::Location(-range_in_centimeters, range_in_centimeters);
+    expected.emplace_back(
+        1e-2f * hit_in_centimeters.x,
+        1e-2f * hit_in_centimeters.y,
+        1e-2f * hit_in_centimeters.z);
+  }
+  measurement.Reset(static_cast<uint32_t>(expected.size()));
+  for (auto &point : expected) {
+    measurement.WritePoint(0u, point);
+  }
+  FakeLidar sensor;
+  auto payload = Registry::Serialize(sensor, measurement, Buffer());
+  auto message = s11n::SensorHeaderSerializer::Serialize(0u, 42u, 1.0, rpc::Transform{});
+  std::vector<unsigned char> bytes(message.begin(), message.end());
+  bytes.insert(bytes.end(), payload.begin(), payload.end());
+  message.copy_from(bytes);
+  auto result = Deserialize(std::move(message));
+  ASSERT_EQ(result->size(), expected.size());
+  // Half a step of the documented resolution, range / 32767, in meters.
+  const float tolerance = 0.5f * range_in_meters / 32767.0f + 1e-5f;
+  for (auto i = 0u; i < expected.size(); ++i) {
+    ASSERT_NEAR((*result)[i].x, expected[i].x, tolerance);
+    ASSERT_NEAR((*result)[i].y, expected[i].y, tolerance);
+    ASSERT_NEAR((*result)[i].z, expected[i].z, tolerance);
+  }
+}
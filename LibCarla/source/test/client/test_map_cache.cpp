@@ -0,0 +1,98 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+
+#include <carla/StopWatch.h>
+#include <carla/client/Map.h>
+#include <carla/client/MapCache.h>
+#include <carla/rpc/MapInfo.h>
+
+#include <boost/filesystem/operations.hpp>
+
+using namespace carla;
+using namespace carla::client;
+
+TEST(map_cache, hash) {
+  const auto hash = rpc::MapInfo::Hash("Town01", "<OpenDRIVE/>", {});
+  ASSERT_EQ(hash, rpc::MapInfo::Hash("Town01", "<OpenDRIVE/>", {}));
+  ASSERT_NE(hash, rpc::MapInfo::Hash("Town02", "<OpenDRIVE/>", {}));
+  ASSERT_NE(hash, rpc::MapInfo::Hash("Town01", "<OpenDRIVE />", {}));
+  ASSERT_NE(rpc::MapInfo::Hash("ab", "c", {}), rpc::MapInfo::Hash("a", "bc", {}));
+  const rpc::MapInfo info{"Town01", "<OpenDRIVE/>", {}};
+  ASSERT_EQ(info.GetHash(), hash);
+}
+
+TEST(map_cache, hash_spawn_points) {
+  const geom::Transform a{geom::Location{1.0f, 2.0f, 3.0f}, geom::Rotation{0.0f, 90.0f, 0.0f}};
+  const geom::Transform b{geom::Location{1.0f, 2.0f, 3.0f}, geom::Rotation{0.0f, 180.0f, 0.0f}};
+  const rpc::MapInfo info{"Town01", "<OpenDRIVE/>", {a, b}};
+  const auto hash = info.GetHash();
+  ASSERT_EQ(hash, rpc::MapInfo::Hash("Town01", "<OpenDRIVE/>", {a, b}));
+  // The cached map serves the spawn points too, so they are part of the key.
+  ASSERT_NE(hash, rpc::MapInfo::Hash("Town01", "<OpenDRIVE/>", {}));
+  ASSERT_NE(hash, rpc::MapInfo::Hash("Town01", "<OpenDRIVE/>", {a}));
+  ASSERT_NE(hash, rpc::MapInfo::Hash("Town01", "<OpenDRIVE/>", {b, a}));
+  ASSERT_NE(hash, rpc::MapInfo::Hash("Town01", "<OpenDRIVE/>", {a, a}));
+}
+
+TEST(map_cache, weak_references) {
+  for (auto &file : util::OpenDrive::GetAvailableFiles()) {
+    const auto stats = MapCache::GetStats();
+    StopWatch stop_watch;
+    auto map = MakeShared<Map>(file, util::OpenDrive::Load(file));
+    const auto parse_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    const auto hash = map->GetHash();
+    ASSERT_EQ(MapCache::Find(hash), nullptr);
+    ASSERT_EQ(MapCache::Add(hash, map), map);
+    stop_watch.Restart();
+    ASSERT_EQ(MapCache::Find(hash), map);
+    const auto hit_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    // A map parsed concurrently with the same hash is discarded.
+    auto other = MakeShared<Map>(file, map->GetOpenDrive());
+    ASSERT_EQ(other->GetHash(), hash);
+    ASSERT_EQ(MapCache::Add(hash, other), map);
+    auto new_stats = MapCache::GetStats();
+    ASSERT_EQ(new_stats.hits, stats.hits + 1u);
+    ASSERT_EQ(new_stats.misses, stats.misses + 2u);
+    ASSERT_EQ(new_stats.size, stats.size + 1u);
+    // The cache does not keep maps alive.
+    WeakPtr<Map> weak = map;
+    map.reset();
+    other.reset();
+    ASSERT_TRUE(weak.expired());
+    ASSERT_EQ(MapCache::Find(hash), nullptr);
+    ASSERT_EQ(MapCache::GetStats().size, stats.size);
+    carla::logging::log(file, "parsed in", parse_time, "us, found in the cache in", hit_time, "us");
+  }
+}
+
+TEST(map_cache, load_compiled) {
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  ASSERT_FALSE(files.empty());
+  const rpc::MapInfo info{
+      files[0u],
+      util::OpenDrive::Load(files[0u]),
+      {geom::Transform{geom::Location{1.0f, 2.0f, 3.0f}, geom::Rotation{}}}};
+  auto map = MakeShared<Map>(info);
+  const auto path = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("%%%%-%%%%-%%%%.carlamap")).string();
+  map->SaveCompiled(path);
+  {
+    // Not in the cache yet, loaded from the file.
+    auto loaded = Map::LoadCompiled(path);
+    ASSERT_NE(loaded, map);
+    ASSERT_EQ(loaded->GetHash(), map->GetHash());
+    ASSERT_EQ(loaded->GetName(), map->GetName());
+    ASSERT_EQ(loaded->GetOpenDrive(), map->GetOpenDrive());
+    ASSERT_EQ(loaded->GetRecommendedSpawnPoints().size(), 1u);
+    ASSERT_EQ(loaded->GetRecommendedSpawnPoints()[0u].location, (geom::Location{1.0f, 2.0f, 3.0f}));
+    ASSERT_EQ(Map::LoadCompiled(path), loaded);
+  }
+  boost::filesystem::remove(path);
+  ASSERT_THROW(Map::LoadCompiled(path), std::runtime_error);
+}
@@ -10,22 +10,35 @@
 
 #include <carla/StopWatch.h>
 #include <carla/ThreadPool.h>
+#include <carla/client/detail/WaypointProjector.h>
 #include <carla/geom/Location.h>
 #include <carla/geom/Math.h>
 #include <carla/opendrive/OpenDriveParser.h>
+#include <carla/road/InformationSet.h>
 #include <carla/road/MapBuilder.h>
+#include <carla/road/RoadSpatialIndex.h>
 #include <carla/road/element/RoadInfoElevation.h>
 #include <carla/road/element/RoadInfoGeometry.h>
+#include <carla/road/element/RoadInfoIterator.h>
+#include <carla/road/element/RoadInfoLaneOffset.h>
+#include <carla/road/element/RoadInfoLaneWidth.h>
 #include <carla/road/element/RoadInfoMarkRecord.h>
+#include <carla/road/element/RoadInfoSpeed.h>
 #include <carla/road/element/RoadInfoVisitor.h>
 
 #include <pugixml/pugixml.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <iterator>
+#include <limits>
 #include <string>
+#include <utility>
 
 using namespace carla::road;
 using namespace carla::road::element;
+using carla::client::detail::WaypointProjector;
 using namespace carla::geom;
 using namespace carla::opendrive;
 using namespace util;
@@ -424,3 +437,497 @@ TEST(road, get_waypoint) {
     result.get();
   }
 }
+
+TEST(road, get_waypoints) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    std::vector<Location> locations;
+    for (auto i = 0u; i < 1'000u; ++i) {
+      locations.emplace_back(Random::Location(-500.0f, 500.0f));
+    }
+    // Locations on the lanes, so some GetWaypoint calls succeed.
+    const auto lane_waypoints = map.GenerateWaypoints(5.0);
+    const auto stride = std::max<size_t>(1u, lane_waypoints.size() / 1'000u);
+    for (size_t i = 0u; i < lane_waypoints.size(); i += stride) {
+      locations.emplace_back(map.ComputeTransform(lane_waypoints[i]).location);
+    }
+    const auto *begin = locations.data();
+    const auto *end = begin + locations.size();
+
+    carla::StopWatch stop_watch;
+    std::vector<boost::optional<Waypoint>> expected_closest;
+    std::vector<boost::optional<Waypoint>> expected;
+    for (auto &location : locations) {
+      expected_closest.emplace_back(map.GetClosestWaypointOnRoad(location));
+      expected.emplace_back(map.GetWaypoint(location));
+    }
+    const auto one_by_one_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    ASSERT_TRUE(std::any_of(expected.begin(), expected.end(), [](const auto &w) { return w.has_value(); }));
+
+    for (auto worker_threads : {0u, 1u, 4u}) {
+      WaypointProjector projector(worker_threads);
+      stop_watch.Restart();
+      const auto closest = projector.GetClosestWaypointsOnRoad(map, begin, end);
+      const auto waypoints = projector.GetWaypoints(map, begin, end);
+      const auto batch_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+      ASSERT_TRUE(closest == expected_closest);
+      ASSERT_TRUE(waypoints == expected);
+      carla::logging::log(
+          file, locations.size(), "locations, one by one", one_by_one_time,
+          "us, batch with", worker_threads, "threads", batch_time, "us");
+    }
+    ASSERT_TRUE(map.GetWaypoints(begin, end) == expected);
+    ASSERT_TRUE(map.GetWaypoints(begin, begin).empty());
+  }
+}
+
+TEST(road, get_waypoint_with_hint) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    auto is_inside_lane = [&](const Waypoint &waypoint, const Location &location) {
+      return Math::Distance2D(map.ComputeTransform(waypoint).location, location) <
+          0.5 * map.GetLaneWidth(waypoint);
+    };
+    const auto starts = map.GenerateWaypoints(50.0);
+    ASSERT_FALSE(starts.empty());
+    const auto stride = std::max<size_t>(1u, starts.size() / 200u);
+    size_t count = 0u;
+    size_t differences = 0u;
+    carla::StopWatch::clock::duration global_time{0};
+    carla::StopWatch::clock::duration hint_time{0};
+    // Follow the lanes as a vehicle would, with some lateral noise, passing
+    // the previous result as hint.
+    for (size_t i = 0u; i < starts.size(); i += stride) {
+      auto current = starts[i];
+      auto hint = current;
+      for (auto step = 0u; step < 50u; ++step) {
+        const auto nexts = map.GetNext(current, 0.5);
+        if (nexts.empty()) {
+          break;
+        }
+        current = nexts.front();
+        auto location = map.ComputeTransform(current).location;
+        location += Random::Location(-0.5f, 0.5f);
+
+        carla::StopWatch stop_watch;
+        const auto expected = map.GetClosestWaypointOnRoad(location);
+        global_time += stop_watch.GetDuration();
+        stop_watch.Restart();
+        const auto result = map.GetClosestWaypointOnRoad(location, hint);
+        hint_time += stop_watch.GetDuration();
+
+        ASSERT_TRUE(expected.has_value());
+        ASSERT_TRUE(result.has_value());
+        ++count;
+        if (*result != *expected) {
+          // Only where lanes overlap, both containing the location.
+          ++differences;
+          ASSERT_TRUE(is_inside_lane(*result, location));
+        }
+        const auto inside = map.GetWaypoint(location, hint);
+        if (map.GetWaypoint(location).has_value()) {
+          ASSERT_TRUE(inside.has_value());
+        }
+        if (inside.has_value()) {
+          ASSERT_TRUE(is_inside_lane(*inside, location));
+        }
+        hint = *result;
+      }
+    }
+    // A hint far away falls back to the global search.
+    const auto far = map.ComputeTransform(starts.back()).location;
+    ASSERT_TRUE(map.GetClosestWaypointOnRoad(far, starts.front()) == map.GetClosestWaypointOnRoad(far));
+    // So does a hint that is not in the map.
+    ASSERT_TRUE(map.GetClosestWaypointOnRoad(far, Waypoint{9'999'999u, 0u, -1, 0.0}) == map.GetClosestWaypointOnRoad(far));
+
+    using us = std::chrono::microseconds;
+    carla::logging::log(
+        file, count, "locations,", differences, "in overlapping lanes; global search",
+        std::chrono::duration_cast<us>(global_time).count(), "us, with hint",
+        std::chrono::duration_cast<us>(hint_time).count(), "us");
+  }
+}
+
+/// The search GetClosestWaypointOnRoad did before having a spatial index:
+/// the 50 closest roads sorted by distance, visiting every road.
+static std::vector<RoadSpatialIndex::Result> FindKNearestRoadsBruteForce(
+    const MapData &data,
+    const Location &location,
+    size_t k) {
+  std::vector<RoadSpatialIndex::Result> result;
+  for (auto road_id : data.GetRoadIds()) {
+    const auto nearest = data.GetRoad(road_id).GetNearestPoint(location);
+    auto it = std::upper_bound(
+        result.begin(),
+        result.end(),
+        nearest.second,
+        [](double distance, const RoadSpatialIndex::Result &item) {
+          return distance < item.distance;
+        });
+    result.insert(it, RoadSpatialIndex::Result{road_id, nearest.first, nearest.second});
+    if (result.size() > k) {
+      result.pop_back();
+    }
+  }
+  return result;
+}
+
+TEST(road, road_spatial_index) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &data = m->GetMap();
+    const RoadSpatialIndex index(data);
+    constexpr size_t number_of_queries = 1000u;
+    std::vector<Location> locations;
+    for (auto i = 0u; i < number_of_queries; ++i) {
+      locations.emplace_back(Random::Location(-500.0f, 500.0f));
+    }
+    for (auto k : {1u, 5u, 50u}) {
+      for (auto &location : locations) {
+        const auto expected = FindKNearestRoadsBruteForce(data, location, k);
+        const auto result = index.FindKNearest(data, location, k);
+        ASSERT_EQ(result.size(), expected.size());
+        for (auto i = 0u; i < result.size(); ++i) {
+          ASSERT_EQ(result[i].road_id, expected[i].road_id);
+          ASSERT_EQ(result[i].s, expected[i].s);
+          ASSERT_EQ(result[i].distance, expected[i].distance);
+        }
+        if (k == 1u) {
+          const auto nearest = index.FindNearest(data, location);
+          ASSERT_TRUE(nearest.has_value());
+          ASSERT_EQ(nearest->road_id, expected.front().road_id);
+        }
+      }
+    }
+    carla::StopWatch stop_watch;
+    for (auto &location : locations) {
+      FindKNearestRoadsBruteForce(data, location, 50u);
+    }
+    const auto brute_force_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    stop_watch.Restart();
+    for (auto &location : locations) {
+      index.FindKNearest(data, location, 50u);
+    }
+    const auto index_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    carla::logging::log(
+        file, data.GetRoadCount(), "roads, 50 nearest roads: visiting every road",
+        static_cast<double>(brute_force_time) / number_of_queries, "us, spatial index",
+        static_cast<double>(index_time) / number_of_queries, "us");
+  }
+}
+
+/// How InformationSet::GetInfo looked infos up before grouping them by type:
+/// visiting every info at a distance <= s from the last one.
+template <typename T>
+static const T *GetInfoByVisitor(const InformationSet &set, double s) {
+  const auto &infos = set.GetAll();
+  auto last = std::upper_bound(infos.begin(), infos.end(), s, [](double distance, const auto &info) {
+    return distance < info->GetDistance();
+  });
+  auto it = MakeRoadInfoIterator<T>(std::make_reverse_iterator(last), infos.rend());
+  return it.IsAtEnd() ? nullptr : &*it;
+}
+
+template <typename T>
+static void CheckInfosOfType(const InformationSet &set) {
+  const auto &infos = set.GetAll();
+  const auto expected = MakeRoadInfoIterator<T>(infos);
+  const auto result = set.GetInfos<T>();
+  auto it = expected;
+  for (auto *info : result) {
+    ASSERT_FALSE(it.IsAtEnd());
+    ASSERT_EQ(info, &*it);
+    ++it;
+  }
+  ASSERT_TRUE(it.IsAtEnd());
+  for (auto &info : infos) {
+    for (auto s : {info->GetDistance() - 0.5, info->GetDistance(), info->GetDistance() + 0.5}) {
+      ASSERT_EQ(set.GetInfo<T>(s), GetInfoByVisitor<T>(set, s));
+    }
+  }
+}
+
+TEST(road, information_set) {
+  for (auto i = 0u; i < 100u; ++i) {
+    std::vector<std::unique_ptr<RoadInfo>> infos;
+    for (auto j = 0u; j < 200u; ++j) {
+      // Integer distances so some infos share the same one.
+      const double s = std::floor(Random::Uniform(0.0, 50.0));
+      switch (static_cast<int>(Random::Uniform(0.0, 4.0))) {
+        case 0: infos.emplace_back(std::make_unique<RoadInfoElevation>(s, j, 0.0, 0.0, 0.0)); break;
+        case 1: infos.emplace_back(std::make_unique<RoadInfoLaneOffset>(s, j, 0.0, 0.0, 0.0)); break;
+        case 2: infos.emplace_back(std::make_unique<RoadInfoLaneWidth>(s, j, 0.0, 0.0, 0.0)); break;
+        default: infos.emplace_back(std::make_unique<RoadInfoSpeed>(s, j)); break;
+      }
+    }
+    const InformationSet set(std::move(infos));
+    ASSERT_EQ(set.GetAll().size(), 200u);
+    CheckInfosOfType<RoadInfoElevation>(set);
+    CheckInfosOfType<RoadInfoLaneOffset>(set);
+    CheckInfosOfType<RoadInfoLaneWidth>(set);
+    CheckInfosOfType<RoadInfoSpeed>(set);
+    CheckInfosOfType<RoadInfoGeometry>(set);
+  }
+}
+
+TEST(road, compute_transform_throughput) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    const auto waypoints = m->GenerateWaypoints(1.0);
+    ASSERT_FALSE(waypoints.empty());
+    constexpr auto repetitions = 10u;
+    float checksum = 0.0f;
+    carla::StopWatch stop_watch;
+    for (auto i = 0u; i < repetitions; ++i) {
+      for (auto &waypoint : waypoints) {
+        checksum += m->ComputeTransform(waypoint).location.x;
+      }
+    }
+    const auto elapsed = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    ASSERT_TRUE(std::isfinite(checksum));
+    const auto count = static_cast<double>(repetitions * waypoints.size());
+    carla::logging::log(
+        file, "ComputeTransform:", 1e3 * static_cast<double>(elapsed) / count, "ns per call,",
+        count / (1e-6 * static_cast<double>(std::max<decltype(elapsed)>(elapsed, 1))), "calls per second");
+  }
+}
+
+TEST(road, lane_centerlines) {
+  const auto time_compute_transform = [](const Map &map, const std::vector<Waypoint> &waypoints) {
+    float checksum = 0.0f;
+    carla::StopWatch stop_watch;
+    for (auto &waypoint : waypoints) {
+      checksum += map.ComputeTransform(waypoint).location.x;
+    }
+    const auto elapsed = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    EXPECT_TRUE(std::isfinite(checksum));
+    return 1e3 * static_cast<double>(elapsed) / static_cast<double>(waypoints.size());
+  };
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    ASSERT_EQ(m->GetLaneCenterlines(), nullptr);
+    const auto waypoints = m->GenerateWaypoints(0.7);
+    ASSERT_FALSE(waypoints.empty());
+    std::vector<Transform> transforms;
+    std::vector<double> widths;
+    for (auto &waypoint : waypoints) {
+      transforms.emplace_back(m->ComputeTransform(waypoint));
+      widths.emplace_back(m->GetLaneWidth(waypoint));
+    }
+    carla::logging::log(file, "analytic:", time_compute_transform(*m, waypoints), "ns per ComputeTransform");
+
+    for (auto resolution : {0.5, 1.0, 2.0, 5.0}) {
+      const auto &stats = m->BuildLaneCenterlines(resolution);
+      ASSERT_NE(m->GetLaneCenterlines(), nullptr);
+      ASSERT_GT(stats.samples, 0u);
+      // The error halfway between samples bounds the error elsewhere, up to
+      // float rounding.
+      constexpr double epsilon = 1e-3;
+      for (auto i = 0u; i < waypoints.size(); ++i) {
+        ASSERT_LE(Math::Distance(m->ComputeTransform(waypoints[i]).location, transforms[i].location),
+            stats.max_location_error + epsilon);
+        ASSERT_LE(std::abs(m->GetLaneWidth(waypoints[i]) - widths[i]),
+            stats.max_width_error + epsilon);
+      }
+      carla::logging::log(
+          file, "resolution", resolution, "m:", stats.samples, "samples,",
+          stats.memory / 1024u, "KiB, max error",
+          stats.max_location_error, "m,",
+          stats.max_rotation_error, "deg,",
+          stats.max_width_error, "m width,",
+          time_compute_transform(*m, waypoints), "ns per ComputeTransform");
+    }
+
+    m->ClearLaneCenterlines();
+    ASSERT_EQ(m->GetLaneCenterlines(), nullptr);
+    for (auto i = 0u; i < waypoints.size(); ++i) {
+      ASSERT_EQ(m->ComputeTransform(waypoints[i]).location, transforms[i].location);
+    }
+  }
+}
+
+/// Map::GetNext before it was made iterative: recursive, merging the results
+/// of each successor with ConcatVectors.
+static std::vector<Waypoint> GetNextRecursive(
+    const Map &map,
+    const Waypoint waypoint,
+    const double distance) {
+  constexpr double epsilon = 10.0 * std::numeric_limits<double>::epsilon();
+  const auto &lane = map.GetLane(waypoint);
+  const bool forward = (waypoint.lane_id <= 0);
+  const double relative_s = waypoint.s - lane.GetDistance() + epsilon;
+  const double remaining_lane_length = forward ? lane.GetLength() - relative_s : relative_s;
+  if (distance <= remaining_lane_length) {
+    Waypoint result = waypoint;
+    result.s += forward ? distance : -distance;
+    result.s += forward ? -epsilon : epsilon;
+    return { result };
+  }
+  std::vector<Waypoint> result;
+  for (const auto &successor : map.GetSuccessors(waypoint)) {
+    auto next = GetNextRecursive(map, successor, distance - remaining_lane_length);
+    if (next.size() > result.size()) {
+      std::swap(next, result);
+    }
+    result.insert(result.end(), next.begin(), next.end());
+  }
+  return result;
+}
+
+static bool IsSameWaypoint(const Waypoint &lhs, const Waypoint &rhs) {
+  return (lhs.road_id == rhs.road_id) &&
+      (lhs.section_id == rhs.section_id) &&
+      (lhs.lane_id == rhs.lane_id) &&
+      (lhs.s == rhs.s);
+}
+
+TEST(road, get_next) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    const auto waypoints = m->GenerateWaypoints(5.0);
+    ASSERT_FALSE(waypoints.empty());
+    for (auto distance : {5.0, 50.0, 200.0}) {
+      std::vector<Waypoint> buffer;
+      size_t total = 0u;
+      carla::StopWatch recursive_time;
+      for (auto &waypoint : waypoints) {
+        total += GetNextRecursive(*m, waypoint, distance).size();
+      }
+      recursive_time.Stop();
+      carla::StopWatch iterative_time;
+      for (auto &waypoint : waypoints) {
+        buffer.clear();
+        m->GetNext(waypoint, distance, buffer);
+        total -= buffer.size();
+      }
+      iterative_time.Stop();
+      ASSERT_EQ(total, 0u);
+
+      for (auto &waypoint : waypoints) {
+        const auto expected = GetNextRecursive(*m, waypoint, distance);
+        const auto next = m->GetNext(waypoint, distance);
+        ASSERT_EQ(next.size(), expected.size());
+        for (auto i = 0u; i < next.size(); ++i) {
+          ASSERT_TRUE(IsSameWaypoint(next[i], expected[i]));
+        }
+        // Every waypoint found leads back to the lane we started from, unless
+        // we started right at one of its ends.
+        const auto &lane = m->GetLane(waypoint);
+        if ((std::abs(waypoint.s - lane.GetDistance()) < 1e-3) ||
+            (std::abs(waypoint.s - lane.GetDistance() - lane.GetLength()) < 1e-3)) {
+          continue;
+        }
+        for (auto &item : next) {
+          const auto previous = m->GetPrevious(item, distance);
+          ASSERT_TRUE(std::any_of(previous.begin(), previous.end(), [&](const Waypoint &w) {
+            return (w.road_id == waypoint.road_id) &&
+                (w.section_id == waypoint.section_id) &&
+                (w.lane_id == waypoint.lane_id) &&
+                (std::abs(w.s - waypoint.s) < 1e-6);
+          }));
+        }
+      }
+      using us = std::chrono::microseconds;
+      carla::logging::log(
+          file, "GetNext", distance, "m:",
+          recursive_time.GetElapsedTime<us>(), "us recursive,",
+          iterative_time.GetElapsedTime<us>(), "us iterative with a reused buffer");
+    }
+  }
+}
+
+TEST(road, get_next_until_lane_end) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    for (auto &waypoint : m->GenerateWaypointsOnLaneEntries()) {
+      const auto &lane = m->GetLane(waypoint);
+      const auto result = m->GetNextUntilLaneEnd(waypoint, 2.0);
+      ASSERT_FALSE(result.empty());
+      double previous_s = waypoint.s;
+      for (auto &item : result) {
+        ASSERT_EQ(item.road_id, waypoint.road_id);
+        ASSERT_EQ(item.section_id, waypoint.section_id);
+        ASSERT_EQ(item.lane_id, waypoint.lane_id);
+        ASSERT_LE(std::abs(item.s - previous_s), 2.0 + 1e-9);
+        ASSERT_GE(item.s, lane.GetDistance());
+        ASSERT_LE(item.s, lane.GetDistance() + lane.GetLength());
+        previous_s = item.s;
+      }
+      const auto end = (waypoint.lane_id <= 0) ?
+          lane.GetDistance() + lane.GetLength() :
+          lane.GetDistance();
+      ASSERT_NEAR(result.back().s, end, 1e-6);
+    }
+  }
+}
+
+/// Map::GenerateWaypoints before walking the lane sections in order: search
+/// the lane sections at each step.
+static std::vector<Waypoint> GenerateWaypointsBySearch(const MapData &data, double distance) {
+  constexpr double epsilon = 10.0 * std::numeric_limits<double>::epsilon();
+  std::vector<Waypoint> result;
+  for (auto road_id : data.GetRoadIds()) {
+    const auto &road = data.GetRoad(road_id);
+    for (double s = epsilon; s < (road.GetLength() - epsilon); s += distance) {
+      for (const auto &lane_section : road.GetLaneSectionsAt(s)) {
+        for (const auto &lane : lane_section.GetLanes()) {
+          if ((static_cast<uint32_t>(lane.second.GetType()) & static_cast<uint32_t>(Lane::LaneType::Driving)) > 0) {
+            result.emplace_back(Waypoint{road.GetId(), lane_section.GetId(), lane.second.GetId(), s});
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+TEST(road, generate_waypoints_in_parallel) {
+  auto is_same = [](const std::vector<Waypoint> &lhs, const std::vector<Waypoint> &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), IsSameWaypoint);
+  };
+  auto is_same_topology = [](const auto &lhs, const auto &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const auto &a, const auto &b) {
+      return IsSameWaypoint(a.first, b.first) && IsSameWaypoint(a.second, b.second);
+    });
+  };
+  using us = std::chrono::microseconds;
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    const auto topology = map.GenerateTopology();
+    for (auto distance : {1.0, 2.5}) {
+      carla::StopWatch stop_watch;
+      const auto expected = GenerateWaypointsBySearch(map.GetMap(), distance);
+      const auto search_time = stop_watch.GetElapsedTime<us>();
+      ASSERT_FALSE(expected.empty());
+      stop_watch.Restart();
+      ASSERT_TRUE(is_same(map.GenerateWaypoints(distance), expected));
+      const auto serial_time = stop_watch.GetElapsedTime<us>();
+      carla::logging::log(
+          file, expected.size(), "waypoints every", distance, "m: search", search_time,
+          "us, serial", serial_time, "us");
+      for (auto worker_threads : {0u, 1u, 4u}) {
+        WaypointProjector projector(worker_threads);
+        stop_watch.Restart();
+        const auto waypoints = projector.GenerateWaypoints(map, distance);
+        const auto parallel_time = stop_watch.GetElapsedTime<us>();
+        ASSERT_TRUE(is_same(waypoints, expected));
+        ASSERT_TRUE(is_same_topology(projector.GenerateTopology(map), topology));
+        carla::logging::log(file, "with", worker_threads, "threads", parallel_time, "us");
+      }
+    }
+    const auto road_ids = map.GetRoadIds();
+    ASSERT_EQ(road_ids.size(), map.GetMap().GetRoads().size());
+    ASSERT_TRUE(map.GenerateWaypoints(1.0, road_ids.data(), road_ids.data()).empty());
+  }
+}
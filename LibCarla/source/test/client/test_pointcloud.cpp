@@ -0,0 +1,144 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/StopWatch.h>
+#include <carla/pointcloud/PointCloudIO.h>
+#include <carla/rpc/Location.h>
+
+#include <cstring>
+#include <list>
+#include <sstream>
+
+using namespace carla;
+using carla::pointcloud::PointCloudIO;
+using util::Random;
+
+static std::vector<rpc::Location> MakePoints(size_t count) {
+  std::vector<rpc::Location> points;
+  points.reserve(count);
+  for (auto i = 0u; i < count; ++i) {
+    points.emplace_back(Random::Location(-100.0f, 100.0f));
+  }
+  return points;
+}
+
+/// Split @a data in header and body at the end of the line @a last_line.
+static std::pair<std::string, std::string> SplitHeader(const std::string &data, const std::string &last_line) {
+  const auto pos = data.find(last_line);
+  EXPECT_NE(pos, std::string::npos);
+  const auto body = pos + last_line.size();
+  return {data.substr(0u, body), data.substr(body)};
+}
+
+template <typename T>
+static T Read(const std::string &data, size_t offset) {
+  T value;
+  std::memcpy(&value, data.data() + offset, sizeof(T));
+  return value;
+}
+
+TEST(pointcloud, binary_ply) {
+  const auto points = MakePoints(10000u);
+  std::ostringstream out;
+  PointCloudIO::Dump(out, points.data(), points.data() + points.size(), PointCloudIO::Format::PlyBinary);
+  auto split = SplitHeader(out.str(), "end_header\n");
+  ASSERT_NE(split.first.find("format binary_little_endian 1.0\n"), std::string::npos);
+  ASSERT_NE(split.first.find("element vertex 10000\n"), std::string::npos);
+  ASSERT_EQ(split.second.size(), sizeof(rpc::Location) * points.size());
+  ASSERT_EQ(std::memcmp(split.second.data(), points.data(), split.second.size()), 0);
+
+  // Other iterators take the packing path, same result.
+  const std::list<rpc::Location> list(points.begin(), points.end());
+  std::ostringstream out_list;
+  PointCloudIO::Dump(out_list, list.begin(), list.end(), PointCloudIO::Format::PlyBinary);
+  ASSERT_EQ(out_list.str(), out.str());
+}
+
+TEST(pointcloud, ring) {
+  const auto points = MakePoints(6000u);
+  const std::vector<uint32_t> points_per_channel = {1000u, 0u, 4095u, 905u};
+  for (auto format : {PointCloudIO::Format::PlyBinary, PointCloudIO::Format::PcdBinary}) {
+    std::ostringstream out;
+    PointCloudIO::Dump(out, points.begin(), points.end(), format, points_per_channel);
+    const bool is_ply = format == PointCloudIO::Format::PlyBinary;
+    auto split = SplitHeader(out.str(), is_ply ? "end_header\n" : "DATA binary\n");
+    if (is_ply) {
+      ASSERT_NE(split.first.find("property uint16 ring\n"), std::string::npos);
+    } else {
+      ASSERT_NE(split.first.find("FIELDS x y z ring\n"), std::string::npos);
+      ASSERT_NE(split.first.find("POINTS 6000\n"), std::string::npos);
+    }
+    constexpr size_t record_size = 3u * sizeof(float) + sizeof(uint16_t);
+    const auto &body = split.second;
+    ASSERT_EQ(body.size(), record_size * points.size());
+    size_t i = 0u;
+    for (auto channel = 0u; channel < points_per_channel.size(); ++channel) {
+      for (auto j = 0u; j < points_per_channel[channel]; ++j, ++i) {
+        const size_t offset = i * record_size;
+        ASSERT_EQ(Read<float>(body, offset), points[i].x);
+        ASSERT_EQ(Read<float>(body, offset + 4u), points[i].y);
+        ASSERT_EQ(Read<float>(body, offset + 8u), points[i].z);
+        ASSERT_EQ(Read<uint16_t>(body, offset + 12u), channel);
+      }
+    }
+  }
+}
+
+TEST(pointcloud, kitti_bin) {
+  const auto points = MakePoints(5000u);
+  std::ostringstream out;
+  PointCloudIO::Dump(out, points.begin(), points.end(), PointCloudIO::Format::KittiBin, {5000u});
+  const auto body = out.str();
+  ASSERT_EQ(body.size(), 4u * sizeof(float) * points.size());
+  for (auto i = 0u; i < points.size(); ++i) {
+    ASSERT_EQ(Read<float>(body, 16u * i), points[i].x);
+    ASSERT_EQ(Read<float>(body, 16u * i + 4u), points[i].y);
+    ASSERT_EQ(Read<float>(body, 16u * i + 8u), points[i].z);
+    ASSERT_EQ(Read<float>(body, 16u * i + 12u), 0.0f);
+  }
+  std::vector<float> intensity(points.size());
+  for (auto i = 0u; i < intensity.size(); ++i) {
+    intensity[i] = static_cast<float>(i) / static_cast<float>(intensity.size());
+  }
+  std::ostringstream out_with_intensity;
+  PointCloudIO::Dump(
+      out_with_intensity, points.begin(), points.end(), PointCloudIO::Format::KittiBin, {5000u}, intensity);
+  const auto body_with_intensity = out_with_intensity.str();
+  ASSERT_EQ(body_with_intensity.size(), body.size());
+  for (auto i = 0u; i < points.size(); ++i) {
+    ASSERT_EQ(Read<float>(body_with_intensity, 16u * i), points[i].x);
+    ASSERT_EQ(Read<float>(body_with_intensity, 16u * i + 12u), intensity[i]);
+  }
+}
+
+TEST(pointcloud, benchmark) {
+  const auto points = MakePoints(1000000u);
+  const std::vector<uint32_t> points_per_channel(32u, 1000000u / 32u);
+  const std::vector<std::pair<const char *, PointCloudIO::Format>> formats = {
+      {"ascii PLY", PointCloudIO::Format::PlyAscii},
+      {"binary PLY", PointCloudIO::Format::PlyBinary},
+      {"binary PCD", PointCloudIO::Format::PcdBinary},
+      {"KITTI bin", PointCloudIO::Format::KittiBin}};
+  for (auto &format : formats) {
+    for (auto *channels : {static_cast<const std::vector<uint32_t> *>(nullptr), &points_per_channel}) {
+      std::ostringstream out;
+      StopWatch stop_watch;
+      if (channels == nullptr) {
+        PointCloudIO::Dump(out, points.data(), points.data() + points.size(), format.second);
+      } else {
+        PointCloudIO::Dump(out, points.data(), points.data() + points.size(), format.second, *channels);
+      }
+      stop_watch.Stop();
+      carla::logging::log(
+          format.first, (channels == nullptr ? "" : "with ring:"),
+          stop_watch.GetElapsedTime<std::chrono::microseconds>(), "us,",
+          out.str().size() / 1024u, "KB for", points.size(), "points");
+    }
+  }
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/StopWatch.h>
+#include <carla/pointcloud/PointCloudFilter.h>
+
+#include <cmath>
+#include <map>
+#include <tuple>
+
+using namespace carla::pointcloud;
+using carla::geom::Location;
+using carla::StopWatch;
+using util::Random;
+
+static std::vector<Location> MakePoints(size_t number_of_points) {
+  std::vector<Location> points;
+  points.reserve(number_of_points);
+  for (auto i = 0u; i < number_of_points; ++i) {
+    points.emplace_back(Random::Location(-100.0f, 100.0f));
+  }
+  return points;
+}
+
+template <typename PredicateT>
+static std::vector<uint32_t> Select(const std::vector<Location> &points, PredicateT &&predicate) {
+  std::vector<uint32_t> result;
+  for (auto i = 0u; i < points.size(); ++i) {
+    if (predicate(points[i])) {
+      result.emplace_back(i);
+    }
+  }
+  return result;
+}
+
+TEST(pointcloud_filter, crop) {
+  // Odd sizes to exercise the points left after the vectorized loop.
+  for (auto size : {0u, 3u, 1001u, 50003u}) {
+    const auto points = MakePoints(size);
+    const Location min{-20.0f, -50.0f, -10.0f};
+    const Location max{30.0f, 10.0f, 70.0f};
+    const Location center{5.0f, -5.0f, 2.0f};
+    const float radius = 40.0f;
+    const auto inside_box = [&](const Location &p) {
+      return (min.x <= p.x) && (p.x <= max.x) && (min.y <= p.y) && (p.y <= max.y) && (min.z <= p.z) && (p.z <= max.z);
+    };
+    const auto inside_sphere = [&](const Location &p) {
+      const auto d = p - center;
+      return (d.x * d.x + d.y * d.y + d.z * d.z) <= radius * radius;
+    };
+    for (auto threads : {0u, 3u}) {
+      PointCloudFilter filter(threads);
+      const auto *begin = points.data();
+      const auto *end = begin + points.size();
+      ASSERT_EQ(filter.CropBox(begin, end, min, max), Select(points, inside_box));
+      ASSERT_EQ(filter.CropBox(begin, end, min, max, true), Select(points, [&](const auto &p) { return !inside_box(p); }));
+      ASSERT_EQ(filter.CropRadius(begin, end, center, radius), Select(points, inside_sphere));
+      ASSERT_EQ(filter.CropRadius(begin, end, center, radius, true), Select(points, [&](const auto &p) { return !inside_sphere(p); }));
+    }
+  }
+  // Points on the faces are inside.
+  const std::vector<Location> points = {{1.0f, 0.0f, 0.0f}, {0.0f, 2.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, {3.0f, 0.0f, 0.0f}};
+  PointCloudFilter filter;
+  const auto indices = filter.CropBox(points.data(), points.data() + points.size(), {0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 0.0f});
+  ASSERT_EQ(indices, (std::vector<uint32_t>{0u, 1u, 2u}));
+  ASSERT_EQ(PointCloudFilter::Gather(points.data(), indices).back(), points[2u]);
+}
+
+TEST(pointcloud_filter, voxel_downsample) {
+  const auto points = MakePoints(100000u);
+  const float voxel_size = 10.0f;
+  // Reference with an ordered map.
+  std::map<std::tuple<int, int, int>, std::pair<std::array<double, 3u>, uint32_t>> voxels;
+  for (auto &point : points) {
+    const auto key = std::make_tuple(
+        static_cast<int>(std::floor(point.x / voxel_size)),
+        static_cast<int>(std::floor(point.y / voxel_size)),
+        static_cast<int>(std::floor(point.z / voxel_size)));
+    auto &voxel = voxels[key];
+    voxel.first[0u] += point.x;
+    voxel.first[1u] += point.y;
+    voxel.first[2u] += point.z;
+    ++voxel.second;
+  }
+  for (auto threads : {0u, 4u}) {
+    PointCloudFilter filter(threads);
+    const auto result = filter.VoxelDownsample(points.data(), points.data() + points.size(), voxel_size);
+    ASSERT_EQ(result.size(), voxels.size());
+    for (auto &centroid : result) {
+      const auto key = std::make_tuple(
+          static_cast<int>(std::floor(centroid.x / voxel_size)),
+          static_cast<int>(std::floor(centroid.y / voxel_size)),
+          static_cast<int>(std::floor(centroid.z / voxel_size)));
+      const auto it = voxels.find(key);
+      ASSERT_NE(it, voxels.end());
+      const double count = it->second.second;
+      ASSERT_NEAR(centroid.x, it->second.first[0u] / count, 1e-3);
+      ASSERT_NEAR(centroid.y, it->second.first[1u] / count, 1e-3);
+      ASSERT_NEAR(centroid.z, it->second.first[2u] / count, 1e-3);
+    }
+  }
+  // Voxels are in the order of their first point.
+  const std::vector<Location> few = {{5.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, {5.0f, 0.0f, 0.0f}};
+  PointCloudFilter filter;
+  const auto result = filter.VoxelDownsample(few.data(), few.data() + few.size(), 1.0f);
+  ASSERT_EQ(result, (std::vector<Location>{{5.25f, 0.25f, 0.25f}, {0.5f, 0.5f, 0.5f}}));
+}
+
+TEST(pointcloud_filter, range_image) {
+  const std::vector<Location> points = {
+      {10.0f, 0.0f, 0.0f},     // channel 0, azimuth 0
+      {-5.0f, 0.0f, 0.0f},     // channel 0, azimuth pi
+      {0.0f, -3.0f, 4.0f},     // channel 1, azimuth -pi/2
+      {0.0f, -2.0f, 0.0f},     // channel 1, same pixel, closer
+      {0.0f, 7.0f, 0.0f}};     // channel 1, azimuth pi/2
+  const std::vector<uint32_t> points_per_channel = {2u, 3u};
+  for (auto threads : {0u, 2u}) {
+    PointCloudFilter filter(threads);
+    const auto image = filter.ProjectToRangeImage(points.data(), points.data() + points.size(), points_per_channel, 4u);
+    ASSERT_EQ(image, (std::vector<float>{0.0f, 0.0f, 10.0f, 5.0f, 0.0f, 2.0f, 0.0f, 7.0f}));
+  }
+}
+
+TEST(pointcloud_filter, benchmark) {
+  for (auto number_of_points : {100000u, 1000000u}) {
+    const auto points = MakePoints(number_of_points);
+    const auto *begin = points.data();
+    const auto *end = begin + points.size();
+    std::vector<uint32_t> points_per_channel(64u, number_of_points / 64u);
+    points_per_channel.back() += number_of_points % 64u;
+    for (auto threads : {0u, 4u}) {
+      PointCloudFilter filter(threads);
+      StopWatch stop_watch;
+      const auto box = filter.CropBox(begin, end, {-50.0f, -50.0f, -5.0f}, {50.0f, 50.0f, 5.0f});
+      const auto box_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+      stop_watch.Restart();
+      const auto sphere = filter.CropRadius(begin, end, {}, 60.0f);
+      const auto sphere_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+      stop_watch.Restart();
+      const auto voxels = filter.VoxelDownsample(begin, end, 5.0f);
+      const auto voxel_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+      stop_watch.Restart();
+      const auto image = filter.ProjectToRangeImage(begin, end, points_per_channel, 2048u);
+      const auto image_time = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+      carla::logging::log(
+          number_of_points, "points,", threads, "worker threads: crop box", box_time,
+          "us, crop radius", sphere_time,
+          "us, voxel grid", voxel_time, "us (", voxels.size(), "voxels ), range image", image_time, "us");
+      ASSERT_FALSE(box.empty() || sphere.empty() || voxels.empty() || image.empty());
+    }
+  }
+}
@@ -0,0 +1,252 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+#include "Random.h"
+
+#include <carla/StopWatch.h>
+#include <carla/client/LaneRouter.h>
+#include <carla/client/Map.h>
+#include <carla/client/Waypoint.h>
+#include <carla/geom/Math.h>
+#include <carla/opendrive/OpenDriveParser.h>
+#include <carla/road/ContractionHierarchy.h>
+#include <carla/road/LaneGraph.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+using namespace carla::road;
+using namespace carla::geom;
+using carla::opendrive::OpenDriveParser;
+using util::Random;
+
+using NodeId = LaneGraph::NodeId;
+
+/// Cost of the cheapest route with plain Dijkstra.
+static double ReferenceCost(const LaneGraph &graph, NodeId origin, NodeId destination) {
+  constexpr double infinity = std::numeric_limits<double>::infinity();
+  std::vector<double> cost(graph.GetNumberOfNodes(), infinity);
+  using Entry = std::pair<double, NodeId>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+  cost[origin] = 0.0;
+  open.emplace(0.0, origin);
+  while (!open.empty()) {
+    const auto entry = open.top();
+    open.pop();
+    if (entry.second == destination) {
+      return entry.first;
+    }
+    if (entry.first > cost[entry.second]) {
+      continue;
+    }
+    for (const auto &edge : graph.GetEdges(entry.second)) {
+      if (entry.first + edge.cost < cost[edge.target]) {
+        cost[edge.target] = entry.first + edge.cost;
+        open.emplace(cost[edge.target], edge.target);
+      }
+    }
+  }
+  return infinity;
+}
+
+/// Check that consecutive nodes of @a route are joined by an edge and that
+/// the edges add up to its cost.
+static void CheckRoute(
+    const LaneGraph &graph,
+    const LaneGraph::Route &route,
+    NodeId origin,
+    NodeId destination) {
+  ASSERT_FALSE(route.nodes.empty());
+  ASSERT_EQ(route.nodes.front(), origin);
+  ASSERT_EQ(route.nodes.back(), destination);
+  double cost = 0.0;
+  for (auto i = 1u; i < route.nodes.size(); ++i) {
+    const auto edges = graph.GetEdges(route.nodes[i - 1u]);
+    const auto it = std::find_if(edges.begin(), edges.end(), [&](const auto &edge) {
+      return edge.target == route.nodes[i];
+    });
+    ASSERT_TRUE(it != edges.end());
+    cost += it->cost;
+  }
+  ASSERT_NEAR(cost, route.cost, 1e-6 * std::max(1.0, cost));
+}
+
+static NodeId RandomNode(const LaneGraph &graph) {
+  const auto size = graph.GetNumberOfNodes();
+  return std::min(
+      static_cast<NodeId>(Random::Uniform(0.0, static_cast<double>(size))),
+      static_cast<NodeId>(size - 1u));
+}
+
+TEST(routing, lane_graph) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(map.has_value());
+    const LaneGraph graph{*map, 5.0};
+    ASSERT_EQ(graph.GetNumberOfNodes(), map->GenerateWaypointsOnLaneEntries().size());
+    for (NodeId node = 0u; node < graph.GetNumberOfNodes(); ++node) {
+      const auto &waypoint = graph.GetWaypoint(node);
+      ASSERT_TRUE(graph.GetNode(waypoint) == node);
+      const auto successors = map->GetSuccessors(waypoint);
+      for (const auto &edge : graph.GetEdges(node)) {
+        const auto &target = graph.GetWaypoint(edge.target);
+        const auto distance = static_cast<double>(
+            Math::Distance(graph.GetLocation(node), graph.GetLocation(edge.target)));
+        ASSERT_GE(edge.cost, distance);
+        if (edge.type == LaneGraph::EdgeType::Successor) {
+          ASSERT_TRUE(std::find_if(successors.begin(), successors.end(), [&](const auto &successor) {
+            return graph.GetNode(successor) == edge.target;
+          }) != successors.end());
+        } else {
+          ASSERT_FALSE(map->IsJunction(waypoint.road_id));
+          ASSERT_EQ(target.road_id, waypoint.road_id);
+          ASSERT_EQ(target.section_id, waypoint.section_id);
+          ASSERT_EQ(target.lane_id < 0, waypoint.lane_id < 0);
+          ASSERT_EQ(std::abs(target.lane_id - waypoint.lane_id), 1);
+          ASSERT_NEAR(edge.cost, distance + 5.0, 1e-9);
+        }
+      }
+    }
+    ASSERT_THROW(graph.GetEdges(static_cast<NodeId>(graph.GetNumberOfNodes())), std::out_of_range);
+    ASSERT_FALSE(graph.FindRoute(element::Waypoint{9'999'999u, 0u, -1, 0.0}, graph.GetWaypoint(0u)).has_value());
+  }
+}
+
+TEST(routing, same_cost_as_dijkstra) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(map.has_value());
+    const LaneGraph graph{*map};
+    // A tiny witness search limit only adds shortcuts, routes must still be
+    // optimal.
+    for (auto limit : {size_t(1u), ContractionHierarchy::DEFAULT_WITNESS_SEARCH_LIMIT}) {
+      const ContractionHierarchy hierarchy{graph, limit};
+      ASSERT_EQ(hierarchy.GetNumberOfNodes(), graph.GetNumberOfNodes());
+      for (auto i = 0u; i < 100u; ++i) {
+        const auto origin = RandomNode(graph);
+        const auto destination = RandomNode(graph);
+        const auto expected = ReferenceCost(graph, origin, destination);
+        const auto a_star = graph.FindRoute(origin, destination);
+        const auto ch = hierarchy.FindRoute(origin, destination);
+        if (std::isinf(expected)) {
+          ASSERT_FALSE(a_star.has_value());
+          ASSERT_FALSE(ch.has_value());
+          continue;
+        }
+        ASSERT_TRUE(a_star.has_value());
+        ASSERT_TRUE(ch.has_value());
+        ASSERT_NEAR(a_star->cost, expected, 1e-6 * std::max(1.0, expected));
+        ASSERT_NEAR(ch->cost, expected, 1e-6 * std::max(1.0, expected));
+        CheckRoute(graph, *a_star, origin, destination);
+        CheckRoute(graph, *ch, origin, destination);
+      }
+      const auto same = hierarchy.FindRoute(0u, 0u);
+      ASSERT_TRUE(same.has_value());
+      ASSERT_EQ(same->nodes, std::vector<NodeId>{0u});
+      ASSERT_EQ(same->cost, 0.0);
+    }
+  }
+}
+
+TEST(routing, lane_router) {
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  ASSERT_FALSE(files.empty());
+  auto map = carla::MakeShared<carla::client::Map>(files[0u], util::OpenDrive::Load(files[0u]));
+  auto other = carla::MakeShared<carla::client::Map>(files[0u], map->GetOpenDrive());
+  carla::client::LaneRouter router{map};
+  const auto waypoints = map->GenerateWaypoints(20.0);
+  const auto other_waypoints = other->GenerateWaypoints(20.0);
+  ASSERT_GE(waypoints.size(), 2u);
+  ASSERT_EQ(other_waypoints.size(), waypoints.size());
+
+  // Same lane ids, but from another map.
+  ASSERT_THROW(router.FindRoute(*other_waypoints[0u], *waypoints[1u]), std::invalid_argument);
+  ASSERT_THROW(router.FindRoute(*waypoints[0u], *other_waypoints[1u]), std::invalid_argument);
+
+  std::vector<std::pair<size_t, size_t>> queries;
+  std::vector<bool> reachable;
+  for (auto i = 0u; i < 50u; ++i) {
+    auto random_index = [&]() {
+      const auto index = static_cast<size_t>(Random::Uniform(0.0, static_cast<double>(waypoints.size())));
+      return std::min(index, waypoints.size() - 1u);
+    };
+    const auto origin = random_index();
+    const auto destination = random_index();
+    queries.emplace_back(origin, destination);
+    reachable.push_back(!router.FindRoute(*waypoints[origin], *waypoints[destination]).empty());
+  }
+
+  // Routes can be found while the hierarchy is (re)built.
+  std::atomic_bool built{false};
+  std::thread builder([&]() {
+    for (auto i = 0u; i < 2u; ++i) {
+      router.BuildContractionHierarchy();
+    }
+    built = true;
+  });
+  do {
+    for (auto i = 0u; i < queries.size(); ++i) {
+      const auto route = router.FindRoute(*waypoints[queries[i].first], *waypoints[queries[i].second]);
+      ASSERT_EQ(!route.empty(), reachable[i]);
+    }
+  } while (!built);
+  builder.join();
+  ASSERT_TRUE(router.HasContractionHierarchy());
+}
+
+TEST(routing, benchmark) {
+  constexpr auto number_of_queries = 1000u;
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(map.has_value());
+
+    carla::StopWatch build;
+    const LaneGraph graph{*map};
+    build.Stop();
+
+    carla::StopWatch preprocessing;
+    const ContractionHierarchy hierarchy{graph};
+    preprocessing.Stop();
+
+    std::vector<std::pair<NodeId, NodeId>> queries;
+    for (auto i = 0u; i < number_of_queries; ++i) {
+      queries.emplace_back(RandomNode(graph), RandomNode(graph));
+    }
+
+    size_t found_a_star = 0u;
+    carla::StopWatch a_star;
+    for (const auto &query : queries) {
+      found_a_star += graph.FindRoute(query.first, query.second).has_value() ? 1u : 0u;
+    }
+    a_star.Stop();
+
+    size_t found_ch = 0u;
+    carla::StopWatch ch;
+    for (const auto &query : queries) {
+      found_ch += hierarchy.FindRoute(query.first, query.second).has_value() ? 1u : 0u;
+    }
+    ch.Stop();
+
+    ASSERT_EQ(found_a_star, found_ch);
+    using us = std::chrono::microseconds;
+    carla::logging::log(
+        file, graph.GetNumberOfNodes(), "nodes,", graph.GetNumberOfEdges(), "edges,",
+        hierarchy.GetNumberOfShortcuts(), "shortcuts; graph built in",
+        build.GetElapsedTime<us>(), "us, hierarchy in",
+        preprocessing.GetElapsedTime<us>(), "us; per query: A*",
+        a_star.GetElapsedTime<us>() / number_of_queries, "us, CH",
+        ch.GetElapsedTime<us>() / number_of_queries, "us");
+  }
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/sensor/CompositeSerializer.h>
+#include <carla/sensor/SensorDataPool.h>
+#include <carla/sensor/data/LidarMeasurement.h>
+#include <carla/sensor/s11n/LidarSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace carla;
+using namespace carla::sensor;
+
+namespace {
+
+  struct Counted {
+    static std::atomic_int alive;
+
+    explicit Counted(int v) : value(v) {
+      ++alive;
+    }
+
+    ~Counted() {
+      --alive;
+    }
+
+    int value;
+  };
+
+  std::atomic_int Counted::alive{0};
+
+  struct Throwing {
+    explicit Throwing(bool should_throw) {
+      if (should_throw) {
+        throw std::invalid_argument("should throw");
+      }
+    }
+  };
+
+  class FakeLidar {};
+
+  using Registry = CompositeSerializer<std::pair<FakeLidar *, s11n::LidarSerializer>>;
+
+} // namespace
+
+static SharedPtr<Counted> MakeCounted(int value) {
+  return SensorDataPool::Make<Counted>([=](void *memory) {
+    return new (memory) Counted(value);
+  });
+}
+
+TEST(sensor_data_pool, reuse) {
+  constexpr size_t number_of_objects = 10u;
+  const auto initial = SensorDataPool::GetStats<Counted>();
+  for (auto round = 0; round < 5; ++round) {
+    std::vector<SharedPtr<Counted>> objects;
+    for (auto i = 0u; i < number_of_objects; ++i) {
+      objects.emplace_back(MakeCounted(static_cast<int>(i)));
+      ASSERT_EQ(objects.back()->value, static_cast<int>(i));
+    }
+    ASSERT_EQ(Counted::alive, static_cast<int>(number_of_objects));
+  }
+  ASSERT_EQ(Counted::alive, 0);
+  const auto stats = SensorDataPool::GetStats<Counted>();
+  ASSERT_EQ(stats.heap_allocations - initial.heap_allocations, number_of_objects);
+  ASSERT_EQ(stats.reuses - initial.reuses, 4u * number_of_objects);
+}
+
+TEST(sensor_data_pool, factory_throws) {
+  auto make = [](bool should_throw) {
+    return SensorDataPool::Make<Throwing>([=](void *memory) {
+      return new (memory) Throwing(should_throw);
+    });
+  };
+  ASSERT_THROW(make(true), std::invalid_argument);
+  // The memory of the failed construction returned to the pool.
+  auto object = make(false);
+  const auto stats = SensorDataPool::GetStats<Throwing>();
+  ASSERT_EQ(stats.heap_allocations, 1u);
+  ASSERT_EQ(stats.reuses, 1u);
+}
+
+TEST(sensor_data_pool, released_in_other_threads) {
+  constexpr int number_of_objects = 10000;
+  std::vector<SharedPtr<Counted>> objects;
+  for (auto i = 0; i < number_of_objects; ++i) {
+    objects.emplace_back(MakeCounted(i));
+  }
+  {
+    ThreadGroup threads;
+    constexpr size_t number_of_threads = 4u;
+    const size_t chunk = objects.size() / number_of_threads;
+    for (auto t = 0u; t < number_of_threads; ++t) {
+      threads.CreateThread([&, t]() {
+        for (auto i = t * chunk; i < (t + 1u) * chunk; ++i) {
+          objects[i].reset();
+        }
+        for (auto i = 0; i < 100; ++i) {
+          auto object = MakeCounted(i);
+          ASSERT_EQ(object->value, i);
+        }
+      });
+    }
+  }
+  ASSERT_EQ(Counted::alive, 0);
+}
+
+TEST(sensor_data_pool, deserialize_without_heap_allocations) {
+  s11n::LidarMeasurement measurement(2u);
+  measurement.Reset(2u);
+  measurement.WritePoint(0u, {1.0f, 2.0f, 3.0f});
+  measurement.WritePoint(1u, {4.0f, 5.0f, 6.0f});
+  FakeLidar sensor;
+  auto payload = Registry::Serialize(sensor, measurement, Buffer());
+  auto header = s11n::SensorHeaderSerializer::Serialize(0u, 1u, 1.0, rpc::Transform{});
+  std::vector<unsigned char> message(header.begin(), header.end());
+  message.insert(message.end(), payload.begin(), payload.end());
+
+  auto deserialize = [&]() {
+    auto data = Registry::Deserialize(Buffer(message));
+    ASSERT_EQ(boost::static_pointer_cast<data::LidarMeasurement>(data)->size(), 2u);
+  };
+  deserialize();
+  const auto warm = SensorDataPool::GetStats<data::LidarMeasurement>();
+  for (auto i = 0; i < 100; ++i) {
+    deserialize();
+  }
+  const auto stats = SensorDataPool::GetStats<data::LidarMeasurement>();
+  ASSERT_EQ(stats.heap_allocations, warm.heap_allocations);
+  ASSERT_EQ(stats.reuses - warm.reuses, 100u);
+}
@@ -0,0 +1,182 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/client/detail/FrameSynchronizer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace carla;
+using namespace std::chrono_literals;
+using carla::client::SensorBundle;
+using carla::client::detail::FrameSynchronizer;
+
+namespace {
+
+  class FakeData : public sensor::SensorData {
+  public:
+
+    explicit FakeData(size_t frame) : SensorData(frame, 0.0, rpc::Transform{}) {}
+  };
+
+  /// Collects the bundles emitted by a FrameSynchronizer.
+  class Collector {
+  public:
+
+    FrameSynchronizer::CallbackFunctionType MakeCallback() {
+      return [this](SharedPtr<SensorBundle> bundle) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _bundles.emplace_back(std::move(bundle));
+      };
+    }
+
+    std::vector<SharedPtr<SensorBundle>> Get() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _bundles;
+    }
+
+  private:
+
+    std::mutex _mutex;
+
+    std::vector<SharedPtr<SensorBundle>> _bundles;
+  };
+
+} // namespace
+
+static SharedPtr<sensor::SensorData> MakeData(size_t frame) {
+  return MakeShared<FakeData>(frame);
+}
+
+TEST(sensor_group, complete_bundles) {
+  constexpr size_t number_of_members = 3u;
+  constexpr size_t number_of_frames = 100u;
+  Collector collector;
+  FrameSynchronizer synchronizer(number_of_members, 0ms, 4u, collector.MakeCallback());
+  std::vector<size_t> order = {0u, 1u, 2u};
+  std::mt19937 engine(42u);
+  std::vector<std::vector<SharedPtr<sensor::SensorData>>> pushed;
+  for (auto frame = 1u; frame <= number_of_frames; ++frame) {
+    pushed.emplace_back(number_of_members);
+    std::shuffle(order.begin(), order.end(), engine);
+    for (auto index : order) {
+      pushed.back()[index] = MakeData(frame);
+      synchronizer.Push(index, pushed.back()[index]);
+    }
+  }
+  const auto bundles = collector.Get();
+  ASSERT_EQ(bundles.size(), number_of_frames);
+  for (auto i = 0u; i < number_of_frames; ++i) {
+    ASSERT_EQ(bundles[i]->GetFrame(), i + 1u);
+    ASSERT_TRUE(bundles[i]->IsComplete());
+    ASSERT_EQ(bundles[i]->size(), number_of_members);
+    for (auto j = 0u; j < number_of_members; ++j) {
+      // The very same objects, nothing copied.
+      ASSERT_EQ(bundles[i]->at(j), pushed[i][j]);
+    }
+  }
+  ASSERT_EQ(synchronizer.GetDroppedCount(), 0u);
+}
+
+TEST(sensor_group, timeout) {
+  Collector collector;
+  FrameSynchronizer synchronizer(2u, 10ms, 8u, collector.MakeCallback());
+  synchronizer.Push(0u, MakeData(1u));
+  ASSERT_TRUE(collector.Get().empty());
+  std::this_thread::sleep_for(20ms);
+  // Expired bundles are emitted when new data arrives.
+  synchronizer.Push(0u, MakeData(2u));
+  auto bundles = collector.Get();
+  ASSERT_EQ(bundles.size(), 1u);
+  ASSERT_EQ(bundles[0u]->GetFrame(), 1u);
+  ASSERT_FALSE(bundles[0u]->IsComplete());
+  ASSERT_NE(bundles[0u]->at(0u), nullptr);
+  ASSERT_EQ(bundles[0u]->at(1u), nullptr);
+  // Too late.
+  synchronizer.Push(1u, MakeData(1u));
+  ASSERT_EQ(synchronizer.GetDroppedCount(), 1u);
+  // Not expired yet.
+  synchronizer.Push(1u, MakeData(2u));
+  bundles = collector.Get();
+  ASSERT_EQ(bundles.size(), 2u);
+  ASSERT_EQ(bundles[1u]->GetFrame(), 2u);
+  ASSERT_TRUE(bundles[1u]->IsComplete());
+}
+
+TEST(sensor_group, eviction_and_flush) {
+  constexpr size_t ring_size = 4u;
+  Collector collector;
+  FrameSynchronizer synchronizer(2u, 0ms, ring_size, collector.MakeCallback());
+  for (auto frame = 0u; frame < 10u; ++frame) {
+    synchronizer.Push(0u, MakeData(frame));
+  }
+  // Frames pushed out of the ring by newer frames.
+  auto bundles = collector.Get();
+  ASSERT_EQ(bundles.size(), 10u - ring_size);
+  for (auto i = 0u; i < bundles.size(); ++i) {
+    ASSERT_EQ(bundles[i]->GetFrame(), i);
+    ASSERT_FALSE(bundles[i]->IsComplete());
+  }
+  // Older than the frame in its slot.
+  synchronizer.Push(1u, MakeData(2u));
+  ASSERT_EQ(synchronizer.GetDroppedCount(), 1u);
+  synchronizer.Push(1u, MakeData(9u));
+  synchronizer.Flush();
+  bundles = collector.Get();
+  ASSERT_EQ(bundles.size(), 10u);
+  std::set<size_t> frames;
+  for (auto &bundle : bundles) {
+    frames.insert(bundle->GetFrame());
+    ASSERT_EQ(bundle->IsComplete(), bundle->GetFrame() == 9u);
+  }
+  ASSERT_EQ(frames.size(), 10u);
+}
+
+TEST(sensor_group, concurrent_members) {
+  constexpr size_t number_of_members = 4u;
+  constexpr size_t number_of_frames = 20000u;
+  Collector collector;
+  FrameSynchronizer synchronizer(number_of_members, 0ms, 64u, collector.MakeCallback());
+  {
+    ThreadGroup threads;
+    for (auto index = 0u; index < number_of_members; ++index) {
+      threads.CreateThread([&, index]() {
+        for (auto frame = 0u; frame < number_of_frames; ++frame) {
+          synchronizer.Push(index, MakeData(frame));
+          if ((frame % 256u) == 0u) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+  }
+  synchronizer.Flush();
+  // Members run at their own pace, so some frames may be incomplete; but
+  // every data object is either delivered once or dropped.
+  size_t delivered = 0u;
+  size_t complete = 0u;
+  std::set<size_t> frames;
+  for (auto &bundle : collector.Get()) {
+    ASSERT_TRUE(frames.insert(bundle->GetFrame()).second);
+    for (auto &data : *bundle) {
+      if (data != nullptr) {
+        ASSERT_EQ(data->GetFrame(), bundle->GetFrame());
+        ++delivered;
+      }
+    }
+    complete += bundle->IsComplete() ? 1u : 0u;
+  }
+  ASSERT_EQ(delivered + synchronizer.GetDroppedCount(), number_of_members * number_of_frames);
+  carla::logging::log(complete, "complete bundles out of", number_of_frames, "frames");
+}
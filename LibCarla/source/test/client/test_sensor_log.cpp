@@ -0,0 +1,148 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/sensor/SensorLogReader.h>
+#include <carla/sensor/SensorLogWriter.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+using namespace carla;
+using namespace carla::sensor;
+using util::Random;
+
+static Buffer MakeMessage(uint64_t frame, size_t payload_size) {
+  auto buffer = s11n::SensorHeaderSerializer::Serialize(0u, frame, 0.05 * static_cast<double>(frame), rpc::Transform{});
+  const auto header_size = buffer.size();
+  std::vector<unsigned char> message(buffer.begin(), buffer.end());
+  for (auto i = 0u; i < payload_size; ++i) {
+    message.push_back(static_cast<unsigned char>(Random::Uniform(0, 255)));
+  }
+  buffer.copy_from(message);
+  EXPECT_EQ(buffer.size(), header_size + payload_size);
+  return buffer;
+}
+
+static bool Equal(const Buffer &lhs, const Buffer &rhs) {
+  return (lhs.size() == rhs.size()) && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+class TemporaryFile {
+public:
+
+  TemporaryFile()
+    : _path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string() + ".log") {}
+
+  ~TemporaryFile() {
+    boost::filesystem::remove(_path);
+  }
+
+  const std::string &path() const {
+    return _path;
+  }
+
+private:
+
+  std::string _path;
+};
+
+TEST(sensor_log, write_and_read) {
+  TemporaryFile file;
+  constexpr auto number_of_frames = 20u;
+  const std::vector<uint32_t> sensor_ids = {42u, 7u, 1000u};
+  std::map<std::pair<uint32_t, uint64_t>, Buffer> messages;
+  {
+    SensorLogWriter writer(file.path());
+    for (auto frame = 100u; frame < 100u + number_of_frames; ++frame) {
+      for (auto id : sensor_ids) {
+        auto message = MakeMessage(frame, static_cast<size_t>(Random::Uniform(0, 1001)));
+        writer.Write(id, message);
+        messages.emplace(std::make_pair(id, frame), std::move(message));
+      }
+    }
+    ASSERT_EQ(writer.GetNumberOfRecords(), messages.size());
+  }
+
+  Buffer kept_alive;
+  {
+    SensorLogReader reader(file.path());
+    ASSERT_EQ(reader.size(), messages.size());
+    ASSERT_EQ(reader.GetSensorIds(), (std::vector<uint32_t>{7u, 42u, 1000u}));
+    for (auto id : sensor_ids) {
+      auto entries = reader.GetEntries(id);
+      ASSERT_EQ(std::distance(entries.first, entries.second), number_of_frames);
+      ASSERT_TRUE(std::is_sorted(entries.first, entries.second, [](const auto &lhs, const auto &rhs) {
+        return lhs.frame < rhs.frame;
+      }));
+    }
+    ASSERT_EQ(std::distance(reader.GetEntries(8u).first, reader.GetEntries(8u).second), 0);
+    for (auto &item : messages) {
+      auto entry = reader.Find(item.first.first, item.first.second);
+      ASSERT_TRUE(entry.has_value());
+      ASSERT_EQ(entry->offset % SensorLogFormat::alignment, 0u);
+      auto buffer = reader.GetBuffer(*entry);
+      ASSERT_TRUE(Equal(buffer, item.second));
+      // No copies, the buffers point to the mapped file.
+      ASSERT_EQ(reader.GetBuffer(*entry).data(), buffer.data());
+    }
+    ASSERT_FALSE(reader.Find(42u, 99u).has_value());
+    kept_alive = reader.GetBuffer(*reader.Find(7u, 105u));
+  }
+  // The mapping outlives the reader.
+  ASSERT_TRUE(Equal(kept_alive, messages.at(std::make_pair(7u, 105u))));
+}
+
+TEST(sensor_log, recover_without_index) {
+  TemporaryFile file;
+  std::vector<Buffer> messages;
+  {
+    SensorLogWriter writer(file.path());
+    for (auto frame = 0u; frame < 10u; ++frame) {
+      messages.emplace_back(MakeMessage(frame, 10u * frame + 1u));
+      writer.Write(3u, messages.back());
+    }
+  }
+  uint64_t truncated_size;
+  {
+    SensorLogReader reader(file.path());
+    // Keep half of the last record, drop the index.
+    const auto &last = reader.GetIndex().back();
+    truncated_size = last.offset + last.size / 2u;
+  }
+  boost::filesystem::resize_file(file.path(), truncated_size);
+  SensorLogReader reader(file.path());
+  ASSERT_EQ(reader.size(), messages.size() - 1u);
+  for (auto i = 0u; i < reader.size(); ++i) {
+    const auto &entry = reader.GetIndex()[i];
+    ASSERT_EQ(entry.frame, i);
+    ASSERT_TRUE(Equal(reader.GetBuffer(entry), messages[i]));
+  }
+}
+
+TEST(sensor_log, invalid_input) {
+  TemporaryFile file;
+  {
+    std::ofstream out(file.path());
+    out << "not a sensor log, just some text";
+  }
+  ASSERT_THROW(SensorLogReader{file.path()}, std::runtime_error);
+  ASSERT_THROW(SensorLogReader{file.path() + ".missing"}, std::runtime_error);
+  SensorLogWriter writer(file.path());
+  ASSERT_THROW(writer.Write(1u, Buffer(std::string("short"))), std::invalid_argument);
+  writer.Close();
+  ASSERT_THROW(writer.Write(1u, MakeMessage(1u, 1u)), std::runtime_error);
+  SensorLogReader reader(file.path());
+  ASSERT_EQ(reader.size(), 0u);
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/sensor/CompositeSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <array>
+#include <random>
+#include <vector>
+
+using namespace carla;
+using namespace carla::sensor;
+
+namespace {
+
+  constexpr size_t MAX_SENSORS = 64u;
+
+  std::array<size_t, MAX_SENSORS> calls{};
+
+  template <size_t N>
+  class FakeSensor {};
+
+  template <size_t N>
+  class FakeSerializer {
+  public:
+
+    static SharedPtr<SensorData> Deserialize(RawData &&) {
+      ++calls[N];
+      return nullptr;
+    }
+  };
+
+  template <size_t... Is>
+  CompositeSerializer<std::pair<FakeSensor<Is> *, FakeSerializer<Is>>...> MakeRegistry(std::index_sequence<Is...>);
+
+  template <size_t Size>
+  using Registry = decltype(MakeRegistry(std::make_index_sequence<Size>()));
+
+} // namespace
+
+static std::vector<Buffer> MakeMessages(size_t number_of_messages, size_t number_of_types) {
+  std::mt19937 engine(42u);
+  std::uniform_int_distribution<size_t> type_id(0u, number_of_types - 1u);
+  std::vector<Buffer> messages;
+  messages.reserve(number_of_messages);
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    messages.emplace_back(s11n::SensorHeaderSerializer::Serialize(type_id(engine), i, 0.0, rpc::Transform{}));
+  }
+  return messages;
+}
+
+TEST(sensor_registry, type_ids) {
+  using R = Registry<3u>;
+  static_assert(R::size() == 3u, "Invalid size");
+  static_assert(R::get<FakeSensor<0u> *>::index == 0u, "Invalid type id");
+  static_assert(R::get<FakeSensor<2u> *>::index == 2u, "Invalid type id");
+  static_assert(std::is_same<R::get_by_index<1u>::type, FakeSerializer<1u>>::value, "Invalid serializer");
+  static_assert(std::is_same<R::get<FakeSensor<5u> *>::type, void>::value, "Unknown keys map to void");
+}
+
+TEST(sensor_registry, dispatch) {
+  calls.fill(0u);
+  for (auto type_id : {0u, 2u, 2u, 7u, 7u, 7u}) {
+    Registry<8u>::Deserialize(s11n::SensorHeaderSerializer::Serialize(type_id, 0u, 0.0, rpc::Transform{}));
+  }
+  ASSERT_EQ(calls[0u], 1u);
+  ASSERT_EQ(calls[1u], 0u);
+  ASSERT_EQ(calls[2u], 2u);
+  ASSERT_EQ(calls[7u], 3u);
+  // Unknown type ids are ignored.
+  auto data = Registry<8u>::Deserialize(s11n::SensorHeaderSerializer::Serialize(8u, 0u, 0.0, rpc::Transform{}));
+  ASSERT_EQ(data, nullptr);
+  ASSERT_EQ(calls[8u], 0u);
+}
+
+template <size_t Size>
+static void Benchmark() {
+  constexpr size_t number_of_messages = 1000000u;
+  auto messages = MakeMessages(number_of_messages, Size);
+  calls.fill(0u);
+  StopWatch stop_watch;
+  for (auto &message : messages) {
+    Registry<Size>::Deserialize(std::move(message));
+  }
+  const auto elapsed = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+  size_t total = 0u;
+  for (auto count : calls) {
+    total += count;
+  }
+  ASSERT_EQ(total, number_of_messages);
+  carla::logging::log(
+      Size, "sensor types:",
+      1e3 * static_cast<double>(elapsed) / static_cast<double>(number_of_messages),
+      "ns per message");
+}
+
+TEST(sensor_registry, benchmark) {
+  Benchmark<4u>();
+  Benchmark<16u>();
+  Benchmark<MAX_SENSORS>();
+}
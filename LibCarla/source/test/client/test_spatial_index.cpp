@@ -0,0 +1,219 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/StopWatch.h>
+#include <carla/client/detail/ActorSpatialIndex.h>
+#include <carla/geom/Math.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace carla;
+using namespace carla::geom;
+using carla::client::detail::ActorSpatialIndex;
+using util::Random;
+
+using Items = std::vector<ActorSpatialIndex::Item>;
+
+static Items MakeItems(size_t count, float extent) {
+  Items items;
+  items.reserve(count);
+  for (auto i = 0u; i < count; ++i) {
+    auto location = Random::Location(-extent, extent);
+    location.z *= 0.01f;
+    items.push_back({i + 1u, location});
+  }
+  return items;
+}
+
+static std::vector<ActorId> BruteForceRadius(const Items &items, const Location &center, float radius) {
+  std::vector<ActorId> result;
+  for (auto &item : items) {
+    if (Math::DistanceSquared(item.location, center) <= radius * radius) {
+      result.emplace_back(item.id);
+    }
+  }
+  return result;
+}
+
+static std::vector<ActorId> BruteForceKNearest(const Items &items, const Location &point, size_t k) {
+  std::vector<std::pair<float, ActorId>> sorted;
+  for (auto &item : items) {
+    sorted.emplace_back(Math::DistanceSquared(item.location, point), item.id);
+  }
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<ActorId> result;
+  for (auto i = 0u; i < std::min(k, sorted.size()); ++i) {
+    result.emplace_back(sorted[i].second);
+  }
+  return result;
+}
+
+static void Sort(std::vector<ActorId> &ids) {
+  std::sort(ids.begin(), ids.end());
+}
+
+TEST(spatial_index, empty) {
+  ActorSpatialIndex index{Items{}};
+  ASSERT_TRUE(index.FindInRadius({0.0f, 0.0f, 0.0f}, 100.0f).empty());
+  ASSERT_TRUE(index.FindInBox(BoundingBox{Location{}, Vector3D{10.0f, 10.0f, 10.0f}}).empty());
+  ASSERT_TRUE(index.FindKNearest({0.0f, 0.0f, 0.0f}, 5u).empty());
+}
+
+TEST(spatial_index, matches_brute_force) {
+  for (auto count : {1u, 7u, 500u, 3000u}) {
+    const auto items = MakeItems(count, 300.0f);
+    ActorSpatialIndex index{items};
+    ASSERT_EQ(index.size(), items.size());
+    for (auto i = 0u; i < 200u; ++i) {
+      // Include query points outside the grid.
+      const auto point = Random::Location(-400.0f, 400.0f);
+      const auto radius = static_cast<float>(Random::Uniform(0.0, 80.0));
+
+      auto expected = BruteForceRadius(items, point, radius);
+      auto result = index.FindInRadius(point, radius);
+      Sort(expected);
+      Sort(result);
+      ASSERT_EQ(result, expected);
+
+      const Vector3D extent{radius, 0.5f * radius, 10.0f};
+      std::vector<ActorId> expected_box;
+      for (auto &item : items) {
+        const auto d = item.location - point;
+        if (std::abs(d.x) <= extent.x && std::abs(d.y) <= extent.y && std::abs(d.z) <= extent.z) {
+          expected_box.emplace_back(item.id);
+        }
+      }
+      auto result_box = index.FindInBox(BoundingBox{point, extent});
+      Sort(expected_box);
+      Sort(result_box);
+      ASSERT_EQ(result_box, expected_box);
+
+      const auto k = static_cast<size_t>(Random::Uniform(1.0, 20.0));
+      const auto nearest = index.FindKNearest(point, k);
+      const auto expected_nearest = BruteForceKNearest(items, point, k);
+      ASSERT_EQ(nearest.size(), expected_nearest.size());
+      // Compare distances, ties may be resolved in a different order.
+      for (auto j = 0u; j < nearest.size(); ++j) {
+        auto distance = [&](ActorId id) {
+          return Math::DistanceSquared(items[id - 1u].location, point);
+        };
+        ASSERT_FLOAT_EQ(distance(nearest[j]), distance(expected_nearest[j]));
+      }
+    }
+  }
+}
+
+TEST(spatial_index, aligned_actors) {
+  Items items;
+  for (auto i = 0u; i < 1000u; ++i) {
+    items.push_back({i + 1u, Location{static_cast<float>(i), 0.0f, 0.0f}});
+  }
+  ActorSpatialIndex index{items};
+  auto result = index.FindInRadius({500.0f, 0.0f, 0.0f}, 2.5f);
+  Sort(result);
+  ASSERT_EQ(result, (std::vector<ActorId>{499u, 500u, 501u, 502u, 503u}));
+  ASSERT_EQ(index.FindKNearest({-10.0f, 0.0f, 0.0f}, 2u), (std::vector<ActorId>{1u, 2u}));
+}
+
+TEST(spatial_index, huge_and_infinite_queries) {
+  constexpr float infinity = std::numeric_limits<float>::infinity();
+  constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+  const auto items = MakeItems(100u, 300.0f);
+  ActorSpatialIndex index{items};
+  auto check_box = [&](const BoundingBox &box) {
+    const Location min = box.location - Location(box.extent);
+    const Location max = box.location + Location(box.extent);
+    std::vector<ActorId> expected;
+    for (auto &item : items) {
+      const auto &l = item.location;
+      if ((l.x >= min.x) && (l.x <= max.x) &&
+          (l.y >= min.y) && (l.y <= max.y) &&
+          (l.z >= min.z) && (l.z <= max.z)) {
+        expected.emplace_back(item.id);
+      }
+    }
+    auto result = index.FindInBox(box);
+    Sort(expected);
+    Sort(result);
+    ASSERT_EQ(result, expected);
+  };
+  for (auto &center : {Location{}, Location{1e10f, -1e10f, 0.0f}, Location{infinity, 0.0f, 0.0f}}) {
+    for (auto radius : {1e4f, 1e12f, 1e20f, 3e38f, infinity}) {
+      auto expected = BruteForceRadius(items, center, radius);
+      auto result = index.FindInRadius(center, radius);
+      Sort(expected);
+      Sort(result);
+      ASSERT_EQ(result, expected) << center.x << " radius " << radius;
+      check_box(BoundingBox{center, Vector3D{radius, radius, radius}});
+      check_box(BoundingBox{center, Vector3D{radius, 1.0f, radius}});
+    }
+  }
+  ASSERT_EQ(index.FindInRadius(Location{}, 1e12f).size(), items.size());
+  ASSERT_EQ(index.FindInRadius(Location{}, infinity).size(), items.size());
+  ASSERT_EQ(index.FindInBox(BoundingBox{Location{}, Vector3D{infinity, infinity, infinity}}).size(), items.size());
+  // NaN matches nothing.
+  ASSERT_TRUE(index.FindInRadius(Location{}, nan).empty());
+  ASSERT_TRUE(index.FindInRadius(Location{nan, 0.0f, 0.0f}, infinity).empty());
+  ASSERT_TRUE(index.FindInBox(BoundingBox{Location{}, Vector3D{nan, 1.0f, 1.0f}}).empty());
+  ASSERT_TRUE(index.FindKNearest(Location{0.0f, nan, 0.0f}, 5u).empty());
+  ASSERT_EQ(index.FindKNearest(Location{1e30f, 0.0f, 0.0f}, 5u).size(), 5u);
+
+  // Actors spread over a non-finite extent.
+  const Items far{
+      {1u, Location{-3e38f, 0.0f, 0.0f}},
+      {2u, Location{3e38f, 0.0f, 0.0f}},
+      {3u, Location{0.0f, 0.0f, 0.0f}}};
+  ActorSpatialIndex far_index{far};
+  auto result = far_index.FindInRadius(Location{}, 1.0f);
+  ASSERT_EQ(result, (std::vector<ActorId>{3u}));
+  result = far_index.FindInRadius(Location{}, infinity);
+  Sort(result);
+  ASSERT_EQ(result, (std::vector<ActorId>{1u, 2u, 3u}));
+  ASSERT_EQ(far_index.FindKNearest(Location{}, 1u), (std::vector<ActorId>{3u}));
+}
+
+TEST(spatial_index, benchmark) {
+  constexpr auto number_of_queries = 2000u;
+  for (auto count : {1000u, 5000u, 20000u}) {
+    const auto items = MakeItems(count, 1000.0f);
+    std::vector<Location> points;
+    for (auto i = 0u; i < number_of_queries; ++i) {
+      points.emplace_back(Random::Location(-1000.0f, 1000.0f));
+    }
+
+    StopWatch build;
+    ActorSpatialIndex index{items};
+    build.Stop();
+
+    size_t found_index = 0u;
+    StopWatch indexed;
+    for (auto &point : points) {
+      found_index += index.FindInRadius(point, 50.0f).size();
+      found_index += index.FindKNearest(point, 10u).size();
+    }
+    indexed.Stop();
+
+    size_t found_brute_force = 0u;
+    StopWatch brute_force;
+    for (auto &point : points) {
+      found_brute_force += BruteForceRadius(items, point, 50.0f).size();
+      found_brute_force += BruteForceKNearest(items, point, 10u).size();
+    }
+    brute_force.Stop();
+
+    ASSERT_EQ(found_index, found_brute_force);
+    carla::logging::log(
+        count, "actors:",
+        "build", build.GetElapsedTime<std::chrono::microseconds>(), "us,",
+        "grid", indexed.GetElapsedTime<std::chrono::microseconds>(), "us,",
+        "brute force", brute_force.GetElapsedTime<std::chrono::microseconds>(), "us,",
+        "for", number_of_queries, "radius + k-nearest queries");
+  }
+}
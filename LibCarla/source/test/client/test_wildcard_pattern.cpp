@@ -0,0 +1,33 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StringUtil.h>
+#include <carla/WildcardPattern.h>
+
+TEST(wildcard_pattern, match) {
+  using carla::StringUtil;
+  using carla::WildcardPattern;
+  const std::vector<std::string> patterns = {
+      "", "*", "**", "?", "vehicle.*", "*.tesla.*", "*model3", "vehicle.tesla.model3",
+      "vehicle.*.model?", "*a*b*", "v*e*h", "sensor.camera.[rd]*", "walker.pedestrian.000?",
+      "*?", "a*?*b"};
+  const std::vector<std::string> strings = {
+      "", "a", "ab", "aab", "vehicle.tesla.model3", "vehicle.audi.tt", "sensor.camera.rgb",
+      "sensor.camera.depth", "sensor.camera.semantic_segmentation", "walker.pedestrian.0001",
+      "static.prop.vehicle", "vehicle", "vehicle.", "veh", "model3", "acb", "axxb"};
+  for (auto &pattern : patterns) {
+    WildcardPattern compiled(pattern);
+    ASSERT_EQ(WildcardPattern::Get(pattern)->GetPattern(), pattern);
+    for (auto &str : strings) {
+      ASSERT_EQ(compiled.Match(str), StringUtil::Match(str, pattern))
+          << "pattern '" << pattern << "' string '" << str << "'";
+    }
+  }
+  ASSERT_TRUE(WildcardPattern("vehicle.audi.tt").IsLiteral());
+  ASSERT_FALSE(WildcardPattern("vehicle.*").IsLiteral());
+}
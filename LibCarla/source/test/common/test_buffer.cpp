@@ -134,3 +134,25 @@ TEST(buffer, buffer_pool) {
   // Now delete the pool to test the weak reference inside the buffers.
   pool.reset();
 }
+
+TEST(buffer, external_memory) {
+  auto memory = std::make_shared<std::array<unsigned char, 16u>>();
+  memory->fill(42u);
+  std::weak_ptr<std::array<unsigned char, 16u>> weak = memory;
+  {
+    auto *data = memory->data();
+    Buffer buffer(data + 4u, 8u, std::move(memory));
+    ASSERT_EQ(buffer.size(), 8u);
+    ASSERT_EQ(buffer[0u], 42u);
+    ASSERT_FALSE(weak.expired());
+    Buffer moved = std::move(buffer);
+    ASSERT_EQ(moved.data(), data + 4u);
+    // Fits in the external memory.
+    moved.reset(4u);
+    ASSERT_FALSE(weak.expired());
+    // Needs new memory, the external memory is released.
+    moved.reset(32u);
+    ASSERT_TRUE(weak.expired());
+    moved[31u] = 1u;
+  }
+}
@@ -179,3 +179,34 @@ TEST(geom, nearest_point_arc) {
   ASSERT_NEAR(Math::DistanceArcToPoint(Vector3D(1,2,0),
       Vector3D(0,0,0), 1.57f, 0, 1).second, 1.0f, 0.01f);
 }
+
+TEST(geom, slerp) {
+  auto compare = [](Rotation result, Rotation expected) {
+    constexpr float eps = 1e-3f;
+    // Compare orientations, not angles, since several angles are equivalent.
+    auto forward = result.GetForwardVector();
+    auto expected_forward = expected.GetForwardVector();
+    EXPECT_NEAR(forward.x, expected_forward.x, eps);
+    EXPECT_NEAR(forward.y, expected_forward.y, eps);
+    EXPECT_NEAR(forward.z, expected_forward.z, eps);
+    EXPECT_NEAR(std::sin(Math::ToRadians(result.roll)), std::sin(Math::ToRadians(expected.roll)), eps);
+  };
+  const Rotation a{10.0f, 20.0f, 30.0f};
+  const Rotation b{-20.0f, 60.0f, 0.0f};
+  compare(Math::Slerp(a, b, 0.0f), a);
+  compare(Math::Slerp(a, b, 1.0f), b);
+  compare(Math::Slerp(a, a, 0.3f), a);
+  //                  pitch   yaw  roll           pitch   yaw  roll
+  compare(Math::Slerp({0.0f,  0.0f, 0.0f}, {0.0f,  90.0f, 0.0f}, 0.5f), {0.0f,  45.0f, 0.0f});
+  compare(Math::Slerp({0.0f, 170.0f, 0.0f}, {0.0f, -170.0f, 0.0f}, 0.5f), {0.0f, 180.0f, 0.0f});
+  compare(Math::Slerp({0.0f, 0.0f, 0.0f}, {60.0f, 0.0f, 0.0f}, 0.25f), {15.0f, 0.0f, 0.0f});
+  compare(Math::Slerp({0.0f, 0.0f, -40.0f}, {0.0f, 0.0f, 40.0f}, 0.5f), {0.0f, 0.0f, 0.0f});
+}
+
+TEST(geom, lerp) {
+  const Vector3D a{1.0f, 2.0f, 3.0f};
+  const Vector3D b{3.0f, -2.0f, 7.0f};
+  ASSERT_EQ(Math::Lerp(a, b, 0.0f), a);
+  ASSERT_EQ(Math::Lerp(a, b, 1.0f), b);
+  ASSERT_EQ(Math::Lerp(a, b, 0.5f), Vector3D(2.0f, 0.0f, 5.0f));
+}
@@ -6,12 +6,20 @@
 
 #include <carla/FileSystem.h>
 #include <carla/PythonUtil.h>
+#include <carla/client/LaneRouter.h>
 #include <carla/client/Map.h>
+#include <carla/client/MapCache.h>
 #include <carla/client/Waypoint.h>
+#include <carla/client/detail/WaypointProjector.h>
 #include <carla/road/element/LaneMarking.h>
 
-#include <ostream>
+#include <cstring>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
 
 namespace carla {
 namespace client {
@@ -21,6 +29,13 @@ namespace client {
     return out;
   }
 
+  std::ostream &operator<<(std::ostream &out, const MapCache::Stats &stats) {
+    out << "MapCacheStats(hits=" << std::to_string(stats.hits)
+        << ",misses=" << std::to_string(stats.misses)
+        << ",size=" << std::to_string(stats.size) << ')';
+    return out;
+  }
+
   std::ostream &operator<<(std::ostream &out, const Waypoint &waypoint) {
     out << "Waypoint(" << waypoint.GetTransform() << ')';
     return out;
@@ -39,9 +54,45 @@ static void SaveOpenDriveToDisk(const carla::client::Map &self, std::string path
   out << self.GetOpenDrive() << std::endl;
 }
 
+static void SaveCompiledToDisk(const carla::client::Map &self, std::string path) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  carla::FileSystem::ValidateFilePath(path, ".carlamap");
+  self.SaveCompiled(path);
+}
+
+static auto LoadCompiledFromDisk(const std::string &path) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return carla::client::Map::LoadCompiled(path);
+}
+
+// Shared by every map, runs in the calling thread by default.
+static std::mutex WAYPOINT_PROJECTOR_MUTEX;
+static std::shared_ptr<carla::client::detail::WaypointProjector> WAYPOINT_PROJECTOR =
+    std::make_shared<carla::client::detail::WaypointProjector>();
+
+static std::shared_ptr<carla::client::detail::WaypointProjector> GetWaypointProjector() {
+  std::lock_guard<std::mutex> lock(WAYPOINT_PROJECTOR_MUTEX);
+  return WAYPOINT_PROJECTOR;
+}
+
+static void SetWaypointProjectionThreads(size_t worker_threads) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  auto projector = std::make_shared<carla::client::detail::WaypointProjector>(worker_threads);
+  std::lock_guard<std::mutex> lock(WAYPOINT_PROJECTOR_MUTEX);
+  WAYPOINT_PROJECTOR = std::move(projector);
+}
+
+static size_t GetWaypointProjectionThreads() {
+  return GetWaypointProjector()->GetWorkerThreads();
+}
+
 static auto GetTopology(const carla::client::Map &self) {
   namespace py = boost::python;
-  auto topology = self.GetTopology();
+  carla::client::Map::TopologyList topology;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    topology = self.GetTopology(*GetWaypointProjector());
+  }
   py::list result;
   for (auto &&pair : topology) {
     result.append(py::make_tuple(pair.first, pair.second));
@@ -49,6 +100,136 @@ static auto GetTopology(const carla::client::Map &self) {
   return result;
 }
 
+static auto GenerateWaypoints(const carla::client::Map &self, double distance) {
+  std::vector<carla::SharedPtr<carla::client::Waypoint>> waypoints;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    waypoints = self.GenerateWaypoints(distance, *GetWaypointProjector());
+  }
+  boost::python::list result;
+  for (auto &&waypoint : waypoints) {
+    result.append(waypoint);
+  }
+  return result;
+}
+
+/// Copy the locations in @a object, either a list of carla.Location or an
+/// object exposing a C-contiguous buffer of float32 x, y, z triples (e.g. a
+/// numpy array of shape (N, 3)).
+static std::vector<carla::geom::Location> GetLocations(const boost::python::object &object) {
+  static_assert(sizeof(carla::geom::Location) == 3u * sizeof(float), "Invalid location size");
+  std::vector<carla::geom::Location> result;
+  if (PyObject_CheckBuffer(object.ptr())) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(object.ptr(), &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) {
+      boost::python::throw_error_already_set();
+    }
+    const std::string format = view.format != nullptr ? view.format : "B";
+    const auto size = static_cast<size_t>(view.len);
+    const bool is_valid =
+        (view.itemsize == sizeof(float)) &&
+        ((format == "f") || (format == "<f") || (format == "=f")) &&
+        (size % sizeof(carla::geom::Location) == 0u);
+    if (is_valid) {
+      result.resize(size / sizeof(carla::geom::Location));
+      if (size > 0u) {
+        std::memcpy(result.data(), view.buf, size);
+      }
+    }
+    PyBuffer_Release(&view);
+    if (!is_valid) {
+      throw std::invalid_argument("locations buffer must hold float32 x, y, z triples");
+    }
+  } else {
+    result.assign(
+        boost::python::stl_input_iterator<carla::geom::Location>(object),
+        boost::python::stl_input_iterator<carla::geom::Location>());
+  }
+  return result;
+}
+
+/// Layout of each waypoint returned by Map.get_waypoints, lane_id is zero if
+/// there is no waypoint for the location.
+struct WaypointRecord {
+  uint32_t road_id;
+  uint32_t section_id;
+  int32_t lane_id;
+  uint32_t reserved;
+  double s;
+};
+
+static_assert(sizeof(WaypointRecord) == 24u, "Invalid waypoint record size");
+
+static auto GetWaypoints(
+    const carla::client::Map &self,
+    const boost::python::object &locations,
+    bool project_to_road,
+    uint32_t lane_type) {
+  const auto input = GetLocations(locations);
+  std::vector<WaypointRecord> records;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    auto projector = GetWaypointProjector();
+    const auto *begin = input.data();
+    const auto *end = begin + input.size();
+    const auto waypoints = project_to_road ?
+        projector->GetClosestWaypointsOnRoad(self.GetMap(), begin, end, lane_type) :
+        projector->GetWaypoints(self.GetMap(), begin, end, lane_type);
+    records.reserve(waypoints.size());
+    for (auto &waypoint : waypoints) {
+      records.emplace_back(waypoint.has_value() ?
+          WaypointRecord{waypoint->road_id, waypoint->section_id, waypoint->lane_id, 0u, waypoint->s} :
+          WaypointRecord{0u, 0u, 0, 0u, 0.0});
+    }
+  }
+  auto *ptr = PyBytes_FromStringAndSize(
+      reinterpret_cast<const char *>(records.data()),
+      static_cast<Py_ssize_t>(sizeof(WaypointRecord) * records.size()));
+  return boost::python::object(boost::python::handle<>(ptr));
+}
+
+static auto GetWaypoint(
+    const carla::client::Map &self,
+    const carla::geom::Location &location,
+    bool project_to_road,
+    uint32_t lane_type,
+    const boost::python::object &hint) {
+  if (hint.is_none()) {
+    return self.GetWaypoint(location, project_to_road, lane_type);
+  }
+  const carla::client::Waypoint &hint_waypoint =
+      boost::python::extract<const carla::client::Waypoint &>(hint);
+  return self.GetWaypoint(location, hint_waypoint, project_to_road, lane_type);
+}
+
+static carla::SharedPtr<carla::client::LaneRouter> MakeLaneRouter(
+    const carla::SharedPtr<carla::client::Map> &map,
+    double lane_change_cost) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return carla::MakeShared<carla::client::LaneRouter>(map, lane_change_cost);
+}
+
+static void BuildContractionHierarchy(carla::client::LaneRouter &self) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  self.BuildContractionHierarchy();
+}
+
+static boost::python::list FindRoute(
+    const carla::client::LaneRouter &self,
+    const carla::client::Waypoint &origin,
+    const carla::client::Waypoint &destination) {
+  std::vector<carla::SharedPtr<carla::client::Waypoint>> route;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    route = self.FindRoute(origin, destination);
+  }
+  boost::python::list result;
+  for (auto &&waypoint : route) {
+    result.append(waypoint);
+  }
+  return result;
+}
+
 static carla::geom::GeoLocation ToGeolocation(
     const carla::client::Map &self,
     const carla::geom::Location &location) {
@@ -129,12 +310,38 @@ void export_map() {
     .def(init<std::string, std::string>((arg("name"), arg("xodr_content"))))
     .add_property("name", CALL_RETURNING_COPY(cc::Map, GetName))
     .def("get_spawn_points", CALL_RETURNING_LIST(cc::Map, GetRecommendedSpawnPoints))
-    .def("get_waypoint", &cc::Map::GetWaypoint, (arg("location"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
+    .def("get_waypoint", &GetWaypoint, (arg("location"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving, arg("hint")=object()))
+    .def("get_waypoints", &GetWaypoints, (arg("locations"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
+    .def("set_waypoint_projection_threads", &SetWaypointProjectionThreads, (arg("worker_threads")))
+    .staticmethod("set_waypoint_projection_threads")
+    .def("get_waypoint_projection_threads", &GetWaypointProjectionThreads)
+    .staticmethod("get_waypoint_projection_threads")
     .def("get_topology", &GetTopology)
-    .def("generate_waypoints", CALL_RETURNING_LIST_1(cc::Map, GenerateWaypoints, double), (args("distance")))
+    .def("generate_waypoints", &GenerateWaypoints, (args("distance")))
     .def("transform_to_geolocation", &ToGeolocation, (arg("location")))
     .def("to_opendrive", CALL_RETURNING_COPY(cc::Map, GetOpenDrive))
     .def("save_to_disk", &SaveOpenDriveToDisk, (arg("path")=""))
+    .def("save_compiled", &SaveCompiledToDisk, (arg("path")))
+    .def("load_compiled", &LoadCompiledFromDisk, (arg("path")))
+    .staticmethod("load_compiled")
+    .def("get_cache_stats", &cc::MapCache::GetStats)
+    .staticmethod("get_cache_stats")
+    .def(self_ns::str(self_ns::self))
+  ;
+
+  class_<cc::LaneRouter, boost::noncopyable, boost::shared_ptr<cc::LaneRouter>>("LaneRouter", no_init)
+    .def("__init__", make_constructor(&MakeLaneRouter, default_call_policies(), (arg("map"), arg("lane_change_cost")=cr::LaneGraph::DEFAULT_LANE_CHANGE_COST)))
+    .add_property("number_of_lanes", +[](const cc::LaneRouter &self) { return self.GetGraph().GetNumberOfNodes(); })
+    .add_property("lane_change_cost", +[](const cc::LaneRouter &self) { return self.GetGraph().GetLaneChangeCost(); })
+    .def("build_contraction_hierarchy", &BuildContractionHierarchy)
+    .def("has_contraction_hierarchy", &cc::LaneRouter::HasContractionHierarchy)
+    .def("find_route", &FindRoute, (arg("origin"), arg("destination")))
+  ;
+
+  class_<cc::MapCache::Stats>("MapCacheStats", no_init)
+    .def_readonly("hits", &cc::MapCache::Stats::hits)
+    .def_readonly("misses", &cc::MapCache::Stats::misses)
+    .def_readonly("size", &cc::MapCache::Stats::size)
     .def(self_ns::str(self_ns::self))
   ;
 
@@ -165,6 +372,8 @@ void export_map() {
     .add_property("right_lane_marking", CALL_RETURNING_OPTIONAL(cc::Waypoint, GetRightLaneMarking))
     .add_property("left_lane_marking", CALL_RETURNING_OPTIONAL(cc::Waypoint, GetLeftLaneMarking))
     .def("next", CALL_RETURNING_LIST_1(cc::Waypoint, GetNext, double), (args("distance")))
+    .def("previous", CALL_RETURNING_LIST_1(cc::Waypoint, GetPrevious, double), (args("distance")))
+    .def("next_until_lane_end", CALL_RETURNING_LIST_1(cc::Waypoint, GetNextUntilLaneEnd, double), (args("distance")))
     .def("get_right_lane", &cc::Waypoint::GetRight)
     .def("get_left_lane", &cc::Waypoint::GetLeft)
     .def(self_ns::str(self_ns::self))
@@ -8,12 +8,29 @@
 #include <carla/client/ClientSideSensor.h>
 #include <carla/client/LaneInvasionSensor.h>
 #include <carla/client/Sensor.h>
+#include <carla/client/SensorBundle.h>
+#include <carla/client/SensorGroup.h>
 #include <carla/client/ServerSideSensor.h>
 
 static void SubscribeToStream(carla::client::Sensor &self, boost::python::object callback) {
   self.Listen(MakeCallback(std::move(callback)));
 }
 
+static void SubscribeToGroup(carla::client::SensorGroup &self, boost::python::object callback) {
+  self.Listen(MakeCallback(std::move(callback)));
+}
+
+static auto MakeSensorGroup(boost::python::object sensors, double timeout, size_t ring_size) {
+  using SensorPtr = carla::SharedPtr<carla::client::Sensor>;
+  std::vector<SensorPtr> list{
+      boost::python::stl_input_iterator<SensorPtr>(sensors),
+      boost::python::stl_input_iterator<SensorPtr>()};
+  return boost::make_shared<carla::client::SensorGroup>(
+      std::move(list),
+      TimeDurationFromSeconds(timeout),
+      ring_size);
+}
+
 void export_sensor() {
   using namespace boost::python;
   namespace cc = carla::client;
@@ -40,4 +57,30 @@ void export_sensor() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  class_<cc::SensorBundle, boost::noncopyable, boost::shared_ptr<cc::SensorBundle>>("SensorBundle", no_init)
+    .add_property("frame", &cc::SensorBundle::GetFrame)
+    .add_property("is_complete", &cc::SensorBundle::IsComplete)
+    .def("__getitem__", &cc::SensorBundle::at, return_value_policy<copy_const_reference>())
+    .def("__len__", &cc::SensorBundle::size)
+    .def("__iter__", range(&cc::SensorBundle::begin, &cc::SensorBundle::end))
+  ;
+
+  class_<cc::SensorGroup, boost::noncopyable, boost::shared_ptr<cc::SensorGroup>>("SensorGroup", no_init)
+    .def("__init__", make_constructor(
+        &MakeSensorGroup,
+        default_call_policies(),
+        (arg("sensors"), arg("timeout")=1.0, arg("ring_size")=8u)))
+    .add_property("sensors", +[](const cc::SensorGroup &self) {
+      boost::python::list result;
+      for (auto &sensor : self.GetSensors()) {
+        result.append(sensor);
+      }
+      return result;
+    })
+    .add_property("is_listening", &cc::SensorGroup::IsListening)
+    .add_property("dropped_count", &cc::SensorGroup::GetDroppedCount)
+    .def("listen", &SubscribeToGroup, (arg("callback")))
+    .def("stop", &cc::SensorGroup::Stop)
+  ;
+
 }
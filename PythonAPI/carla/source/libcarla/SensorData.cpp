@@ -4,10 +4,13 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
+#include <carla/AsyncDiskWriter.h>
 #include <carla/PythonUtil.h>
 #include <carla/image/ImageConverter.h>
 #include <carla/image/ImageIO.h>
 #include <carla/image/ImageView.h>
+#include <carla/image/ParallelImageConverter.h>
+#include <carla/pointcloud/PointCloudFilter.h>
 #include <carla/pointcloud/PointCloudIO.h>
 #include <carla/sensor/SensorData.h>
 #include <carla/sensor/data/CollisionEvent.h>
@@ -20,6 +23,8 @@
 
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <iostream>
 
@@ -97,10 +102,9 @@ enum class EColorConverter {
   CityScapesPalette
 };
 
-template <typename T>
-static auto GetRawDataAsBuffer(T &self) {
-  auto *data = reinterpret_cast<unsigned char *>(self.data());
-  auto size = static_cast<Py_ssize_t>(sizeof(typename T::value_type) * self.size());
+static auto GetMemoryAsBuffer(const void *begin, size_t size_in_bytes) {
+  auto *data = reinterpret_cast<unsigned char *>(const_cast<void *>(begin));
+  auto size = static_cast<Py_ssize_t>(size_in_bytes);
 #if PY_MAJOR_VERSION >= 3
   auto *ptr = PyMemoryView_FromMemory(reinterpret_cast<char *>(data), size, PyBUF_READ);
 #else
@@ -109,20 +113,74 @@ static auto GetRawDataAsBuffer(T &self) {
   return boost::python::object(boost::python::handle<>(ptr));
 }
 
+template <typename T>
+static auto GetRawDataAsBuffer(T &self) {
+  return GetMemoryAsBuffer(self.data(), sizeof(typename T::value_type) * self.size());
+}
+
+template <typename ListViewT>
+static auto GetListViewAsBuffer(const ListViewT &view) {
+  return GetMemoryAsBuffer(view.begin(), sizeof(*view.begin()) * view.size());
+}
+
+// Shared by every image, images are converted in the calling thread if null.
+static std::mutex IMAGE_CONVERTER_MUTEX;
+static std::shared_ptr<carla::image::ParallelImageConverter> IMAGE_CONVERTER;
+
+static std::shared_ptr<carla::image::ParallelImageConverter> GetImageConverter() {
+  std::lock_guard<std::mutex> lock(IMAGE_CONVERTER_MUTEX);
+  return IMAGE_CONVERTER;
+}
+
+static void SetImageConversionThreads(size_t worker_threads) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  auto converter = worker_threads > 0u ?
+      std::make_shared<carla::image::ParallelImageConverter>(worker_threads) :
+      nullptr;
+  std::lock_guard<std::mutex> lock(IMAGE_CONVERTER_MUTEX);
+  IMAGE_CONVERTER = std::move(converter);
+}
+
+static size_t GetImageConversionThreads() {
+  auto converter = GetImageConverter();
+  return converter != nullptr ? converter->GetWorkerThreads() : 0u;
+}
+
+template <typename T, typename CC>
+static void ConvertImageInPlace(T &self, CC cc) {
+  auto converter = GetImageConverter();
+  if (converter != nullptr) {
+    converter->ConvertInPlace(self, cc);
+  } else {
+    carla::image::ImageConverter::ConvertInPlace(self, cc);
+  }
+}
+
+template <typename ViewT>
+static std::string WriteConvertedView(std::string path, const ViewT &view) {
+  auto converter = GetImageConverter();
+  if (converter == nullptr) {
+    return carla::image::ImageIO::WriteView(std::move(path), view);
+  }
+  // Convert in parallel into a temporary image, then encode it.
+  boost::gil::image<typename ViewT::value_type, false> image(view.dimensions());
+  converter->CopyPixels(view, boost::gil::view(image));
+  return carla::image::ImageIO::WriteView(std::move(path), boost::gil::const_view(image));
+}
+
 template <typename T>
 static void ConvertImage(T &self, EColorConverter cc) {
   carla::PythonUtil::ReleaseGIL unlock;
   using namespace carla::image;
-  auto view = ImageView::MakeView(self);
   switch (cc) {
     case EColorConverter::Depth:
-      ImageConverter::ConvertInPlace(view, ColorConverter::Depth());
+      ConvertImageInPlace(self, ColorConverter::Depth());
       break;
     case EColorConverter::LogarithmicDepth:
-      ImageConverter::ConvertInPlace(view, ColorConverter::LogarithmicDepth());
+      ConvertImageInPlace(self, ColorConverter::LogarithmicDepth());
       break;
     case EColorConverter::CityScapesPalette:
-      ImageConverter::ConvertInPlace(view, ColorConverter::CityScapesPalette());
+      ConvertImageInPlace(self, ColorConverter::CityScapesPalette());
       break;
     case EColorConverter::Raw:
       break; // ignore.
@@ -131,26 +189,24 @@ static void ConvertImage(T &self, EColorConverter cc) {
   }
 }
 
-template <typename T>
-static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc) {
-  carla::PythonUtil::ReleaseGIL unlock;
+template <typename ViewT>
+static std::string SaveViewToDisk(const ViewT &view, std::string path, EColorConverter cc) {
   using namespace carla::image;
-  auto view = ImageView::MakeView(self);
   switch (cc) {
     case EColorConverter::Raw:
       return ImageIO::WriteView(
           std::move(path),
           view);
     case EColorConverter::Depth:
-      return ImageIO::WriteView(
+      return WriteConvertedView(
           std::move(path),
           ImageView::MakeColorConvertedView(view, ColorConverter::Depth()));
     case EColorConverter::LogarithmicDepth:
-      return ImageIO::WriteView(
+      return WriteConvertedView(
           std::move(path),
           ImageView::MakeColorConvertedView(view, ColorConverter::LogarithmicDepth()));
     case EColorConverter::CityScapesPalette:
-      return ImageIO::WriteView(
+      return WriteConvertedView(
           std::move(path),
           ImageView::MakeColorConvertedView(view, ColorConverter::CityScapesPalette()));
     default:
@@ -159,9 +215,165 @@ static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc
 }
 
 template <typename T>
-static std::string SavePointCloudToDisk(T &self, std::string path) {
+static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return SaveViewToDisk(carla::image::ImageView::MakeView(self), std::move(path), cc);
+}
+
+static std::vector<uint32_t> GetPointsPerChannel(const carla::sensor::data::LidarMeasurement &measurement) {
+  std::vector<uint32_t> points_per_channel(measurement.GetChannelCount());
+  for (auto i = 0u; i < points_per_channel.size(); ++i) {
+    points_per_channel[i] = measurement.GetPointCount(i);
+  }
+  return points_per_channel;
+}
+
+/// Empty if the Lidar does not send intensities.
+static std::vector<float> GetIntensityColumn(const carla::sensor::data::LidarMeasurement &measurement) {
+  const auto intensity = measurement.GetIntensity();
+  return {intensity.begin(), intensity.end()};
+}
+
+template <typename T>
+static auto GetVectorAsBytes(const std::vector<T> &data) {
+  auto *ptr = PyBytes_FromStringAndSize(
+      reinterpret_cast<const char *>(data.data()),
+      static_cast<Py_ssize_t>(sizeof(T) * data.size()));
+  return boost::python::object(boost::python::handle<>(ptr));
+}
+
+// Shared by every lidar measurement, runs in the calling thread by default.
+static std::mutex POINT_CLOUD_FILTER_MUTEX;
+static std::shared_ptr<carla::pointcloud::PointCloudFilter> POINT_CLOUD_FILTER =
+    std::make_shared<carla::pointcloud::PointCloudFilter>();
+
+static std::shared_ptr<carla::pointcloud::PointCloudFilter> GetPointCloudFilter() {
+  std::lock_guard<std::mutex> lock(POINT_CLOUD_FILTER_MUTEX);
+  return POINT_CLOUD_FILTER;
+}
+
+static void SetPointCloudProcessingThreads(size_t worker_threads) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  auto filter = std::make_shared<carla::pointcloud::PointCloudFilter>(worker_threads);
+  std::lock_guard<std::mutex> lock(POINT_CLOUD_FILTER_MUTEX);
+  POINT_CLOUD_FILTER = std::move(filter);
+}
+
+static size_t GetPointCloudProcessingThreads() {
+  return GetPointCloudFilter()->GetWorkerThreads();
+}
+
+// Run functor(filter, begin, end) on the points of self without the
+// GIL, and return the resulting vector as bytes.
+template <typename FunctorT>
+static auto FilterPointCloud(const carla::sensor::data::LidarMeasurement &self, FunctorT &&functor) {
+  using ResultT = decltype(functor(
+      std::declval<carla::pointcloud::PointCloudFilter &>(),
+      self.data(),
+      self.data()));
+  ResultT result;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    auto filter = GetPointCloudFilter();
+    result = functor(*filter, self.data(), self.data() + self.size());
+  }
+  return GetVectorAsBytes(result);
+}
+
+static auto CropBox(
+    const carla::sensor::data::LidarMeasurement &self,
+    const carla::geom::Location &min,
+    const carla::geom::Location &max,
+    bool negative) {
+  return FilterPointCloud(self, [&](auto &filter, auto *begin, auto *end) {
+    return filter.Gather(begin, filter.CropBox(begin, end, min, max, negative));
+  });
+}
+
+static auto CropRadius(
+    const carla::sensor::data::LidarMeasurement &self,
+    float radius,
+    const carla::geom::Location &center,
+    bool negative) {
+  return FilterPointCloud(self, [&](auto &filter, auto *begin, auto *end) {
+    return filter.Gather(begin, filter.CropRadius(begin, end, center, radius, negative));
+  });
+}
+
+static auto VoxelDownsample(const carla::sensor::data::LidarMeasurement &self, float voxel_size) {
+  if (!(voxel_size > 0.0f)) {
+    throw std::invalid_argument("voxel_size must be positive");
+  }
+  return FilterPointCloud(self, [&](auto &filter, auto *begin, auto *end) {
+    return filter.VoxelDownsample(begin, end, voxel_size);
+  });
+}
+
+static auto ProjectToRangeImage(const carla::sensor::data::LidarMeasurement &self, size_t width) {
+  if (width == 0u) {
+    throw std::invalid_argument("width must be positive");
+  }
+  const auto points_per_channel = GetPointsPerChannel(self);
+  return FilterPointCloud(self, [&](auto &filter, auto *begin, auto *end) {
+    return filter.ProjectToRangeImage(begin, end, points_per_channel, width);
+  });
+}
+
+template <typename T>
+static std::string SavePointCloudToDisk(
+    T &self,
+    std::string path,
+    carla::pointcloud::PointCloudIO::Format format) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return carla::pointcloud::PointCloudIO::SaveToDisk(
+      std::move(path),
+      self.begin(),
+      self.end(),
+      format,
+      GetPointsPerChannel(self),
+      GetIntensityColumn(self));
+}
+
+static bool SaveImageAsync(
+    carla::AsyncDiskWriter &self,
+    const carla::sensor::data::Image &image,
+    std::string path,
+    EColorConverter cc) {
   carla::PythonUtil::ReleaseGIL unlock;
-  return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end());
+  // Copy the pixels, the image may be modified or released meanwhile.
+  carla::Buffer data(reinterpret_cast<const unsigned char *>(image.data()), sizeof(carla::sensor::data::Color) * image.size());
+  const auto width = image.GetWidth();
+  const auto height = image.GetHeight();
+  return self.Write(std::move(data), std::move(path), [=](const carla::Buffer &buffer, const std::string &file) {
+    auto view = boost::gil::interleaved_view(
+        width,
+        height,
+        reinterpret_cast<const boost::gil::bgra8c_pixel_t *>(buffer.data()),
+        sizeof(carla::sensor::data::Color) * width);
+    SaveViewToDisk(view, file, cc);
+  });
+}
+
+static bool SavePointCloudAsync(
+    carla::AsyncDiskWriter &self,
+    const carla::sensor::data::LidarMeasurement &measurement,
+    std::string path,
+    carla::pointcloud::PointCloudIO::Format format) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  using Point = carla::rpc::Location;
+  carla::Buffer data(reinterpret_cast<const unsigned char *>(measurement.data()), sizeof(Point) * measurement.size());
+  auto points_per_channel = GetPointsPerChannel(measurement);
+  auto intensity = GetIntensityColumn(measurement);
+  return self.Write(std::move(data), std::move(path), [=](const carla::Buffer &buffer, const std::string &file) {
+    const auto *begin = reinterpret_cast<const Point *>(buffer.data());
+    carla::pointcloud::PointCloudIO::SaveToDisk(
+        file,
+        begin,
+        begin + buffer.size() / sizeof(Point),
+        format,
+        points_per_channel,
+        intensity);
+  });
 }
 
 void export_sensor_data() {
@@ -192,6 +404,10 @@ void export_sensor_data() {
     .add_property("raw_data", &GetRawDataAsBuffer<csd::Image>)
     .def("convert", &ConvertImage<csd::Image>, (arg("color_converter")))
     .def("save_to_disk", &SaveImageToDisk<csd::Image>, (arg("path"), arg("color_converter")=EColorConverter::Raw))
+    .def("set_conversion_threads", &SetImageConversionThreads, (arg("worker_threads")))
+    .staticmethod("set_conversion_threads")
+    .def("get_conversion_threads", &GetImageConversionThreads)
+    .staticmethod("get_conversion_threads")
     .def("__len__", &csd::Image::size)
     .def("__iter__", iterator<csd::Image>())
     .def("__getitem__", +[](const csd::Image &self, size_t pos) -> csd::Color {
@@ -203,12 +419,64 @@ void export_sensor_data() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  enum_<carla::pointcloud::PointCloudIO::Format>("PointCloudFormat")
+    .value("PlyAscii", carla::pointcloud::PointCloudIO::Format::PlyAscii)
+    .value("PlyBinary", carla::pointcloud::PointCloudIO::Format::PlyBinary)
+    .value("PcdBinary", carla::pointcloud::PointCloudIO::Format::PcdBinary)
+    .value("KittiBin", carla::pointcloud::PointCloudIO::Format::KittiBin)
+  ;
+
+  enum_<carla::AsyncDiskWriter::OverflowPolicy>("DiskWriterOverflowPolicy")
+    .value("Block", carla::AsyncDiskWriter::OverflowPolicy::Block)
+    .value("DropNewest", carla::AsyncDiskWriter::OverflowPolicy::DropNewest)
+    .value("DropOldest", carla::AsyncDiskWriter::OverflowPolicy::DropOldest)
+  ;
+
+  class_<carla::AsyncDiskWriter::Stats>("AsyncDiskWriterStats", no_init)
+    .def_readonly("pending", &carla::AsyncDiskWriter::Stats::pending)
+    .def_readonly("written", &carla::AsyncDiskWriter::Stats::written)
+    .def_readonly("dropped", &carla::AsyncDiskWriter::Stats::dropped)
+    .def_readonly("failed", &carla::AsyncDiskWriter::Stats::failed)
+    .def_readonly("bytes_written", &carla::AsyncDiskWriter::Stats::bytes_written)
+    .def_readonly("throughput", &carla::AsyncDiskWriter::Stats::throughput)
+  ;
+
+  class_<carla::AsyncDiskWriter, boost::noncopyable, boost::shared_ptr<carla::AsyncDiskWriter>>("AsyncDiskWriter",
+      init<size_t, size_t, carla::AsyncDiskWriter::OverflowPolicy>(
+        (arg("worker_threads")=1u,
+         arg("queue_size")=64u,
+         arg("overflow_policy")=carla::AsyncDiskWriter::OverflowPolicy::Block)))
+    .def("save_image", &SaveImageAsync, (arg("image"), arg("path"), arg("color_converter")=EColorConverter::Raw))
+    .def("save_point_cloud", &SavePointCloudAsync, (arg("lidar_measurement"), arg("path"), arg("format")=carla::pointcloud::PointCloudIO::Format::PlyAscii))
+    .def("flush", +[](carla::AsyncDiskWriter &self) {
+      carla::PythonUtil::ReleaseGIL unlock;
+      self.Flush();
+    })
+    .def("get_stats", &carla::AsyncDiskWriter::GetStats)
+  ;
+
   class_<csd::LidarMeasurement, bases<cs::SensorData>, boost::noncopyable, boost::shared_ptr<csd::LidarMeasurement>>("LidarMeasurement", no_init)
     .add_property("horizontal_angle", &csd::LidarMeasurement::GetHorizontalAngle)
     .add_property("channels", &csd::LidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::LidarMeasurement>)
+    .add_property("has_intensity", &csd::LidarMeasurement::HasIntensity)
+    .add_property("has_ring", &csd::LidarMeasurement::HasRing)
+    .add_property("raw_intensity", +[](const csd::LidarMeasurement &self) {
+      return GetListViewAsBuffer(self.GetIntensity());
+    })
+    .add_property("raw_ring", +[](const csd::LidarMeasurement &self) {
+      return GetListViewAsBuffer(self.GetRing());
+    })
     .def("get_point_count", &csd::LidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path"), arg("format")=carla::pointcloud::PointCloudIO::Format::PlyAscii))
+    .def("crop_box", &CropBox, (arg("min"), arg("max"), arg("negative")=false))
+    .def("crop_radius", &CropRadius, (arg("radius"), arg("center")=cr::Location(), arg("negative")=false))
+    .def("voxel_downsample", &VoxelDownsample, (arg("voxel_size")))
+    .def("to_range_image", &ProjectToRangeImage, (arg("width")))
+    .def("set_processing_threads", &SetPointCloudProcessingThreads, (arg("worker_threads")))
+    .staticmethod("set_processing_threads")
+    .def("get_processing_threads", &GetPointCloudProcessingThreads)
+    .staticmethod("get_processing_threads")
     .def("__len__", &csd::LidarMeasurement::size)
     .def("__iter__", iterator<csd::LidarMeasurement>())
     .def("__getitem__", +[](const csd::LidarMeasurement &self, size_t pos) -> cr::Location {
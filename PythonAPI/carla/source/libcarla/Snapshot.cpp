@@ -30,6 +30,7 @@ namespace client {
 void export_snapshot() {
   using namespace boost::python;
   namespace cc = carla::client;
+  namespace cg = carla::geom;
 
   class_<cc::ActorSnapshot>("ActorSnapshot", no_init)
     .def_readonly("id", &cc::ActorSnapshot::id)
@@ -52,6 +53,9 @@ void export_snapshot() {
     /// @}
     .def("has_actor", &cc::WorldSnapshot::Contains, (arg("actor_id")))
     .def("find", CALL_RETURNING_OPTIONAL_1(cc::WorldSnapshot, Find, carla::ActorId), (arg("actor_id")))
+    .def("find_actors_in_radius", CALL_RETURNING_LIST_2(cc::WorldSnapshot, FindActorsInRadius, const cg::Location &, float), (arg("location"), arg("radius")))
+    .def("find_actors_in_box", CALL_RETURNING_LIST_1(cc::WorldSnapshot, FindActorsInBox, const cg::BoundingBox &), (arg("box")))
+    .def("find_k_nearest_actors", CALL_RETURNING_LIST_2(cc::WorldSnapshot, FindKNearestActors, const cg::Location &, size_t), (arg("location"), arg("k")))
     .def("__len__", &cc::WorldSnapshot::size)
     .def("__iter__", range(&cc::WorldSnapshot::begin, &cc::WorldSnapshot::end))
     .def("__eq__", &cc::WorldSnapshot::operator==)
@@ -26,6 +26,17 @@ namespace client {
     return out;
   }
 
+  std::ostream &operator<<(std::ostream &out, const CallbackStats &stats) {
+    out << "CallbackStats(calls=" << std::to_string(stats.calls)
+        << ",dropped=" << std::to_string(stats.dropped)
+        << ",pending=" << std::to_string(stats.pending)
+        << ",average_latency=" << std::to_string(stats.average_latency)
+        << ",max_latency=" << std::to_string(stats.max_latency)
+        << ",average_lag=" << std::to_string(stats.average_lag)
+        << ",max_lag=" << std::to_string(stats.max_lag) << ')';
+    return out;
+  }
+
   std::ostream &operator<<(std::ostream &out, const World &world) {
     out << "World(id=" << world.GetId() << ')';
     return out;
@@ -52,8 +63,17 @@ static auto WaitForTick(const carla::client::World &world, double seconds) {
   return world.WaitForTick(TimeDurationFromSeconds(seconds));
 }
 
-static size_t OnTick(carla::client::World &self, boost::python::object callback) {
-  return self.OnTick(MakeCallback(std::move(callback)));
+static size_t OnTick(
+    carla::client::World &self,
+    boost::python::object callback,
+    carla::client::CallbackExecutor executor,
+    size_t queue_size,
+    carla::client::CallbackOverflowPolicy overflow) {
+  carla::client::CallbackPolicy policy;
+  policy.executor = executor;
+  policy.queue_size = queue_size;
+  policy.overflow = overflow;
+  return self.OnTick(MakeCallback(std::move(callback)), policy);
 }
 
 static auto GetActorsById(carla::client::World &self, const boost::python::list &actor_ids) {
@@ -86,7 +106,7 @@ void export_world() {
     .def(self_ns::str(self_ns::self))
   ;
 
-  class_<cc::ActorList, boost::shared_ptr<cc::ActorList>>("ActorList", no_init)
+  class_<cc::ActorList, boost::noncopyable, boost::shared_ptr<cc::ActorList>>("ActorList", no_init)
     .def("find", &cc::ActorList::Find, (arg("id")))
     .def("filter", &cc::ActorList::Filter, (arg("wildcard_pattern")))
     .def("__getitem__", &cc::ActorList::at)
@@ -115,6 +135,28 @@ void export_world() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  enum_<cc::CallbackExecutor>("CallbackExecutor")
+    .value("Inline", cc::CallbackExecutor::Inline)
+    .value("DedicatedThread", cc::CallbackExecutor::DedicatedThread)
+    .value("SharedPool", cc::CallbackExecutor::SharedPool)
+  ;
+
+  enum_<cc::CallbackOverflowPolicy>("CallbackOverflowPolicy")
+    .value("DropNewest", cc::CallbackOverflowPolicy::DropNewest)
+    .value("DropOldest", cc::CallbackOverflowPolicy::DropOldest)
+  ;
+
+  class_<cc::CallbackStats>("CallbackStats", no_init)
+    .def_readonly("calls", &cc::CallbackStats::calls)
+    .def_readonly("dropped", &cc::CallbackStats::dropped)
+    .def_readonly("pending", &cc::CallbackStats::pending)
+    .def_readonly("average_latency", &cc::CallbackStats::average_latency)
+    .def_readonly("max_latency", &cc::CallbackStats::max_latency)
+    .def_readonly("average_lag", &cc::CallbackStats::average_lag)
+    .def_readonly("max_lag", &cc::CallbackStats::max_lag)
+    .def(self_ns::str(self_ns::self))
+  ;
+
   enum_<cr::AttachmentType>("AttachmentType")
     .value("Rigid", cr::AttachmentType::Rigid)
     .value("SpringArm", cr::AttachmentType::SpringArm)
@@ -147,14 +189,26 @@ void export_world() {
     .def("get_weather", CONST_CALL_WITHOUT_GIL(cc::World, GetWeather))
     .def("set_weather", &cc::World::SetWeather)
     .def("get_snapshot", &cc::World::GetSnapshot)
+    .def("set_snapshot_history_size", &cc::World::SetSnapshotHistorySize, (arg("size")))
+    .def("get_snapshot_history_size", &cc::World::GetSnapshotHistorySize)
+    .def("get_snapshot_by_frame", CALL_RETURNING_OPTIONAL_1(cc::World, GetSnapshotByFrame, size_t), (arg("frame")))
+    .def("get_actor_snapshot_at", +[](const cc::World &self, carla::ActorId id, double elapsed_seconds) {
+      auto snapshot = self.GetActorSnapshotAt(id, elapsed_seconds);
+      return OptionalToPythonObject(snapshot);
+    }, (arg("actor_id"), arg("elapsed_seconds")))
     .def("get_actor", CONST_CALL_WITHOUT_GIL_1(cc::World, GetActor, carla::ActorId), (arg("actor_id")))
     .def("get_actors", CONST_CALL_WITHOUT_GIL(cc::World, GetActors))
     .def("get_actors", &GetActorsById, (arg("actor_ids")))
     .def("spawn_actor", SPAWN_ACTOR_WITHOUT_GIL(SpawnActor))
     .def("try_spawn_actor", SPAWN_ACTOR_WITHOUT_GIL(TrySpawnActor))
     .def("wait_for_tick", &WaitForTick, (arg("seconds")=10.0))
-    .def("on_tick", &OnTick, (arg("callback")))
-    .def("remove_on_tick", &cc::World::RemoveOnTick, (arg("callback_id")))
+    .def("on_tick", &OnTick,
+        (arg("callback"),
+         arg("executor")=cc::CallbackExecutor::Inline,
+         arg("queue_size")=1u,
+         arg("overflow")=cc::CallbackOverflowPolicy::DropOldest))
+    .def("remove_on_tick", CALL_WITHOUT_GIL_1(cc::World, RemoveOnTick, size_t), (arg("callback_id")))
+    .def("get_on_tick_stats", CALL_RETURNING_OPTIONAL_1(cc::World, GetOnTickStats, size_t), (arg("callback_id")))
     .def("tick", CALL_WITHOUT_GIL(cc::World, Tick))
     .def(self_ns::str(self_ns::self))
   ;
@@ -776,9 +776,33 @@ void UActorBlueprintFunctionLibrary::MakeLidarDefinition(
   LowerFOV.Id = TEXT("lower_fov");
   LowerFOV.Type = EActorAttributeType::Float;
   LowerFOV.RecommendedValues = { TEXT("-30.0") };
+  // Atmosphere attenuation rate.
+  FActorVariation AtmospAttenRate;
+  AtmospAttenRate.Id = TEXT("atmosphere_attenuation_rate");
+  AtmospAttenRate.Type = EActorAttributeType::Float;
+  AtmospAttenRate.RecommendedValues = { TEXT("0.004") };
+  // Intensity column.
+  FActorVariation Intensity;
+  Intensity.Id = TEXT("send_intensity");
+  Intensity.Type = EActorAttributeType::Bool;
+  Intensity.RecommendedValues = { TEXT("false") };
+  Intensity.bRestrictToRecommended = false;
+  // Ring column.
+  FActorVariation Ring;
+  Ring.Id = TEXT("send_ring");
+  Ring.Type = EActorAttributeType::Bool;
+  Ring.RecommendedValues = { TEXT("false") };
+  Ring.bRestrictToRecommended = false;
+  // Compact points.
+  FActorVariation CompactPoints;
+  CompactPoints.Id = TEXT("compact_points");
+  CompactPoints.Type = EActorAttributeType::Bool;
+  CompactPoints.RecommendedValues = { TEXT("false") };
+  CompactPoints.bRestrictToRecommended = false;
 
   Definition.Variations.Append(
-      {Channels, Range, PointsPerSecond, Frequency, UpperFOV, LowerFOV});
+      {Channels, Range, PointsPerSecond, Frequency, UpperFOV, LowerFOV,
+       AtmospAttenRate, Intensity, Ring, CompactPoints});
 
   Success = CheckActorDefinition(Definition);
 }
@@ -1370,6 +1394,14 @@ void UActorBlueprintFunctionLibrary::SetLidar(
       RetrieveActorAttributeToFloat("upper_fov", Description.Variations, Lidar.UpperFovLimit);
   Lidar.LowerFovLimit =
       RetrieveActorAttributeToFloat("lower_fov", Description.Variations, Lidar.LowerFovLimit);
+  Lidar.AtmosphereAttenuationRate =
+      RetrieveActorAttributeToFloat("atmosphere_attenuation_rate", Description.Variations, Lidar.AtmosphereAttenuationRate);
+  Lidar.bIntensity =
+      RetrieveActorAttributeToBool("send_intensity", Description.Variations, Lidar.bIntensity);
+  Lidar.bRing =
+      RetrieveActorAttributeToBool("send_ring", Description.Variations, Lidar.bRing);
+  Lidar.bCompactPoints =
+      RetrieveActorAttributeToBool("compact_points", Description.Variations, Lidar.bCompactPoints);
 }
 
 void UActorBlueprintFunctionLibrary::SetGnss(
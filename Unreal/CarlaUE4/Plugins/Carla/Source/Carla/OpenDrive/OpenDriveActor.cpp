@@ -175,12 +175,14 @@ void AOpenDriveActor::BuildRoutes(FString MapName)
     for (auto &&Wp : PredecessorWp.second)
     {
       std::vector<Waypoint> Waypoints;
+      std::vector<Waypoint> Successors;
       auto CurrentWp = Wp;
 
       do
       {
         Waypoints.emplace_back(CurrentWp);
-        const auto Successors = map->GetNext(CurrentWp, RoadAccuracy);
+        Successors.clear();
+        map->GetNext(CurrentWp, RoadAccuracy, Successors);
         if (Successors.empty())
         {
           break;
@@ -39,6 +39,23 @@ struct CARLA_API FLidarDescription
   UPROPERTY(EditAnywhere)
   float LowerFovLimit = -30.0f;
 
+  /// Attenuation of the intensity per meter traveled by the laser.
+  UPROPERTY(EditAnywhere)
+  float AtmosphereAttenuationRate = 0.004f;
+
+  /// Send the intensity of each point.
+  UPROPERTY(EditAnywhere)
+  bool bIntensity = false;
+
+  /// Send the channel (ring) of each point.
+  UPROPERTY(EditAnywhere)
+  bool bRing = false;
+
+  /// Send the points and intensities as 16-bit fixed point, with a
+  /// resolution of Range / 32767.
+  UPROPERTY(EditAnywhere)
+  bool bCompactPoints = false;
+
   /// Wether to show debug points of laser hits in simulator.
   UPROPERTY(EditAnywhere)
   bool ShowDebugPoints = false;
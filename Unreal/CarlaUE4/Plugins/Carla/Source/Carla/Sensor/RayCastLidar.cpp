@@ -39,6 +39,20 @@ void ARayCastLidar::Set(const FLidarDescription &LidarDescription)
 {
   Description = LidarDescription;
   LidarMeasurement = FLidarMeasurement(Description.Channels);
+  uint32 Flags = 0u;
+  if (Description.bIntensity)
+  {
+    Flags |= carla::sensor::s11n::LidarFlags::Intensity;
+  }
+  if (Description.bRing)
+  {
+    Flags |= carla::sensor::s11n::LidarFlags::Ring;
+  }
+  if (Description.bCompactPoints)
+  {
+    Flags |= carla::sensor::s11n::LidarFlags::CompactPoints;
+  }
+  LidarMeasurement.SetLayoutFromCentimeters(Flags, Description.Range);
   CreateLasers();
 }
 
@@ -99,10 +113,11 @@ void ARayCastLidar::ReadPoints(const float DeltaTime)
     for (auto i = 0u; i < PointsToScanWithOneLaser; ++i)
     {
       FVector Point;
+      float Intensity;
       const float Angle = CurrentHorizontalAngle + AngleDistanceOfLaserMeasure * i;
-      if (ShootLaser(Channel, Angle, Point))
+      if (ShootLaser(Channel, Angle, Point, Intensity))
       {
-        LidarMeasurement.WritePoint(Channel, Point);
+        LidarMeasurement.WritePoint(Channel, Point, Intensity);
       }
     }
   }
@@ -112,7 +127,7 @@ void ARayCastLidar::ReadPoints(const float DeltaTime)
   LidarMeasurement.SetHorizontalAngle(HorizontalAngle);
 }
 
-bool ARayCastLidar::ShootLaser(const uint32 Channel, const float HorizontalAngle, FVector &XYZ) const
+bool ARayCastLidar::ShootLaser(const uint32 Channel, const float HorizontalAngle, FVector &XYZ, float &Intensity) const
 {
   const float VerticalAngle = LaserAngles[Channel];
 
@@ -156,6 +171,8 @@ bool ARayCastLidar::ShootLaser(const uint32 Channel, const float HorizontalAngle
     }
 
     XYZ = LidarBodyLoc - HitInfo.ImpactPoint;
+    // Intensity decays with the distance traveled, in meters.
+    Intensity = FMath::Exp(-Description.AtmosphereAttenuationRate * 1e-2f * XYZ.Size());
     XYZ = UKismetMathLibrary::RotateAngleAxis(
       XYZ,
       - LidarBodyRot.Yaw + 90,
@@ -48,7 +48,7 @@ private:
   void ReadPoints(float DeltaTime);
 
   /// Shoot a laser ray-trace, return whether the laser hit something.
-  bool ShootLaser(uint32 Channel, float HorizontalAngle, FVector &Point) const;
+  bool ShootLaser(uint32 Channel, float HorizontalAngle, FVector &Point, float &Intensity) const;
 
   UPROPERTY(EditAnywhere)
   FLidarDescription Description;
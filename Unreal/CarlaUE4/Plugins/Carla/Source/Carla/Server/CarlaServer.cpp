@@ -209,6 +209,17 @@ void FCarlaServer::FPimpl::BindActions()
       MakeVectorFromTArray<cg::Transform>(SpawnPoints)};
   };
 
+  BIND_SYNC(get_map_hash) << [this]() -> R<uint64_t>
+  {
+    REQUIRE_CARLA_EPISODE();
+    auto FileContents = UOpenDrive::LoadXODR(Episode->GetMapName());
+    const auto &SpawnPoints = Episode->GetRecommendedSpawnPoints();
+    return cr::MapInfo::Hash(
+        cr::FromFString(Episode->GetMapName()),
+        cr::FromFString(FileContents),
+        MakeVectorFromTArray<cg::Transform>(SpawnPoints));
+  };
+
   BIND_SYNC(get_navigation_mesh) << [this]() -> R<std::vector<uint8_t>>
   {
     REQUIRE_CARLA_EPISODE();